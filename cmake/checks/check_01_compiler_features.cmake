@@ -25,6 +25,7 @@
 #   DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
 #   DEAL_II_VECTOR_ITERATOR_IS_POINTER
 #   DEAL_II_HAVE_BUILTIN_EXPECT
+#   DEAL_II_HAVE_BUILTIN_POPCOUNT
 #   DEAL_II_HAVE_VERBOSE_TERMINATE
 #   DEAL_II_HAVE_GLIBC_STACKTRACE
 #   DEAL_II_HAVE_LIBSTDCXX_DEMANGLER
@@ -98,6 +99,18 @@ CHECK_CXX_SOURCE_COMPILES(
   DEAL_II_HAVE_BUILTIN_EXPECT)
 
 
+#
+# Check for the __builtin_popcountll facility of GCC and compatible
+# compilers that counts the bits set in an integer, usually with a single
+# instruction. It is used by the bitmaps in IndexSet.
+#
+CHECK_CXX_SOURCE_COMPILES(
+  "
+  int main(){ unsigned long long int i = 5; return __builtin_popcountll(i) - 2; }
+  "
+  DEAL_II_HAVE_BUILTIN_POPCOUNT)
+
+
 #
 # Newer versions of GCC have a very nice feature: you can set
 # a verbose terminate handler, that not only aborts a program
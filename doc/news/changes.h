@@ -160,6 +160,47 @@ inconvenience this causes.
 <h3>General</h3>
 <ol>
 
+  <li> Changed: parallel::distributed::Triangulation::save() now writes the
+  data attached to cells through register_data_attach() into a separate file
+  using collective MPI-IO operations. The data is stored in the global order
+  of cells in blocks that can optionally be compressed with zlib, together
+  with an index of the blocks. load() only reads the blocks needed for the
+  locally owned cells, also when loading with a different number of
+  processors. Files written by previous versions can still be loaded.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The class MGTransferMatrixFree implements the multigrid transfer
+  between levels in a matrix-free way. Instead of storing sparse prolongation
+  matrices, it applies the one-dimensional embedding matrices of FE_Q and
+  FE_DGQ elements by sum factorization on batches of parent cells, using the
+  same tensor product kernels as FEEvaluation. It operates on
+  parallel::distributed::Vector level vectors.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: MatrixFree::loop() runs over cells, interior faces and boundary
+  faces, and the new class FEFaceEvaluation evaluates and integrates finite
+  element functions on batches of faces with sum factorization. Faces are set
+  up by specifying AdditionalData::mapping_update_flags_inner_faces and
+  AdditionalData::mapping_update_flags_boundary_faces. This enables
+  matrix-free operators for discontinuous Galerkin methods, including faces
+  with hanging nodes and faces between cells owned by different processors.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The class SlicedEllpackMatrix stores a sparse matrix in the
+  SELL-C-sigma format, i.e., in chunks of rows that match the width of
+  VectorizedArray, and implements vmult(), Tvmult() and matrix_norm_square()
+  with SIMD instructions. It is set up from a SparseMatrix and can be used in
+  its place in the iterative solvers.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
   <li> New: 2nd derivatives are implemented for polynomials_BDM in 3D.
   <br>
   (Alistair Bentley, 2015/10/27)
@@ -399,6 +440,226 @@ inconvenience this causes.
 
 <ol>
 
+  <li> Fixed: DoFTools::get_subdomain_association() read the owners of the
+  cells of a parallel::shared::Triangulation from an empty array if the
+  triangulation was created without artificial cells. It now uses the
+  subdomain ids stored in the cells in that case.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: hp::FEValues, hp::FEFaceValues and hp::FESubfaceValues have a
+  function precompute_fe_values() that creates all needed FEValues objects up
+  front instead of lazily inside the assembly loop. The new function
+  hp::sort_cells_by_active_fe_index() orders cells so that the underlying
+  objects are switched as rarely as possible.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The class FEValuesBatch evaluates shape functions, their
+  gradients, JxW values and quadrature points on a batch of cells at once and
+  returns them as VectorizedArray objects, with one cell per lane. This allows
+  to write assembly loops that process several cells with each SIMD
+  instruction, using the same interface as FEValues including the extractors
+  for scalar and vector components.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: FEValues::enable_cell_similarity_cache() keeps the transformed
+  derivatives of the shape functions for several cell geometries, identified
+  by the Jacobians in the quadrature points, and reuses them on all later
+  cells with the same geometry rather than only on translations of the
+  previous cell.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: TimerOutput::add_work() attaches the expected number of floating
+  point operations and bytes transferred from and to memory to the active
+  sections, and TimerOutput::enable_hardware_counters() reads the processor's
+  cycle, instruction, and cache miss counters through perf_event_open on
+  Linux. The statistics and the summary report the achieved GFLOP/s and GB/s
+  next to the expected work.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> Improved: TimerOutput can now be used from several threads at once.
+  Every thread keeps its own active sections and times, and the data are
+  merged when output is generated. Sections can be nested. The new function
+  TimerOutput::get_statistics() returns the times for each nesting path, with
+  the number of calls and threads and the minimum, average and maximum over
+  all MPI processes. TimerOutput::write_statistics() writes these data in JSON
+  or CSV format.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: PreconditionSSOR can now run in parallel for SparseMatrix objects.
+  PreconditionSSOR::AdditionalData::multicolor colors the rows with
+  GraphColoring::make_graph_coloring() and processes all rows of one color in
+  parallel. PreconditionSSOR::AdditionalData::block_jacobi applies SSOR to
+  contiguous blocks of rows in parallel. The kernels are the new functions
+  SparseMatrix::precondition_SSOR_multicolor() and
+  SparseMatrix::precondition_SSOR_blockwise().
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: SparseILU and SparseMIC can compute their decomposition and apply
+  it in vmult() in parallel, processing the rows level by level in the
+  dependency graph of the triangular solves. This is enabled by the new flag
+  SparseLUDecomposition::AdditionalData::use_level_scheduling.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: SolverIterativeRefinement solves a linear system with an inner
+  Krylov solver, operator and preconditioner in lower precision, e.g.
+  SparseMatrix<float> or a matrix-free operator based on
+  MatrixFree<dim,float>, while the residual is computed and the solution is
+  updated in double precision.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The class MultiVector stores several vectors of the same size
+  interleaved, and SparseMatrix::vmult() applied to a MultiVector reads the
+  matrix only once for all of its columns. The new solver SolverBlockCG uses
+  this to solve linear systems with several right hand sides at once.
+  Operators that only act on single vectors, like matrix-free operators, can
+  be used through MultiVectorColumnwiseOperator.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> Improved: parallel::distributed::BlockVector::compress() and
+  parallel::distributed::BlockVector::update_ghost_values() now send the data
+  of all blocks that goes to the same processor in a single message, using
+  persistent requests. The new functions compress_start(), compress_finish(),
+  update_ghost_values_start() and update_ghost_values_finish() of the block
+  vector allow to overlap this communication with computations.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New:
+  Utilities::MPI::Partitioner::initialize_neighborhood_communicator() and
+  Utilities::MPI::Partitioner::initialize_shared_memory_communicator() set up
+  an MPI-3 neighborhood communicator and a shared memory communicator once per
+  partitioner. parallel::distributed::Vector then exchanges ghost data with a
+  single neighborhood collective, and reads the entries of processes on the
+  same node directly from their memory instead of sending messages.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> Improved: IndexSet now also stores blocks of 4096 indices in which the
+  set is heavily fragmented as bitmaps, with per-word counts of preceding
+  elements. This makes IndexSet::is_element() and IndexSet::index_within_set()
+  on fragmented sets of ghost indices a bit test plus a population count
+  instead of a binary search over all ranges. The set operations work on whole
+  words of bitmaps for such sets, and IndexSet::subtract_set() no longer has
+  quadratic complexity in the number of ranges.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: DoFRenumbering::distributed_Cuthill_McKee() renumbers the locally
+  owned degrees of freedom on each processor with the Cuthill-McKee algorithm.
+  It starts from the degrees of freedom that couple to processors with lower
+  numbers, as seen through the ghost couplings. The interfaces to neighboring
+  processors then end up at the two ends of each processor's index range,
+  which keeps the bandwidth of the global matrix small without any
+  communication.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: DoFRenumbering::space_filling_curve() numbers the degrees of
+  freedom along a Hilbert or Morton curve through the mesh, to improve the
+  cache locality of matrix-vector products and cell loops on adaptively
+  refined meshes. DoFRenumbering::compute_space_filling_curve_cell_order()
+  returns the matching order of the locally owned cells. Both work on serial
+  and parallel triangulations.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The class SparsityPatternBuilder collects the entries of a
+  sparsity pattern from several threads without locks.
+  DoFTools::make_sparsity_pattern() runs its loop over cells in parallel when
+  given such an object, and SparsityPattern::copy_from() merges the collected
+  entries into the compressed format in parallel, without going through
+  DynamicSparsityPattern.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The class WorkStream::ThreadPartitioning splits a range of
+  iterators into fixed partitions that are assigned to the same threads every
+  time WorkStream::run() is called with it. Scratch and copy data are created
+  by the thread that uses them, and the time spent on each partition is
+  recorded to assess load balance. This improves memory locality when
+  assembling repeatedly on machines with several memory domains.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The new functions Vector::add_linear_combination() and
+  Vector::inner_products() and their counterparts in
+  parallel::distributed::Vector update a vector by a linear combination of
+  several vectors and compute several inner products in a single sweep over
+  memory. SolverGMRES uses them for the solution update and the classical
+  Gram-Schmidt orthogonalization, and SolverPipelinedCG fuses all vector
+  updates of an iteration with the local parts of the inner products.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: The new class SolverPipelinedCG implements the pipelined conjugate
+  gradient method of Ghysels and Vanroose that computes all inner products of
+  an iteration in one reduction and overlaps it with the preconditioner and
+  the matrix-vector product.
+  SolverGMRES::AdditionalData::use_classical_gram_schmidt selects a classical
+  Gram-Schmidt orthogonalization with one reduction per Arnoldi vector. For
+  parallel::distributed::Vector, these reductions use non-blocking MPI
+  collectives.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: DataOutInterface::write_vtu_in_background() writes a vtu file on a
+  background task managed by the new class DataOutBase::BackgroundWriter,
+  which bounds the memory held by pending output jobs and offers a wait()
+  barrier. Large data arrays in compressed vtu output are now split into
+  blocks that are compressed in parallel.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> New: ConstraintMatrix::distribute_local_to_global() has a new overload
+  that takes the local matrices, vectors and dof indices of many cells at
+  once. Cells are colored such that no two cells of the same color write into
+  the same rows of the global objects, and each color is then processed in
+  parallel. The coloring and the positions of the constraints can be set up
+  once by ConstraintMatrix::setup_local_to_global_batch() and be reused for
+  several calls with the same dof indices.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
+  <li> Improved: MappingQGeneric now computes the quadrature points and the
+  Jacobians on cells by sum factorization when the quadrature formula is the
+  tensor product of a one-dimensional formula, reducing the cost per cell from
+  O(p<sup>2d</sup>) to O(p<sup>d+1</sup>) operations for a mapping of degree
+  p.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
   <li> Fixed: PolynomialsBDM::degree() now returns the correct value.
   <br>
   (Alistair Bentley, 2015/10/24)
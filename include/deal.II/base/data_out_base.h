@@ -22,8 +22,12 @@
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/std_cxx11/tuple.h>
+#include <deal.II/base/std_cxx11/function.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+#include <deal.II/base/thread_management.h>
 
 #include <vector>
+#include <list>
 #include <string>
 #include <limits>
 #include <typeinfo>
@@ -1637,6 +1641,113 @@ namespace DataOutBase
                        const VtkFlags                          &flags,
                        std::ostream                            &out);
 
+  /**
+   * A class that writes output files on background tasks, so that a program
+   * can continue with its computations while the data of previous time steps
+   * is compressed and written to disk.
+   *
+   * Each call to submit() hands a function that produces the content of one
+   * file to a new task, see Threads::new_task(). The function must only work
+   * on data it owns, because the caller is free to modify or destroy its own
+   * data as soon as submit() returns. This is the case for
+   * DataOutInterface::write_vtu_in_background(), which copies the patches of
+   * a DataOut object into the job before returning.
+   *
+   * Since every job keeps a copy of its data until it is finished, the number
+   * of jobs in flight is limited by a memory budget given to the constructor:
+   * if a new job would exceed the budget, submit() first waits for the
+   * oldest jobs to complete. A job that is larger than the whole budget is
+   * accepted once all previous jobs have finished. The function wait() is a
+   * barrier that returns only after all submitted files have been written;
+   * it is also called by the destructor.
+   *
+   * An exception thrown while writing a file, e.g. because the file cannot
+   * be opened, is caught on the task and its message is stored along with
+   * the job. The next call to submit() or wait() that waits for this job
+   * then throws an exception with that message to the caller. The destructor
+   * waits for all jobs but does not throw.
+   *
+   * The member functions of this class are meant to be called from one
+   * thread only, typically the one that runs the time loop of a program.
+   *
+   * @ingroup output
+   */
+  class BackgroundWriter
+  {
+  public:
+    /**
+     * Constructor. The argument is the maximal number of bytes that the
+     * jobs in flight may occupy.
+     */
+    BackgroundWriter (const std::size_t memory_budget = 268435456);
+
+    /**
+     * Destructor. Waits for all jobs to finish.
+     */
+    ~BackgroundWriter ();
+
+    /**
+     * Create a task that opens the file @p filename and passes the stream
+     * to @p write_function. The argument @p memory is the number of bytes
+     * held by @p write_function and counts against the memory budget.
+     */
+    void submit (const std_cxx11::function<void (std::ostream &)> &write_function,
+                 const std::string &filename,
+                 const std::size_t  memory);
+
+    /**
+     * Wait until all jobs submitted so far have been written.
+     */
+    void wait ();
+
+    /**
+     * Return the number of jobs that have been submitted but not yet been
+     * waited for.
+     */
+    unsigned int n_pending_jobs () const;
+
+    /**
+     * Return the number of bytes held by the jobs that have been submitted
+     * but not yet been waited for.
+     */
+    std::size_t memory_in_flight () const;
+
+  private:
+    /**
+     * A job in flight: the task that writes the file, the number of bytes
+     * the job holds, and the message of an exception thrown on the task, if
+     * any. The message is written by the task and read only after the task
+     * has been joined.
+     */
+    struct Job
+    {
+      Threads::Task<>                    task;
+      std::size_t                        memory;
+      std_cxx11::shared_ptr<std::string> error;
+    };
+
+    /**
+     * Wait for the oldest job and release its data. Returns the message of
+     * the exception the job threw, or an empty string.
+     */
+    std::string wait_for_oldest_job ();
+
+    /**
+     * The maximal number of bytes held by the jobs in flight.
+     */
+    const std::size_t memory_budget;
+
+    /**
+     * The number of bytes held by the jobs in flight.
+     */
+    std::size_t current_memory;
+
+    /**
+     * The jobs in flight, in the order in which they were submitted.
+     */
+    std::list<Job> jobs;
+  };
+
   /**
    * Write the given list of patches to the output stream in SVG format.
    *
@@ -2048,6 +2159,19 @@ public:
    */
   void write_vtu_in_parallel (const char *filename, MPI_Comm comm) const;
 
+  /**
+   * Write the data in Vtu format to the file @p filename on a background
+   * task of the given @p writer and return immediately. The patches, data
+   * set names and output flags are copied before this function returns, so
+   * the current object can be reused, e.g. by calling build_patches() for
+   * the next time step, while the file is written. Call
+   * DataOutBase::BackgroundWriter::wait() to make sure that all files have
+   * been written. See DataOutBase::BackgroundWriter for how the memory held
+   * by the copies is bounded.
+   */
+  void write_vtu_in_background (const std::string             &filename,
+                                DataOutBase::BackgroundWriter &writer) const;
+
   /**
    * Some visualization programs, such as ParaView, can read several separate
    * VTU files to parallelize visualization. In that case, you need a
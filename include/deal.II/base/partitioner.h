@@ -22,6 +22,7 @@
 #include <deal.II/base/types.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
 
 #include <limits>
 
@@ -55,6 +56,24 @@ namespace Utilities
      * consecutively in [@p local_size, @p local_size + @p n_ghost_indices).
      * The ghost indices are sorted according to their global index.
      *
+     * By default, vectors based on a partitioner exchange ghost data with
+     * one persistent point-to-point message per process in the lists of
+     * ghost_targets() and import_targets(). For repeated exchanges of small
+     * amounts of data, e.g. on the coarser levels of a multigrid hierarchy,
+     * the latency of these messages can be reduced by two additional
+     * mechanisms that are set up once per partitioner by the collective
+     * functions initialize_neighborhood_communicator() and
+     * initialize_shared_memory_communicator(). The former creates an MPI-3
+     * distributed graph communicator connecting all processes that exchange
+     * data, such that all messages of one exchange are handled by a single
+     * neighborhood collective call. The latter groups the processes that
+     * can access each other's memory and lets vectors place their data in a
+     * shared memory window, such that ghost values from processes on the
+     * same node are read directly from the owner's vector without being
+     * copied into an import buffer and sent as a message. Both can be
+     * combined, in which case only the processes on other nodes take part
+     * in the neighborhood collective.
+     *
      *
      * @author Katharina Kormann, Martin Kronbichler, 2010, 2011
      */
@@ -259,6 +278,120 @@ namespace Utilities
        */
       bool ghost_indices_initialized() const;
 
+      /**
+       * Sets up an MPI-3 distributed graph communicator whose neighbors are
+       * the processes in ghost_targets() and import_targets(). Vectors based
+       * on this partitioner then exchange their ghost data by a single call
+       * to <tt>MPI_Ineighbor_alltoallv</tt> instead of one message per
+       * process. This function must be called on all processes of the
+       * communicator at the same time, after the ghost indices have been
+       * set, and before the partitioner is handed to any vector. If MPI does
+       * not support version 3 of the standard or if only a single process is
+       * involved, this function does nothing.
+       */
+      void initialize_neighborhood_communicator ();
+
+      /**
+       * Returns whether initialize_neighborhood_communicator() has set up a
+       * neighborhood communicator.
+       */
+      bool has_neighborhood_communicator () const;
+
+      /**
+       * Returns the neighborhood communicator set up by
+       * initialize_neighborhood_communicator(). Its neighbors are sorted by
+       * their rank in the communicator of the partitioner.
+       */
+      const MPI_Comm &get_neighborhood_communicator () const;
+
+      /**
+       * Returns the number of ghost entries received from each process in the
+       * neighborhood communicator during update of ghost values. Processes
+       * whose data are exchanged through shared memory contribute zero
+       * entries.
+       */
+      const std::vector<int> &neighborhood_ghost_counts () const;
+
+      /**
+       * Returns the position of the ghost entries of each process in the
+       * neighborhood communicator, relative to the first ghost entry.
+       */
+      const std::vector<int> &neighborhood_ghost_offsets () const;
+
+      /**
+       * Returns the number of import entries sent to each process in the
+       * neighborhood communicator during update of ghost values.
+       */
+      const std::vector<int> &neighborhood_import_counts () const;
+
+      /**
+       * Returns the position of the import entries of each process in the
+       * neighborhood communicator, relative to the first import entry.
+       */
+      const std::vector<int> &neighborhood_import_offsets () const;
+
+      /**
+       * Groups the processes of the communicator that share memory, i.e.,
+       * that run on the same node, and determines which of the processes in
+       * ghost_targets() and import_targets() are in the same group. Vectors
+       * based on this partitioner then allocate their data in an MPI-3
+       * shared memory window and access the entries owned by processes on
+       * the same node directly. Like initialize_neighborhood_communicator(),
+       * this function is collective and does nothing if MPI does not support
+       * version 3 of the standard or if only a single process is involved.
+       *
+       * @note Allocating and freeing shared memory windows are collective
+       * operations on all processes of a node. Vectors based on a
+       * partitioner with a shared memory communicator must therefore be
+       * created, reinitialized, and destroyed on all processes at the same
+       * time. Furthermore, update_ghost_values() and compress() synchronize
+       * all processes on the node, including those without ghost entries.
+       */
+      void initialize_shared_memory_communicator ();
+
+      /**
+       * Returns whether initialize_shared_memory_communicator() has set up a
+       * shared memory communicator.
+       */
+      bool has_shared_memory_communicator () const;
+
+      /**
+       * Returns the communicator of the processes on the same node as the
+       * present process.
+       */
+      const MPI_Comm &get_shared_memory_communicator () const;
+
+      /**
+       * For each entry of ghost_targets(), returns the rank of the owning
+       * process in the shared memory communicator, or
+       * numbers::invalid_unsigned_int if that process is on another node.
+       */
+      const std::vector<unsigned int> &ghost_targets_shared_memory_rank () const;
+
+      /**
+       * For each entry of import_targets(), returns the rank of the process
+       * in the shared memory communicator, or numbers::invalid_unsigned_int
+       * if that process is on another node.
+       */
+      const std::vector<unsigned int> &import_targets_shared_memory_rank () const;
+
+      /**
+       * The ghost indices owned by processes on the same node, in the order
+       * of ghost_targets(), translated to the local index space of the
+       * owning process and compressed to ranges. The ranges of different
+       * processes are never merged.
+       */
+      const std::vector<std::pair<unsigned int, unsigned int> > &
+      shared_memory_ghost_indices () const;
+
+      /**
+       * For each entry of import_targets() on the same node, returns the
+       * local index in the vector of that process where its ghost entries
+       * owned by the present process start. Entries for processes on other
+       * nodes are set to numbers::invalid_unsigned_int.
+       */
+      const std::vector<unsigned int> &shared_memory_import_offsets () const;
+
       /**
        * Computes the memory consumption of this structure.
        */
@@ -347,6 +480,76 @@ namespace Utilities
        * Stores whether the ghost indices have been explicitly set.
        */
       bool have_ghost_indices;
+
+      /**
+       * The distributed graph communicator set up by
+       * initialize_neighborhood_communicator(), or an empty pointer. Since
+       * freeing a communicator is collective, the communicator is only
+       * marked as unused when the last copy of the pointer goes away. It is
+       * freed by the next call to initialize_neighborhood_communicator() or
+       * initialize_shared_memory_communicator() on the same processes after
+       * all of them have released it.
+       */
+      std_cxx11::shared_ptr<MPI_Comm> neighborhood_communicator;
+
+      /**
+       * Number of ghost entries per neighbor in the neighborhood
+       * communicator.
+       */
+      std::vector<int> neighborhood_ghost_counts_data;
+
+      /**
+       * Offsets of the ghost entries per neighbor in the neighborhood
+       * communicator.
+       */
+      std::vector<int> neighborhood_ghost_offsets_data;
+
+      /**
+       * Number of import entries per neighbor in the neighborhood
+       * communicator.
+       */
+      std::vector<int> neighborhood_import_counts_data;
+
+      /**
+       * Offsets of the import entries per neighbor in the neighborhood
+       * communicator.
+       */
+      std::vector<int> neighborhood_import_offsets_data;
+
+      /**
+       * The communicator of the processes on the same node set up by
+       * initialize_shared_memory_communicator(), or an empty pointer. It is
+       * freed in the same way as the neighborhood communicator.
+       */
+      std_cxx11::shared_ptr<MPI_Comm> shared_memory_communicator;
+
+      /**
+       * Rank of each ghost target in the shared memory communicator.
+       */
+      std::vector<unsigned int> ghost_targets_shared_memory_rank_data;
+
+      /**
+       * Rank of each import target in the shared memory communicator.
+       */
+      std::vector<unsigned int> import_targets_shared_memory_rank_data;
+
+      /**
+       * The ghost indices owned by processes on the same node in the local
+       * index space of the owner.
+       */
+      std::vector<std::pair<unsigned int, unsigned int> > shared_memory_ghost_indices_data;
+
+      /**
+       * Start of the ghost entries owned by the present process in the
+       * vectors of the import targets on the same node.
+       */
+      std::vector<unsigned int> shared_memory_import_offsets_data;
+
+      /**
+       * Fills the count and offset arrays of the neighborhood communicator,
+       * leaving out the processes that exchange data through shared memory.
+       */
+      void compute_neighborhood_counts ();
     };
 
 
@@ -540,6 +743,116 @@ namespace Utilities
       return have_ghost_indices;
     }
 
+
+
+    inline
+    bool
+    Partitioner::has_neighborhood_communicator() const
+    {
+      return neighborhood_communicator.get() != 0;
+    }
+
+
+
+    inline
+    const MPI_Comm &
+    Partitioner::get_neighborhood_communicator() const
+    {
+      Assert (has_neighborhood_communicator(), ExcNotInitialized());
+      return *neighborhood_communicator;
+    }
+
+
+
+    inline
+    const std::vector<int> &
+    Partitioner::neighborhood_ghost_counts() const
+    {
+      return neighborhood_ghost_counts_data;
+    }
+
+
+
+    inline
+    const std::vector<int> &
+    Partitioner::neighborhood_ghost_offsets() const
+    {
+      return neighborhood_ghost_offsets_data;
+    }
+
+
+
+    inline
+    const std::vector<int> &
+    Partitioner::neighborhood_import_counts() const
+    {
+      return neighborhood_import_counts_data;
+    }
+
+
+
+    inline
+    const std::vector<int> &
+    Partitioner::neighborhood_import_offsets() const
+    {
+      return neighborhood_import_offsets_data;
+    }
+
+
+
+    inline
+    bool
+    Partitioner::has_shared_memory_communicator() const
+    {
+      return shared_memory_communicator.get() != 0;
+    }
+
+
+
+    inline
+    const MPI_Comm &
+    Partitioner::get_shared_memory_communicator() const
+    {
+      Assert (has_shared_memory_communicator(), ExcNotInitialized());
+      return *shared_memory_communicator;
+    }
+
+
+
+    inline
+    const std::vector<unsigned int> &
+    Partitioner::ghost_targets_shared_memory_rank() const
+    {
+      return ghost_targets_shared_memory_rank_data;
+    }
+
+
+
+    inline
+    const std::vector<unsigned int> &
+    Partitioner::import_targets_shared_memory_rank() const
+    {
+      return import_targets_shared_memory_rank_data;
+    }
+
+
+
+    inline
+    const std::vector<std::pair<unsigned int, unsigned int> > &
+    Partitioner::shared_memory_ghost_indices() const
+    {
+      return shared_memory_ghost_indices_data;
+    }
+
+
+
+    inline
+    const std::vector<unsigned int> &
+    Partitioner::shared_memory_import_offsets() const
+    {
+      return shared_memory_import_offsets_data;
+    }
+
 #endif  // ifndef DOXYGEN
 
   } // end of namespace MPI
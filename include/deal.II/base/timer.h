@@ -19,7 +19,9 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/mpi.h>
 
 #ifdef DEAL_II_WITH_MPI
 #  include <mpi.h>
@@ -28,6 +30,8 @@
 #include <string>
 #include <list>
 #include <map>
+#include <vector>
+#include <ostream>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -228,7 +232,6 @@ private:
 
 
 
-//TODO: The following class is not thread-safe
 /**
  * This class can be used to generate formatted output from time measurements
  * of different subsections in a program. It is possible to create several
@@ -382,6 +385,98 @@ private:
  * sure that we only generate output on a single processor. See the step-32
  * and step-40 tutorial programs for this kind of usage of this class.
  *
+ *
+ * <h3>Nested sections and usage with threads</h3>
+ *
+ * Sections can be nested, i.e., a section can be entered while another one
+ * is active. Besides the table of print_summary(), which lists every section
+ * name once, the class records the time for each nesting path, like
+ * <code>"Solve/Preconditioner setup"</code> for a section
+ * <code>"Preconditioner setup"</code> entered within the section
+ * <code>"Solve"</code>. These data are available through get_statistics()
+ * and write_statistics().
+ *
+ * Sections may be entered and left concurrently from several threads, e.g.
+ * from the worker functions of WorkStream::run(). Each thread keeps its own
+ * list of active sections and accumulates its times separately without any
+ * locking, and the data of all threads are merged when output is generated.
+ * Consequently, the nesting of a section only refers to the sections active
+ * on the same thread, the same section may be active on several threads at
+ * once, and leave_subsection() without argument leaves the section most
+ * recently entered on the calling thread. The summary and statistics must
+ * not be generated while other threads are within a section. Note that the
+ * CPU time is the CPU time of the whole process, so concurrent sections all
+ * see the CPU time spent by all threads. If the object was constructed with
+ * an MPI communicator, the barriers described above are only placed in the
+ * sections entered from the thread that created the object, and only these
+ * sections use the synchronized times in print_summary().
+ *
+ *
+ * <h3>Statistics over threads and processes</h3>
+ *
+ * The function get_statistics() returns for each nesting path the number of
+ * calls, the number of threads that entered the section, the time summed
+ * over all threads and the largest time of a single thread on the present
+ * process, as well as the minimum, average, and maximum of the time over
+ * all processes in the MPI communicator together with the ranks of the
+ * minimum and the maximum, computed with Utilities::MPI::min_max_avg(). A
+ * large difference between the minimum and maximum over the processes, or
+ * between the total time and the maximal time of a single thread multiplied
+ * by the number of threads, points to a load imbalance. The function
+ * write_statistics() writes the same data in JSON or CSV format for further
+ * processing:
+ * @code
+ *   std::ofstream file ("timings.json");
+ *   timer.write_statistics (file, TimerOutput::json);
+ * @endcode
+ *
+ *
+ * <h3>Arithmetic intensity and hardware counters</h3>
+ *
+ * For kernels whose performance is limited by the memory bandwidth or the
+ * arithmetic throughput, like matrix-vector products or vector operations,
+ * the time alone does not tell how close a kernel gets to the capabilities
+ * of the hardware. To this end, the number of floating point operations and
+ * the number of bytes transferred from and to main memory a kernel is
+ * expected to need can be attached to the active sections with add_work().
+ * These numbers are computed analytically by the caller, and the class
+ * reports the achieved GFLOP/s and GB/s based on them. For example, a
+ * matrix-vector product with a SparseMatrix<double> performs two operations
+ * per nonzero entry and needs to at least load the matrix entries with their
+ * column indices, the row starts, the source vector, and to write the
+ * destination vector:
+ * @code
+ *   {
+ *     TimerOutput::Scope scope (timer, "vmult");
+ *     matrix.vmult (dst, src);
+ *     const double nnz = matrix.n_nonzero_elements();
+ *     timer.add_work (2. * nnz,
+ *                     nnz * (sizeof(double) + sizeof(unsigned int)) +
+ *                     (matrix.m() + 1) * sizeof(std::size_t) +
+ *                     (src.size() + 2. * dst.size()) * sizeof(double));
+ *   }
+ * @endcode
+ * Here, the destination vector is counted twice because the processor
+ * loads a cache line before writing to it.
+ *
+ * In addition, enable_hardware_counters() instructs the class to read the
+ * hardware performance counters of the processor for the number of cycles,
+ * the number of instructions, and the number of cache misses in the last
+ * level cache at the beginning and end of each section. They are accessed
+ * through the <code>perf_event_open</code> system call and are thus only
+ * available on Linux, and only if the kernel allows access to them (see the
+ * file <code>/proc/sys/kernel/perf_event_paranoid</code>). From the cache
+ * misses, the class computes the number of bytes actually loaded from main
+ * memory assuming cache lines of 64 bytes, which can be compared to the
+ * expected number of bytes given to add_work(). This number is only a rough
+ * estimate since it ignores write backs and hardware prefetching.
+ * The counters only count the events of the thread that entered the section.
+ *
+ * The work and the counter values are included in the data returned by
+ * get_statistics() and written by write_statistics(), and print_summary()
+ * adds a table with the achieved rates if any section has expected work or
+ * counter values attached.
+ *
  * @ingroup utilities
  * @author M. Kronbichler, 2009.
  */
@@ -447,6 +542,89 @@ public:
     cpu_and_wall_times
   };
 
+  /**
+   * An enumeration data type that describes the machine-readable formats
+   * supported by write_statistics().
+   */
+  enum StatisticsFormat
+  {
+    json,
+    csv
+  };
+
+  /**
+   * A structure that groups the information about one nesting path of
+   * sections as returned by get_statistics().
+   */
+  struct SectionStatistics
+  {
+    /**
+     * The names of the section and of all sections it is nested in,
+     * separated by slashes.
+     */
+    std::string name;
+
+    /**
+     * The number of sections the section is nested in.
+     */
+    unsigned int depth;
+
+    /**
+     * The number of times the section was entered on the present process,
+     * summed over all threads.
+     */
+    unsigned int n_calls;
+
+    /**
+     * The number of threads that entered the section on the present
+     * process.
+     */
+    unsigned int n_threads;
+
+    /**
+     * The CPU time of the process spent within the section, summed over all
+     * threads.
+     */
+    double cpu_time;
+
+    /**
+     * The wall time spent within the section on the present process, summed
+     * over all threads.
+     */
+    double wall_time;
+
+    /**
+     * The largest wall time spent within the section by a single thread of
+     * the present process.
+     */
+    double max_thread_wall_time;
+
+    /**
+     * The minimum, average, and maximum of #wall_time over all processes in
+     * the MPI communicator given to the constructor.
+     */
+    Utilities::MPI::MinMaxAvg wall_time_over_processes;
+
+    /**
+     * The number of floating point operations and the number of bytes
+     * transferred from and to memory given to add_work() within the section
+     * on the present process, summed over all threads.
+     */
+    double expected_flops;
+    double expected_bytes;
+
+    /**
+     * The number of processor cycles, instructions, and the number of bytes
+     * loaded from main memory as estimated from the last level cache misses,
+     * measured with hardware counters within the section on the present
+     * process and summed over all threads. These numbers are zero if
+     * hardware counters are not enabled or not available.
+     */
+    double cycles;
+    double instructions;
+    double measured_bytes;
+  };
+
   /**
    * Constructor.
    *
@@ -567,12 +745,55 @@ public:
    */
   void exit_section (const std::string &section_name = std::string());
 
+  /**
+   * Add the given number of floating point operations and bytes transferred
+   * from and to memory to the section most recently entered on the calling
+   * thread and to all sections it is nested in. See the documentation of
+   * this class for an example.
+   */
+  void add_work (const double n_flops,
+                 const double n_bytes);
+
+  /**
+   * Read the hardware performance counters at the beginning and end of all
+   * sections entered after calling this function. The counters are opened
+   * separately for each thread the first time the thread enters a section.
+   * If they are not available, sections are timed as before and the
+   * counter values reported are zero.
+   */
+  void enable_hardware_counters ();
+
+  /**
+   * Return whether hardware counters have been enabled and can be accessed
+   * from the calling thread.
+   */
+  bool hardware_counters_available () const;
+
   /**
    * Print a formatted table that summarizes the time consumed in the various
    * sections.
    */
   void print_summary () const;
 
+  /**
+   * Return the data collected for all nesting paths of sections, merged
+   * over all threads. The entries are sorted such that each section comes
+   * right after the section it is nested in. If the object was constructed
+   * with an MPI communicator, this function must be called on all processes
+   * of the communicator, and all processes must have entered the same
+   * nesting paths.
+   */
+  std::vector<SectionStatistics> get_statistics () const;
+
+  /**
+   * Write the data returned by get_statistics() to @p out in the given
+   * format. Like get_statistics(), this function must be called on all
+   * processes if the object was constructed with an MPI communicator, but
+   * only the process with rank zero writes the data.
+   */
+  void write_statistics (std::ostream           &out,
+                         const StatisticsFormat  format) const;
+
   /**
    * By calling this function, all output can be disabled. This function
    * together with enable_output() can be useful if one wants to control the
@@ -613,21 +834,109 @@ private:
   Timer              timer_all;
 
   /**
-   * A structure that groups all information that we collect about each of the
-   * sections.
+   * A structure that groups the information for the table of
+   * print_summary(), which lists each section name once.
    */
   struct Section
   {
-    Timer  timer;
     double total_cpu_time;
     double total_wall_time;
     unsigned int n_calls;
+    double flops;
+    double bytes;
+    double measured_bytes;
   };
 
   /**
-   * A list of all the sections and their information.
+   * The number of hardware counters read for each section: the number of
+   * cycles, of instructions, and of last level cache misses.
+   */
+  static const unsigned int n_hardware_counters = 3;
+
+  /**
+   * A section that is currently active on a thread.
    */
-  std::map<std::string, Section> sections;
+  struct ActiveSection
+  {
+    /**
+     * The name of the section and its nesting path.
+     */
+    std::string name;
+    std::string path;
+
+    /**
+     * The timer measuring the times of the present thread and process.
+     */
+    Timer timer;
+
+    /**
+     * Whether the section is timed with synchronization over all processes,
+     * and the timer doing so.
+     */
+    bool synchronized;
+    Timer synchronized_timer;
+
+    /**
+     * The work given to add_work() while the section is active, and the
+     * values of the hardware counters when the section was entered.
+     */
+    double flops;
+    double bytes;
+    bool counted;
+    unsigned long long int counters_at_start[n_hardware_counters];
+  };
+
+  /**
+   * The times accumulated by one thread for one nesting path. Besides the
+   * times of the present process, the times for print_summary() are stored,
+   * which are the synchronized times over all processes if applicable.
+   */
+  struct SectionData
+  {
+    SectionData ();
+
+    std::string name;
+    unsigned int n_calls;
+    double cpu_time;
+    double wall_time;
+    double summary_cpu_time;
+    double summary_wall_time;
+    double flops;
+    double bytes;
+    unsigned long long int counters[n_hardware_counters];
+  };
+
+  /**
+   * All data of one thread: the list of active sections in the order in
+   * which they have been entered, the accumulated times for each nesting
+   * path, and the file descriptors of the hardware counters of the thread
+   * with a flag whether opening them has already been attempted.
+   */
+  struct ThreadData
+  {
+    ThreadData ();
+
+    std::vector<ActiveSection> active_sections;
+    std::map<std::string, SectionData> sections;
+    bool counters_initialized;
+    int counter_fds[n_hardware_counters];
+  };
+
+  /**
+   * The data of all threads.
+   */
+  mutable Threads::ThreadLocalStorage<ThreadData> thread_data;
+
+  /**
+   * Merge the data of all threads into the table of print_summary().
+   */
+  std::map<std::string, Section> collect_sections () const;
+
+  /**
+   * Open the hardware counters of the given thread unless this has been
+   * attempted before, and return whether they are available.
+   */
+  static bool open_hardware_counters (ThreadData &data);
 
   /**
    * The stream object to which we are to output.
@@ -641,21 +950,26 @@ private:
   bool output_is_enabled;
 
   /**
-   * A list of the sections that have been entered and not exited. The list is
-   * kept in the order in which sections have been entered, but elements may
-   * be removed in the middle if an argument is given to the exit_section()
-   * function.
+   * mpi communicator
    */
-  std::list<std::string> active_sections;
+  MPI_Comm            mpi_communicator;
 
   /**
-   * mpi communicator
+   * The id of the thread that created this object, see
+   * Threads::this_thread_id(). Only sections entered on this thread are
+   * synchronized over the MPI communicator.
    */
-  MPI_Comm            mpi_communicator;
+  const unsigned int  main_thread_id;
+
+  /**
+   * Whether enable_hardware_counters() has been called.
+   */
+  bool use_hardware_counters;
 
   /**
-   * A lock that makes sure that this class gives reasonable results even when
-   * used with several threads.
+   * A lock that makes sure that the output generated every time a section
+   * is left is not garbled when several threads leave sections at the same
+   * time.
    */
   Threads::Mutex mutex;
 };
@@ -26,6 +26,7 @@
 #include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/base/thread_local_storage.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/timer.h>
 
 #ifdef DEAL_II_WITH_THREADS
 #  include <deal.II/base/thread_management.h>
@@ -35,6 +36,8 @@
 #include <vector>
 #include <utility>
 #include <memory>
+#include <algorithm>
+#include <ostream>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -126,6 +129,12 @@ DEAL_II_NAMESPACE_OPEN
  * unused and may be re-used for the next invocation of the worker function,
  * on this or another thread.
  *
+ * If the same range is worked on many times, for example when a system is
+ * re-assembled in every time step, the class ThreadPartitioning offers an
+ * alternative that assigns fixed partitions of the range to the threads,
+ * which keeps the data of each thread within one memory domain on machines
+ * with non-uniform memory access.
+ *
  * The functions in this namespace only really work in parallel when
  * multithread mode was selected during deal.II configuration. Otherwise they
  * simply work on each item sequentially.
@@ -1253,6 +1262,394 @@ namespace WorkStream
          chunk_size);
   }
 
+
+
+  /**
+   * A class that splits a range of iterators into a fixed set of partitions,
+   * typically one per thread, and runs the worker and copier functions on
+   * these partitions such that the same partition is processed by the same
+   * thread every time run() is called. This is the setting of codes that
+   * assemble the same kind of system on the same mesh many times, e.g. in
+   * every time step or every nonlinear iteration, on machines with several
+   * memory (NUMA) domains: the other run() functions of this namespace hand
+   * out chunks of the range to whichever thread is idle, so a thread may
+   * work on cells and degrees of freedom that are scattered over the whole
+   * mesh and whose data live in the memory of a different processor socket.
+   *
+   * Partitions are contiguous pieces of the range, which for cell iterators
+   * of a triangulation keeps cells that are close in space together since
+   * the cells are enumerated by the refinement hierarchy. Alternatively, the
+   * partitions can be given explicitly, for example to group cells by the
+   * subdomain ids computed by GridTools::partition_triangulation() or in an
+   * order along a space filling curve.
+   *
+   * On each run, the partitions are distributed onto the threads with the
+   * same mapping as in the previous run (using the affinity partitioner of
+   * the Threading Building Blocks). The scratch and copy data objects are
+   * created by the thread that works on the partition, so that their memory
+   * is placed on the NUMA domain of this thread by the first-touch policy of
+   * the operating system. Within a partition, the worker is called on
+   * @p chunk_size items at a time, after which the copier is called for
+   * these items while holding a lock. Consequently, calls to the copier
+   * never run concurrently, but their order is not specified.
+   *
+   * The wall time spent on each partition in the last run is recorded and
+   * can be queried with get_partition_times() or printed with
+   * print_statistics() to check the load balance between the threads.
+   */
+  template <typename Iterator>
+  class ThreadPartitioning
+  {
+  public:
+    /**
+     * Constructor. Split the range <tt>[begin,end)</tt> into @p n_partitions
+     * contiguous partitions with the same number of elements (up to one).
+     */
+    ThreadPartitioning (const Iterator                          &begin,
+                        const typename identity<Iterator>::type &end,
+                        const unsigned int n_partitions = MultithreadInfo::n_threads());
+
+    /**
+     * Constructor. Use the given partitions. The partitions must be
+     * disjoint.
+     */
+    explicit
+    ThreadPartitioning (const std::vector<std::vector<Iterator> > &partitions);
+
+    /**
+     * Return the number of partitions.
+     */
+    unsigned int n_partitions () const;
+
+    /**
+     * Return the elements of the given partition.
+     */
+    const std::vector<Iterator> &
+    get_partition (const unsigned int partition) const;
+
+    /**
+     * Call the worker and copier functions on all elements of all
+     * partitions, as described in the documentation of this class. The
+     * requirements on the arguments are the same as for the other run()
+     * functions of this namespace. If the copier is an empty function, it is
+     * ignored.
+     */
+    template <typename Worker,
+              typename Copier,
+              typename ScratchData,
+              typename CopyData>
+    void
+    run (Worker              worker,
+         Copier              copier,
+         const ScratchData  &sample_scratch_data,
+         const CopyData     &sample_copy_data,
+         const unsigned int  chunk_size = 8);
+
+    /**
+     * Return the wall time in seconds spent on each partition during the
+     * last call to run().
+     */
+    const std::vector<double> &
+    get_partition_times () const;
+
+    /**
+     * Print the number of elements and the time spent on each partition in
+     * the last call to run(), as well as the ratio between the maximal and
+     * the average time over all partitions.
+     */
+    void print_statistics (std::ostream &out) const;
+
+  private:
+    /**
+     * Work on one partition. Called from the thread the partition is
+     * assigned to.
+     */
+    template <typename ScratchData,
+              typename CopyData>
+    void
+    run_on_partition (const unsigned int  partition,
+                      const std_cxx11::function<void (const Iterator &,
+                                                      ScratchData &,
+                                                      CopyData &)> &worker,
+                      const std_cxx11::function<void (const CopyData &)> &copier,
+                      const ScratchData  &sample_scratch_data,
+                      const CopyData     &sample_copy_data,
+                      const unsigned int  chunk_size);
+
+    /**
+     * Call run_on_partition() for all partitions in the given range.
+     */
+    template <typename ScratchData,
+              typename CopyData>
+    void
+    run_on_partition_range (const unsigned int  begin,
+                            const unsigned int  end,
+                            const std_cxx11::function<void (const Iterator &,
+                                                            ScratchData &,
+                                                            CopyData &)> &worker,
+                            const std_cxx11::function<void (const CopyData &)> &copier,
+                            const ScratchData  &sample_scratch_data,
+                            const CopyData     &sample_copy_data,
+                            const unsigned int  chunk_size);
+
+    /**
+     * The elements of each partition.
+     */
+    std::vector<std::vector<Iterator> > partitions;
+
+    /**
+     * The wall time spent on each partition in the last run.
+     */
+    std::vector<double> partition_times;
+
+    /**
+     * A mutex that serializes the calls to the copier.
+     */
+    Threads::Mutex copier_mutex;
+
+#ifdef DEAL_II_WITH_THREADS
+    /**
+     * The object that records which thread worked on which partition in the
+     * last run, such that the next run can use the same assignment.
+     */
+    tbb::affinity_partitioner affinity_partitioner;
+#endif
+  };
+
+
+
+  /**
+   * Call the worker and copier functions on all elements of the partitions
+   * stored in @p partitioning, such that each partition is processed by the
+   * same thread as in previous calls. This is equivalent to calling
+   * ThreadPartitioning::run(); see there for a discussion.
+   */
+  template <typename Worker,
+            typename Copier,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run (ThreadPartitioning<Iterator> &partitioning,
+       Worker                        worker,
+       Copier                        copier,
+       const ScratchData            &sample_scratch_data,
+       const CopyData               &sample_copy_data,
+       const unsigned int            chunk_size = 8)
+  {
+    partitioning.run (worker, copier, sample_scratch_data, sample_copy_data,
+                      chunk_size);
+  }
+
+
+
+  template <typename Iterator>
+  ThreadPartitioning<Iterator>::
+  ThreadPartitioning (const Iterator                          &begin,
+                      const typename identity<Iterator>::type &end,
+                      const unsigned int                       n_partitions)
+  {
+    Assert (n_partitions > 0,
+            ExcMessage ("The number of partitions must be at least one."));
+
+    std::vector<Iterator> all_iterators;
+    for (Iterator p=begin; p!=end; ++p)
+      all_iterators.push_back (p);
+
+    partitions.resize (n_partitions);
+    const std::size_t n_items = all_iterators.size();
+    for (unsigned int partition=0; partition<n_partitions; ++partition)
+      partitions[partition].assign
+      (all_iterators.begin() + n_items*partition/n_partitions,
+       all_iterators.begin() + n_items*(partition+1)/n_partitions);
+    partition_times.resize (n_partitions, 0.);
+  }
+
+
+
+  template <typename Iterator>
+  ThreadPartitioning<Iterator>::
+  ThreadPartitioning (const std::vector<std::vector<Iterator> > &partitions)
+    :
+    partitions (partitions),
+    partition_times (partitions.size(), 0.)
+  {}
+
+
+
+  template <typename Iterator>
+  inline
+  unsigned int
+  ThreadPartitioning<Iterator>::n_partitions () const
+  {
+    return partitions.size();
+  }
+
+
+
+  template <typename Iterator>
+  inline
+  const std::vector<Iterator> &
+  ThreadPartitioning<Iterator>::get_partition (const unsigned int partition) const
+  {
+    AssertIndexRange (partition, partitions.size());
+    return partitions[partition];
+  }
+
+
+
+  template <typename Iterator>
+  inline
+  const std::vector<double> &
+  ThreadPartitioning<Iterator>::get_partition_times () const
+  {
+    return partition_times;
+  }
+
+
+
+  template <typename Iterator>
+  void
+  ThreadPartitioning<Iterator>::print_statistics (std::ostream &out) const
+  {
+    double max_time = 0, sum_time = 0;
+    for (unsigned int partition=0; partition<partitions.size(); ++partition)
+      {
+        out << "Partition " << partition << ": "
+            << partitions[partition].size() << " items, "
+            << partition_times[partition] << " s" << std::endl;
+        max_time = std::max (max_time, partition_times[partition]);
+        sum_time += partition_times[partition];
+      }
+    if (sum_time > 0)
+      out << "Load imbalance (max/average time): "
+          << max_time * partitions.size() / sum_time << std::endl;
+  }
+
+
+
+  template <typename Iterator>
+  template <typename Worker,
+            typename Copier,
+            typename ScratchData,
+            typename CopyData>
+  void
+  ThreadPartitioning<Iterator>::run (Worker              worker,
+                                     Copier              copier,
+                                     const ScratchData  &sample_scratch_data,
+                                     const CopyData     &sample_copy_data,
+                                     const unsigned int  chunk_size)
+  {
+    Assert (chunk_size > 0,
+            ExcMessage ("The chunk_size must be at least one."));
+
+    const std_cxx11::function<void (const Iterator &, ScratchData &, CopyData &)>
+    worker_function = worker;
+    const std_cxx11::function<void (const CopyData &)> copier_function = copier;
+
+    partition_times.resize (partitions.size());
+    std::fill (partition_times.begin(), partition_times.end(), 0.);
+
+#ifdef DEAL_II_WITH_THREADS
+    if (MultithreadInfo::n_threads() > 1 && partitions.size() > 1)
+      tbb::parallel_for (tbb::blocked_range<unsigned int> (0, partitions.size(), 1),
+                         std_cxx11::bind (&ThreadPartitioning<Iterator>::template
+                                          run_on_partition_range<ScratchData,CopyData>,
+                                          this,
+                                          std_cxx11::bind (&tbb::blocked_range<unsigned int>::begin,
+                                                           std_cxx11::_1),
+                                          std_cxx11::bind (&tbb::blocked_range<unsigned int>::end,
+                                                           std_cxx11::_1),
+                                          std_cxx11::cref (worker_function),
+                                          std_cxx11::cref (copier_function),
+                                          std_cxx11::cref (sample_scratch_data),
+                                          std_cxx11::cref (sample_copy_data),
+                                          chunk_size),
+                         affinity_partitioner);
+    else
+#endif
+      run_on_partition_range (0, partitions.size(), worker_function,
+                              copier_function, sample_scratch_data,
+                              sample_copy_data, chunk_size);
+  }
+
+
+
+  template <typename Iterator>
+  template <typename ScratchData,
+            typename CopyData>
+  void
+  ThreadPartitioning<Iterator>::
+  run_on_partition_range (const unsigned int  begin,
+                          const unsigned int  end,
+                          const std_cxx11::function<void (const Iterator &,
+                                                          ScratchData &,
+                                                          CopyData &)> &worker,
+                          const std_cxx11::function<void (const CopyData &)> &copier,
+                          const ScratchData  &sample_scratch_data,
+                          const CopyData     &sample_copy_data,
+                          const unsigned int  chunk_size)
+  {
+    for (unsigned int partition=begin; partition<end; ++partition)
+      run_on_partition (partition, worker, copier, sample_scratch_data,
+                        sample_copy_data, chunk_size);
+  }
+
+
+
+  template <typename Iterator>
+  template <typename ScratchData,
+            typename CopyData>
+  void
+  ThreadPartitioning<Iterator>::
+  run_on_partition (const unsigned int  partition,
+                    const std_cxx11::function<void (const Iterator &,
+                                                    ScratchData &,
+                                                    CopyData &)> &worker,
+                    const std_cxx11::function<void (const CopyData &)> &copier,
+                    const ScratchData  &sample_scratch_data,
+                    const CopyData     &sample_copy_data,
+                    const unsigned int  chunk_size)
+  {
+    Timer timer;
+
+    // create the scratch and copy data on the thread that works on this
+    // partition, such that their memory is touched first by this thread
+    ScratchData scratch_data = sample_scratch_data;
+    std::vector<CopyData> copy_datas (chunk_size, sample_copy_data);
+
+    const std::vector<Iterator> &items = partitions[partition];
+    for (std::size_t chunk_begin=0; chunk_begin<items.size();
+         chunk_begin+=chunk_size)
+      {
+        const std::size_t chunk_end = std::min (items.size(),
+                                                chunk_begin+chunk_size);
+        try
+          {
+            if (worker)
+              for (std::size_t i=chunk_begin; i<chunk_end; ++i)
+                worker (items[i], scratch_data, copy_datas[i-chunk_begin]);
+
+            if (copier)
+              {
+                Threads::Mutex::ScopedLock lock (copier_mutex);
+                for (std::size_t i=chunk_begin; i<chunk_end; ++i)
+                  copier (copy_datas[i-chunk_begin]);
+              }
+          }
+        catch (const std::exception &exc)
+          {
+            Threads::internal::handle_std_exception (exc);
+          }
+        catch (...)
+          {
+            Threads::internal::handle_unknown_exception ();
+          }
+      }
+
+    partition_times[partition] = timer.wall_time();
+  }
+
 }
 
 
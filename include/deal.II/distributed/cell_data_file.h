@@ -0,0 +1,102 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__distributed_cell_data_file_h
+#define dealii__distributed_cell_data_file_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <vector>
+#include <string>
+
+DEAL_II_NAMESPACE_OPEN
+
+#ifdef DEAL_II_WITH_MPI
+
+namespace parallel
+{
+  namespace distributed
+  {
+    /**
+     * Functions reading and writing the file in which
+     * parallel::distributed::Triangulation::save() stores the data attached
+     * to the cells, and from which parallel::distributed::Triangulation::load()
+     * reads it back in.
+     *
+     * The data consists of records of fixed size, one for each cell, in the
+     * global order of the cells. Each processor holds a contiguous range of
+     * these records, and the ranges are ordered by processor number. The file
+     * starts with a header (format version, size of a record, total number
+     * of records, number of blocks, compression flag), followed by an index
+     * with the global number of the first record, the position in the file
+     * and the size in the file of each block, and then the blocks
+     * themselves. A block holds the records of a single processor, so the
+     * blocks written by one processor are contiguous in the file. All
+     * processors write and read their part at once with collective MPI-IO
+     * operations.
+     *
+     * Since the index tells where the records of each block are, the file can
+     * be read on a different number of processors than it was written on,
+     * and each processor only reads the blocks that overlap with its range of
+     * records.
+     *
+     * @ingroup grid
+     */
+    namespace CellDataFile
+    {
+      /**
+       * Collectively write the records in @p local_data, each of size
+       * @p record_size, into the file @p filename. The records of each
+       * processor follow the ones of the processors with lower numbers in
+       * @p mpi_communicator. The records are split into blocks of at most
+       * @p block_size bytes (but at least one record), which are compressed
+       * separately if @p compress is true and deal.II was configured with
+       * zlib.
+       */
+      void write (const std::string       &filename,
+                  const std::vector<char> &local_data,
+                  const std::size_t        record_size,
+                  const bool               compress,
+                  const MPI_Comm          &mpi_communicator,
+                  const std::size_t        block_size = 1<<20);
+
+      /**
+       * Collectively read the records with global numbers @p first_record to
+       * <tt>first_record+n_local_records</tt> from the file @p filename into
+       * @p local_data, which is resized accordingly. Only the blocks
+       * overlapping with this range are read. The ranges of the processors
+       * in @p mpi_communicator need not match the ones the file was written
+       * with. An exception is thrown if the file does not contain
+       * @p n_global_records records of size @p record_size.
+       */
+      void read (const std::string            &filename,
+                 const unsigned long long int  first_record,
+                 const unsigned long long int  n_local_records,
+                 const unsigned long long int  n_global_records,
+                 const std::size_t             record_size,
+                 std::vector<char>            &local_data,
+                 const MPI_Comm               &mpi_communicator);
+    }
+  }
+}
+
+#endif
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif //dealii__distributed_cell_data_file_h
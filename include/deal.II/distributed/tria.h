@@ -672,8 +672,19 @@ namespace parallel
        * computation on a shared network file system. See the SolutionTransfer
        * class on how to store solution vectors into this file. Additional
        * cell-based data can be saved using register_data_attach().
+       *
+       * The refinement information is written through p4est. The cell-based
+       * data is written into a separate file <tt>filename.data</tt> by all
+       * processors at once using collective MPI-IO operations. The data is
+       * stored in the global order of the cells, split into blocks that are
+       * listed in an index at the beginning of the file. This allows load()
+       * to read only the blocks overlapping with the cells a processor owns
+       * after loading, independently of the number of processors the data
+       * was saved with. If @p compress_data is true and deal.II was
+       * configured with zlib, each block is compressed separately.
        */
-      void save(const char *filename) const;
+      void save(const char *filename,
+                const bool  compress_data = true) const;
 
       /**
        * Load the refinement information saved with save() back in. The mesh
@@ -958,6 +969,22 @@ namespace parallel
        */
       void copy_local_forest_to_triangulation ();
 
+      /**
+       * Collectively write the data attached to the locally owned quadrants
+       * of the p4est forest into the file <tt>filename.data</tt>, in blocks
+       * that are optionally compressed. Called by save().
+       */
+      void write_attached_data (const std::string &filename,
+                                const bool         compress_data) const;
+
+      /**
+       * Read the blocks of the file <tt>filename.data</tt> that overlap
+       * with the locally owned quadrants of the p4est forest and attach the
+       * data of size @p data_size to the quadrants. Called by load().
+       */
+      void read_attached_data (const std::string  &filename,
+                               const unsigned int  data_size);
+
       /**
        * Internal function notifying all registered classes to attach their
        * data before repartitioning occurs. Called from
@@ -207,6 +207,23 @@ DEAL_II_NAMESPACE_OPEN
  * by the other cell.
  *
  *
+ * <h3>Space filling curve numbering</h3>
+ *
+ * The function space_filling_curve() sorts the cells along a Hilbert or
+ * Morton (z-order) curve through the bounding box of the mesh and then
+ * numbers the degrees of freedom in the order of the first cell they belong
+ * to, in the same way as cell_wise() does. Cells and degrees of freedom that
+ * are close to each other in space thus get similar indices, independent of
+ * how the mesh was refined. This improves the cache locality of matrix-vector
+ * products and of loops over cells that access vector entries, such as the
+ * ones in the MatrixFree framework, in particular on adaptively refined
+ * unstructured meshes where the default numbering produced by
+ * DoFHandler::distribute_dofs() jumps around a lot. The cell order used for
+ * the renumbering is available through
+ * compute_space_filling_curve_cell_order(), so that loops over cells can
+ * traverse the mesh in the same order.
+ *
+ *
  * <h3>Random renumbering</h3>
  *
  * The random() function renumbers degrees of freedom randomly. This function
@@ -560,6 +577,76 @@ namespace DoFRenumbering
                          const bool use_constraints    = false,
                          const std::vector<types::global_dof_index> &starting_indices   = std::vector<types::global_dof_index>());
 
+  /**
+   * Renumber the degrees of freedom of a DoFHandler on a parallel
+   * triangulation with a variant of the Cuthill-McKee method that also takes
+   * into account the couplings to degrees of freedom owned by other
+   * processors.
+   *
+   * Like Cuthill_McKee(), this function renumbers the locally owned degrees
+   * of freedom of each processor among themselves, based on the couplings
+   * between them, and neither communicates nor collects the connection graph
+   * on one processor. However, while Cuthill_McKee() only knows about the
+   * couplings between locally owned degrees of freedom and starts the
+   * numbering at an arbitrary point of the subdomain, this function also
+   * looks at the couplings to the ghost degrees of freedom in the
+   * @ref GlossLocallyRelevantDof "locally relevant set", both on the
+   * locally owned cells and on the ghost cells adjacent to them. (The latter
+   * are the only couplings to processors with higher numbers on a
+   * parallel::distributed::Triangulation, since degrees of freedom on the
+   * interface are owned by the processor with the lower number.) Since the
+   * locally owned ranges of the processors are sorted by processor number,
+   * it can tell for each of these couplings whether it goes to a processor
+   * with a lower or a higher number. The degrees of freedom coupling
+   * to processors with lower numbers are then used as the starting level of
+   * the Cuthill-McKee algorithm, so that they get the first indices of the
+   * locally owned range, and the ones coupling to processors with higher
+   * numbers end up at the end of the range. (With @p reversed_numbering, the
+   * algorithm is started from the degrees of freedom coupling to processors
+   * with higher numbers and the result is reversed, which leads to the same
+   * placement of the interfaces. The interface the algorithm is started from
+   * forms a contiguous block at its end of the range, whereas the other one
+   * is only placed towards the other end.)
+   *
+   * As a consequence, the couplings between the ranges of neighboring
+   * processors are located close to the diagonal of the global matrix, and
+   * the diagonal block of each processor has a small bandwidth, too. This is
+   * what block-Jacobi type preconditioners with ILU or SSOR on the diagonal
+   * blocks need, in the same way as the serial versions of these
+   * preconditioners benefit from the Cuthill-McKee ordering.
+   *
+   * The locally owned part of the mesh need not be connected, and each of
+   * its connected components is treated separately: On a component that
+   * only couples to processors with higher numbers (or only to processors
+   * with lower numbers), the algorithm is started from these interface
+   * degrees of freedom and the result reversed (or not reversed, if
+   * @p reversed_numbering is set), such that the interface again ends up at
+   * the correct end of the range. The components touching the interface the
+   * algorithm is started from are placed at that end of the locally owned
+   * range, those only touching the other interface at the other end, and
+   * components without couplings to other processors in between. If there are
+   * no couplings to other processors at all, in particular on a sequential
+   * triangulation, this function is equivalent to Cuthill_McKee().
+   */
+  template <class DH>
+  void
+  distributed_Cuthill_McKee (DH         &dof_handler,
+                             const bool  reversed_numbering = false,
+                             const bool  use_constraints    = false);
+
+  /**
+   * Compute the renumbering vector needed by the distributed_Cuthill_McKee()
+   * function. Does not perform the renumbering on the DoFHandler dofs but
+   * returns the renumbering vector, which needs to have as many elements as
+   * there are locally owned degrees of freedom.
+   */
+  template <class DH>
+  void
+  compute_distributed_Cuthill_McKee (std::vector<types::global_dof_index> &new_dof_indices,
+                                     const DH                             &dof_handler,
+                                     const bool                            reversed_numbering = false,
+                                     const bool                            use_constraints    = false);
+
   /**
    * Renumber the degrees of freedom according to the Cuthill-McKee method,
    * eventually using the reverse numbering scheme, in this case for a
@@ -1076,6 +1163,75 @@ namespace DoFRenumbering
   compute_subdomain_wise (std::vector<types::global_dof_index> &new_dof_indices,
                           const DH                  &dof_handler);
 
+  /**
+   * The space filling curves that can be used by space_filling_curve().
+   */
+  enum SpaceFillingCurve
+  {
+    /**
+     * The Hilbert curve. Cells that are consecutive in this order are always
+     * neighbors in space (up to the resolution of the curve), which gives the
+     * best locality.
+     */
+    hilbert_curve,
+    /**
+     * The Morton curve, also known as z-order or Lebesgue curve. Its index is
+     * cheaper to compute than the one of the Hilbert curve, but it makes
+     * jumps across the domain at the boundaries of the quadrants.
+     */
+    morton_curve
+  };
+
+  /**
+   * Renumber the degrees of freedom along a space filling curve. The locally
+   * owned active cells are sorted by the position of their centers along the
+   * given curve through the bounding box of the triangulation, see
+   * compute_space_filling_curve_cell_order(), and the degrees of freedom are
+   * then numbered in the order of the first cell they belong to, as in
+   * cell_wise(). See the general documentation of this namespace for the
+   * purpose of this numbering.
+   *
+   * If the DoFHandler is built on a parallel triangulation, each processor
+   * renumbers its locally owned degrees of freedom among themselves, i.e.
+   * the index set of locally owned degrees of freedom of each processor does
+   * not change and no communication is necessary.
+   */
+  template <class DH>
+  void
+  space_filling_curve (DH                      &dof_handler,
+                       const SpaceFillingCurve  curve = hilbert_curve);
+
+  /**
+   * Compute the renumbering vector needed by the space_filling_curve()
+   * function. Does not perform the renumbering on the DoFHandler dofs but
+   * returns the renumbering vector. The vector must have as many elements as
+   * there are locally owned degrees of freedom.
+   */
+  template <class DH>
+  void
+  compute_space_filling_curve (std::vector<types::global_dof_index> &new_dof_indices,
+                               const DH                             &dof_handler,
+                               const SpaceFillingCurve               curve = hilbert_curve);
+
+  /**
+   * Return the locally owned active cells of the given DoFHandler sorted by
+   * the position of their centers along the given space filling curve. The
+   * curve runs through the bounding box of all vertices of the triangulation
+   * with a resolution of $2^{21}$ points per coordinate direction in 3d, and
+   * $2^{31}$ in 2d; cells whose centers fall onto the same point keep their
+   * relative order from the triangulation.
+   *
+   * This is the cell order used by space_filling_curve(). Loops over cells
+   * that access the degrees of freedom renumbered by that function (for
+   * example via WorkStream or when setting up a MatrixFree object) can use
+   * this order to traverse the cells in the same order as the degrees of
+   * freedom.
+   */
+  template <class DH>
+  std::vector<typename DH::active_cell_iterator>
+  compute_space_filling_curve_cell_order (const DH                &dof_handler,
+                                          const SpaceFillingCurve  curve = hilbert_curve);
+
   /**
    * @}
    */
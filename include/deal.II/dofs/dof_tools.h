@@ -38,6 +38,7 @@ DEAL_II_NAMESPACE_OPEN
 
 template<int dim, class T> class Table;
 class SparsityPattern;
+class SparsityPatternBuilder;
 template <typename number> class Vector;
 template <int dim, typename Number> class Function;
 template <int dim, int spacedim> class FiniteElement;
@@ -403,6 +404,34 @@ namespace DoFTools
                          const bool              keep_constrained_dofs = true,
                          const types::subdomain_id subdomain_id = numbers::invalid_subdomain_id);
 
+  /**
+   * Locate non-zero entries of the system matrix. This function does the
+   * same as the previous one, but for the SparsityPatternBuilder class into
+   * which several threads can insert entries at the same time. Consequently,
+   * the loop over all cells is run in parallel. Afterwards, the entries can
+   * be written into a SparsityPattern by SparsityPattern::copy_from(), which
+   * is also done in parallel:
+   * @code
+   *   SparsityPatternBuilder builder (dof_handler.n_dofs(),
+   *                                   dof_handler.n_dofs());
+   *   DoFTools::make_sparsity_pattern (dof_handler, builder, constraints,
+   *                                    false);
+   *   sparsity_pattern.copy_from (builder);
+   * @endcode
+   * The resulting sparsity pattern is the same as when using a
+   * DynamicSparsityPattern as intermediate object, but none of the steps
+   * involved is serial.
+   *
+   * @ingroup constraints
+   */
+  template <class DH>
+  void
+  make_sparsity_pattern (const DH               &dof,
+                         SparsityPatternBuilder &sparsity_pattern,
+                         const ConstraintMatrix &constraints = ConstraintMatrix(),
+                         const bool              keep_constrained_dofs = true,
+                         const types::subdomain_id subdomain_id = numbers::invalid_subdomain_id);
+
   /**
    * Locate non-zero entries for vector valued finite elements.  This function
    * does mostly the same as the previous make_sparsity_pattern(), but it is
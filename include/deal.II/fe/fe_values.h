@@ -2855,12 +2855,99 @@ public:
    */
   const FEValues<dim,spacedim> &get_present_fe_values () const;
 
+  /**
+   * Enable a cache that keeps the transformed derivatives of the shape
+   * functions for up to @p max_n_geometries different cell geometries, for
+   * example of the few different cell shapes in a mesh of mostly uniform
+   * bricks. This generalizes the reuse of data for cells that are a
+   * translation of the previous cell (see CellSimilarity) to cells that
+   * have the same geometry as any cell visited before.
+   *
+   * The geometry of a cell is identified by the Jacobians of the mapping in
+   * the quadrature points, complemented by the gradients and second
+   * derivatives of the Jacobians if hessians or third derivatives of the
+   * shape functions are requested. To this end, this function adds
+   * update_jacobians to the update flags of this object. The mapping is
+   * still evaluated on each cell, so the Jacobians, JxW values, and
+   * quadrature points are always those of the present cell. If the
+   * Jacobians match those of a cell in the cache up to a relative tolerance
+   * of 1e-12, the gradients, hessians, and third derivatives of the shape
+   * functions are copied from the cache instead of being transformed from
+   * the unit cell. Otherwise, they are computed and stored in the cache,
+   * replacing the oldest entry when the cache is full.
+   *
+   * Since the transformation of the derivatives is the most expensive part
+   * of reinit() for elements of higher degree, this can save most of the
+   * cost of reinit() in assembly loops. As with the translation detected
+   * from the previous cell, the values obtained on a cell may differ by
+   * roundoff from the values computed on that cell without the cache,
+   * depending on the order in which cells are visited.
+   *
+   * The cache is only used for elements whose shape functions are all
+   * primitive. The shape functions of elements like FE_RaviartThomas or
+   * FE_Nedelec also depend on the orientation of the faces of the cell and
+   * are always computed. The cache is also not used if <tt>dim &lt;
+   * spacedim</tt>.
+   *
+   * Calling this function with @p max_n_geometries equal to zero disables
+   * the cache.
+   */
+  void enable_cell_similarity_cache (const unsigned int max_n_geometries = 8);
+
+  /**
+   * Return how many times the data of a cell have been taken from the cache
+   * enabled by enable_cell_similarity_cache() since the cache has been
+   * enabled.
+   */
+  unsigned int n_cell_similarity_cache_hits () const;
+
 private:
   /**
    * Store a copy of the quadrature formula here.
    */
   const Quadrature<dim> quadrature;
 
+  /**
+   * The data of one cell geometry in the cache enabled by
+   * enable_cell_similarity_cache(): the mapping data that identify the
+   * geometry and the shape function derivatives computed for it.
+   */
+  struct CachedGeometry
+  {
+    std::vector<DerivativeForm<1,dim,spacedim> > jacobians;
+    std::vector<Tensor<3,spacedim> >             jacobian_pushed_forward_grads;
+    std::vector<Tensor<4,spacedim> >             jacobian_pushed_forward_2nd_derivatives;
+
+    typename dealii::internal::FEValues::FiniteElementRelatedData<dim,spacedim>::GradientVector
+    shape_gradients;
+    typename dealii::internal::FEValues::FiniteElementRelatedData<dim,spacedim>::HessianVector
+    shape_hessians;
+    typename dealii::internal::FEValues::FiniteElementRelatedData<dim,spacedim>::ThirdDerivativeVector
+    shape_3rd_derivatives;
+  };
+
+  /**
+   * The cached geometries, the maximal number of them, the index of the
+   * entry to be replaced next, and the number of cells whose data have been
+   * taken from the cache.
+   */
+  std::vector<CachedGeometry> cached_geometries;
+  unsigned int                max_n_cached_geometries;
+  unsigned int                next_cached_geometry;
+  unsigned int                n_cache_hits;
+
+  /**
+   * Return the index of the cached geometry that matches the mapping data
+   * of the present cell, or numbers::invalid_unsigned_int if there is none.
+   */
+  unsigned int find_cached_geometry () const;
+
+  /**
+   * Store the mapping data and the shape function derivatives of the
+   * present cell in the cache.
+   */
+  void store_cached_geometry ();
+
   /**
    * Do work common to the two constructors.
    */
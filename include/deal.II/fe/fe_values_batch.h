@@ -0,0 +1,785 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__fe_values_batch_h
+#define dealii__fe_values_batch_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/symmetric_tensor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <int dim, int spacedim> class FEValuesBatch;
+
+
+/**
+ * A namespace for views into an FEValuesBatch object that represent a scalar
+ * or a vector-valued part of a finite element. They play the same role for
+ * FEValuesBatch as the classes in namespace FEValuesViews do for FEValues,
+ * except that all values returned are of type VectorizedArray, with one
+ * entry per cell of the batch.
+ *
+ * These objects are cheap to create and are returned by value from
+ * FEValuesBatch::operator[]. They hold a reference to the FEValuesBatch
+ * object and must therefore not outlive it.
+ */
+namespace FEValuesBatchViews
+{
+  /**
+   * A view into a single scalar component of a finite element evaluated on
+   * a batch of cells.
+   */
+  template <int dim, int spacedim=dim>
+  class Scalar
+  {
+  public:
+    /**
+     * Type of values of the shape functions, one per cell of the batch.
+     */
+    typedef VectorizedArray<double> value_type;
+
+    /**
+     * Type of gradients of the shape functions, one per cell of the batch.
+     */
+    typedef dealii::Tensor<1,spacedim,VectorizedArray<double> > gradient_type;
+
+    /**
+     * Constructor for an object that represents a single scalar component
+     * of the finite element used by @p fe_values_batch.
+     */
+    Scalar (const FEValuesBatch<dim,spacedim> &fe_values_batch,
+            const unsigned int                 component);
+
+    /**
+     * Return the value of the selected component of shape function @p
+     * shape_function at quadrature point @p q_point on all cells of the
+     * batch.
+     */
+    value_type
+    value (const unsigned int shape_function,
+           const unsigned int q_point) const;
+
+    /**
+     * Return the gradient of the selected component of shape function @p
+     * shape_function at quadrature point @p q_point on all cells of the
+     * batch.
+     */
+    gradient_type
+    gradient (const unsigned int shape_function,
+              const unsigned int q_point) const;
+
+  private:
+    /**
+     * The object we are a view into.
+     */
+    const FEValuesBatch<dim,spacedim> &fe_values_batch;
+
+    /**
+     * The component this view represents.
+     */
+    const unsigned int component;
+  };
+
+
+
+  /**
+   * A view into a set of <code>spacedim</code> consecutive components of a
+   * finite element evaluated on a batch of cells, interpreted as a vector
+   * field.
+   */
+  template <int dim, int spacedim=dim>
+  class Vector
+  {
+  public:
+    /**
+     * Type of values of the shape functions, one per cell of the batch.
+     */
+    typedef dealii::Tensor<1,spacedim,VectorizedArray<double> > value_type;
+
+    /**
+     * Type of gradients of the shape functions, one per cell of the batch.
+     */
+    typedef dealii::Tensor<2,spacedim,VectorizedArray<double> > gradient_type;
+
+    /**
+     * Type of symmetrized gradients of the shape functions.
+     */
+    typedef dealii::SymmetricTensor<2,spacedim,VectorizedArray<double> > symmetric_gradient_type;
+
+    /**
+     * Type of divergences of the shape functions.
+     */
+    typedef VectorizedArray<double> divergence_type;
+
+    /**
+     * Constructor for an object that represents the <code>spacedim</code>
+     * components of the finite element used by @p fe_values_batch starting
+     * at @p first_vector_component.
+     */
+    Vector (const FEValuesBatch<dim,spacedim> &fe_values_batch,
+            const unsigned int                 first_vector_component);
+
+    /**
+     * Return the value of the vector components of shape function @p
+     * shape_function at quadrature point @p q_point.
+     */
+    value_type
+    value (const unsigned int shape_function,
+           const unsigned int q_point) const;
+
+    /**
+     * Return the gradient of the vector components of shape function @p
+     * shape_function at quadrature point @p q_point. The entry
+     * <code>[i][j]</code> of the result is the derivative of component
+     * <code>i</code> in direction <code>j</code>.
+     */
+    gradient_type
+    gradient (const unsigned int shape_function,
+              const unsigned int q_point) const;
+
+    /**
+     * Return the symmetric part of the gradient of the vector components of
+     * shape function @p shape_function at quadrature point @p q_point.
+     */
+    symmetric_gradient_type
+    symmetric_gradient (const unsigned int shape_function,
+                        const unsigned int q_point) const;
+
+    /**
+     * Return the divergence of the vector components of shape function @p
+     * shape_function at quadrature point @p q_point.
+     */
+    divergence_type
+    divergence (const unsigned int shape_function,
+                const unsigned int q_point) const;
+
+  private:
+    /**
+     * The object we are a view into.
+     */
+    const FEValuesBatch<dim,spacedim> &fe_values_batch;
+
+    /**
+     * The first component this view represents.
+     */
+    const unsigned int first_vector_component;
+  };
+}
+
+
+
+/**
+ * A version of FEValues that evaluates shape functions, their gradients,
+ * the Jacobian determinants times quadrature weights and the quadrature
+ * points on a batch of cells at once, and stores them in a layout where the
+ * data of the different cells sits in the lanes of a VectorizedArray.
+ *
+ * The usual cell-wise assembly loop performs the same sequence of
+ * operations on every cell, but each of these operations acts on scalar
+ * <code>double</code> values. With this class, one instead groups up to
+ * <code>VectorizedArray<double>::n_array_elements</code> cells into a batch
+ * and writes the assembly loop for all of them at once: each arithmetic
+ * operation on the quantities returned by this class then processes all
+ * cells of the batch in a single SIMD instruction. This is the same
+ * strategy that the MatrixFree framework uses for matrix-free operator
+ * evaluation, applied to conventional matrix-based assembly.
+ *
+ * The interface mirrors that of FEValues: one calls reinit() with a vector
+ * of cell iterators instead of a single one, queries shape values,
+ * gradients and JxW values through functions of the same name, and uses
+ * FEValuesExtractors::Scalar and FEValuesExtractors::Vector to obtain views
+ * into parts of a vector-valued element. The only difference is that all
+ * returned quantities are VectorizedArray objects, or tensors thereof.
+ *
+ * A typical loop to assemble the Laplace matrix then looks as follows:
+ * @code
+ *   const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+ *   FEValuesBatch<dim> fe_values (fe, quadrature,
+ *                                 update_gradients | update_JxW_values);
+ *   FullMatrix<double> cell_matrix (dofs_per_cell, dofs_per_cell);
+ *   Table<2,VectorizedArray<double> > batch_matrix (dofs_per_cell, dofs_per_cell);
+ *
+ *   std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+ *   for (cell = dof_handler.begin_active(); cell != endc; )
+ *     {
+ *       cells.clear ();
+ *       for (; cell != endc && cells.size() < n_lanes; ++cell)
+ *         cells.push_back (cell);
+ *       fe_values.reinit (cells);
+ *
+ *       for (unsigned int i=0; i<dofs_per_cell; ++i)
+ *         for (unsigned int j=0; j<dofs_per_cell; ++j)
+ *           {
+ *             VectorizedArray<double> sum = VectorizedArray<double>();
+ *             for (unsigned int q=0; q<n_q_points; ++q)
+ *               sum += (fe_values.shape_grad(i,q) *
+ *                       fe_values.shape_grad(j,q) *
+ *                       fe_values.JxW(q));
+ *             batch_matrix(i,j) = sum;
+ *           }
+ *
+ *       for (unsigned int lane=0; lane<fe_values.n_active_lanes(); ++lane)
+ *         {
+ *           for (unsigned int i=0; i<dofs_per_cell; ++i)
+ *             for (unsigned int j=0; j<dofs_per_cell; ++j)
+ *               cell_matrix(i,j) = batch_matrix(i,j)[lane];
+ *           cells[lane]->get_dof_indices (local_dof_indices);
+ *           constraints.distribute_local_to_global (cell_matrix,
+ *                                                   local_dof_indices,
+ *                                                   system_matrix);
+ *         }
+ *     }
+ * @endcode
+ *
+ * If the last batch contains fewer cells than there are lanes, the unused
+ * lanes are filled with copies of the data of the first cell, so that
+ * arithmetic operations on them remain well-defined. Their results must
+ * simply be ignored, as done above by looping only up to n_active_lanes().
+ *
+ * <h3>Implementation</h3>
+ *
+ * Internally, reinit() evaluates a regular FEValues object on each cell of
+ * the batch in turn and transposes the result into the lane-wise layout.
+ * Consequently, the cost of reinit() is the same as for the scalar class
+ * (plus a copy), and all of the benefit comes from the vectorized
+ * arithmetic in the user's assembly loop, which is usually the dominant
+ * cost for higher order elements. Since the scalar FEValues object is
+ * reused, the usual optimizations for translated cells apply as well.
+ *
+ * Only the quantities listed above are stored in vectorized form. The
+ * update flags update_values, update_gradients, update_JxW_values and
+ * update_quadrature_points are respected; other flags are passed on to the
+ * underlying FEValues object, but the corresponding data is not available
+ * through this class.
+ *
+ * @ingroup feaccess
+ */
+template <int dim, int spacedim=dim>
+class FEValuesBatch : public Subscriptor
+{
+public:
+  /**
+   * The number of cells that are processed at once, i.e., the number of
+   * lanes of a VectorizedArray<double>.
+   */
+  static const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+
+  /**
+   * Number of quadrature points per cell.
+   */
+  const unsigned int n_quadrature_points;
+
+  /**
+   * Number of shape functions per cell.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * Constructor. Initialize the underlying FEValues object with the given
+   * mapping, finite element, quadrature formula and update flags.
+   */
+  FEValuesBatch (const Mapping<dim,spacedim>       &mapping,
+                 const FiniteElement<dim,spacedim> &fe,
+                 const Quadrature<dim>             &quadrature,
+                 const UpdateFlags                  update_flags);
+
+  /**
+   * Constructor. Use a default linear mapping.
+   */
+  FEValuesBatch (const FiniteElement<dim,spacedim> &fe,
+                 const Quadrature<dim>             &quadrature,
+                 const UpdateFlags                  update_flags);
+
+  /**
+   * Evaluate the finite element on the given cells, which will be assigned
+   * to the lanes of the vectorized data in the order given. The number of
+   * cells must be at least one and at most n_lanes. @p CellIterator can be
+   * any iterator type that FEValues::reinit() accepts.
+   */
+  template <typename CellIterator>
+  void reinit (const std::vector<CellIterator> &cells);
+
+  /**
+   * Return the number of cells that were passed to the last call of
+   * reinit(). Lanes beyond this number contain copies of the data of the
+   * first cell.
+   */
+  unsigned int n_active_lanes () const;
+
+  /**
+   * Value of shape function @p i at quadrature point @p q on all cells of
+   * the batch. As for FEValuesBase::shape_value(), the element must be
+   * primitive.
+   */
+  VectorizedArray<double>
+  shape_value (const unsigned int i,
+               const unsigned int q) const;
+
+  /**
+   * Value of the given vector component of shape function @p i at
+   * quadrature point @p q on all cells of the batch.
+   */
+  VectorizedArray<double>
+  shape_value_component (const unsigned int i,
+                         const unsigned int q,
+                         const unsigned int component) const;
+
+  /**
+   * Gradient of shape function @p i at quadrature point @p q on all cells
+   * of the batch. As for FEValuesBase::shape_grad(), the element must be
+   * primitive.
+   */
+  Tensor<1,spacedim,VectorizedArray<double> >
+  shape_grad (const unsigned int i,
+              const unsigned int q) const;
+
+  /**
+   * Gradient of the given vector component of shape function @p i at
+   * quadrature point @p q on all cells of the batch.
+   */
+  Tensor<1,spacedim,VectorizedArray<double> >
+  shape_grad_component (const unsigned int i,
+                        const unsigned int q,
+                        const unsigned int component) const;
+
+  /**
+   * Mapped quadrature weight at quadrature point @p q on all cells of the
+   * batch.
+   */
+  VectorizedArray<double>
+  JxW (const unsigned int q) const;
+
+  /**
+   * Location of quadrature point @p q in real space on all cells of the
+   * batch.
+   */
+  const Point<spacedim,VectorizedArray<double> > &
+  quadrature_point (const unsigned int q) const;
+
+  /**
+   * Create a view of the scalar component selected by @p scalar.
+   */
+  FEValuesBatchViews::Scalar<dim,spacedim>
+  operator[] (const FEValuesExtractors::Scalar &scalar) const;
+
+  /**
+   * Create a view of the vector-valued part selected by @p vector.
+   */
+  FEValuesBatchViews::Vector<dim,spacedim>
+  operator[] (const FEValuesExtractors::Vector &vector) const;
+
+  /**
+   * Return a reference to the finite element in use.
+   */
+  const FiniteElement<dim,spacedim> &get_fe () const;
+
+  /**
+   * Return the update flags of the underlying FEValues object.
+   */
+  UpdateFlags get_update_flags () const;
+
+  /**
+   * Return an estimate of the memory consumption of this object, in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Set up the fields of this class once the underlying FEValues object
+   * is initialized.
+   */
+  void initialize ();
+
+  /**
+   * Copy the data of the underlying FEValues object, which has just been
+   * reinitialized on a cell, into lane @p lane of the vectorized fields.
+   */
+  void copy_lane (const unsigned int lane);
+
+  /**
+   * Fill the lanes after the last active one with the data of lane zero.
+   */
+  void fill_unused_lanes ();
+
+  /**
+   * The FEValues object used to evaluate the data on each cell.
+   */
+  FEValues<dim,spacedim> fe_values;
+
+  /**
+   * For each pair of shape function and vector component, the row in
+   * shape_values and shape_gradients holding the corresponding data, or
+   * numbers::invalid_unsigned_int if the component of this shape function
+   * is zero. The layout matches the one used internally by FEValues.
+   */
+  std::vector<unsigned int> shape_function_to_row_table;
+
+  /**
+   * Values of the nonzero components of the shape functions, indexed by
+   * row and quadrature point.
+   */
+  Table<2,VectorizedArray<double> > shape_values;
+
+  /**
+   * Gradients of the nonzero components of the shape functions, indexed by
+   * row and quadrature point.
+   */
+  Table<2,Tensor<1,spacedim,VectorizedArray<double> > > shape_gradients;
+
+  /**
+   * Mapped quadrature weights.
+   */
+  AlignedVector<VectorizedArray<double> > JxW_values;
+
+  /**
+   * Quadrature points in real space.
+   */
+  AlignedVector<Point<spacedim,VectorizedArray<double> > > quadrature_points;
+
+  /**
+   * Number of cells given to the last call of reinit().
+   */
+  unsigned int n_filled_lanes;
+
+  /**
+   * The update flags of the underlying FEValues object.
+   */
+  const UpdateFlags update_flags;
+};
+
+
+#ifndef DOXYGEN
+
+
+/*------------------------ Inline functions: FEValuesBatch ------------------*/
+
+template <int dim, int spacedim>
+template <typename CellIterator>
+void
+FEValuesBatch<dim,spacedim>::reinit (const std::vector<CellIterator> &cells)
+{
+  Assert (cells.size() > 0 && cells.size() <= n_lanes,
+          ExcIndexRange (cells.size(), 1, n_lanes+1));
+
+  for (unsigned int lane=0; lane<cells.size(); ++lane)
+    {
+      fe_values.reinit (cells[lane]);
+      copy_lane (lane);
+    }
+  n_filled_lanes = cells.size();
+  fill_unused_lanes ();
+}
+
+
+
+template <int dim, int spacedim>
+inline
+unsigned int
+FEValuesBatch<dim,spacedim>::n_active_lanes () const
+{
+  return n_filled_lanes;
+}
+
+
+
+template <int dim, int spacedim>
+inline
+VectorizedArray<double>
+FEValuesBatch<dim,spacedim>::shape_value (const unsigned int i,
+                                          const unsigned int q) const
+{
+  typedef FEValuesBase<dim,spacedim> FVB;
+  Assert (i < dofs_per_cell, ExcIndexRange (i, 0, dofs_per_cell));
+  Assert (update_flags & update_values,
+          typename FVB::ExcAccessToUninitializedField("update_values"));
+  Assert (get_fe().is_primitive (i),
+          typename FVB::ExcShapeFunctionNotPrimitive(i));
+
+  const unsigned int n_components = get_fe().n_components();
+  return shape_values(shape_function_to_row_table[i * n_components +
+                                                  get_fe().system_to_component_index(i).first],
+                      q);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+VectorizedArray<double>
+FEValuesBatch<dim,spacedim>::shape_value_component (const unsigned int i,
+                                                    const unsigned int q,
+                                                    const unsigned int component) const
+{
+  typedef FEValuesBase<dim,spacedim> FVB;
+  Assert (i < dofs_per_cell, ExcIndexRange (i, 0, dofs_per_cell));
+  Assert (update_flags & update_values,
+          typename FVB::ExcAccessToUninitializedField("update_values"));
+  Assert (component < get_fe().n_components(),
+          ExcIndexRange(component, 0, get_fe().n_components()));
+
+  const unsigned int row
+    = shape_function_to_row_table[i * get_fe().n_components() + component];
+  if (row == numbers::invalid_unsigned_int)
+    return VectorizedArray<double>();
+  else
+    return shape_values(row, q);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+Tensor<1,spacedim,VectorizedArray<double> >
+FEValuesBatch<dim,spacedim>::shape_grad (const unsigned int i,
+                                         const unsigned int q) const
+{
+  typedef FEValuesBase<dim,spacedim> FVB;
+  Assert (i < dofs_per_cell, ExcIndexRange (i, 0, dofs_per_cell));
+  Assert (update_flags & update_gradients,
+          typename FVB::ExcAccessToUninitializedField("update_gradients"));
+  Assert (get_fe().is_primitive (i),
+          typename FVB::ExcShapeFunctionNotPrimitive(i));
+
+  const unsigned int n_components = get_fe().n_components();
+  return shape_gradients(shape_function_to_row_table[i * n_components +
+                                                     get_fe().system_to_component_index(i).first],
+                         q);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+Tensor<1,spacedim,VectorizedArray<double> >
+FEValuesBatch<dim,spacedim>::shape_grad_component (const unsigned int i,
+                                                   const unsigned int q,
+                                                   const unsigned int component) const
+{
+  typedef FEValuesBase<dim,spacedim> FVB;
+  Assert (i < dofs_per_cell, ExcIndexRange (i, 0, dofs_per_cell));
+  Assert (update_flags & update_gradients,
+          typename FVB::ExcAccessToUninitializedField("update_gradients"));
+  Assert (component < get_fe().n_components(),
+          ExcIndexRange(component, 0, get_fe().n_components()));
+
+  const unsigned int row
+    = shape_function_to_row_table[i * get_fe().n_components() + component];
+  if (row == numbers::invalid_unsigned_int)
+    return Tensor<1,spacedim,VectorizedArray<double> >();
+  else
+    return shape_gradients(row, q);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+VectorizedArray<double>
+FEValuesBatch<dim,spacedim>::JxW (const unsigned int q) const
+{
+  typedef FEValuesBase<dim,spacedim> FVB;
+  Assert (update_flags & update_JxW_values,
+          typename FVB::ExcAccessToUninitializedField("update_JxW_values"));
+  AssertIndexRange (q, JxW_values.size());
+  return JxW_values[q];
+}
+
+
+
+template <int dim, int spacedim>
+inline
+const Point<spacedim,VectorizedArray<double> > &
+FEValuesBatch<dim,spacedim>::quadrature_point (const unsigned int q) const
+{
+  typedef FEValuesBase<dim,spacedim> FVB;
+  Assert (update_flags & update_quadrature_points,
+          typename FVB::ExcAccessToUninitializedField("update_quadrature_points"));
+  AssertIndexRange (q, quadrature_points.size());
+  return quadrature_points[q];
+}
+
+
+
+template <int dim, int spacedim>
+inline
+FEValuesBatchViews::Scalar<dim,spacedim>
+FEValuesBatch<dim,spacedim>::operator[] (const FEValuesExtractors::Scalar &scalar) const
+{
+  return FEValuesBatchViews::Scalar<dim,spacedim> (*this, scalar.component);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+FEValuesBatchViews::Vector<dim,spacedim>
+FEValuesBatch<dim,spacedim>::operator[] (const FEValuesExtractors::Vector &vector) const
+{
+  return FEValuesBatchViews::Vector<dim,spacedim> (*this, vector.first_vector_component);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+const FiniteElement<dim,spacedim> &
+FEValuesBatch<dim,spacedim>::get_fe () const
+{
+  return fe_values.get_fe();
+}
+
+
+
+template <int dim, int spacedim>
+inline
+UpdateFlags
+FEValuesBatch<dim,spacedim>::get_update_flags () const
+{
+  return update_flags;
+}
+
+
+
+/*------------------------ Inline functions: FEValuesBatchViews -------------*/
+
+namespace FEValuesBatchViews
+{
+  template <int dim, int spacedim>
+  inline
+  Scalar<dim,spacedim>::Scalar (const FEValuesBatch<dim,spacedim> &fe_values_batch,
+                                const unsigned int                 component)
+    :
+    fe_values_batch (fe_values_batch),
+    component (component)
+  {
+    Assert (component < fe_values_batch.get_fe().n_components(),
+            ExcIndexRange(component, 0, fe_values_batch.get_fe().n_components()));
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  typename Scalar<dim,spacedim>::value_type
+  Scalar<dim,spacedim>::value (const unsigned int shape_function,
+                               const unsigned int q_point) const
+  {
+    return fe_values_batch.shape_value_component (shape_function, q_point,
+                                                  component);
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  typename Scalar<dim,spacedim>::gradient_type
+  Scalar<dim,spacedim>::gradient (const unsigned int shape_function,
+                                  const unsigned int q_point) const
+  {
+    return fe_values_batch.shape_grad_component (shape_function, q_point,
+                                                 component);
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  Vector<dim,spacedim>::Vector (const FEValuesBatch<dim,spacedim> &fe_values_batch,
+                                const unsigned int                 first_vector_component)
+    :
+    fe_values_batch (fe_values_batch),
+    first_vector_component (first_vector_component)
+  {
+    Assert (first_vector_component+spacedim-1 < fe_values_batch.get_fe().n_components(),
+            ExcIndexRange(first_vector_component+spacedim-1, 0,
+                          fe_values_batch.get_fe().n_components()));
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  typename Vector<dim,spacedim>::value_type
+  Vector<dim,spacedim>::value (const unsigned int shape_function,
+                               const unsigned int q_point) const
+  {
+    value_type return_value;
+    for (unsigned int d=0; d<spacedim; ++d)
+      return_value[d]
+        = fe_values_batch.shape_value_component (shape_function, q_point,
+                                                 first_vector_component+d);
+    return return_value;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  typename Vector<dim,spacedim>::gradient_type
+  Vector<dim,spacedim>::gradient (const unsigned int shape_function,
+                                  const unsigned int q_point) const
+  {
+    gradient_type return_value;
+    for (unsigned int d=0; d<spacedim; ++d)
+      return_value[d]
+        = fe_values_batch.shape_grad_component (shape_function, q_point,
+                                                first_vector_component+d);
+    return return_value;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  typename Vector<dim,spacedim>::symmetric_gradient_type
+  Vector<dim,spacedim>::symmetric_gradient (const unsigned int shape_function,
+                                            const unsigned int q_point) const
+  {
+    return symmetrize (gradient (shape_function, q_point));
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  typename Vector<dim,spacedim>::divergence_type
+  Vector<dim,spacedim>::divergence (const unsigned int shape_function,
+                                    const unsigned int q_point) const
+  {
+    divergence_type return_value = divergence_type();
+    for (unsigned int d=0; d<spacedim; ++d)
+      return_value
+      += fe_values_batch.shape_grad_component (shape_function, q_point,
+                                               first_vector_component+d)[d];
+    return return_value;
+  }
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -366,6 +366,52 @@ public:
      */
     std::vector<Tensor<4,dim> > shape_fourth_derivatives;
 
+    /**
+     * Whether the quadrature formula on the cell is the tensor product of a
+     * one-dimensional formula. In that case, the quadrature points and the
+     * Jacobians are computed by sum factorization from the one-dimensional
+     * shape functions below, which costs $\mathcal O(p^{\text{dim}+1})$
+     * operations per cell instead of the $\mathcal O(p^{2\,\text{dim}})$
+     * operations of the product with the full arrays @p shape_values and
+     * @p shape_derivatives.
+     *
+     * Computed once.
+     */
+    bool tensor_product_quadrature;
+
+    /**
+     * Values of the one-dimensional mapping shape functions in the points
+     * of the one-dimensional quadrature formula, with the shape functions
+     * running slowest. Only used if @p tensor_product_quadrature is set.
+     *
+     * Computed once.
+     */
+    std::vector<double> shape_values_1d;
+
+    /**
+     * Derivatives of the one-dimensional mapping shape functions in the
+     * points of the one-dimensional quadrature formula, stored in the same
+     * format as @p shape_values_1d.
+     *
+     * Computed once.
+     */
+    std::vector<double> shape_gradients_1d;
+
+    /**
+     * For each mapping support point in lexicographic order, the position
+     * within @p mapping_support_points. Only used if @p
+     * tensor_product_quadrature is set.
+     *
+     * Computed once.
+     */
+    std::vector<unsigned int> lexicographic_to_support_point;
+
+    /**
+     * Temporary arrays for the sum factorization, holding one component of
+     * the support points in lexicographic order and intermediate results.
+     */
+    mutable std::vector<double> tensor_product_scratch;
+
     /**
      * Unit tangential vectors. Used for the computation of boundary forms and
      * normal vectors.
@@ -23,7 +23,9 @@
 #include <deal.II/hp/mapping_collection.h>
 #include <deal.II/fe/fe_values.h>
 
+#include <algorithm>
 #include <map>
+#include <vector>
 #include <deal.II/base/std_cxx11/shared_ptr.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -43,7 +45,9 @@ namespace internal
      * quadrature object from their corresponding collection objects there is
      * a matching ::FEValues, ::FEFaceValues, or ::FESubfaceValues object. To
      * make things more efficient, however, these FE*Values objects are only
-     * created once requested (lazy allocation).
+     * created once requested (lazy allocation). Alternatively, all objects
+     * that will be needed can be created up front by calling
+     * precompute_fe_values().
      *
      * The first template parameter denotes the space dimension we are in, the
      * second the dimensionality of the object that we integrate on, i.e. for
@@ -109,6 +113,41 @@ namespace internal
        */
       const FEValues &get_present_fe_values () const;
 
+      /**
+       * Create the FE*Values objects for all combinations of finite
+       * element, mapping, and quadrature indices that the reinit() functions
+       * of the derived classes select if their optional index arguments are
+       * left at their default values, i.e., for every finite element index
+       * @p i the combination of the finite element with index @p i with the
+       * mapping and quadrature formula with index @p i, or index zero if the
+       * respective collection has only a single element.
+       *
+       * By default, the FE*Values objects are created lazily, the first time
+       * a cell with a particular combination of indices is visited. This
+       * means that the expensive construction, which evaluates all shape
+       * functions on the reference cell, happens inside the assembly loop,
+       * and that the objects end up scattered in memory in the order in
+       * which the combinations were first encountered. Calling this function
+       * before the loop instead builds all objects in one go, ordered by
+       * finite element index, so that subsequent calls to reinit() never
+       * allocate and only switch between existing objects. This is
+       * particularly useful if the assembly is split into several threads
+       * that each own a copy of this object, or if the loop is timed.
+       *
+       * Combinations for which an object already exists are left untouched.
+       * If you intend to call reinit() with explicitly specified indices,
+       * use the other version of this function for these combinations.
+       */
+      void precompute_fe_values ();
+
+      /**
+       * Create the FE*Values object for the given combination of finite
+       * element, mapping, and quadrature indices, unless it already exists.
+       */
+      void precompute_fe_values (const unsigned int fe_index,
+                                 const unsigned int mapping_index,
+                                 const unsigned int q_index);
+
     protected:
 
       /**
@@ -161,6 +200,14 @@ namespace internal
        */
       TableIndices<3> present_fe_values_index;
 
+      /**
+       * A pointer to the object selected last time the select_fe_values()
+       * function was called, i.e., the object stored in fe_values_table at
+       * position present_fe_values_index. It is cached here to avoid the
+       * index computation on every call to get_present_fe_values().
+       */
+      FEValues *present_fe_values;
+
       /**
        * Values of the update flags as given to the constructor.
        */
@@ -215,7 +262,39 @@ namespace hp
    * Note that ::FEValues objects are created on the fly, i.e. only as they
    * are needed. This ensures that we do not create objects for every
    * combination of finite element, quadrature formula and mapping, but only
-   * those that will actually be needed.
+   * those that will actually be needed. If the cost of creating these
+   * objects inside the assembly loop is undesirable, they can be created up
+   * front by calling precompute_fe_values() after construction.
+   *
+   * On meshes with many different finite elements, adjacent cells in the
+   * usual order of iteration often have different active_fe_index values,
+   * and every cell then uses a different ::FEValues object than its
+   * predecessor. Since each of these objects has its own tables of shape
+   * function values, this leads to poor cache reuse, and it also defeats the
+   * detection of translated cells within each ::FEValues object. In such
+   * cases, it can be beneficial to first collect the cells to be assembled
+   * and sort them by their active_fe_index using
+   * hp::sort_cells_by_active_fe_index():
+   * @code
+   *   hp::FEValues<dim> hp_fe_values (fe_collection, quadrature_collection,
+   *                                   update_values | update_gradients |
+   *                                   update_JxW_values);
+   *   hp_fe_values.precompute_fe_values ();
+   *
+   *   std::vector<typename hp::DoFHandler<dim>::active_cell_iterator> cells;
+   *   for (cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+   *     cells.push_back (cell);
+   *   hp::sort_cells_by_active_fe_index (cells);
+   *
+   *   for (unsigned int c=0; c<cells.size(); ++c)
+   *     {
+   *       hp_fe_values.reinit (cells[c]);
+   *       const FEValues<dim> &fe_values = hp_fe_values.get_present_fe_values ();
+   *       ...
+   *     }
+   * @endcode
+   * The order in which cells are assembled does not matter for the resulting
+   * matrix or vector, up to round-off.
    *
    * This class has not yet been implemented for the use in the codimension
    * one case (<tt>spacedim != dim </tt>).
@@ -586,6 +665,23 @@ namespace hp
             const unsigned int fe_index = numbers::invalid_unsigned_int);
   };
 
+
+
+  /**
+   * Sort the given cell iterators by the active_fe_index of the cells they
+   * point to, keeping the original order among cells with the same index.
+   * Assembling cells in this order means that hp::FEValues and its relatives
+   * switch between the underlying ::FEValues objects as rarely as possible,
+   * which improves cache reuse on meshes with many different finite
+   * elements. See the documentation of hp::FEValues for an example.
+   *
+   * @p CellIterator can be any iterator into an hp::DoFHandler.
+   *
+   * @ingroup hp
+   */
+  template <typename CellIterator>
+  void
+  sort_cells_by_active_fe_index (std::vector<CellIterator> &cells);
 }
 
 
@@ -600,7 +696,10 @@ namespace internal
     const FEValues &
     FEValuesBase<dim,q_dim,FEValues>::get_present_fe_values () const
     {
-      return *fe_values_table(present_fe_values_index);
+      Assert (present_fe_values != 0,
+              ExcMessage ("No object has been selected yet. Call reinit() "
+                          "before accessing the present FEValues object."));
+      return *present_fe_values;
     }
 
 
@@ -642,10 +741,39 @@ namespace internal
     {
       return update_flags;
     }
+
+
+
+    /**
+     * A comparison object that orders cell iterators by their
+     * active_fe_index.
+     */
+    struct CompareActiveFEIndex
+    {
+      template <typename CellIterator>
+      bool operator () (const CellIterator &cell_1,
+                        const CellIterator &cell_2) const
+      {
+        return cell_1->active_fe_index() < cell_2->active_fe_index();
+      }
+    };
   }
 
 }
 
+
+
+namespace hp
+{
+  template <typename CellIterator>
+  void
+  sort_cells_by_active_fe_index (std::vector<CellIterator> &cells)
+  {
+    std::stable_sort (cells.begin(), cells.end(),
+                      internal::hp::CompareActiveFEIndex());
+  }
+}
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
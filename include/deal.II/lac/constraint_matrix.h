@@ -887,6 +887,89 @@ public:
                               VectorType                    &global_vector,
                               bool                          use_inhomogeneities_for_rhs = false) const;
 
+  /**
+   * The data the batched distribute_local_to_global() function below
+   * computes from the dof indices of a batch of cells. It only depends on
+   * the dof indices and the constraints, so it can be set up once by
+   * setup_local_to_global_batch() and be reused as long as neither of them
+   * changes, e.g. for assembling the matrix of every step of a nonlinear or
+   * time-dependent problem.
+   */
+  struct LocalToGlobalBatch
+  {
+    /**
+     * The positions of the cells within the batch, split into colors such
+     * that no two cells of the same color write into the same global row.
+     */
+    std::vector<std::vector<unsigned int> > colors;
+
+    /**
+     * For each cell and each of its degrees of freedom, the position of the
+     * constraint of this degree of freedom within the constraints of the
+     * ConstraintMatrix object, or numbers::invalid_size_type for
+     * unconstrained degrees of freedom. This avoids looking up the
+     * constraints again for each cell when distributing the data.
+     */
+    std::vector<std::vector<size_type> > constraint_lines;
+  };
+
+  /**
+   * Compute the coloring and the positions of the constraints for the cells
+   * whose dof indices are given in @p local_dof_indices, as needed by the
+   * batched distribute_local_to_global() function. The cells are colored
+   * such that no two cells of the same color write into the same global row,
+   * including the rows that the constraints of a cell's degrees of freedom
+   * resolve to. This object must be closed.
+   */
+  void setup_local_to_global_batch (const std::vector<std::vector<size_type> > &local_dof_indices,
+                                    LocalToGlobalBatch                         &batch) const;
+
+  /**
+   * Batched version of the previous function: distribute the local matrices
+   * and vectors of many cells, given by the entries of the three vectors
+   * @p local_matrices, @p local_vectors and @p local_dof_indices, into the
+   * global matrix and vector.
+   *
+   * The cells within one color of @p batch, which must have been set up by
+   * setup_local_to_global_batch() for the same dof indices and the current
+   * constraints, are processed in parallel by the tasks of the threading
+   * library, without any locks. Each task reuses the thread-local scratch
+   * data of this class. If only one thread is available, the cells are
+   * processed one after the other in the given order. In both cases, the
+   * constraints are taken from @p batch instead of being looked up again.
+   *
+   * This requires that the global matrix and vector allow simultaneous
+   * access to different rows, which is the case for the deal.II matrix and
+   * vector classes but not for the wrappers of PETSc and Trilinos objects.
+   * The result equals the one obtained by calling the previous function for
+   * each cell, up to roundoff from the different order of summation.
+   */
+  template <typename MatrixType, typename VectorType>
+  void
+  distribute_local_to_global (const std::vector<FullMatrix<typename MatrixType::value_type> > &local_matrices,
+                              const std::vector<Vector<typename VectorType::value_type> >     &local_vectors,
+                              const std::vector<std::vector<size_type> >                      &local_dof_indices,
+                              const LocalToGlobalBatch                                        &batch,
+                              MatrixType                    &global_matrix,
+                              VectorType                    &global_vector,
+                              bool                          use_inhomogeneities_for_rhs = false) const;
+
+  /**
+   * Same as the previous function, but set up the coloring and the
+   * positions of the constraints by setup_local_to_global_batch() in each
+   * call, which is only done if more than one thread is available. Use the
+   * previous function to reuse this data for several calls with the same
+   * dof indices.
+   */
+  template <typename MatrixType, typename VectorType>
+  void
+  distribute_local_to_global (const std::vector<FullMatrix<typename MatrixType::value_type> > &local_matrices,
+                              const std::vector<Vector<typename VectorType::value_type> >     &local_vectors,
+                              const std::vector<std::vector<size_type> >                      &local_dof_indices,
+                              MatrixType                    &global_matrix,
+                              VectorType                    &global_vector,
+                              bool                          use_inhomogeneities_for_rhs = false) const;
+
   /**
    * Do a similar operation as the distribute_local_to_global() function that
    * distributes writing entries into a matrix for constrained degrees of
@@ -1263,7 +1346,8 @@ private:
                               MatrixType                   &global_matrix,
                               VectorType                   &global_vector,
                               bool                          use_inhomogeneities_for_rhs,
-                              internal::bool2type<false>) const;
+                              internal::bool2type<false>,
+                              const std::vector<size_type> *constraint_lines = 0) const;
 
   /**
    * This function actually implements the local_to_global function for block
@@ -1277,7 +1361,31 @@ private:
                               MatrixType                   &global_matrix,
                               VectorType                   &global_vector,
                               bool                          use_inhomogeneities_for_rhs,
-                              internal::bool2type<true>) const;
+                              internal::bool2type<true>,
+                              const std::vector<size_type> *constraint_lines = 0) const;
+
+  /**
+   * Functor that distributes the data of the cells <tt>cells[begin]</tt> to
+   * <tt>cells[end-1]</tt> of a batch, using the positions of the constraints
+   * stored in @p batch. Called in parallel for the cells of one color by the
+   * batched distribute_local_to_global() function.
+   */
+  template <typename MatrixType, typename VectorType>
+  struct LocalToGlobalRange
+  {
+    void operator() (const unsigned int begin,
+                     const unsigned int end) const;
+
+    const ConstraintMatrix                                          *constraints;
+    const std::vector<FullMatrix<typename MatrixType::value_type> > *local_matrices;
+    const std::vector<Vector<typename VectorType::value_type> >     *local_vectors;
+    const std::vector<std::vector<size_type> >                      *local_dof_indices;
+    const LocalToGlobalBatch                                        *batch;
+    const std::vector<unsigned int>                                 *cells;
+    MatrixType                                                      *global_matrix;
+    VectorType                                                      *global_vector;
+    bool                                                             use_inhomogeneities_for_rhs;
+  };
 
   /**
    * This function actually implements the local_to_global function for
@@ -1308,11 +1416,15 @@ private:
    *
    * Creates a list of affected global rows for distribution, including the
    * local rows where the entries come from. The list is sorted according to
-   * the global row indices.
+   * the global row indices. If @p constraint_lines is given, it contains the
+   * positions of the constraints of the local degrees of freedom in the
+   * list of lines as stored in LocalToGlobalBatch, and the constraints are
+   * not looked up again.
    */
   void
   make_sorted_row_list (const std::vector<size_type> &local_dof_indices,
-                        internals::GlobalRowsFromLocal  &global_rows) const;
+                        internals::GlobalRowsFromLocal  &global_rows,
+                        const std::vector<size_type>    *constraint_lines = 0) const;
 
   /**
    * Internal helper function for add_entries_local_to_global function.
@@ -21,6 +21,10 @@
 #include <deal.II/lac/constraint_matrix.h>
 
 #include <deal.II/base/table.h>
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/sparse_matrix.h>
@@ -2006,7 +2010,8 @@ add_this_index:
 void
 ConstraintMatrix::
 make_sorted_row_list (const std::vector<size_type>   &local_dof_indices,
-                      internals::GlobalRowsFromLocal &global_rows) const
+                      internals::GlobalRowsFromLocal &global_rows,
+                      const std::vector<size_type>   *constraint_lines) const
 {
   const size_type n_local_dofs = local_dof_indices.size();
   AssertDimension (n_local_dofs, global_rows.size());
@@ -2033,9 +2038,15 @@ make_sorted_row_list (const std::vector<size_type>   &local_dof_indices,
 
   // first add the indices in an unsorted way and only keep track of the
   // constraints that appear. They are resolved in a second step.
+  // the positions of the constraints are either given by the caller or
+  // looked up here
+  if (constraint_lines != 0)
+    AssertDimension (constraint_lines->size(), n_local_dofs);
   for (size_type i = 0; i<n_local_dofs; ++i)
     {
-      if (is_constrained(local_dof_indices[i]) == false)
+      if (constraint_lines != 0 ?
+          (*constraint_lines)[i] == numbers::invalid_size_type :
+          is_constrained(local_dof_indices[i]) == false)
         {
           global_rows.global_row(added_rows)  = local_dof_indices[i];
           global_rows.local_row(added_rows++) = i;
@@ -2053,7 +2064,11 @@ make_sorted_row_list (const std::vector<size_type>   &local_dof_indices,
       const size_type global_row = local_dof_indices[local_row];
       Assert (is_constrained(global_row), ExcInternalError());
       const ConstraintLine &position =
-        lines[lines_cache[calculate_line_index(global_row)]];
+        lines[constraint_lines != 0 ? (*constraint_lines)[local_row] :
+              lines_cache[calculate_line_index(global_row)]];
+      Assert (position.line == global_row,
+              ExcMessage ("The positions of the constraints do not match the "
+                          "current constraints."));
       if (position.inhomogeneity != 0)
         global_rows.set_ith_constraint_inhomogeneous (i);
       for (size_type q=0; q<position.entries.size(); ++q)
@@ -2176,7 +2191,8 @@ ConstraintMatrix::distribute_local_to_global (
   MatrixType                      &global_matrix,
   VectorType                      &global_vector,
   bool                            use_inhomogeneities_for_rhs,
-  internal::bool2type<false>) const
+  internal::bool2type<false>,
+  const std::vector<size_type>    *constraint_lines) const
 {
   // check whether we work on real vectors or we just used a dummy when
   // calling the other function above.
@@ -2203,7 +2219,7 @@ ConstraintMatrix::distribute_local_to_global (
 
   internals::GlobalRowsFromLocal &global_rows = scratch_data->global_rows;
   global_rows.reinit(n_local_dofs);
-  make_sorted_row_list (local_dof_indices, global_rows);
+  make_sorted_row_list (local_dof_indices, global_rows, constraint_lines);
 
   const size_type n_actual_dofs = global_rows.size();
 
@@ -2274,6 +2290,109 @@ ConstraintMatrix::distribute_local_to_global (
 
 
 
+template <typename MatrixType, typename VectorType>
+void
+ConstraintMatrix::LocalToGlobalRange<MatrixType,VectorType>::operator() (
+  const unsigned int begin,
+  const unsigned int end) const
+{
+  for (unsigned int i=begin; i<end; ++i)
+    {
+      const unsigned int cell = (*cells)[i];
+      constraints->distribute_local_to_global ((*local_matrices)[cell],
+                                               (*local_vectors)[cell],
+                                               (*local_dof_indices)[cell],
+                                               *global_matrix, *global_vector,
+                                               use_inhomogeneities_for_rhs,
+                                               dealii::internal::bool2type<IsBlockMatrix<MatrixType>::value>(),
+                                               &batch->constraint_lines[cell]);
+    }
+}
+
+
+
+template <typename MatrixType, typename VectorType>
+void
+ConstraintMatrix::distribute_local_to_global (
+  const std::vector<FullMatrix<typename MatrixType::value_type> > &local_matrices,
+  const std::vector<Vector<typename VectorType::value_type> >     &local_vectors,
+  const std::vector<std::vector<size_type> >                      &local_dof_indices,
+  const LocalToGlobalBatch                                        &batch,
+  MatrixType                                                      &global_matrix,
+  VectorType                                                      &global_vector,
+  bool                                                            use_inhomogeneities_for_rhs) const
+{
+  const unsigned int n_cells = local_dof_indices.size();
+  AssertDimension (local_matrices.size(), n_cells);
+  AssertDimension (local_vectors.size(), n_cells);
+  AssertDimension (batch.constraint_lines.size(), n_cells);
+
+  if (MultithreadInfo::n_threads() == 1)
+    {
+      for (unsigned int cell=0; cell<n_cells; ++cell)
+        distribute_local_to_global (local_matrices[cell], local_vectors[cell],
+                                    local_dof_indices[cell], global_matrix,
+                                    global_vector, use_inhomogeneities_for_rhs,
+                                    dealii::internal::bool2type<IsBlockMatrix<MatrixType>::value>(),
+                                    &batch.constraint_lines[cell]);
+      return;
+    }
+
+  // the cells of one color write into disjoint rows, so they can be
+  // processed in parallel without synchronization
+  LocalToGlobalRange<MatrixType,VectorType> range;
+  range.constraints       = this;
+  range.local_matrices    = &local_matrices;
+  range.local_vectors     = &local_vectors;
+  range.local_dof_indices = &local_dof_indices;
+  range.batch             = &batch;
+  range.global_matrix     = &global_matrix;
+  range.global_vector     = &global_vector;
+  range.use_inhomogeneities_for_rhs = use_inhomogeneities_for_rhs;
+  for (unsigned int c=0; c<batch.colors.size(); ++c)
+    {
+      range.cells = &batch.colors[c];
+      parallel::apply_to_subranges (0U, static_cast<unsigned int>(batch.colors[c].size()),
+                                    range, 8);
+    }
+}
+
+
+
+template <typename MatrixType, typename VectorType>
+void
+ConstraintMatrix::distribute_local_to_global (
+  const std::vector<FullMatrix<typename MatrixType::value_type> > &local_matrices,
+  const std::vector<Vector<typename VectorType::value_type> >     &local_vectors,
+  const std::vector<std::vector<size_type> >                      &local_dof_indices,
+  MatrixType                                                      &global_matrix,
+  VectorType                                                      &global_vector,
+  bool                                                            use_inhomogeneities_for_rhs) const
+{
+  const unsigned int n_cells = local_dof_indices.size();
+  AssertDimension (local_matrices.size(), n_cells);
+  AssertDimension (local_vectors.size(), n_cells);
+
+  // setting up the coloring does not pay off for a single call if the cells
+  // are processed one after the other anyway
+  if (MultithreadInfo::n_threads() == 1 || n_cells < 2)
+    {
+      for (unsigned int cell=0; cell<n_cells; ++cell)
+        distribute_local_to_global (local_matrices[cell], local_vectors[cell],
+                                    local_dof_indices[cell], global_matrix,
+                                    global_vector, use_inhomogeneities_for_rhs);
+      return;
+    }
+
+  LocalToGlobalBatch batch;
+  setup_local_to_global_batch (local_dof_indices, batch);
+  distribute_local_to_global (local_matrices, local_vectors, local_dof_indices,
+                              batch, global_matrix, global_vector,
+                              use_inhomogeneities_for_rhs);
+}
+
+
+
 template <typename MatrixType>
 void
 ConstraintMatrix::distribute_local_to_global (
@@ -2339,7 +2458,8 @@ distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>  &
                             MatrixType                   &global_matrix,
                             VectorType                   &global_vector,
                             bool                          use_inhomogeneities_for_rhs,
-                            internal::bool2type<true>) const
+                            internal::bool2type<true>,
+                            const std::vector<size_type> *constraint_lines) const
 {
   const bool use_vectors = (local_vector.size() == 0 &&
                             global_vector.size() == 0) ? false : true;
@@ -2366,7 +2486,7 @@ distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>  &
   internals::GlobalRowsFromLocal &global_rows = scratch_data->global_rows;
   global_rows.reinit(n_local_dofs);
 
-  make_sorted_row_list (local_dof_indices, global_rows);
+  make_sorted_row_list (local_dof_indices, global_rows, constraint_lines);
   const size_type n_actual_dofs = global_rows.size();
 
   std::vector<size_type> &global_indices = scratch_data->vector_indices;
@@ -0,0 +1,452 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__multi_vector_h
+#define dealii__multi_vector_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <typename number> class FullMatrix;
+
+
+/*! @addtogroup Vectors
+ *@{
+ */
+
+/**
+ * A collection of a fixed number of vectors of the same size, such as the
+ * right hand sides and solutions of a linear system with several right hand
+ * sides $AX=B$. In contrast to a std::vector of Vector objects, the entries
+ * of all vectors are stored interleaved, i.e., the entries of all columns for
+ * the first row come first, followed by the entries of all columns for the
+ * second row, and so on. Products with a sparse matrix such as
+ * SparseMatrix::vmult() can then read each matrix entry once and apply it to
+ * all columns with contiguous accesses, so the matrix, whose memory transfer
+ * dominates the cost of a sparse matrix-vector product, is only streamed from
+ * memory once for all columns rather than once per column.
+ *
+ * The class provides the vector operations that are needed by iterative
+ * solvers like SolverBlockCG: the usual operations applied to all columns at
+ * once (equ(), add(), sadd()), the products of the form $X^TY$ between all
+ * columns of two multi-vectors (inner_products()), and the update $X \mathrel{+}= YC$
+ * with a small dense matrix $C$ (add_times()). The last two operations are
+ * what distinguishes a block Krylov method from running several independent
+ * Krylov methods side by side.
+ *
+ * Following the convention of other vector classes, size() returns the
+ * number of rows, i.e., the length of each of the vectors, while
+ * n_columns() returns the number of vectors. The class is meant for real
+ * number types.
+ */
+template <typename Number>
+class MultiVector : public Subscriptor
+{
+public:
+  /**
+   * Declare standard types used in all containers.
+   */
+  typedef Number                                                  value_type;
+  typedef typename numbers::NumberTraits<Number>::real_type       real_type;
+  typedef types::global_dof_index                                 size_type;
+
+  /**
+   * Default constructor. Create an object with no rows and no columns.
+   */
+  MultiVector ();
+
+  /**
+   * Constructor. Create an object with @p n_rows rows and @p n_columns
+   * columns, with all entries set to zero.
+   */
+  MultiVector (const size_type    n_rows,
+               const unsigned int n_columns);
+
+  /**
+   * Change the dimensions to @p n_rows rows and @p n_columns columns. If @p
+   * omit_zeroing_entries is false, all entries are set to zero, otherwise
+   * their values are undefined.
+   */
+  void reinit (const size_type    n_rows,
+               const unsigned int n_columns,
+               const bool         omit_zeroing_entries = false);
+
+  /**
+   * Change the dimensions to those of @p other. The entries of @p other are
+   * not copied.
+   */
+  void reinit (const MultiVector<Number> &other,
+               const bool                 omit_zeroing_entries = false);
+
+  /**
+   * Swap the contents of this object and @p other.
+   */
+  void swap (MultiVector<Number> &other);
+
+  /**
+   * Return the number of rows, i.e., the size of each of the vectors.
+   */
+  size_type size () const;
+
+  /**
+   * Return the number of columns, i.e., the number of vectors.
+   */
+  unsigned int n_columns () const;
+
+  /**
+   * Read access to the entry in row @p row of column @p column.
+   */
+  Number operator() (const size_type    row,
+                     const unsigned int column) const;
+
+  /**
+   * Read-write access to the entry in row @p row of column @p column.
+   */
+  Number &operator() (const size_type    row,
+                      const unsigned int column);
+
+  /**
+   * Return a pointer to the first entry. The entry of row <tt>i</tt> in
+   * column <tt>k</tt> is at position <tt>i*n_columns()+k</tt>.
+   */
+  Number *begin ();
+
+  /**
+   * Constant version of the function above.
+   */
+  const Number *begin () const;
+
+  /**
+   * Return a pointer to one past the last entry.
+   */
+  Number *end ();
+
+  /**
+   * Constant version of the function above.
+   */
+  const Number *end () const;
+
+  /**
+   * Set all entries to @p s.
+   */
+  MultiVector<Number> &operator= (const Number s);
+
+  /**
+   * Return whether all entries are zero.
+   */
+  bool all_zero () const;
+
+  /**
+   * Set <tt>*this = a*V</tt>.
+   */
+  void equ (const Number               a,
+            const MultiVector<Number> &V);
+
+  /**
+   * Set <tt>*this += a*V</tt>.
+   */
+  void add (const Number               a,
+            const MultiVector<Number> &V);
+
+  /**
+   * Set <tt>*this = s*(*this) + a*V</tt>.
+   */
+  void sadd (const Number               s,
+             const Number               a,
+             const MultiVector<Number> &V);
+
+  /**
+   * Multiply each column by the respective entry of @p factors.
+   */
+  void scale_columns (const std::vector<Number> &factors);
+
+  /**
+   * Set <tt>*this += V*C</tt>, where @p C is a matrix with as many rows as
+   * @p V has columns and as many columns as this object. In other words,
+   * each column of this object is updated by a linear combination of the
+   * columns of @p V.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  void add_times (const MultiVector<Number> &V,
+                  const FullMatrix<Number>  &C);
+
+  /**
+   * Compute the inner products between all columns of this object and all
+   * columns of @p W, i.e., the matrix <tt>result = (*this)^T W</tt>. The
+   * output matrix is resized as necessary. The sum over the rows is done in
+   * an order that does not depend on the number of threads.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  void inner_products (const MultiVector<Number> &W,
+                       FullMatrix<Number>        &result) const;
+
+  /**
+   * Compute the $l_2$ norm of each column.
+   */
+  void column_norms (std::vector<real_type> &norms) const;
+
+  /**
+   * Copy the entries of column @p column into the vector @p v, which must
+   * have size() entries and which is accessed with operator().
+   */
+  template <class VECTOR>
+  void extract_column (const unsigned int column,
+                       VECTOR            &v) const;
+
+  /**
+   * Copy the entries of the vector @p v, which must have size() entries and
+   * which is accessed with operator(), into column @p column.
+   */
+  template <class VECTOR>
+  void set_column (const unsigned int column,
+                   const VECTOR      &v);
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Number of rows.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns.
+   */
+  unsigned int n_cols;
+
+  /**
+   * The entries, stored row by row.
+   */
+  AlignedVector<Number> values;
+};
+
+
+
+/**
+ * A wrapper that applies an operator that only acts on single vectors to
+ * all columns of a MultiVector, one column after the other. This allows to
+ * use operators that do not have a specialized implementation for
+ * MultiVector, like the matrix-free operators built on MatrixFree::cell_loop()
+ * or a preconditioner acting on Vector objects, within SolverBlockCG. The
+ * columns are copied into and out of temporary vectors of type @p VECTOR,
+ * which are initialized from the template vector given to the constructor,
+ * such that this works with vectors that need special initialization, e.g.
+ * through MatrixFree::initialize_dof_vector().
+ *
+ * Since the operator is applied to each column separately, this class does
+ * not save any memory transfer compared to solving for the columns one after
+ * the other; for matrix-free operators, the cost is dominated by the
+ * arithmetic on the cells rather than by the memory access anyway.
+ */
+template <class MATRIX, class VECTOR>
+class MultiVectorColumnwiseOperator : public Subscriptor
+{
+public:
+  /**
+   * Constructor. Store a pointer to @p matrix and initialize the temporary
+   * vectors with the layout of @p template_vector.
+   */
+  MultiVectorColumnwiseOperator (const MATRIX &matrix,
+                                 const VECTOR &template_vector);
+
+  /**
+   * Apply the operator to each column of @p src and write the result into
+   * the respective column of @p dst.
+   */
+  template <typename Number>
+  void vmult (MultiVector<Number>       &dst,
+              const MultiVector<Number> &src) const;
+
+private:
+  /**
+   * Pointer to the operator.
+   */
+  SmartPointer<const MATRIX,MultiVectorColumnwiseOperator<MATRIX,VECTOR> > matrix;
+
+  /**
+   * Temporary vectors for the input and the output of the operator.
+   */
+  mutable VECTOR src_column, dst_column;
+};
+
+/*@}*/
+/*---------------------- Inline functions -----------------------------------*/
+
+
+template <typename Number>
+inline
+typename MultiVector<Number>::size_type
+MultiVector<Number>::size () const
+{
+  return n_rows;
+}
+
+
+
+template <typename Number>
+inline
+unsigned int
+MultiVector<Number>::n_columns () const
+{
+  return n_cols;
+}
+
+
+
+template <typename Number>
+inline
+Number
+MultiVector<Number>::operator() (const size_type    row,
+                                 const unsigned int column) const
+{
+  AssertIndexRange (row, n_rows);
+  AssertIndexRange (column, n_cols);
+  return values[row*n_cols+column];
+}
+
+
+
+template <typename Number>
+inline
+Number &
+MultiVector<Number>::operator() (const size_type    row,
+                                 const unsigned int column)
+{
+  AssertIndexRange (row, n_rows);
+  AssertIndexRange (column, n_cols);
+  return values[row*n_cols+column];
+}
+
+
+
+template <typename Number>
+inline
+Number *
+MultiVector<Number>::begin ()
+{
+  return values.begin();
+}
+
+
+
+template <typename Number>
+inline
+const Number *
+MultiVector<Number>::begin () const
+{
+  return values.begin();
+}
+
+
+
+template <typename Number>
+inline
+Number *
+MultiVector<Number>::end ()
+{
+  return values.end();
+}
+
+
+
+template <typename Number>
+inline
+const Number *
+MultiVector<Number>::end () const
+{
+  return values.end();
+}
+
+
+
+template <typename Number>
+template <class VECTOR>
+inline
+void
+MultiVector<Number>::extract_column (const unsigned int column,
+                                     VECTOR            &v) const
+{
+  AssertIndexRange (column, n_cols);
+  AssertDimension (v.size(), n_rows);
+  for (size_type i=0; i<n_rows; ++i)
+    v(i) = values[i*n_cols+column];
+}
+
+
+
+template <typename Number>
+template <class VECTOR>
+inline
+void
+MultiVector<Number>::set_column (const unsigned int column,
+                                 const VECTOR      &v)
+{
+  AssertIndexRange (column, n_cols);
+  AssertDimension (v.size(), n_rows);
+  for (size_type i=0; i<n_rows; ++i)
+    values[i*n_cols+column] = v(i);
+}
+
+
+
+template <class MATRIX, class VECTOR>
+inline
+MultiVectorColumnwiseOperator<MATRIX,VECTOR>::
+MultiVectorColumnwiseOperator (const MATRIX &matrix,
+                               const VECTOR &template_vector)
+  :
+  matrix (&matrix),
+  src_column (template_vector),
+  dst_column (template_vector)
+{}
+
+
+
+template <class MATRIX, class VECTOR>
+template <typename Number>
+inline
+void
+MultiVectorColumnwiseOperator<MATRIX,VECTOR>::
+vmult (MultiVector<Number>       &dst,
+       const MultiVector<Number> &src) const
+{
+  AssertDimension (dst.n_columns(), src.n_columns());
+  for (unsigned int k=0; k<src.n_columns(); ++k)
+    {
+      src.extract_column (k, src_column);
+      matrix->vmult (dst_column, src_column);
+      dst.set_column (k, dst_column);
+    }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
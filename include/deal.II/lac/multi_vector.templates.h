@@ -0,0 +1,379 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__multi_vector_templates_h
+#define dealii__multi_vector_templates_h
+
+
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/memory_consumption.h>
+
+#include <algorithm>
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MultiVector
+  {
+    // number of rows that are worked on as one unit in the threaded loops
+    // below
+    const unsigned int rows_per_chunk = 256;
+
+    // Functor for MultiVector::add_times: every row of the destination is
+    // updated by the product of the respective row of the source with the
+    // small matrix
+    template <typename Number>
+    struct AddTimes
+    {
+      void operator() (const std::size_t begin_chunk,
+                       const std::size_t end_chunk) const
+      {
+        const std::size_t n_rows = std::min<std::size_t>
+                                   (end_chunk*rows_per_chunk, size);
+        for (std::size_t i=begin_chunk*rows_per_chunk; i<n_rows; ++i)
+          {
+            const Number *v_row = v + i*n_v_columns;
+            Number *dst_row = dst + i*n_dst_columns;
+            for (unsigned int j=0; j<n_v_columns; ++j)
+              {
+                const Number v_ij = v_row[j];
+                const Number *c_row = c + j*n_dst_columns;
+                for (unsigned int k=0; k<n_dst_columns; ++k)
+                  dst_row[k] += v_ij * c_row[k];
+              }
+          }
+      }
+
+      std::size_t size;
+      unsigned int n_v_columns, n_dst_columns;
+      const Number *v;
+      const Number *c;
+      Number *dst;
+    };
+
+
+
+    // Data for MultiVector::inner_products: add the contribution of the rows
+    // [begin,end) to the matrix of inner products in sums
+    template <typename Number>
+    struct InnerProducts
+    {
+      void add_rows (const std::size_t begin,
+                     const std::size_t end,
+                     Number           *sums) const
+      {
+        for (std::size_t i=begin; i<end; ++i)
+          {
+            const Number *v_row = v + i*n_v_columns;
+            const Number *w_row = w + i*n_w_columns;
+            for (unsigned int j=0; j<n_v_columns; ++j)
+              {
+                const Number v_ij = v_row[j];
+                Number *sums_row = sums + j*n_w_columns;
+                for (unsigned int k=0; k<n_w_columns; ++k)
+                  sums_row[k] += v_ij * w_row[k];
+              }
+          }
+      }
+
+      unsigned int n_v_columns, n_w_columns;
+      const Number *v;
+      const Number *w;
+    };
+
+
+
+    // Compute the inner products over the rows [first_row,
+    // first_row+n_rows) and write them into result, which holds
+    // n_v_columns*n_w_columns entries. This follows the accumulate()
+    // function in vector.templates.h: the rows are split into four pieces
+    // recursively until at most four chunks are left, and the results of
+    // the pieces are added pairwise. The splitting only depends on the
+    // number of rows, so the result does not depend on the number of
+    // threads, and each level of the recursion only holds three temporary
+    // matrices.
+    template <typename Number>
+    void accumulate_inner_products (const InnerProducts<Number> &data,
+                                    const std::size_t            first_row,
+                                    const std::size_t            n_rows,
+                                    Number                      *result,
+                                    const int                    depth = -1)
+    {
+      (void)depth;
+      const std::size_t n_entries = std::size_t(data.n_v_columns)*data.n_w_columns;
+      std::fill (result, result+n_entries, Number());
+      if (n_rows <= 4*rows_per_chunk)
+        {
+          data.add_rows (first_row, first_row+n_rows, result);
+          return;
+        }
+
+      // make pieces (except last) divisible by rows_per_chunk
+      const std::size_t new_size = (n_rows / (4*rows_per_chunk)) * rows_per_chunk;
+      std::vector<Number> r1 (n_entries), r2 (n_entries), r3 (n_entries);
+#ifdef DEAL_II_WITH_THREADS
+      if (MultithreadInfo::n_threads() > 1 && depth != 0)
+        {
+          // limit the depth of the task hierarchy like in vector.templates.h
+          int next_depth = depth;
+          if (depth == -1)
+            next_depth = 8 * MultithreadInfo::n_threads();
+          next_depth /= 4;
+
+          Threads::TaskGroup<> task_group;
+          task_group += Threads::new_task (&accumulate_inner_products<Number>,
+                                           data, first_row, new_size, result,
+                                           next_depth);
+          task_group += Threads::new_task (&accumulate_inner_products<Number>,
+                                           data, first_row+new_size, new_size,
+                                           &r1[0], next_depth);
+          task_group += Threads::new_task (&accumulate_inner_products<Number>,
+                                           data, first_row+2*new_size, new_size,
+                                           &r2[0], next_depth);
+          task_group += Threads::new_task (&accumulate_inner_products<Number>,
+                                           data, first_row+3*new_size,
+                                           n_rows-3*new_size, &r3[0], next_depth);
+          task_group.join_all();
+        }
+      else
+#endif
+        {
+          accumulate_inner_products (data, first_row, new_size, result, 0);
+          accumulate_inner_products (data, first_row+new_size, new_size, &r1[0], 0);
+          accumulate_inner_products (data, first_row+2*new_size, new_size, &r2[0], 0);
+          accumulate_inner_products (data, first_row+3*new_size, n_rows-3*new_size,
+                                     &r3[0], 0);
+        }
+      for (std::size_t e=0; e<n_entries; ++e)
+        result[e] = (result[e] + r1[e]) + (r2[e] + r3[e]);
+    }
+  }
+}
+
+
+
+template <typename Number>
+MultiVector<Number>::MultiVector ()
+  :
+  n_rows (0),
+  n_cols (0)
+{}
+
+
+
+template <typename Number>
+MultiVector<Number>::MultiVector (const size_type    n_rows,
+                                  const unsigned int n_columns)
+  :
+  n_rows (0),
+  n_cols (0)
+{
+  reinit (n_rows, n_columns);
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::reinit (const size_type    rows,
+                             const unsigned int columns,
+                             const bool         omit_zeroing_entries)
+{
+  n_rows = rows;
+  n_cols = columns;
+  values.resize_fast (n_rows*n_cols);
+  if (omit_zeroing_entries == false)
+    values.fill (Number());
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::reinit (const MultiVector<Number> &other,
+                             const bool                 omit_zeroing_entries)
+{
+  reinit (other.size(), other.n_columns(), omit_zeroing_entries);
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::swap (MultiVector<Number> &other)
+{
+  std::swap (n_rows, other.n_rows);
+  std::swap (n_cols, other.n_cols);
+  values.swap (other.values);
+}
+
+
+
+template <typename Number>
+MultiVector<Number> &
+MultiVector<Number>::operator= (const Number s)
+{
+  values.fill (s);
+  return *this;
+}
+
+
+
+template <typename Number>
+bool
+MultiVector<Number>::all_zero () const
+{
+  for (const Number *p=values.begin(); p!=values.end(); ++p)
+    if (*p != Number())
+      return false;
+  return true;
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::equ (const Number               a,
+                          const MultiVector<Number> &V)
+{
+  AssertDimension (n_rows, V.n_rows);
+  AssertDimension (n_cols, V.n_cols);
+  const std::size_t n_entries = values.size();
+  for (std::size_t i=0; i<n_entries; ++i)
+    values[i] = a * V.values[i];
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::add (const Number               a,
+                          const MultiVector<Number> &V)
+{
+  AssertDimension (n_rows, V.n_rows);
+  AssertDimension (n_cols, V.n_cols);
+  const std::size_t n_entries = values.size();
+  for (std::size_t i=0; i<n_entries; ++i)
+    values[i] += a * V.values[i];
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::sadd (const Number               s,
+                           const Number               a,
+                           const MultiVector<Number> &V)
+{
+  AssertDimension (n_rows, V.n_rows);
+  AssertDimension (n_cols, V.n_cols);
+  const std::size_t n_entries = values.size();
+  for (std::size_t i=0; i<n_entries; ++i)
+    values[i] = s * values[i] + a * V.values[i];
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::scale_columns (const std::vector<Number> &factors)
+{
+  AssertDimension (factors.size(), n_cols);
+  for (size_type i=0; i<n_rows; ++i)
+    for (unsigned int k=0; k<n_cols; ++k)
+      values[i*n_cols+k] *= factors[k];
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::add_times (const MultiVector<Number> &V,
+                                const FullMatrix<Number>  &C)
+{
+  AssertDimension (n_rows, V.n_rows);
+  AssertDimension (C.m(), V.n_cols);
+  AssertDimension (C.n(), n_cols);
+  if (n_rows == 0 || n_cols == 0 || V.n_cols == 0)
+    return;
+
+  internal::MultiVector::AddTimes<Number> add_times;
+  add_times.size = n_rows;
+  add_times.n_v_columns = V.n_cols;
+  add_times.n_dst_columns = n_cols;
+  add_times.v = V.values.begin();
+  add_times.c = &C(0,0);
+  add_times.dst = values.begin();
+
+  const std::size_t n_chunks = (n_rows + internal::MultiVector::rows_per_chunk - 1) /
+                               internal::MultiVector::rows_per_chunk;
+  parallel::apply_to_subranges (std::size_t(0), n_chunks, add_times, 4);
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::inner_products (const MultiVector<Number> &W,
+                                     FullMatrix<Number>        &result) const
+{
+  AssertDimension (n_rows, W.n_rows);
+  result.reinit (n_cols, W.n_cols);
+  if (n_rows == 0 || n_cols == 0 || W.n_cols == 0)
+    return;
+
+  internal::MultiVector::InnerProducts<Number> inner_products;
+  inner_products.n_v_columns = n_cols;
+  inner_products.n_w_columns = W.n_cols;
+  inner_products.v = values.begin();
+  inner_products.w = W.values.begin();
+  internal::MultiVector::accumulate_inner_products (inner_products, 0, n_rows,
+                                                    &result(0,0));
+}
+
+
+
+template <typename Number>
+void
+MultiVector<Number>::column_norms (std::vector<real_type> &norms) const
+{
+  norms.assign (n_cols, real_type());
+  for (size_type i=0; i<n_rows; ++i)
+    for (unsigned int k=0; k<n_cols; ++k)
+      norms[k] += numbers::NumberTraits<Number>::abs_square (values[i*n_cols+k]);
+  for (unsigned int k=0; k<n_cols; ++k)
+    norms[k] = std::sqrt (norms[k]);
+}
+
+
+
+template <typename Number>
+std::size_t
+MultiVector<Number>::memory_consumption () const
+{
+  return sizeof(*this) + values.memory_consumption();
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,331 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__non_blocking_inner_products_h
+#define dealii__non_blocking_inner_products_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <vector>
+#include <utility>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <typename> class Vector;
+
+namespace parallel
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
+
+namespace internal
+{
+  /**
+   * A class that computes several inner products of vectors with a single
+   * global reduction, and that allows the reduction to proceed in the
+   * background while the caller does other work. This is used by solvers
+   * such as SolverPipelinedCG that overlap the global communication of an
+   * iteration with matrix-vector products and preconditioner applications.
+   *
+   * The general implementation of this class simply evaluates the inner
+   * products through the <tt>operator*</tt> of the vector class in start(),
+   * i.e., with one blocking reduction per inner product. For
+   * parallel::distributed::Vector, there is a specialization that computes
+   * the contributions of the locally owned elements in start() and sums
+   * them over all processors with a single non-blocking
+   * <tt>MPI_Iallreduce</tt>, which is completed in finish(). If the MPI
+   * implementation does not support MPI 3.0, a blocking
+   * <tt>MPI_Allreduce</tt> is used instead.
+   *
+   * For dealii::Vector and parallel::distributed::Vector, all pairs that
+   * share the same first vector are evaluated together with
+   * dealii::Vector::inner_products(), such that this vector is read from
+   * memory only once.
+   */
+  template <class VECTOR>
+  class NonBlockingInnerProducts
+  {
+  public:
+    /**
+     * Start computing the inner products between the two vectors of each
+     * pair in the given list. The vectors must not be changed before
+     * finish() has been called.
+     */
+    void start (const std::vector<std::pair<const VECTOR *, const VECTOR *> > &pairs)
+    {
+      results.resize (pairs.size());
+      for (unsigned int i=0; i<pairs.size(); ++i)
+        results[i] = *pairs[i].first * *pairs[i].second;
+    }
+
+    /**
+     * Wait for the inner products started by the last call to start() and
+     * write them into @p inner_products, in the order of the pairs given to
+     * start().
+     */
+    void finish (std::vector<double> &inner_products)
+    {
+      inner_products = results;
+    }
+
+  private:
+    /**
+     * The inner products computed in start().
+     */
+    std::vector<double> results;
+  };
+
+
+
+  /**
+   * Specialization of NonBlockingInnerProducts for dealii::Vector that
+   * computes all inner products with the same first vector in one sweep.
+   */
+  template <typename Number>
+  class NonBlockingInnerProducts<dealii::Vector<Number> >
+  {
+  public:
+    /**
+     * Compute the inner products between the two vectors of each pair in
+     * the given list.
+     */
+    void start (const std::vector<std::pair<const dealii::Vector<Number> *,
+                const dealii::Vector<Number> *> > &pairs)
+    {
+      results.resize (pairs.size());
+      std::vector<bool> done (pairs.size(), false);
+      std::vector<const dealii::Vector<Number> *> vectors;
+      std::vector<unsigned int> indices;
+      std::vector<Number> products;
+      for (unsigned int p=0; p<pairs.size(); ++p)
+        if (done[p] == false)
+          {
+            vectors.clear();
+            indices.clear();
+            for (unsigned int q=p; q<pairs.size(); ++q)
+              if (pairs[q].first == pairs[p].first)
+                {
+                  vectors.push_back (pairs[q].second);
+                  indices.push_back (q);
+                  done[q] = true;
+                }
+            pairs[p].first->inner_products (vectors, products);
+            for (unsigned int i=0; i<indices.size(); ++i)
+              results[indices[i]] = products[i];
+          }
+    }
+
+    /**
+     * Set the inner products to values the caller has computed itself, e.g.
+     * as part of a fused vector update. As the vectors are not distributed,
+     * these are the final values that are returned by finish().
+     */
+    void start_reduction (const std::vector<double> &products)
+    {
+      results = products;
+    }
+
+    /**
+     * Write the inner products computed by the last call to start() into @p
+     * inner_products, in the order of the pairs given to start().
+     */
+    void finish (std::vector<double> &inner_products)
+    {
+      inner_products = results;
+    }
+
+  private:
+    /**
+     * The inner products computed in start().
+     */
+    std::vector<double> results;
+  };
+
+
+
+  /**
+   * Specialization of NonBlockingInnerProducts for
+   * parallel::distributed::Vector that sums the local contributions to all
+   * inner products with a single non-blocking reduction.
+   */
+  template <typename Number>
+  class NonBlockingInnerProducts<parallel::distributed::Vector<Number> >
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    NonBlockingInnerProducts ()
+      :
+      reduction_in_flight (false)
+    {}
+
+    /**
+     * Destructor. Completes the reduction if finish() has not been called.
+     * Unlike finish(), errors reported by MPI are only checked in debug
+     * mode, since a destructor must not throw.
+     */
+    ~NonBlockingInnerProducts ()
+    {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (reduction_in_flight)
+        {
+          const int ierr = MPI_Wait (&request, MPI_STATUS_IGNORE);
+          (void)ierr;
+          AssertNothrow (ierr == MPI_SUCCESS, ExcInternalError());
+        }
+#endif
+    }
+
+    /**
+     * Compute the contributions of the locally owned elements to the inner
+     * products of the given pairs of vectors and start the reduction over
+     * all processors of the communicator of the first vector.
+     */
+    void start (const std::vector<std::pair<const parallel::distributed::Vector<Number> *,
+                const parallel::distributed::Vector<Number> *> > &pairs)
+    {
+      Assert (reduction_in_flight == false,
+              ExcMessage ("The previous reduction has not been finished"));
+
+      local_results.resize (pairs.size());
+      std::vector<bool> done (pairs.size(), false);
+      std::vector<const parallel::distributed::Vector<Number> *> vectors;
+      std::vector<unsigned int> indices;
+      std::vector<Number> products;
+      for (unsigned int p=0; p<pairs.size(); ++p)
+        if (done[p] == false)
+          {
+            vectors.clear();
+            indices.clear();
+            for (unsigned int q=p; q<pairs.size(); ++q)
+              if (pairs[q].first == pairs[p].first)
+                {
+                  vectors.push_back (pairs[q].second);
+                  indices.push_back (q);
+                  done[q] = true;
+                }
+            pairs[p].first->inner_products_local (vectors, products);
+            for (unsigned int i=0; i<indices.size(); ++i)
+              local_results[indices[i]] = products[i];
+          }
+
+      if (pairs.size() > 0)
+        start_reduction (local_results,
+                         pairs[0].first->get_mpi_communicator());
+    }
+
+    /**
+     * Start the reduction over all processors in @p communicator of inner
+     * products whose local contributions have already been computed by the
+     * caller, e.g. as part of a fused vector update. The results are
+     * obtained by finish().
+     */
+    void start_reduction (const std::vector<double> &local_products,
+                          const MPI_Comm            &communicator)
+    {
+      Assert (reduction_in_flight == false,
+              ExcMessage ("The previous reduction has not been finished"));
+
+      // the buffers must not change while the reduction is in flight, so
+      // copy the local contributions into the member variable
+      if (&local_products != &local_results)
+        local_results = local_products;
+      results.resize (local_results.size());
+      if (local_results.size() == 0)
+        return;
+
+#ifdef DEAL_II_WITH_MPI
+      if (Utilities::MPI::job_supports_mpi())
+        {
+#  if MPI_VERSION >= 3
+          const int ierr = MPI_Iallreduce (&local_results[0], &results[0],
+                                           local_results.size(), MPI_DOUBLE,
+                                           MPI_SUM, communicator, &request);
+          AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+          reduction_in_flight = true;
+#  else
+          const int ierr = MPI_Allreduce (&local_results[0], &results[0],
+                                          local_results.size(), MPI_DOUBLE,
+                                          MPI_SUM, communicator);
+          AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+#  endif
+          return;
+        }
+#endif
+      results = local_results;
+    }
+
+    /**
+     * Wait for the reduction started by the last call to start() and write
+     * the inner products into @p inner_products, in the order of the pairs
+     * given to start().
+     */
+    void finish (std::vector<double> &inner_products)
+    {
+      wait ();
+      inner_products = results;
+    }
+
+  private:
+    /**
+     * Complete the reduction in flight, if any.
+     */
+    void wait ()
+    {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (reduction_in_flight)
+        {
+          const int ierr = MPI_Wait (&request, MPI_STATUS_IGNORE);
+          AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        }
+#endif
+      reduction_in_flight = false;
+    }
+
+    /**
+     * The contributions of the locally owned elements.
+     */
+    std::vector<double> local_results;
+
+    /**
+     * The global inner products. Written to by the reduction.
+     */
+    std::vector<double> results;
+
+    /**
+     * Whether a non-blocking reduction has been started but not completed.
+     */
+    bool reduction_in_flight;
+
+#ifdef DEAL_II_WITH_MPI
+    /**
+     * The request of the non-blocking reduction.
+     */
+    MPI_Request request;
+#endif
+  };
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
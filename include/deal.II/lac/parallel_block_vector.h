@@ -27,6 +27,7 @@
 #include <deal.II/lac/trilinos_parallel_block_vector.h>
 
 
+#include <algorithm>
 #include <cstdio>
 #include <vector>
 
@@ -49,6 +50,15 @@ namespace parallel
      * class handles the actual allocation of vectors and provides functions
      * that are specific to the underlying vector type.
      *
+     * The functions compress() and update_ghost_values() exchange the data
+     * of all blocks at once: the entries of all blocks that go to the same
+     * process are packed into a single message, so the number of messages
+     * does not grow with the number of blocks. This requires that all blocks
+     * live on the same MPI communicator and that their partitioners use
+     * neither a neighborhood nor a shared memory communicator (see
+     * Utilities::MPI::Partitioner). Otherwise, the data is exchanged block by
+     * block.
+     *
      * @note Instantiations for this template are provided for <tt>@<float@>
      * and @<double@></tt>; others can be generated in application programs
      * (see the section on
@@ -292,6 +302,44 @@ namespace parallel
        */
       void update_ghost_values () const;
 
+      /**
+       * Initiates the communication of compress() with non-blocking
+       * communication for all blocks. This function does not wait for the
+       * transfer to finish, in order to allow for other computations during
+       * the time it takes until all data arrives. It must be followed by a
+       * call to compress_finish().
+       *
+       * In case this function is called for more than one vector before
+       * compress_finish() is invoked, it is mandatory to specify a unique
+       * communication channel to each such call, in order to avoid several
+       * messages with the same ID that will corrupt this operation.
+       */
+      void compress_start (const unsigned int communication_channel = 0,
+                           ::dealii::VectorOperation::values operation = VectorOperation::add);
+
+      /**
+       * Waits for the communication started by compress_start() to finish
+       * and adds or sets the data (depending on the flag @p operation, which
+       * must be the same as in compress_start()) on the owning processor.
+       * Clears the ghost entries afterwards.
+       */
+      void compress_finish (::dealii::VectorOperation::values operation);
+
+      /**
+       * Initiates the communication of update_ghost_values() with
+       * non-blocking communication for all blocks. It must be followed by a
+       * call to update_ghost_values_finish() before reading ghost entries.
+       * The same rules for the communication channel apply as in
+       * compress_start().
+       */
+      void update_ghost_values_start (const unsigned int communication_channel = 0) const;
+
+      /**
+       * Waits for the communication started by update_ghost_values_start()
+       * to finish.
+       */
+      void update_ghost_values_finish () const;
+
       /**
        * This method zeros the entries on ghost dofs, but does not touch
        * locally owned DoFs.
@@ -436,6 +484,93 @@ namespace parallel
        */
       DeclException0 (ExcIteratorRangeDoesNotMatchVectorSize);
       //@}
+
+    private:
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * Returns whether the data of all blocks can be exchanged by combined
+       * messages, see the documentation of this class. The result is the
+       * same on all processors.
+       */
+      bool use_combined_exchange () const;
+
+      /**
+       * Sets up the buffers and the persistent MPI requests for the combined
+       * exchange, unless this has been done before for the same partitioners
+       * of the blocks and the same communication channel.
+       */
+      void setup_combined_exchange (const unsigned int communication_channel) const;
+
+      /**
+       * Frees the persistent MPI requests of the combined exchange. If MPI
+       * has already been finalized, the requests are only forgotten.
+       */
+      void clear_combined_exchange () const;
+
+      /**
+       * The communication pattern, buffers, and requests of the combined
+       * exchange. The buffers hold the data of one process after the other,
+       * and for each process the data of one block after the other.
+       */
+      struct CombinedExchange
+      {
+        /**
+         * The partitioners of the blocks the data below has been set up for.
+         */
+        std::vector<std_cxx11::shared_ptr<const Utilities::MPI::Partitioner> > partitioners;
+
+        /**
+         * The communication channel the tags of the persistent requests
+         * below have been derived from.
+         */
+        unsigned int communication_channel;
+
+        /**
+         * The processes that own ghost entries of at least one block, and
+         * the start of their data in @p ghost_buffer.
+         */
+        std::vector<unsigned int> ghost_ranks;
+        std::vector<unsigned int> ghost_offsets;
+
+        /**
+         * For each block and each entry in the ghost targets of that block,
+         * the position of its data in @p ghost_buffer.
+         */
+        std::vector<std::vector<unsigned int> > ghost_positions;
+
+        /**
+         * The processes that have ghost entries owned by this process in at
+         * least one block, and the start of their data in @p import_buffer.
+         */
+        std::vector<unsigned int> import_ranks;
+        std::vector<unsigned int> import_offsets;
+
+        /**
+         * For each block and each entry in the import targets of that block,
+         * the position of its data in @p import_buffer.
+         */
+        std::vector<std::vector<unsigned int> > import_positions;
+
+        /**
+         * Buffers for the data of the ghost and import entries of all blocks.
+         */
+        std::vector<Number> ghost_buffer;
+        std::vector<Number> import_buffer;
+
+        /**
+         * The persistent requests of compress() and update_ghost_values().
+         * The receives are placed before the sends.
+         */
+        std::vector<MPI_Request> compress_requests;
+        std::vector<MPI_Request> update_ghost_values_requests;
+      };
+
+      /**
+       * The data of the combined exchange. Not copied along with the
+       * vector.
+       */
+      mutable CombinedExchange combined_exchange;
+#endif
     };
 
     /*@}*/
@@ -572,7 +707,11 @@ namespace parallel
     template <typename Number>
     inline
     BlockVector<Number>::~BlockVector ()
-    {}
+    {
+#ifdef DEAL_II_WITH_MPI
+      clear_combined_exchange ();
+#endif
+    }
 
 
 
@@ -677,10 +816,160 @@ namespace parallel
     void
     BlockVector<Number>::compress (::dealii::VectorOperation::values operation)
     {
+      compress_start (0, operation);
+      compress_finish (operation);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    BlockVector<Number>::update_ghost_values () const
+    {
+      update_ghost_values_start ();
+      update_ghost_values_finish ();
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    BlockVector<Number>::compress_start (const unsigned int communication_channel,
+                                         ::dealii::VectorOperation::values operation)
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (use_combined_exchange() == true)
+        {
+          Assert (has_ghost_elements() == false,
+                  ExcMessage ("Cannot call compress() on a ghosted vector"));
+
+          // same as in Vector::compress_start(): nothing to send for insert
+          // in optimized mode
+#ifndef DEBUG
+          if (operation == VectorOperation::insert)
+            return;
+#endif
+          setup_combined_exchange (communication_channel);
+
+          // copy the ghost entries of all blocks into the send buffer
+          for (unsigned int block=0; block<this->n_blocks(); ++block)
+            {
+              const Vector<Number> &vec = this->block(block);
+              const Utilities::MPI::Partitioner &part = *vec.partitioner;
+              const Number *ghost_entry = vec.val + part.local_size();
+              for (unsigned int i=0; i<part.ghost_targets().size(); ++i)
+                {
+                  std::copy (ghost_entry, ghost_entry + part.ghost_targets()[i].second,
+                             combined_exchange.ghost_buffer.begin() +
+                             combined_exchange.ghost_positions[block][i]);
+                  ghost_entry += part.ghost_targets()[i].second;
+                }
+            }
+
+          if (combined_exchange.compress_requests.size() > 0)
+            {
+              const int ierr = MPI_Startall (combined_exchange.compress_requests.size(),
+                                             &combined_exchange.compress_requests[0]);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+          return;
+        }
+#endif
+
       // start all requests for all blocks before finishing the transfers as
       // this saves repeated synchronizations
       for (unsigned int block=0; block<this->n_blocks(); ++block)
-        this->block(block).compress_start(block*10 + 8273, operation);
+        this->block(block).compress_start((communication_channel*this->n_blocks() +
+                                           block)*10 + 8273, operation);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    BlockVector<Number>::compress_finish (::dealii::VectorOperation::values operation)
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (use_combined_exchange() == true)
+        {
+#ifndef DEBUG
+          if (operation == VectorOperation::insert)
+            {
+              zero_out_ghosts ();
+              return;
+            }
+#endif
+          const unsigned int n_imports = combined_exchange.import_ranks.size();
+          if (n_imports > 0)
+            {
+              const int ierr = MPI_Waitall (n_imports,
+                                            &combined_exchange.compress_requests[0],
+                                            MPI_STATUSES_IGNORE);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+
+          // add the received data to the locally owned entries of each
+          // block, walking through the import indices of the block and the
+          // import targets they belong to at the same time
+          for (unsigned int block=0; block<this->n_blocks(); ++block)
+            {
+              Vector<Number> &vec = this->block(block);
+              const Utilities::MPI::Partitioner &part = *vec.partitioner;
+              if (part.n_import_indices() == 0)
+                continue;
+
+              unsigned int target = 0, n_read = 0;
+              const Number *read_position = &combined_exchange.import_buffer
+                                            [combined_exchange.import_positions[block][0]];
+              std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+              my_imports = part.import_indices().begin();
+              for ( ; my_imports!=part.import_indices().end(); ++my_imports)
+                for (unsigned int j=my_imports->first; j<my_imports->second; ++j)
+                  {
+                    if (n_read == part.import_targets()[target].second)
+                      {
+                        ++target;
+                        n_read = 0;
+                        read_position = &combined_exchange.import_buffer
+                                        [combined_exchange.import_positions[block][target]];
+                      }
+                    ++n_read;
+                    if (operation != dealii::VectorOperation::insert)
+                      vec.val[j] += *read_position++;
+                    else
+                      {
+                        Assert(*read_position == 0. ||
+                               std::abs(vec.val[j] - *read_position) <=
+                               std::abs(vec.val[j]) * 1000. *
+                               std::numeric_limits<Number>::epsilon(),
+                               typename Vector<Number>::ExcNonMatchingElements
+                               (*read_position, vec.val[j],
+                                part.this_mpi_process()));
+                        ++read_position;
+                      }
+                  }
+            }
+
+          const unsigned int n_requests = combined_exchange.compress_requests.size();
+          if (n_requests > n_imports)
+            {
+              const int ierr = MPI_Waitall (n_requests - n_imports,
+                                            &combined_exchange.compress_requests[n_imports],
+                                            MPI_STATUSES_IGNORE);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+
+          zero_out_ghosts ();
+          return;
+        }
+#endif
+
       for (unsigned int block=0; block<this->n_blocks(); ++block)
         this->block(block).compress_finish(operation);
     }
@@ -690,16 +979,305 @@ namespace parallel
     template <typename Number>
     inline
     void
-    BlockVector<Number>::update_ghost_values () const
+    BlockVector<Number>::update_ghost_values_start (const unsigned int communication_channel) const
     {
+#ifdef DEAL_II_WITH_MPI
+      if (use_combined_exchange() == true)
+        {
+          setup_combined_exchange (communication_channel);
+
+          // copy the entries requested by other processes from all blocks
+          // into the send buffer
+          for (unsigned int block=0; block<this->n_blocks(); ++block)
+            {
+              const Vector<Number> &vec = this->block(block);
+              const Utilities::MPI::Partitioner &part = *vec.partitioner;
+              if (part.n_import_indices() == 0)
+                continue;
+
+              unsigned int target = 0, n_written = 0;
+              Number *write_position = &combined_exchange.import_buffer
+                                       [combined_exchange.import_positions[block][0]];
+              std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+              my_imports = part.import_indices().begin();
+              for ( ; my_imports!=part.import_indices().end(); ++my_imports)
+                for (unsigned int j=my_imports->first; j<my_imports->second; ++j)
+                  {
+                    if (n_written == part.import_targets()[target].second)
+                      {
+                        ++target;
+                        n_written = 0;
+                        write_position = &combined_exchange.import_buffer
+                                         [combined_exchange.import_positions[block][target]];
+                      }
+                    ++n_written;
+                    *write_position++ = vec.val[j];
+                  }
+            }
+
+          if (combined_exchange.update_ghost_values_requests.size() > 0)
+            {
+              const int ierr = MPI_Startall (combined_exchange.update_ghost_values_requests.size(),
+                                             &combined_exchange.update_ghost_values_requests[0]);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+          return;
+        }
+#endif
+
       for (unsigned int block=0; block<this->n_blocks(); ++block)
-        this->block(block).update_ghost_values_start(block*10 + 9923);
+        this->block(block).update_ghost_values_start((communication_channel*this->n_blocks() +
+                                                      block)*10 + 9923);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    BlockVector<Number>::update_ghost_values_finish () const
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (use_combined_exchange() == true)
+        {
+          // wait for both sends and receives to complete, as in
+          // Vector::update_ghost_values_finish()
+          if (combined_exchange.update_ghost_values_requests.size() > 0)
+            {
+              const int ierr = MPI_Waitall (combined_exchange.update_ghost_values_requests.size(),
+                                            &combined_exchange.update_ghost_values_requests[0],
+                                            MPI_STATUSES_IGNORE);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+
+          // copy the received data into the ghost range of each block
+          for (unsigned int block=0; block<this->n_blocks(); ++block)
+            {
+              const Vector<Number> &vec = this->block(block);
+              const Utilities::MPI::Partitioner &part = *vec.partitioner;
+              Number *ghost_entry = vec.val + part.local_size();
+              for (unsigned int i=0; i<part.ghost_targets().size(); ++i)
+                {
+                  const typename std::vector<Number>::const_iterator
+                  begin = combined_exchange.ghost_buffer.begin() +
+                          combined_exchange.ghost_positions[block][i];
+                  std::copy (begin, begin + part.ghost_targets()[i].second,
+                             ghost_entry);
+                  ghost_entry += part.ghost_targets()[i].second;
+                }
+              vec.vector_is_ghosted = true;
+            }
+          return;
+        }
+#endif
+
       for (unsigned int block=0; block<this->n_blocks(); ++block)
         this->block(block).update_ghost_values_finish();
     }
 
 
 
+#ifdef DEAL_II_WITH_MPI
+
+    template <typename Number>
+    inline
+    bool
+    BlockVector<Number>::use_combined_exchange () const
+    {
+      if (this->n_blocks() < 2 ||
+          this->block(0).partitioner->n_mpi_processes() < 2)
+        return false;
+
+      // all blocks must send their data over the same communicator and use
+      // plain point-to-point messages
+      for (unsigned int block=0; block<this->n_blocks(); ++block)
+        {
+          const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+          if (part.get_communicator() !=
+              this->block(0).partitioner->get_communicator() ||
+              part.has_neighborhood_communicator() ||
+              part.has_shared_memory_communicator())
+            return false;
+        }
+      return true;
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    BlockVector<Number>::setup_combined_exchange (const unsigned int communication_channel) const
+    {
+      // check whether the pattern has already been set up for the current
+      // partitioners of the blocks. the tags of the persistent requests
+      // depend on the communication channel, so set them up again for a
+      // different channel
+      bool same_setup = (combined_exchange.partitioners.size() ==
+                         this->n_blocks() &&
+                         combined_exchange.communication_channel ==
+                         communication_channel);
+      for (unsigned int block=0; block<this->n_blocks() && same_setup; ++block)
+        if (combined_exchange.partitioners[block].get() !=
+            this->block(block).partitioner.get())
+          same_setup = false;
+      if (same_setup == true)
+        return;
+
+      clear_combined_exchange ();
+      combined_exchange.partitioners.resize (this->n_blocks());
+      for (unsigned int block=0; block<this->n_blocks(); ++block)
+        combined_exchange.partitioners[block] = this->block(block).partitioner;
+      combined_exchange.communication_channel = communication_channel;
+
+      // collect the processes of all blocks. the targets of each partitioner
+      // are sorted by rank, so the sorted union gives each process its
+      // position in the buffers
+      std::vector<unsigned int> &ghost_ranks = combined_exchange.ghost_ranks;
+      std::vector<unsigned int> &import_ranks = combined_exchange.import_ranks;
+      ghost_ranks.clear ();
+      import_ranks.clear ();
+      for (unsigned int block=0; block<this->n_blocks(); ++block)
+        {
+          const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+          for (unsigned int i=0; i<part.ghost_targets().size(); ++i)
+            ghost_ranks.push_back (part.ghost_targets()[i].first);
+          for (unsigned int i=0; i<part.import_targets().size(); ++i)
+            import_ranks.push_back (part.import_targets()[i].first);
+        }
+      std::sort (ghost_ranks.begin(), ghost_ranks.end());
+      ghost_ranks.erase (std::unique (ghost_ranks.begin(), ghost_ranks.end()),
+                         ghost_ranks.end());
+      std::sort (import_ranks.begin(), import_ranks.end());
+      import_ranks.erase (std::unique (import_ranks.begin(), import_ranks.end()),
+                          import_ranks.end());
+
+      // lay out the data of each process block by block
+      combined_exchange.ghost_offsets.assign (ghost_ranks.size()+1, 0);
+      combined_exchange.import_offsets.assign (import_ranks.size()+1, 0);
+      combined_exchange.ghost_positions.resize (this->n_blocks());
+      combined_exchange.import_positions.resize (this->n_blocks());
+      for (unsigned int block=0; block<this->n_blocks(); ++block)
+        {
+          const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+          combined_exchange.ghost_positions[block].resize (part.ghost_targets().size());
+          combined_exchange.import_positions[block].resize (part.import_targets().size());
+        }
+      unsigned int position = 0;
+      for (unsigned int k=0; k<ghost_ranks.size(); ++k)
+        {
+          combined_exchange.ghost_offsets[k] = position;
+          for (unsigned int block=0; block<this->n_blocks(); ++block)
+            {
+              const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+              for (unsigned int i=0; i<part.ghost_targets().size(); ++i)
+                if (part.ghost_targets()[i].first == ghost_ranks[k])
+                  {
+                    combined_exchange.ghost_positions[block][i] = position;
+                    position += part.ghost_targets()[i].second;
+                  }
+            }
+        }
+      combined_exchange.ghost_offsets.back() = position;
+      combined_exchange.ghost_buffer.resize (position);
+
+      position = 0;
+      for (unsigned int k=0; k<import_ranks.size(); ++k)
+        {
+          combined_exchange.import_offsets[k] = position;
+          for (unsigned int block=0; block<this->n_blocks(); ++block)
+            {
+              const Utilities::MPI::Partitioner &part = *this->block(block).partitioner;
+              for (unsigned int i=0; i<part.import_targets().size(); ++i)
+                if (part.import_targets()[i].first == import_ranks[k])
+                  {
+                    combined_exchange.import_positions[block][i] = position;
+                    position += part.import_targets()[i].second;
+                  }
+            }
+        }
+      combined_exchange.import_offsets.back() = position;
+      combined_exchange.import_buffer.resize (position);
+
+      // set up persistent requests with one message per process, using
+      // the tags of the first block in the block-wise exchange
+      const Utilities::MPI::Partitioner &part = *this->block(0).partitioner;
+      const MPI_Comm &communicator = part.get_communicator();
+      const unsigned int n_procs = part.n_mpi_processes();
+      const unsigned int my_pid = part.this_mpi_process();
+      const unsigned int update_channel = communication_channel*this->n_blocks()*10 + 9923;
+      const unsigned int compress_channel = communication_channel*this->n_blocks()*10 + 8273;
+
+      std::vector<MPI_Request> &update_requests =
+        combined_exchange.update_ghost_values_requests;
+      update_requests.resize (ghost_ranks.size() + import_ranks.size());
+      for (unsigned int k=0; k<ghost_ranks.size(); ++k)
+        MPI_Recv_init (&combined_exchange.ghost_buffer[0] +
+                       combined_exchange.ghost_offsets[k],
+                       (combined_exchange.ghost_offsets[k+1] -
+                        combined_exchange.ghost_offsets[k]) * sizeof(Number),
+                       MPI_BYTE, ghost_ranks[k],
+                       ghost_ranks[k] + n_procs*update_channel,
+                       communicator, &update_requests[k]);
+      for (unsigned int k=0; k<import_ranks.size(); ++k)
+        MPI_Send_init (&combined_exchange.import_buffer[0] +
+                       combined_exchange.import_offsets[k],
+                       (combined_exchange.import_offsets[k+1] -
+                        combined_exchange.import_offsets[k]) * sizeof(Number),
+                       MPI_BYTE, import_ranks[k],
+                       my_pid + n_procs*update_channel,
+                       communicator, &update_requests[ghost_ranks.size()+k]);
+
+      std::vector<MPI_Request> &compress_requests =
+        combined_exchange.compress_requests;
+      compress_requests.resize (import_ranks.size() + ghost_ranks.size());
+      for (unsigned int k=0; k<import_ranks.size(); ++k)
+        MPI_Recv_init (&combined_exchange.import_buffer[0] +
+                       combined_exchange.import_offsets[k],
+                       (combined_exchange.import_offsets[k+1] -
+                        combined_exchange.import_offsets[k]) * sizeof(Number),
+                       MPI_BYTE, import_ranks[k],
+                       import_ranks[k] + n_procs*compress_channel,
+                       communicator, &compress_requests[k]);
+      for (unsigned int k=0; k<ghost_ranks.size(); ++k)
+        MPI_Send_init (&combined_exchange.ghost_buffer[0] +
+                       combined_exchange.ghost_offsets[k],
+                       (combined_exchange.ghost_offsets[k+1] -
+                        combined_exchange.ghost_offsets[k]) * sizeof(Number),
+                       MPI_BYTE, ghost_ranks[k],
+                       my_pid + n_procs*compress_channel,
+                       communicator, &compress_requests[import_ranks.size()+k]);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    BlockVector<Number>::clear_combined_exchange () const
+    {
+      // vectors that are destroyed after MPI has been finalized, e.g. static
+      // objects, cannot free their requests anymore
+      int finalized = 0;
+      MPI_Finalized (&finalized);
+      if (finalized == 0)
+        {
+          for (unsigned int i=0; i<combined_exchange.compress_requests.size(); ++i)
+            MPI_Request_free (&combined_exchange.compress_requests[i]);
+          for (unsigned int i=0; i<combined_exchange.update_ghost_values_requests.size(); ++i)
+            MPI_Request_free (&combined_exchange.update_ghost_values_requests[i]);
+        }
+      combined_exchange.compress_requests.clear ();
+      combined_exchange.update_ghost_values_requests.clear ();
+      combined_exchange.partitioners.clear ();
+    }
+
+#endif
+
+
+
     template <typename Number>
     inline
     void
@@ -53,6 +53,11 @@ namespace TrilinosWrappers
 }
 #endif
 
+namespace internal
+{
+  template <typename> class NonBlockingInnerProducts;
+}
+
 
 namespace parallel
 {
@@ -112,6 +117,23 @@ namespace parallel
      * the first initiates the communication and the second one finishes it.
      * These functions can be used to overlap communication with computations
      * in other parts of the code.
+     * <li> The data is exchanged by persistent point-to-point messages. If
+     * the partitioner has been equipped with a neighborhood communicator or a
+     * shared memory communicator (see
+     * Utilities::MPI::Partitioner::initialize_neighborhood_communicator() and
+     * Utilities::MPI::Partitioner::initialize_shared_memory_communicator()),
+     * a single neighborhood collective is used instead of the messages, and
+     * the entries of processes on the same node are accessed directly in
+     * their memory, respectively. With a shared memory communicator, the
+     * elements are stored in an MPI window that is allocated and freed
+     * collectively by all processes on the node. This makes the constructor,
+     * the destructor, reinit(), compress() and update_ghost_values() (and
+     * their split variants) collective operations on the processes of the
+     * node: all of them must create, reinitialize, and destroy their vectors
+     * in the same order, including temporary vectors, and call compress()
+     * and update_ghost_values() at the same time even if they have no ghost
+     * entries. Otherwise the program deadlocks. In debug mode, it is checked
+     * that all processes free the same window.
      * <li> Of course, reduction operations (like norms) make use of
      * collective all-to-all MPI communications.
      * </ul>
@@ -228,7 +250,9 @@ namespace parallel
       Vector (const std_cxx11::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
 
       /**
-       * Destructor.
+       * Destructor. If the partitioner has a shared memory communicator,
+       * this is a collective operation on the processes of the node, see the
+       * general documentation of this class.
        */
       ~Vector ();
 
@@ -596,6 +620,25 @@ namespace parallel
                           const Vector<Number> &V,
                           const Vector<Number> &W);
 
+      /**
+       * Add a linear combination of several vectors to this vector, i.e.,
+       * <tt>*this += a[0]*V[0] + a[1]*V[1] + ...</tt>, in a single sweep
+       * over the locally owned elements. See
+       * dealii::Vector::add_linear_combination() for details.
+       */
+      void add_linear_combination (const std::vector<Number>               &a,
+                                   const std::vector<const Vector<Number> *> &V);
+
+      /**
+       * Compute the inner products of this vector with several other
+       * vectors, i.e., <tt>results[k] = *this * *V[k]</tt>. The local
+       * contributions are computed in a single sweep over the vectors and
+       * summed over all processors with one global reduction rather than one
+       * reduction per inner product.
+       */
+      void inner_products (const std::vector<const Vector<Number> *> &V,
+                           std::vector<Number>                       &results) const;
+
       /**
        * Returns the global size of the vector, equal to the sum of the number
        * of locally owned indices among all the processors.
@@ -1081,6 +1124,12 @@ namespace parallel
                                 const Vector<Number> &V,
                                 const Vector<Number> &W);
 
+      /**
+       * Local part of the inner products with several vectors.
+       */
+      void inner_products_local (const std::vector<const Vector<Number> *> &V,
+                                 std::vector<Number>                       &results) const;
+
       /**
        * Shared pointer to store the parallel partitioning information. This
        * information can be shared between several vectors that have the same
@@ -1136,8 +1185,48 @@ namespace parallel
        * operations. This class uses persistent MPI communicators.
        */
       mutable std::vector<MPI_Request>   update_ghost_values_requests;
+
+#  if MPI_VERSION >= 3
+      /**
+       * The request of the neighborhood collective started by @p compress()
+       * or @p update_ghost_values() if the partitioner has a neighborhood
+       * communicator.
+       */
+      mutable MPI_Request neighborhood_request;
+
+      /**
+       * The MPI window holding the array @p val if the partitioner has a
+       * shared memory communicator. Only valid if @p shared_memory_values is
+       * not empty.
+       */
+      MPI_Win shared_memory_window;
+
+      /**
+       * The number of the window in @p shared_memory_window among all windows
+       * created by this process. Since windows are created collectively, the
+       * number is the same on all processes of the node as long as they
+       * create and destroy their vectors in the same order.
+       */
+      unsigned int shared_memory_window_number;
+
+      /**
+       * The partitioner on whose shared memory communicator the window in @p
+       * shared_memory_window has been allocated. Kept to check in debug mode
+       * that all processes of the node free the same window, also after the
+       * vector has been given a different partitioner.
+       */
+      std_cxx11::shared_ptr<const Utilities::MPI::Partitioner> shared_memory_partitioner;
+#  endif
 #endif
 
+      /**
+       * Pointers to the arrays @p val of all processes on the same node if
+       * the elements of this vector are stored in a shared memory window,
+       * indexed by the rank in the shared memory communicator of the
+       * partitioner. Empty otherwise.
+       */
+      std::vector<Number *> shared_memory_values;
+
       /**
        * A lock that makes sure that the @p compress and @p
        * update_ghost_values functions give reasonable results also when used
@@ -1152,9 +1241,20 @@ namespace parallel
       void clear_mpi_requests ();
 
       /**
-       * A helper function that is used to resize the val array.
+       * A helper function that is used to resize the val array. If @p
+       * use_shared_memory is true, the array is allocated in a shared memory
+       * window on the shared memory communicator of the partitioner, which
+       * is a collective operation.
        */
-      void resize_val (const size_type new_allocated_size);
+      void resize_val (const size_type new_allocated_size,
+                       const bool      use_shared_memory = false);
+
+      /**
+       * Makes the elements written by all processes on the same node visible
+       * to each other if the elements are stored in a shared memory window.
+       * Collective on the processes of the node.
+       */
+      void synchronize_shared_memory () const;
 
       /*
        * Make all other vector types friends.
@@ -1165,6 +1265,12 @@ namespace parallel
        * Make BlockVector type friends.
        */
       template <typename Number2> friend class BlockVector;
+
+      /**
+       * Make the class computing non-blocking inner products a friend, such
+       * that it can access the local inner products.
+       */
+      template <typename VECTOR> friend class dealii::internal::NonBlockingInnerProducts;
     };
 
     /*@}*/
@@ -1710,6 +1816,70 @@ namespace parallel
 
 
 
+    template <typename Number>
+    inline
+    void
+    Vector<Number>::add_linear_combination (const std::vector<Number>               &a,
+                                            const std::vector<const Vector<Number> *> &V)
+    {
+      AssertDimension (a.size(), V.size());
+
+      // dealii::Vector does not allow empty fields but this might happen on
+      // some processors for parallel implementation
+      if (local_size())
+        {
+          std::vector<const dealii::Vector<Number> *> views (V.size());
+          for (unsigned int k=0; k<V.size(); ++k)
+            {
+              AssertDimension (local_size(), V[k]->local_size());
+              views[k] = &V[k]->vector_view;
+            }
+          vector_view.add_linear_combination (a, views);
+        }
+
+      if (vector_is_ghosted)
+        update_ghost_values();
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    Vector<Number>::inner_products_local (const std::vector<const Vector<Number> *> &V,
+                                          std::vector<Number>                       &results) const
+    {
+      // on some processors, the size might be zero, which is not allowed by
+      // the dealii::Vector class. Therefore, insert a check here
+      if (partitioner->local_size()>0)
+        {
+          std::vector<const dealii::Vector<Number> *> views (V.size());
+          for (unsigned int k=0; k<V.size(); ++k)
+            {
+              AssertDimension (local_size(), V[k]->local_size());
+              views[k] = &V[k]->vector_view;
+            }
+          vector_view.inner_products (views, results);
+        }
+      else
+        results.assign (V.size(), Number());
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    Vector<Number>::inner_products (const std::vector<const Vector<Number> *> &V,
+                                    std::vector<Number>                       &results) const
+    {
+      inner_products_local (V, results);
+      if (partitioner->n_mpi_processes() > 1 && results.size() > 0)
+        Utilities::MPI::sum (results, partitioner->get_communicator(), results);
+    }
+
+
+
     template <typename Number>
     inline
     typename Vector<Number>::size_type
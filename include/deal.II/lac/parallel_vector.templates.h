@@ -24,6 +24,8 @@
 #include <deal.II/lac/petsc_parallel_vector.h>
 #include <deal.II/lac/trilinos_vector.h>
 
+#include <algorithm>
+
 DEAL_II_NAMESPACE_OPEN
 
 
@@ -31,6 +33,49 @@ namespace parallel
 {
   namespace distributed
   {
+    namespace internal
+    {
+      // returns the number of targets whose data is exchanged by messages,
+      // i.e., that are not on the same node if the data of processes on the
+      // same node is exchanged through shared memory
+      inline
+      unsigned int
+      n_message_targets (const std::vector<std::pair<unsigned int,unsigned int> > &targets,
+                         const std::vector<unsigned int>                          &shared_memory_ranks)
+      {
+        if (shared_memory_ranks.size() == 0)
+          return targets.size();
+        return std::count (shared_memory_ranks.begin(), shared_memory_ranks.end(),
+                           numbers::invalid_unsigned_int);
+      }
+
+      // returns a pointer to the first element of the array, or to a dummy
+      // element if the array is empty. the arrays of the neighborhood
+      // collective are empty on processes without neighbors, which still
+      // have to take part in the collective
+      inline
+      const int *
+      first_element (const std::vector<int> &array)
+      {
+        static const int dummy = 0;
+        return array.empty() ? &dummy : &array[0];
+      }
+
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      // returns a new number for a shared memory window. the windows are
+      // created collectively, so all processes of a node get the same
+      // number for the same window
+      inline
+      unsigned int
+      next_shared_memory_window_number ()
+      {
+        static unsigned int n_windows = 0;
+        return n_windows++;
+      }
+#endif
+    }
+
+
 
     template <typename Number>
     void
@@ -50,8 +95,84 @@ namespace parallel
 
     template <typename Number>
     void
-    Vector<Number>::resize_val (const size_type new_alloc_size)
+    Vector<Number>::resize_val (const size_type new_alloc_size,
+                                const bool      use_shared_memory)
     {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      // memory in a shared memory window is allocated and freed collectively
+      // by all processes on the node, so never keep an old window around
+      // even if it would be large enough
+      if (shared_memory_values.size() > 0)
+        {
+          int finalized = 0;
+          MPI_Finalized (&finalized);
+          if (finalized == 0)
+            {
+#ifdef DEBUG
+              // freeing the window is collective on the node. if a vector is
+              // destroyed or reinitialized on only some of the processes,
+              // the processes would free different windows (or wait
+              // forever), so check that all free the same one
+              const MPI_Comm &comm =
+                shared_memory_partitioner->get_shared_memory_communicator();
+              AssertNothrow (Utilities::MPI::min (shared_memory_window_number, comm) ==
+                             Utilities::MPI::max (shared_memory_window_number, comm),
+                             ExcMessage ("Vectors with elements in shared memory must "
+                                         "be created, reinitialized, and destroyed "
+                                         "on all processes of a node in the same "
+                                         "order."));
+#endif
+              MPI_Win_unlock_all (shared_memory_window);
+              MPI_Win_free (&shared_memory_window);
+            }
+          shared_memory_values.clear ();
+          shared_memory_partitioner.reset ();
+          val = 0;
+          allocated_size = 0;
+        }
+
+      if (use_shared_memory == true)
+        {
+          Assert (partitioner->has_shared_memory_communicator(),
+                  ExcInternalError());
+          const MPI_Comm &comm = partitioner->get_shared_memory_communicator();
+
+          // let MPI place the part of each process in memory close to that
+          // process rather than in one contiguous chunk
+          MPI_Info info;
+          MPI_Info_create (&info);
+          MPI_Info_set (info, const_cast<char *>("alloc_shared_noncontig"),
+                        const_cast<char *>("true"));
+          int ierr = MPI_Win_allocate_shared (new_alloc_size*sizeof(Number),
+                                              sizeof(Number), info, comm,
+                                              &val, &shared_memory_window);
+          AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+          MPI_Info_free (&info);
+
+          int n_node_procs = 0;
+          MPI_Comm_size (comm, &n_node_procs);
+          shared_memory_values.resize (n_node_procs);
+          for (int p=0; p<n_node_procs; ++p)
+            {
+              MPI_Aint size = 0;
+              int disp_unit = 0;
+              ierr = MPI_Win_shared_query (shared_memory_window, p, &size,
+                                           &disp_unit, &shared_memory_values[p]);
+              AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+
+          // open a passive target epoch for the whole lifetime of the window,
+          // such that the processes can synchronize by MPI_Win_sync
+          MPI_Win_lock_all (MPI_MODE_NOCHECK, shared_memory_window);
+          shared_memory_window_number = internal::next_shared_memory_window_number ();
+          shared_memory_partitioner = partitioner;
+          allocated_size = new_alloc_size;
+          return;
+        }
+#else
+      (void)use_shared_memory;
+#endif
+
       if (new_alloc_size > allocated_size)
         {
           Assert (((allocated_size > 0 && val != 0) ||
@@ -74,6 +195,29 @@ namespace parallel
 
 
 
+    template <typename Number>
+    void
+    Vector<Number>::synchronize_shared_memory () const
+    {
+      Assert (partitioner->has_shared_memory_communicator() ==
+              (shared_memory_values.size() > 0), ExcInternalError());
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (shared_memory_values.size() > 0)
+        {
+          // make our own stores visible in the window, wait for the others
+          // to do the same, and make their stores visible to us
+          MPI_Win_sync (shared_memory_window);
+          const int ierr =
+            MPI_Barrier (partitioner->get_shared_memory_communicator());
+          (void)ierr;
+          Assert (ierr == MPI_SUCCESS, ExcInternalError());
+          MPI_Win_sync (shared_memory_window);
+        }
+#endif
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::reinit (const size_type size,
@@ -121,7 +265,8 @@ namespace parallel
           partitioner = v.partitioner;
           const size_type new_allocated_size = partitioner->local_size() +
                                                partitioner->n_ghost_indices();
-          resize_val (new_allocated_size);
+          resize_val (new_allocated_size,
+                      partitioner->has_shared_memory_communicator());
           vector_view.reinit (partitioner->local_size(), val);
         }
       else
@@ -186,7 +331,8 @@ namespace parallel
       // set vector size and allocate memory
       const size_type new_allocated_size = partitioner->local_size() +
                                            partitioner->n_ghost_indices();
-      resize_val (new_allocated_size);
+      resize_val (new_allocated_size,
+                  partitioner->has_shared_memory_communicator());
       vector_view.reinit (partitioner->local_size(), val);
 
       // initialize to zero
@@ -352,9 +498,17 @@ namespace parallel
 
       const Utilities::MPI::Partitioner &part = *partitioner;
 
-      // nothing to do when we neither have import
-      // nor ghost indices.
-      if (part.n_ghost_indices()==0 && part.n_import_indices()==0)
+      // the owners on the same node read our ghost entries directly from
+      // our memory in compress_finish(), so make them visible
+      synchronize_shared_memory ();
+#if MPI_VERSION >= 3
+      neighborhood_request = MPI_REQUEST_NULL;
+#endif
+
+      // nothing to do when we neither have import nor ghost indices, except
+      // for taking part in the neighborhood collective
+      if (part.n_ghost_indices()==0 && part.n_import_indices()==0 &&
+          part.has_neighborhood_communicator() == false)
         return;
 
       // make this function thread safe
@@ -362,30 +516,65 @@ namespace parallel
 
       const unsigned int n_import_targets = part.import_targets().size();
       const unsigned int n_ghost_targets  = part.ghost_targets().size();
+      const std::vector<unsigned int> &import_ranks =
+        part.import_targets_shared_memory_rank();
+      const std::vector<unsigned int> &ghost_ranks =
+        part.ghost_targets_shared_memory_rank();
+
+      // allocate import_data in case it is not set up yet
+      if (import_data == 0)
+        import_data = new Number[part.n_import_indices()];
+
+#if MPI_VERSION >= 3
+      // with a neighborhood communicator, all data is sent by a single
+      // collective, with the roles of ghosts and imports swapped compared to
+      // update_ghost_values(). the collective must be called by all
+      // processes of the communicator, including those without neighbors
+      if (part.has_neighborhood_communicator())
+        {
+          const MPI_Datatype type = Utilities::MPI::internal::mpi_type_id (val);
+          const int ierr =
+            MPI_Ineighbor_alltoallv (val + part.local_size(),
+                                     internal::first_element (part.neighborhood_ghost_counts()),
+                                     internal::first_element (part.neighborhood_ghost_offsets()),
+                                     type, import_data,
+                                     internal::first_element (part.neighborhood_import_counts()),
+                                     internal::first_element (part.neighborhood_import_offsets()),
+                                     type,
+                                     part.get_neighborhood_communicator(),
+                                     &neighborhood_request);
+          (void)ierr;
+          Assert (ierr == MPI_SUCCESS, ExcInternalError());
+          return;
+        }
+#endif
 
       // Need to send and receive the data. Use non-blocking communication,
       // where it is generally less overhead to first initiate the receive and
-      // then actually send the data
+      // then actually send the data. Processes on the same node exchange
+      // their data through shared memory and do not get a message
       if (compress_requests.size() == 0)
         {
           // set channels in different range from update_ghost_values channels
           const unsigned int channel = counter + 400;
           unsigned int current_index_start = 0;
-          compress_requests.resize (n_import_targets + n_ghost_targets);
+          compress_requests.reserve (n_import_targets + n_ghost_targets);
 
-          // allocate import_data in case it is not set up yet
-          if (import_data == 0)
-            import_data = new Number[part.n_import_indices()];
           for (unsigned int i=0; i<n_import_targets; i++)
             {
-              MPI_Recv_init (&import_data[current_index_start],
-                             part.import_targets()[i].second*sizeof(Number),
-                             MPI_BYTE,
-                             part.import_targets()[i].first,
-                             part.import_targets()[i].first +
-                             part.n_mpi_processes()*channel,
-                             part.get_communicator(),
-                             &compress_requests[i]);
+              if (import_ranks.size() == 0 ||
+                  import_ranks[i] == numbers::invalid_unsigned_int)
+                {
+                  compress_requests.push_back (MPI_Request());
+                  MPI_Recv_init (&import_data[current_index_start],
+                                 part.import_targets()[i].second*sizeof(Number),
+                                 MPI_BYTE,
+                                 part.import_targets()[i].first,
+                                 part.import_targets()[i].first +
+                                 part.n_mpi_processes()*channel,
+                                 part.get_communicator(),
+                                 &compress_requests.back());
+                }
               current_index_start += part.import_targets()[i].second;
             }
           AssertDimension(current_index_start, part.n_import_indices());
@@ -394,21 +583,29 @@ namespace parallel
           current_index_start = part.local_size();
           for (unsigned int i=0; i<n_ghost_targets; i++)
             {
-              MPI_Send_init (&this->val[current_index_start],
-                             part.ghost_targets()[i].second*sizeof(Number),
-                             MPI_BYTE,
-                             part.ghost_targets()[i].first,
-                             part.this_mpi_process() +
-                             part.n_mpi_processes()*channel,
-                             part.get_communicator(),
-                             &compress_requests[n_import_targets+i]);
+              if (ghost_ranks.size() == 0 ||
+                  ghost_ranks[i] == numbers::invalid_unsigned_int)
+                {
+                  compress_requests.push_back (MPI_Request());
+                  MPI_Send_init (&this->val[current_index_start],
+                                 part.ghost_targets()[i].second*sizeof(Number),
+                                 MPI_BYTE,
+                                 part.ghost_targets()[i].first,
+                                 part.this_mpi_process() +
+                                 part.n_mpi_processes()*channel,
+                                 part.get_communicator(),
+                                 &compress_requests.back());
+                }
               current_index_start += part.ghost_targets()[i].second;
             }
           AssertDimension (current_index_start,
                            part.local_size()+part.n_ghost_indices());
         }
 
-      AssertDimension(n_import_targets + n_ghost_targets,
+      AssertDimension(internal::n_message_targets (part.import_targets(),
+                                                   import_ranks) +
+                      internal::n_message_targets (part.ghost_targets(),
+                                                   ghost_ranks),
                       compress_requests.size());
       if (compress_requests.size() > 0)
         {
@@ -439,28 +636,53 @@ namespace parallel
 
       const Utilities::MPI::Partitioner &part = *partitioner;
 
-      // nothing to do when we neither have import nor ghost indices.
-      if (part.n_ghost_indices()==0 && part.n_import_indices()==0)
-        return;
+      // nothing to do when we neither have import nor ghost indices, except
+      // for taking part in the synchronization of the node (and finishing
+      // the neighborhood collective below)
+      if (part.n_ghost_indices()==0 && part.n_import_indices()==0 &&
+          part.has_neighborhood_communicator() == false)
+        {
+          synchronize_shared_memory ();
+          return;
+        }
 
       // make this function thread safe
       Threads::Mutex::ScopedLock lock (mutex);
 
       const unsigned int n_import_targets = part.import_targets().size();
-      const unsigned int n_ghost_targets  = part.ghost_targets().size();
-
-      if (operation != dealii::VectorOperation::insert)
-        AssertDimension (n_ghost_targets+n_import_targets,
-                         compress_requests.size());
+      const std::vector<unsigned int> &import_ranks =
+        part.import_targets_shared_memory_rank();
+      const unsigned int n_import_messages =
+        internal::n_message_targets (part.import_targets(), import_ranks);
+      const unsigned int n_ghost_messages =
+        internal::n_message_targets (part.ghost_targets(),
+                                     part.ghost_targets_shared_memory_rank());
 
       // first wait for the receive to complete
-      if (compress_requests.size() > 0 && n_import_targets > 0)
+#if MPI_VERSION >= 3
+      if (part.has_neighborhood_communicator())
         {
-          int ierr = MPI_Waitall (n_import_targets, &compress_requests[0],
-                                  MPI_STATUSES_IGNORE);
+          int ierr = MPI_Wait (&neighborhood_request, MPI_STATUS_IGNORE);
           (void)ierr;
           Assert (ierr == MPI_SUCCESS, ExcInternalError());
+        }
+      else
+#endif
+        {
+          if (operation != dealii::VectorOperation::insert)
+            AssertDimension (n_ghost_messages+n_import_messages,
+                             compress_requests.size());
+          if (compress_requests.size() > 0 && n_import_messages > 0)
+            {
+              int ierr = MPI_Waitall (n_import_messages, &compress_requests[0],
+                                      MPI_STATUSES_IGNORE);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+        }
 
+      if (n_import_targets > 0 && import_ranks.size() == 0)
+        {
           Number *read_position = import_data;
           std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
           my_imports = part.import_indices().begin();
@@ -485,17 +707,55 @@ namespace parallel
                                               part.this_mpi_process()));
           AssertDimension(read_position-import_data,part.n_import_indices());
         }
+      else if (n_import_targets > 0)
+        {
+          // same as above, but the contributions of processes on the same
+          // node are read directly from the ghost range of their vector
+          std::vector<const Number *> sources (n_import_targets);
+          for (unsigned int i=0, offset=0; i<n_import_targets;
+               offset += part.import_targets()[i].second, ++i)
+            sources[i] = (import_ranks[i] == numbers::invalid_unsigned_int ?
+                          import_data + offset :
+                          shared_memory_values[import_ranks[i]] +
+                          part.shared_memory_import_offsets()[i]);
+
+          unsigned int target = 0, n_read = 0;
+          std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+          my_imports = part.import_indices().begin();
+          for ( ; my_imports!=part.import_indices().end(); ++my_imports)
+            for (unsigned int j=my_imports->first; j<my_imports->second; j++)
+              {
+                if (n_read == part.import_targets()[target].second)
+                  {
+                    ++target;
+                    n_read = 0;
+                  }
+                const Number value = sources[target][n_read++];
+                if (operation != dealii::VectorOperation::insert)
+                  local_element(j) += value;
+                else
+                  Assert(value == 0. ||
+                         std::abs(local_element(j) - value) <=
+                         std::abs(local_element(j)) * 1000. *
+                         std::numeric_limits<Number>::epsilon(),
+                         ExcNonMatchingElements(value, local_element(j),
+                                                part.this_mpi_process()));
+              }
+          AssertDimension (target+1, n_import_targets);
+        }
 
-      if (compress_requests.size() > 0 && n_ghost_targets > 0)
+      if (compress_requests.size() > 0 && n_ghost_messages > 0)
         {
-          int ierr = MPI_Waitall (n_ghost_targets,
-                                  &compress_requests[n_import_targets],
+          int ierr = MPI_Waitall (n_ghost_messages,
+                                  &compress_requests[n_import_messages],
                                   MPI_STATUSES_IGNORE);
           (void)ierr;
           Assert (ierr == MPI_SUCCESS, ExcInternalError());
         }
-      else
-        AssertDimension (part.n_ghost_indices(), 0);
+
+      // the owners on the same node must have read our ghost entries before
+      // we can clear them
+      synchronize_shared_memory ();
 
       zero_out_ghosts ();
 #else
@@ -512,8 +772,17 @@ namespace parallel
 #ifdef DEAL_II_WITH_MPI
       const Utilities::MPI::Partitioner &part = *partitioner;
 
-      // nothing to do when we neither have import nor ghost indices.
-      if (part.n_ghost_indices()==0 && part.n_import_indices()==0)
+      // the processes on the same node read our locally owned entries
+      // directly from our memory, so make them visible
+      synchronize_shared_memory ();
+#if MPI_VERSION >= 3
+      neighborhood_request = MPI_REQUEST_NULL;
+#endif
+
+      // nothing to do when we neither have import nor ghost indices, except
+      // for taking part in the neighborhood collective
+      if (part.n_ghost_indices()==0 && part.n_import_indices()==0 &&
+          part.has_neighborhood_communicator() == false)
         return;
 
       // make this function thread safe
@@ -521,72 +790,157 @@ namespace parallel
 
       const unsigned int n_import_targets = part.import_targets().size();
       const unsigned int n_ghost_targets = part.ghost_targets().size();
+      const std::vector<unsigned int> &import_ranks =
+        part.import_targets_shared_memory_rank();
+      const std::vector<unsigned int> &ghost_ranks =
+        part.ghost_targets_shared_memory_rank();
 
-      // Need to send and receive the data. Use non-blocking communication,
-      // where it is generally less overhead to first initiate the receive and
-      // then actually send the data
-      if (update_ghost_values_requests.size() == 0)
-        {
-          Assert (part.local_size() == vector_view.size(),
-                  ExcInternalError());
-          size_type current_index_start = part.local_size();
-          update_ghost_values_requests.resize (n_import_targets+n_ghost_targets);
-          for (unsigned int i=0; i<n_ghost_targets; i++)
-            {
-              // allow writing into ghost indices even though we are in a
-              // const function
-              MPI_Recv_init (const_cast<Number *>(&val[current_index_start]),
-                             part.ghost_targets()[i].second*sizeof(Number),
-                             MPI_BYTE,
-                             part.ghost_targets()[i].first,
-                             part.ghost_targets()[i].first +
-                             counter*part.n_mpi_processes(),
-                             part.get_communicator(),
-                             &update_ghost_values_requests[i]);
-              current_index_start += part.ghost_targets()[i].second;
-            }
-          AssertDimension (current_index_start,
-                           part.local_size()+part.n_ghost_indices());
-
-          // allocate import_data in case it is not set up yet
-          if (import_data == 0 && part.n_import_indices() > 0)
-            import_data = new Number[part.n_import_indices()];
-          current_index_start = 0;
-          for (unsigned int i=0; i<n_import_targets; i++)
-            {
-              MPI_Send_init (&import_data[current_index_start],
-                             part.import_targets()[i].second*sizeof(Number),
-                             MPI_BYTE, part.import_targets()[i].first,
-                             part.this_mpi_process() +
-                             part.n_mpi_processes()*counter,
-                             part.get_communicator(),
-                             &update_ghost_values_requests[n_ghost_targets+i]);
-              current_index_start += part.import_targets()[i].second;
-            }
-          AssertDimension (current_index_start, part.n_import_indices());
-        }
+      // allocate import_data in case it is not set up yet
+      if (import_data == 0 && part.n_import_indices() > 0)
+        import_data = new Number[part.n_import_indices()];
 
-      // copy the data that is actually to be send to the import_data field
+      // copy the data that is actually to be send to the import_data field,
+      // leaving out the processes on the same node
       if (part.n_import_indices() > 0)
         {
           Assert (import_data != 0, ExcInternalError());
           Number *write_position = import_data;
           std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
           my_imports = part.import_indices().begin();
-          for ( ; my_imports!=part.import_indices().end(); ++my_imports)
-            for (unsigned int j=my_imports->first; j<my_imports->second; j++)
-              *write_position++ = local_element(j);
+          if (import_ranks.size() == 0)
+            for ( ; my_imports!=part.import_indices().end(); ++my_imports)
+              for (unsigned int j=my_imports->first; j<my_imports->second; j++)
+                *write_position++ = local_element(j);
+          else
+            {
+              unsigned int target = 0, n_written = 0;
+              for ( ; my_imports!=part.import_indices().end(); ++my_imports)
+                for (unsigned int j=my_imports->first; j<my_imports->second;
+                     j++, write_position++, n_written++)
+                  {
+                    if (n_written == part.import_targets()[target].second)
+                      {
+                        ++target;
+                        n_written = 0;
+                      }
+                    if (import_ranks[target] == numbers::invalid_unsigned_int)
+                      *write_position = local_element(j);
+                  }
+            }
         }
 
-      AssertDimension (n_import_targets+n_ghost_targets,
-                       update_ghost_values_requests.size());
-      if (update_ghost_values_requests.size() > 0)
+#if MPI_VERSION >= 3
+      if (part.has_neighborhood_communicator())
         {
-          int ierr = MPI_Startall(update_ghost_values_requests.size(),
-                                  &update_ghost_values_requests[0]);
+          // the collective must be called by all processes of the
+          // communicator, including those without neighbors
+          const MPI_Datatype type = Utilities::MPI::internal::mpi_type_id (val);
+          const int ierr =
+            MPI_Ineighbor_alltoallv (import_data,
+                                     internal::first_element (part.neighborhood_import_counts()),
+                                     internal::first_element (part.neighborhood_import_offsets()),
+                                     type,
+                                     const_cast<Number *>(val + part.local_size()),
+                                     internal::first_element (part.neighborhood_ghost_counts()),
+                                     internal::first_element (part.neighborhood_ghost_offsets()),
+                                     type,
+                                     part.get_neighborhood_communicator(),
+                                     &neighborhood_request);
           (void)ierr;
           Assert (ierr == MPI_SUCCESS, ExcInternalError());
         }
+      else
+#endif
+        {
+          // Need to send and receive the data. Use non-blocking
+          // communication, where it is generally less overhead to first
+          // initiate the receive and then actually send the data
+          if (update_ghost_values_requests.size() == 0)
+            {
+              Assert (part.local_size() == vector_view.size(),
+                      ExcInternalError());
+              size_type current_index_start = part.local_size();
+              update_ghost_values_requests.reserve (n_import_targets+n_ghost_targets);
+              for (unsigned int i=0; i<n_ghost_targets; i++)
+                {
+                  // allow writing into ghost indices even though we are in a
+                  // const function
+                  if (ghost_ranks.size() == 0 ||
+                      ghost_ranks[i] == numbers::invalid_unsigned_int)
+                    {
+                      update_ghost_values_requests.push_back (MPI_Request());
+                      MPI_Recv_init (const_cast<Number *>(&val[current_index_start]),
+                                     part.ghost_targets()[i].second*sizeof(Number),
+                                     MPI_BYTE,
+                                     part.ghost_targets()[i].first,
+                                     part.ghost_targets()[i].first +
+                                     counter*part.n_mpi_processes(),
+                                     part.get_communicator(),
+                                     &update_ghost_values_requests.back());
+                    }
+                  current_index_start += part.ghost_targets()[i].second;
+                }
+              AssertDimension (current_index_start,
+                               part.local_size()+part.n_ghost_indices());
+
+              current_index_start = 0;
+              for (unsigned int i=0; i<n_import_targets; i++)
+                {
+                  if (import_ranks.size() == 0 ||
+                      import_ranks[i] == numbers::invalid_unsigned_int)
+                    {
+                      update_ghost_values_requests.push_back (MPI_Request());
+                      MPI_Send_init (&import_data[current_index_start],
+                                     part.import_targets()[i].second*sizeof(Number),
+                                     MPI_BYTE, part.import_targets()[i].first,
+                                     part.this_mpi_process() +
+                                     part.n_mpi_processes()*counter,
+                                     part.get_communicator(),
+                                     &update_ghost_values_requests.back());
+                    }
+                  current_index_start += part.import_targets()[i].second;
+                }
+              AssertDimension (current_index_start, part.n_import_indices());
+            }
+
+          AssertDimension (internal::n_message_targets (part.import_targets(),
+                                                        import_ranks) +
+                           internal::n_message_targets (part.ghost_targets(),
+                                                        ghost_ranks),
+                           update_ghost_values_requests.size());
+          if (update_ghost_values_requests.size() > 0)
+            {
+              int ierr = MPI_Startall(update_ghost_values_requests.size(),
+                                      &update_ghost_values_requests[0]);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+        }
+
+      // read the ghost entries owned by processes on the same node directly
+      // from their memory. the ranges of different processes are stored
+      // separately, so each process ends exactly at the end of a range
+      if (ghost_ranks.size() > 0)
+        {
+          std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+          indices = part.shared_memory_ghost_indices().begin();
+          Number *ghost_entry = const_cast<Number *>(val) + part.local_size();
+          for (unsigned int i=0; i<n_ghost_targets; i++)
+            {
+              if (ghost_ranks[i] == numbers::invalid_unsigned_int)
+                {
+                  ghost_entry += part.ghost_targets()[i].second;
+                  continue;
+                }
+
+              const Number *owner_values = shared_memory_values[ghost_ranks[i]];
+              for (unsigned int n=0; n<part.ghost_targets()[i].second; ++indices)
+                for (unsigned int j=indices->first; j<indices->second; ++j, ++n)
+                  *ghost_entry++ = owner_values[j];
+            }
+          Assert (indices == part.shared_memory_ghost_indices().end(),
+                  ExcInternalError());
+        }
 #else
       (void)counter;
 #endif
@@ -599,22 +953,45 @@ namespace parallel
     Vector<Number>::update_ghost_values_finish () const
     {
 #ifdef DEAL_II_WITH_MPI
-      // wait for both sends and receives to complete, even though only
-      // receives are really necessary. this gives (much) better performance
-      AssertDimension (partitioner->ghost_targets().size() +
-                       partitioner->import_targets().size(),
-                       update_ghost_values_requests.size());
-      if (update_ghost_values_requests.size() > 0)
+#if MPI_VERSION >= 3
+      if (partitioner->has_neighborhood_communicator())
         {
           // make this function thread safe
           Threads::Mutex::ScopedLock lock (mutex);
 
-          int ierr = MPI_Waitall (update_ghost_values_requests.size(),
-                                  &update_ghost_values_requests[0],
-                                  MPI_STATUSES_IGNORE);
+          int ierr = MPI_Wait (&neighborhood_request, MPI_STATUS_IGNORE);
           (void)ierr;
           Assert (ierr == MPI_SUCCESS, ExcInternalError());
         }
+      else
+#endif
+        {
+          // wait for both sends and receives to complete, even though only
+          // receives are really necessary. this gives (much) better
+          // performance
+          AssertDimension (internal::n_message_targets
+                           (partitioner->ghost_targets(),
+                            partitioner->ghost_targets_shared_memory_rank()) +
+                           internal::n_message_targets
+                           (partitioner->import_targets(),
+                            partitioner->import_targets_shared_memory_rank()),
+                           update_ghost_values_requests.size());
+          if (update_ghost_values_requests.size() > 0)
+            {
+              // make this function thread safe
+              Threads::Mutex::ScopedLock lock (mutex);
+
+              int ierr = MPI_Waitall (update_ghost_values_requests.size(),
+                                      &update_ghost_values_requests[0],
+                                      MPI_STATUSES_IGNORE);
+              (void)ierr;
+              Assert (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+        }
+
+      // the processes on the same node must have read our locally owned
+      // entries before we are allowed to change them again
+      synchronize_shared_memory ();
 #endif
       vector_is_ghosted = true;
     }
@@ -657,7 +1034,13 @@ namespace parallel
 
       std::swap (compress_requests, v.compress_requests);
       std::swap (update_ghost_values_requests, v.update_ghost_values_requests);
+#  if MPI_VERSION >= 3
+      std::swap (shared_memory_window, v.shared_memory_window);
+#  endif
 #endif
+      std::swap (shared_memory_values, v.shared_memory_values);
+      std::swap (shared_memory_window_number, v.shared_memory_window_number);
+      std::swap (shared_memory_partitioner, v.shared_memory_partitioner);
 
       std::swap (partitioner,       v.partitioner);
       std::swap (allocated_size,    v.allocated_size);
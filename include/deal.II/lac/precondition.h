@@ -23,6 +23,10 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/template_constraints.h>
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/base/std_cxx11/function.h>
 #include <deal.II/lac/tridiagonal_matrix.h>
 #include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/vector_memory.h>
@@ -598,6 +602,36 @@ public:
  * solver.solve (A, x, b, precondition);
  * @endcode
  *
+ * <h3>Parallel SSOR</h3>
+ *
+ * The standard SSOR method visits the rows in the order of their indices,
+ * and each row depends on the result of the previous rows, so it runs on a
+ * single core. For SparseMatrix objects, AdditionalData::ordering selects
+ * one of two variants that can use several threads:
+ * <ul>
+ * <li> AdditionalData::multicolor computes a coloring of the rows in
+ * initialize() by GraphColoring::make_graph_coloring() such that no two
+ * rows of the same color are coupled by a matrix entry. The SSOR sweeps then
+ * visit the colors one after the other and all rows of one color in
+ * parallel. This is the SSOR method for the matrix renumbered by colors,
+ * which usually needs a few more iterations than the lexicographic ordering
+ * when used in a Krylov solver but gives the same result for any number of
+ * threads. The sparsity pattern needs to be structurally symmetric. Note
+ * that computing the coloring is considerably more expensive than a matrix
+ * vector product, so this option pays off when the preconditioner is
+ * applied many times, like in a multigrid smoother.
+ * <li> AdditionalData::block_jacobi splits the rows into
+ * AdditionalData::n_blocks contiguous blocks of about equal size and applies
+ * SSOR to each block while ignoring the entries coupling different blocks,
+ * i.e., a block Jacobi method with SSOR on the blocks. The blocks are worked
+ * on in parallel, and each block is small enough to stay in cache for the
+ * backward sweep right after the forward sweep if there are enough blocks.
+ * The quality of the preconditioner deteriorates slowly with the number of
+ * blocks.
+ * </ul>
+ * In both cases, step() and Tstep() compute the residual and add the result
+ * of vmult() applied to it rather than updating the vector in place.
+ *
  * @author Guido Kanschat, 2000
  */
 template <class MATRIX = SparseMatrix<double> >
@@ -614,14 +648,70 @@ public:
    */
   typedef PreconditionRelaxation<MATRIX> BaseClass;
 
+  /**
+   * Parameters for the SSOR method, adding the choice of the ordering of
+   * the rows to the relaxation parameter.
+   */
+  class AdditionalData : public BaseClass::AdditionalData
+  {
+  public:
+    /**
+     * The order in which the rows are visited, see the general documentation
+     * of this class.
+     */
+    enum Ordering
+    {
+      /**
+       * Visit the rows in the order of their indices on a single thread.
+       */
+      lexicographic,
+      /**
+       * Visit the rows color by color, with all rows of one color processed
+       * in parallel.
+       */
+      multicolor,
+      /**
+       * Apply SSOR independently to contiguous blocks of rows in parallel.
+       */
+      block_jacobi
+    };
+
+    /**
+     * Constructor. A value of zero for @p n_blocks selects as many blocks as
+     * there are threads, see MultithreadInfo::n_threads(). Since the result
+     * of the block Jacobi method depends on the number of blocks, set this
+     * value explicitly if the results need to be reproducible on different
+     * machines.
+     */
+    AdditionalData (const double       relaxation = 1.,
+                    const Ordering     ordering = lexicographic,
+                    const unsigned int n_blocks = 0);
+
+    /**
+     * The order in which the rows are visited.
+     */
+    Ordering ordering;
+
+    /**
+     * Number of blocks for the block Jacobi variant.
+     */
+    unsigned int n_blocks;
+  };
+
+  /**
+   * Constructor.
+   */
+  PreconditionSSOR ();
 
   /**
    * Initialize matrix and relaxation parameter. The matrix is just stored in
    * the preconditioner object. The relaxation parameter should be larger than
-   * zero and smaller than 2 for numerical reasons. It defaults to 1.
+   * zero and smaller than 2 for numerical reasons. It defaults to 1. The
+   * orderings other than AdditionalData::lexicographic are only available
+   * for SparseMatrix objects.
    */
   void initialize (const MATRIX &A,
-                   const typename BaseClass::AdditionalData &parameters = typename BaseClass::AdditionalData());
+                   const AdditionalData &parameters = AdditionalData());
 
   /**
    * Apply preconditioner.
@@ -655,6 +745,50 @@ private:
    * the diagonal is located.
    */
   std::vector<std::size_t> pos_right_of_diagonal;
+
+  /**
+   * Apply the multicolor or the block Jacobi variant of the preconditioner.
+   */
+  template <typename somenumber>
+  void vmult_parallel (Vector<somenumber>       &dst,
+                       const Vector<somenumber> &src) const;
+
+  /**
+   * The same function for all other vector types, for which the parallel
+   * variants are not implemented.
+   */
+  template <class VECTOR>
+  void vmult_parallel (VECTOR       &dst,
+                       const VECTOR &src) const;
+
+  /**
+   * The order in which the rows are visited.
+   */
+  typename AdditionalData::Ordering ordering;
+
+  /**
+   * For the multicolor ordering, the color of each row.
+   */
+  std::vector<unsigned int> row_colors;
+
+  /**
+   * For the multicolor ordering, the rows sorted by color. The rows of color
+   * <tt>c</tt> are stored in the positions <tt>color_start[c]</tt> to
+   * <tt>color_start[c+1]-1</tt>.
+   */
+  std::vector<size_type> rows_by_color;
+
+  /**
+   * For the multicolor ordering, the position of the first row of each
+   * color in rows_by_color, with an additional entry at the end.
+   */
+  std::vector<size_type> color_start;
+
+  /**
+   * For the block Jacobi ordering, the first row of each block, with an
+   * additional entry at the end.
+   */
+  std::vector<size_type> block_start;
 };
 
 
@@ -1334,17 +1468,125 @@ PreconditionSOR<MATRIX>::Tstep (VECTOR &dst, const VECTOR &src) const
 
 //---------------------------------------------------------------------------
 
+namespace internal
+{
+  namespace PreconditionSSOR
+  {
+    // Return the indices of the matrix entries that couple the given row to
+    // other rows. Each coupling is identified by the position of the entry
+    // in the upper triangle of the sparsity pattern, such that two rows get
+    // the same index exactly if they are coupled. This is the conflict
+    // function for GraphColoring::make_graph_coloring
+    template <typename SparsityType>
+    std::vector<types::global_dof_index>
+    get_coupling_indices (const SparsityType                  &sparsity,
+                          const types::global_dof_index &row)
+    {
+      std::vector<types::global_dof_index> indices;
+      for (typename SparsityType::iterator it=sparsity.begin(row);
+           it != sparsity.end(row); ++it)
+        if (it->column() != row)
+          {
+            const types::global_dof_index index
+              = sparsity (std::min (row, it->column()),
+                          std::max (row, it->column()));
+            Assert (index != SparsityType::invalid_entry,
+                    ExcMessage ("The multicolor ordering of PreconditionSSOR "
+                                "needs a structurally symmetric matrix."));
+            indices.push_back (index);
+          }
+      return indices;
+    }
+
+
+
+    // Color the rows of the given sparsity pattern such that rows of the same
+    // color are not coupled, and sort the rows by color
+    template <typename SparsityType>
+    void
+    make_row_coloring (const SparsityType                   &sparsity,
+                       std::vector<unsigned int>            &row_colors,
+                       std::vector<types::global_dof_index> &rows_by_color,
+                       std::vector<types::global_dof_index> &color_start)
+    {
+      const types::global_dof_index n = sparsity.n_rows();
+      row_colors.resize (n);
+      rows_by_color.clear ();
+      rows_by_color.reserve (n);
+      color_start.resize (1, 0);
+      if (n == 0)
+        return;
+
+      const std::vector<std::vector<types::global_dof_index> > coloring
+        = GraphColoring::make_graph_coloring
+          (types::global_dof_index(0), n,
+           std_cxx11::function<std::vector<types::global_dof_index>
+           (const types::global_dof_index &)>
+           (std_cxx11::bind (&get_coupling_indices<SparsityType>,
+                             std_cxx11::cref (sparsity),
+                             std_cxx11::_1)));
+
+      // sort the rows within each color to access the vectors in ascending
+      // order within each sweep
+      for (unsigned int color=0; color<coloring.size(); ++color)
+        {
+          const std::size_t first = rows_by_color.size();
+          rows_by_color.insert (rows_by_color.end(), coloring[color].begin(),
+                                coloring[color].end());
+          std::sort (rows_by_color.begin()+first, rows_by_color.end());
+          for (std::size_t i=first; i<rows_by_color.size(); ++i)
+            row_colors[rows_by_color[i]] = color;
+          color_start.push_back (rows_by_color.size());
+        }
+      AssertDimension (rows_by_color.size(), n);
+    }
+  }
+}
+
+
+
+template <class MATRIX>
+inline
+PreconditionSSOR<MATRIX>::AdditionalData::
+AdditionalData (const double       relaxation,
+                const Ordering     ordering,
+                const unsigned int n_blocks)
+  :
+  BaseClass::AdditionalData (relaxation),
+  ordering (ordering),
+  n_blocks (n_blocks)
+{}
+
+
+
+template <class MATRIX>
+inline
+PreconditionSSOR<MATRIX>::PreconditionSSOR ()
+  :
+  ordering (AdditionalData::lexicographic)
+{}
+
+
+
 template <class MATRIX>
 inline void
 PreconditionSSOR<MATRIX>::initialize (const MATRIX &rA,
-                                      const typename BaseClass::AdditionalData &parameters)
+                                      const AdditionalData &parameters)
 {
   this->PreconditionRelaxation<MATRIX>::initialize (rA, parameters);
+  ordering = parameters.ordering;
+  row_colors.clear ();
+  rows_by_color.clear ();
+  color_start.clear ();
+  block_start.clear ();
 
   // in case we have a SparseMatrix class, we can extract information about
   // the diagonal.
   const SparseMatrix<typename MATRIX::value_type> *mat =
     dynamic_cast<const SparseMatrix<typename MATRIX::value_type> *>(&*this->A);
+  Assert (mat != 0 || ordering == AdditionalData::lexicographic,
+          ExcMessage ("The parallel variants of PreconditionSSOR are only "
+                      "implemented for SparseMatrix."));
 
   // calculate the positions first after the diagonal.
   if (mat != 0)
@@ -1364,10 +1606,59 @@ PreconditionSSOR<MATRIX>::initialize (const MATRIX &rA,
               break;
           pos_right_of_diagonal[row] = it - mat->begin();
         }
+
+      if (ordering == AdditionalData::multicolor)
+        internal::PreconditionSSOR::make_row_coloring (mat->get_sparsity_pattern(),
+                                                       row_colors, rows_by_color,
+                                                       color_start);
+      else if (ordering == AdditionalData::block_jacobi)
+        {
+          const size_type n_blocks
+            = std::max<size_type> (1, std::min<size_type> (n,
+                                                            parameters.n_blocks > 0 ?
+                                                            parameters.n_blocks :
+                                                            MultithreadInfo::n_threads()));
+          block_start.resize (n_blocks+1);
+          for (size_type block=0; block<=n_blocks; ++block)
+            block_start[block] = n / n_blocks * block +
+                                 std::min<size_type> (block, n % n_blocks);
+        }
     }
 }
 
 
+
+template <class MATRIX>
+template <typename somenumber>
+inline void
+PreconditionSSOR<MATRIX>::vmult_parallel (Vector<somenumber>       &dst,
+                                          const Vector<somenumber> &src) const
+{
+  const SparseMatrix<typename MATRIX::value_type> *mat =
+    dynamic_cast<const SparseMatrix<typename MATRIX::value_type> *>(&*this->A);
+  Assert (mat != 0, ExcInternalError());
+
+  if (ordering == AdditionalData::multicolor)
+    mat->precondition_SSOR_multicolor (dst, src, this->relaxation, row_colors,
+                                       rows_by_color, color_start);
+  else
+    mat->precondition_SSOR_blockwise (dst, src, this->relaxation, block_start,
+                                      pos_right_of_diagonal);
+}
+
+
+
+template <class MATRIX>
+template <class VECTOR>
+inline void
+PreconditionSSOR<MATRIX>::vmult_parallel (VECTOR &,
+                                          const VECTOR &) const
+{
+  AssertThrow (false, ExcNotImplemented());
+}
+
+
+
 template <class MATRIX>
 template<class VECTOR>
 inline void
@@ -1380,7 +1671,10 @@ PreconditionSSOR<MATRIX>::vmult (VECTOR &dst, const VECTOR &src) const
 #endif // DEAL_II_WITH_CXX11
 
   Assert (this->A!=0, ExcNotInitialized());
-  this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  if (ordering == AdditionalData::lexicographic)
+    this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  else
+    vmult_parallel (dst, src);
 }
 
 
@@ -1396,8 +1690,7 @@ PreconditionSSOR<MATRIX>::Tvmult (VECTOR &dst, const VECTOR &src) const
     "PreconditionSSOR and VECTOR must have the same size_type.");
 #endif // DEAL_II_WITH_CXX11
 
-  Assert (this->A!=0, ExcNotInitialized());
-  this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  vmult (dst, src);
 }
 
 
@@ -1414,7 +1707,21 @@ PreconditionSSOR<MATRIX>::step (VECTOR &dst, const VECTOR &src) const
 #endif // DEAL_II_WITH_CXX11
 
   Assert (this->A!=0, ExcNotInitialized());
-  this->A->SSOR_step (dst, src, this->relaxation);
+  if (ordering == AdditionalData::lexicographic)
+    this->A->SSOR_step (dst, src, this->relaxation);
+  else
+    {
+      // the parallel variants cannot update the vector in place, so compute
+      // the residual and add the preconditioned residual
+      GrowingVectorMemory<VECTOR> memory;
+      typename VectorMemory<VECTOR>::Pointer residual (memory), update (memory);
+      residual->reinit (dst, true);
+      update->reinit (dst, true);
+      this->A->vmult (*residual, dst);
+      residual->sadd (-1., 1., src);
+      vmult_parallel (*update, *residual);
+      dst += *update;
+    }
 }
 
 
@@ -0,0 +1,399 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__sliced_ellpack_matrix_h
+#define dealii__sliced_ellpack_matrix_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <typename number> class Vector;
+template <typename number> class SparseMatrix;
+class SparsityPattern;
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A sparse matrix stored in the sliced ELLPACK format with row sorting, also
+ * known as SELL-C-$\sigma$ (see M. Kreutzer, G. Hager, G. Wellein, H.
+ * Fehske, A. R. Bishop: A unified sparse matrix data format for efficient
+ * general sparse matrix-vector multiplication on modern processors with wide
+ * SIMD units, SIAM J. Sci. Comput. 36(5), C401-C423, 2014).
+ *
+ * The rows of the matrix are grouped into chunks of $C$ rows, where $C$ is
+ * the number of lanes of VectorizedArray<number>, i.e., the width of the SIMD
+ * unit the library was compiled for. Within each chunk, the entries are
+ * stored column by column, i.e., the first entries of all $C$ rows come
+ * first, followed by the second entries of all rows, and so on. Rows that are
+ * shorter than the longest row in their chunk are padded with zeros. A
+ * matrix-vector product then processes one chunk at a time with full
+ * VectorizedArray operations on the matrix entries, whereas the standard
+ * SparseMatrix works on one row at a time and can only vectorize within a
+ * single (typically short) row.
+ *
+ * In order to keep the amount of padding small, the rows are sorted by their
+ * length within windows of $\sigma$ consecutive rows (set through
+ * AdditionalData::sorting_window) before being assigned to chunks. The
+ * permutation is local to this class: all functions take and return vectors
+ * in the original numbering of the SparseMatrix this object was built from.
+ * Choosing $\sigma=1$ disables the sorting, whereas larger values of
+ * $\sigma$ reduce the padding at the price of a less regular access pattern
+ * into the destination vector.
+ *
+ * This class is not meant to be assembled into. Rather, one assembles a
+ * SparseMatrix as usual and then converts it by the reinit(const
+ * SparseMatrix&) function or by calling reinit(const SparsityPattern&) once
+ * and copy_from() whenever the values of the matrix change. Since it
+ * provides vmult() and Tvmult(), an object of this class can be used in
+ * place of the SparseMatrix in the linear solvers such as SolverCG or
+ * SolverGMRES:
+ * @code
+ * SparseMatrix<double> system_matrix;
+ * ... // assemble the system matrix
+ *
+ * SlicedEllpackMatrix<double> sell_matrix;
+ * sell_matrix.reinit (system_matrix);
+ *
+ * SolverCG<> solver (solver_control);
+ * solver.solve (sell_matrix, solution, system_rhs, preconditioner);
+ * @endcode
+ * Note that the values are copied, so the SparseMatrix may be deleted after
+ * the conversion. The products are computed in the precision given by the
+ * template argument of this class, independent of the number type of the
+ * vectors.
+ *
+ * @note Instantiations for this template are provided for <tt>@<float@> and
+ * @<double@></tt>; others can be generated in application programs (see the
+ * section on
+ * @ref Instantiations
+ * in the manual).
+ *
+ * @ingroup Matrix1
+ */
+template <typename number>
+class SlicedEllpackMatrix : public virtual Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of the matrix entries. This typedef is analogous to
+   * <tt>value_type</tt> in the standard library containers.
+   */
+  typedef number value_type;
+
+  /**
+   * The number of rows in each chunk, equal to the number of lanes in the
+   * SIMD registers for the given number type.
+   */
+  static const unsigned int chunk_size = VectorizedArray<number>::n_array_elements;
+
+  /**
+   * Parameters that control the setup of the storage format.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const unsigned int sorting_window = 256);
+
+    /**
+     * The number $\sigma$ of consecutive rows within which rows get sorted by
+     * their length before being grouped into chunks. The value is rounded up
+     * to the next multiple of chunk_size. A value of one disables sorting.
+     */
+    unsigned int sorting_window;
+  };
+
+  /**
+   * Constructor. Initializes an empty matrix of dimension zero times zero.
+   */
+  SlicedEllpackMatrix ();
+
+  /**
+   * Set up the storage for the structure given by @p sparsity. All entries
+   * are set to zero, use copy_from() to fill in the values.
+   */
+  void reinit (const SparsityPattern &sparsity,
+               const AdditionalData  &additional_data = AdditionalData());
+
+  /**
+   * Set up the storage for the sparsity pattern of @p matrix and copy its
+   * values. Equivalent to calling reinit() with the sparsity pattern of the
+   * matrix followed by copy_from().
+   */
+  template <typename somenumber>
+  void reinit (const SparseMatrix<somenumber> &matrix,
+               const AdditionalData           &additional_data = AdditionalData());
+
+  /**
+   * Copy the values of @p matrix into this object. The sparsity pattern of
+   * the matrix must be the one this object was initialized with.
+   */
+  template <typename somenumber>
+  void copy_from (const SparseMatrix<somenumber> &matrix);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return the dimension of the codomain (or range) space. Note that the
+   * matrix is of dimension $m \times n$.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space. Note that the matrix is of
+   * dimension $m \times n$.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of nonzero elements of the sparsity pattern this
+   * object was built from.
+   */
+  std::size_t n_nonzero_elements () const;
+
+  /**
+   * Return the number of matrix entries actually stored, including the
+   * zeros used to pad the rows within each chunk. The ratio between this
+   * number and n_nonzero_elements() measures the storage overhead of the
+   * format and can be used to tune AdditionalData::sorting_window.
+   */
+  std::size_t n_stored_elements () const;
+
+  /**
+   * Return the value of the entry (<i>i,j</i>), or zero if this entry is not
+   * part of the sparsity pattern. This function searches the row and is
+   * therefore slow; it is mostly meant for debugging.
+   */
+  number el (const size_type i,
+             const size_type j) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i> being
+   * this matrix.
+   *
+   * Source and destination must not be the same vector.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class OutVector, class InVector>
+  void vmult (OutVector      &dst,
+              const InVector &src) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M<sup>T</sup>*src</i> with
+   * <i>M</i> being this matrix. This function does the same as vmult() but
+   * takes the transposed matrix. As opposed to vmult(), this function is not
+   * parallelized because different rows write into the same entries of the
+   * destination vector.
+   *
+   * Source and destination must not be the same vector.
+   */
+  template <class OutVector, class InVector>
+  void Tvmult (OutVector      &dst,
+               const InVector &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add <i>M*src</i> on <i>dst</i> with
+   * <i>M</i> being this matrix.
+   *
+   * Source and destination must not be the same vector.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class OutVector, class InVector>
+  void vmult_add (OutVector      &dst,
+                  const InVector &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add <i>M<sup>T</sup>*src</i> to
+   * <i>dst</i> with <i>M</i> being this matrix.
+   *
+   * Source and destination must not be the same vector.
+   */
+  template <class OutVector, class InVector>
+  void Tvmult_add (OutVector      &dst,
+                   const InVector &src) const;
+
+  /**
+   * Return the square of the norm of the vector $v$ with respect to the norm
+   * induced by this matrix, i.e. $\left(v,Mv\right)$.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  somenumber matrix_norm_square (const Vector<somenumber> &v) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclException0 (ExcDifferentSparsityPatterns);
+
+  /**
+   * Exception
+   */
+  DeclException0 (ExcSourceEqualsDestination);
+  //@}
+
+private:
+  /**
+   * Number of rows of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns of the matrix.
+   */
+  size_type n_cols;
+
+  /**
+   * Number of nonzero entries in the sparsity pattern this object was built
+   * from.
+   */
+  std::size_t n_nonzero;
+
+  /**
+   * For each lane of each chunk, the row of the matrix it represents. Lanes
+   * that fill up the last chunk are marked by numbers::invalid_size_type.
+   */
+  std::vector<size_type> lane_to_row;
+
+  /**
+   * For each row of the matrix, the position in the array lane_to_row.
+   */
+  std::vector<size_type> row_to_lane;
+
+  /**
+   * Offset of the first entry of each chunk in the arrays values and (after
+   * multiplication with chunk_size) column_indices. The array has one more
+   * element than there are chunks, with the last element pointing one past
+   * the last entry.
+   */
+  std::vector<std::size_t> chunk_start;
+
+  /**
+   * The entries of the matrix, stored chunk by chunk. Each element holds
+   * the entries of all rows of a chunk at the same position within the row.
+   */
+  AlignedVector<VectorizedArray<number> > values;
+
+  /**
+   * The column indices of the entries in values, stored in the same order
+   * with chunk_size indices for each element of values. The indices of
+   * padded entries repeat the last valid index of a row such that they do
+   * not touch additional cache lines.
+   */
+  std::vector<size_type> column_indices;
+
+  /**
+   * Vectorized implementation of vmult() and vmult_add() on a range of
+   * chunks.
+   */
+  template <class OutVector, class InVector>
+  void vmult_on_subrange (const size_type  begin_chunk,
+                          const size_type  end_chunk,
+                          OutVector       &dst,
+                          const InVector  &src,
+                          const bool       add) const;
+
+  /**
+   * Implementation of matrix_norm_square() on a range of chunks.
+   */
+  template <typename somenumber>
+  somenumber matrix_norm_sqr_on_subrange (const size_type           begin_chunk,
+                                          const size_type           end_chunk,
+                                          const Vector<somenumber> &v) const;
+};
+
+/*@}*/
+
+#ifndef DOXYGEN
+/*---------------------- Inline functions -----------------------------------*/
+
+
+
+template <typename number>
+inline
+typename SlicedEllpackMatrix<number>::size_type
+SlicedEllpackMatrix<number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline
+typename SlicedEllpackMatrix<number>::size_type
+SlicedEllpackMatrix<number>::n () const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SlicedEllpackMatrix<number>::n_nonzero_elements () const
+{
+  return n_nonzero;
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SlicedEllpackMatrix<number>::n_stored_elements () const
+{
+  return values.size() * chunk_size;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
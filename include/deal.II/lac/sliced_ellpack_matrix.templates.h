@@ -0,0 +1,451 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__sliced_ellpack_matrix_templates_h
+#define dealii__sliced_ellpack_matrix_templates_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <deal.II/base/std_cxx11/bind.h>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace SlicedEllpackMatrix
+  {
+    /**
+     * Comparison functor that orders rows by decreasing length, used for
+     * sorting the rows within a window before they get grouped into chunks.
+     */
+    struct LongerRow
+    {
+      LongerRow (const dealii::SparsityPattern &sparsity)
+        :
+        sparsity (sparsity)
+      {}
+
+      bool operator () (const types::global_dof_index row1,
+                        const types::global_dof_index row2) const
+      {
+        return sparsity.row_length(row1) > sparsity.row_length(row2);
+      }
+
+      const dealii::SparsityPattern &sparsity;
+    };
+  }
+}
+
+
+
+template <typename number>
+const unsigned int SlicedEllpackMatrix<number>::chunk_size;
+
+
+
+template <typename number>
+SlicedEllpackMatrix<number>::AdditionalData::
+AdditionalData (const unsigned int sorting_window)
+  :
+  sorting_window (sorting_window)
+{}
+
+
+
+template <typename number>
+SlicedEllpackMatrix<number>::SlicedEllpackMatrix ()
+  :
+  n_rows (0),
+  n_cols (0),
+  n_nonzero (0)
+{}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::clear ()
+{
+  n_rows = 0;
+  n_cols = 0;
+  n_nonzero = 0;
+  lane_to_row.clear();
+  row_to_lane.clear();
+  chunk_start.clear();
+  values.clear();
+  column_indices.clear();
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::reinit (const SparsityPattern &sparsity,
+                                     const AdditionalData  &additional_data)
+{
+  Assert (sparsity.is_compressed(), SparsityPattern::ExcNotCompressed());
+
+  n_rows = sparsity.n_rows();
+  n_cols = sparsity.n_cols();
+  n_nonzero = sparsity.n_nonzero_elements();
+
+  // sort the rows by decreasing length within each window. the window is at
+  // least one chunk long, so sorting_window==1 keeps the original order
+  const size_type window = std::max<size_type>
+                           (1, (additional_data.sorting_window+chunk_size-1)/chunk_size) * chunk_size;
+  std::vector<size_type> sorted_rows (n_rows);
+  for (size_type row=0; row<n_rows; ++row)
+    sorted_rows[row] = row;
+  if (additional_data.sorting_window > 1)
+    for (size_type start=0; start<n_rows; start += window)
+      std::stable_sort (sorted_rows.begin()+start,
+                        sorted_rows.begin()+std::min(start+window, n_rows),
+                        internal::SlicedEllpackMatrix::LongerRow(sparsity));
+
+  const size_type n_chunks = (n_rows+chunk_size-1)/chunk_size;
+  lane_to_row.resize (n_chunks*chunk_size);
+  std::fill (lane_to_row.begin(), lane_to_row.end(), numbers::invalid_size_type);
+  row_to_lane.resize (n_rows);
+  for (size_type i=0; i<n_rows; ++i)
+    {
+      lane_to_row[i] = sorted_rows[i];
+      row_to_lane[sorted_rows[i]] = i;
+    }
+
+  // the length of each chunk is given by its longest row
+  chunk_start.resize (n_chunks+1);
+  chunk_start[0] = 0;
+  for (size_type c=0; c<n_chunks; ++c)
+    {
+      unsigned int max_length = 0;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        if (lane_to_row[c*chunk_size+v] != numbers::invalid_size_type)
+          max_length = std::max (max_length,
+                                 sparsity.row_length(lane_to_row[c*chunk_size+v]));
+      chunk_start[c+1] = chunk_start[c] + max_length;
+    }
+
+  values.resize (0);
+  values.resize (chunk_start[n_chunks], make_vectorized_array (number()));
+  column_indices.resize (chunk_start[n_chunks]*chunk_size);
+
+  // fill in the column indices. the padded entries of a row repeat its last
+  // column index, empty rows and unused lanes refer to the first column
+  for (size_type c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size; ++v)
+      {
+        const size_type row = lane_to_row[c*chunk_size+v];
+        const unsigned int row_length =
+          (row != numbers::invalid_size_type) ? sparsity.row_length(row) : 0;
+        size_type *col_ptr = &column_indices[chunk_start[c]*chunk_size] + v;
+        size_type last_column = 0;
+        for (std::size_t k=0; k<chunk_start[c+1]-chunk_start[c];
+             ++k, col_ptr += chunk_size)
+          {
+            if (k < row_length)
+              last_column = sparsity.column_number(row, k);
+            *col_ptr = last_column;
+          }
+      }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SlicedEllpackMatrix<number>::reinit (const SparseMatrix<somenumber> &matrix,
+                                     const AdditionalData           &additional_data)
+{
+  reinit (matrix.get_sparsity_pattern(), additional_data);
+  copy_from (matrix);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SlicedEllpackMatrix<number>::copy_from (const SparseMatrix<somenumber> &matrix)
+{
+  AssertDimension (matrix.m(), n_rows);
+  AssertDimension (matrix.n(), n_cols);
+  Assert (matrix.n_nonzero_elements() == n_nonzero,
+          ExcDifferentSparsityPatterns());
+
+  for (size_type row=0; row<n_rows; ++row)
+    {
+      const size_type lane = row_to_lane[row];
+      const unsigned int v = lane % chunk_size;
+      VectorizedArray<number> *val_ptr = values.begin() + chunk_start[lane/chunk_size];
+      const std::size_t chunk_length = chunk_start[lane/chunk_size+1] -
+                                       chunk_start[lane/chunk_size];
+      std::size_t k = 0;
+      for (typename SparseMatrix<somenumber>::const_iterator
+           entry = matrix.begin(row); entry != matrix.end(row); ++entry, ++k)
+        {
+          Assert (k < chunk_length, ExcDifferentSparsityPatterns());
+          Assert (column_indices[(chunk_start[lane/chunk_size]+k)*chunk_size+v]
+                  == entry->column(),
+                  ExcDifferentSparsityPatterns());
+          val_ptr[k][v] = entry->value();
+        }
+      for ( ; k<chunk_length; ++k)
+        val_ptr[k][v] = number();
+    }
+}
+
+
+
+template <typename number>
+number
+SlicedEllpackMatrix<number>::el (const size_type i,
+                                 const size_type j) const
+{
+  AssertIndexRange (i, n_rows);
+  AssertIndexRange (j, n_cols);
+
+  // padded entries repeat the last column index of a row but have a zero
+  // value, so we can simply return the first match
+  const size_type lane = row_to_lane[i];
+  const size_type chunk = lane / chunk_size;
+  const unsigned int v = lane % chunk_size;
+  for (std::size_t k=chunk_start[chunk]; k<chunk_start[chunk+1]; ++k)
+    if (column_indices[k*chunk_size+v] == j)
+      return values[k][v];
+  return number();
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SlicedEllpackMatrix<number>::vmult_on_subrange (const size_type  begin_chunk,
+                                                const size_type  end_chunk,
+                                                OutVector       &dst,
+                                                const InVector  &src,
+                                                const bool       add) const
+{
+  for (size_type c=begin_chunk; c<end_chunk; ++c)
+    {
+      const VectorizedArray<number> *val_ptr = values.begin() + chunk_start[c];
+      const VectorizedArray<number> *const val_end = values.begin() + chunk_start[c+1];
+      const size_type *col_ptr = &column_indices[0] + chunk_start[c]*chunk_size;
+
+      // gather the source entries into the lanes and accumulate the chunk's
+      // rows with full SIMD operations
+      VectorizedArray<number> sum;
+      sum = number();
+      for ( ; val_ptr != val_end; ++val_ptr, col_ptr += chunk_size)
+        {
+          VectorizedArray<number> src_values;
+          for (unsigned int v=0; v<chunk_size; ++v)
+            src_values[v] = src(col_ptr[v]);
+          sum += *val_ptr * src_values;
+        }
+
+      const size_type *rows = &lane_to_row[c*chunk_size];
+      if (add == false)
+        {
+          for (unsigned int v=0; v<chunk_size; ++v)
+            if (rows[v] != numbers::invalid_size_type)
+              dst(rows[v]) = sum[v];
+        }
+      else
+        for (unsigned int v=0; v<chunk_size; ++v)
+          if (rows[v] != numbers::invalid_size_type)
+            dst(rows[v]) += sum[v];
+    }
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SlicedEllpackMatrix<number>::vmult (OutVector      &dst,
+                                    const InVector &src) const
+{
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges (0U, chunk_start.size() ? chunk_start.size()-1 : 0,
+                                std_cxx11::bind (&SlicedEllpackMatrix<number>::template
+                                                 vmult_on_subrange<OutVector,InVector>,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::ref(dst),
+                                                 std_cxx11::cref(src),
+                                                 false),
+                                internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SlicedEllpackMatrix<number>::vmult_add (OutVector      &dst,
+                                        const InVector &src) const
+{
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges (0U, chunk_start.size() ? chunk_start.size()-1 : 0,
+                                std_cxx11::bind (&SlicedEllpackMatrix<number>::template
+                                                 vmult_on_subrange<OutVector,InVector>,
+                                                 this,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 std_cxx11::ref(dst),
+                                                 std_cxx11::cref(src),
+                                                 true),
+                                internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SlicedEllpackMatrix<number>::Tvmult (OutVector      &dst,
+                                     const InVector &src) const
+{
+  Assert(n() == dst.size(), ExcDimensionMismatch(n(),dst.size()));
+  Assert(m() == src.size(), ExcDimensionMismatch(m(),src.size()));
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  dst = 0;
+  Tvmult_add (dst, src);
+}
+
+
+
+template <typename number>
+template <class OutVector, class InVector>
+void
+SlicedEllpackMatrix<number>::Tvmult_add (OutVector      &dst,
+                                         const InVector &src) const
+{
+  Assert(n() == dst.size(), ExcDimensionMismatch(n(),dst.size()));
+  Assert(m() == src.size(), ExcDimensionMismatch(m(),src.size()));
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  const size_type n_chunks = chunk_start.size() ? chunk_start.size()-1 : 0;
+  for (size_type c=0; c<n_chunks; ++c)
+    {
+      const size_type *rows = &lane_to_row[c*chunk_size];
+      VectorizedArray<number> src_values;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        src_values[v] = (rows[v] != numbers::invalid_size_type) ?
+                        number(src(rows[v])) : number();
+
+      const size_type *col_ptr = &column_indices[0] + chunk_start[c]*chunk_size;
+      for (std::size_t k=chunk_start[c]; k<chunk_start[c+1]; ++k, col_ptr += chunk_size)
+        {
+          const VectorizedArray<number> products = values[k] * src_values;
+          for (unsigned int v=0; v<chunk_size; ++v)
+            dst(col_ptr[v]) += products[v];
+        }
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+somenumber
+SlicedEllpackMatrix<number>::
+matrix_norm_sqr_on_subrange (const size_type           begin_chunk,
+                             const size_type           end_chunk,
+                             const Vector<somenumber> &v) const
+{
+  somenumber norm_sqr = 0.;
+  for (size_type c=begin_chunk; c<end_chunk; ++c)
+    {
+      VectorizedArray<number> sum;
+      sum = number();
+      const size_type *col_ptr = &column_indices[0] + chunk_start[c]*chunk_size;
+      for (std::size_t k=chunk_start[c]; k<chunk_start[c+1]; ++k, col_ptr += chunk_size)
+        {
+          VectorizedArray<number> src_values;
+          for (unsigned int l=0; l<chunk_size; ++l)
+            src_values[l] = v(col_ptr[l]);
+          sum += values[k] * src_values;
+        }
+
+      const size_type *rows = &lane_to_row[c*chunk_size];
+      for (unsigned int l=0; l<chunk_size; ++l)
+        if (rows[l] != numbers::invalid_size_type)
+          norm_sqr += v(rows[l]) * somenumber(sum[l]);
+    }
+  return norm_sqr;
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+somenumber
+SlicedEllpackMatrix<number>::matrix_norm_square (const Vector<somenumber> &v) const
+{
+  Assert(m() == v.size(), ExcDimensionMismatch(m(),v.size()));
+  Assert(n() == v.size(), ExcDimensionMismatch(n(),v.size()));
+
+  return
+    parallel::accumulate_from_subranges<somenumber>
+    (std_cxx11::bind (&SlicedEllpackMatrix<number>::template
+                      matrix_norm_sqr_on_subrange<somenumber>,
+                      this,
+                      std_cxx11::_1, std_cxx11::_2,
+                      std_cxx11::cref(v)),
+     0, chunk_start.size() ? chunk_start.size()-1 : 0,
+     internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename number>
+std::size_t
+SlicedEllpackMatrix<number>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (lane_to_row) +
+          MemoryConsumption::memory_consumption (row_to_lane) +
+          MemoryConsumption::memory_consumption (chunk_start) +
+          values.memory_consumption() +
+          MemoryConsumption::memory_consumption (column_indices));
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,407 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__solver_block_cg_h
+#define dealii__solver_block_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Preconditioned block cg method for symmetric positive definite matrices
+ * with several right hand sides, following D. P. O'Leary, "The block
+ * conjugate gradient algorithm and related methods", Linear Algebra and its
+ * Applications 29 (1980), pp. 293-322.
+ *
+ * All right hand sides are solved for at the same time, using a MultiVector
+ * for the solutions and the right hand sides. In each iteration, the search
+ * space is extended by one direction for every column, and the iterates of
+ * all columns are optimal with respect to the combined search space of all
+ * columns. Consequently, the method usually needs fewer iterations than
+ * solving for each column with SolverCG, in particular if the right hand
+ * sides are related. More importantly, each iteration applies the matrix
+ * only once to the multi-vector of search directions, which for
+ * SparseMatrix::vmult() with a MultiVector means that the matrix is only
+ * read from memory once for all columns. The price to pay are the products
+ * between all columns of two multi-vectors and a Cholesky factorization of
+ * a small matrix of the size of the number of columns in each iteration.
+ *
+ * The operator passed to solve() must provide a function
+ * <tt>vmult(VECTOR&,const VECTOR&)</tt> for the multi-vector type. This is
+ * the case for SparseMatrix and for MultiVectorColumnwiseOperator, which
+ * wraps operators acting on single vectors such as the matrix-free
+ * operators. The same holds for the preconditioner, e.g.
+ * PreconditionIdentity or PreconditionJacobi with a SparseMatrix.
+ *
+ * Search directions that become linearly dependent, e.g. because a column
+ * has converged or because two right hand sides are linearly dependent, are
+ * dropped from the search space of the current iteration by a Cholesky
+ * factorization that skips pivots that are small compared to the respective
+ * diagonal entry. Columns whose residual is below the tolerance of the
+ * SolverControl object do not contribute new search directions. For a
+ * ReductionControl, the tolerance of a column is the larger of the absolute
+ * tolerance and the reduction times the largest initial residual of all
+ * columns, which is the criterion ReductionControl applies to the solver as a
+ * whole.
+ *
+ * The convergence criterion is the largest $l_2$ norm of the residuals of
+ * all columns.
+ */
+template <class VECTOR = MultiVector<double> >
+class SolverBlockCG : public Solver<VECTOR>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver. There is
+   * no data in here for this class.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor.
+   */
+  SolverBlockCG (SolverControl        &cn,
+                 VectorMemory<VECTOR> &mem,
+                 const AdditionalData &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverBlockCG (SolverControl        &cn,
+                 const AdditionalData &data = AdditionalData());
+
+  /**
+   * Solve the linear system $AX=B$ for all columns of X.
+   */
+  template <class MATRIX, class PRECONDITIONER>
+  void
+  solve (const MATRIX         &A,
+         VECTOR               &x,
+         const VECTOR         &b,
+         const PRECONDITIONER &precondition);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The solver control object, whose tolerance determines which columns have
+   * converged and do not contribute new search directions.
+   */
+  const SolverControl &solver_control;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverBlockCG
+  {
+    // Compute the Cholesky factor L of the symmetric positive semidefinite
+    // matrix G, skipping all rows and columns whose pivot is small compared
+    // to the diagonal entry. On exit, active[k] is true if row k was used,
+    // and L is the Cholesky factor of the submatrix of G made up of the
+    // active rows and columns
+    template <typename number>
+    void
+    factorize (const FullMatrix<number> &G,
+               FullMatrix<number>       &L,
+               std::vector<bool>        &active)
+    {
+      const unsigned int n = G.m();
+      const number tolerance = 100. * n * std::numeric_limits<number>::epsilon();
+      L.reinit (n, n);
+      active.assign (n, false);
+      for (unsigned int k=0; k<n; ++k)
+        {
+          number pivot = G(k,k);
+          for (unsigned int j=0; j<k; ++j)
+            if (active[j])
+              pivot -= L(k,j) * L(k,j);
+          if (!(pivot > tolerance * G(k,k)) || G(k,k) <= 0)
+            continue;
+
+          active[k] = true;
+          L(k,k) = std::sqrt (pivot);
+          for (unsigned int i=k+1; i<n; ++i)
+            {
+              number sum = G(i,k);
+              for (unsigned int j=0; j<k; ++j)
+                if (active[j])
+                  sum -= L(i,j) * L(k,j);
+              L(i,k) = sum / L(k,k);
+            }
+        }
+    }
+
+
+
+    // Solve GX=factor*B for all columns of B with the factorization computed
+    // above. The rows of X that belong to inactive rows of G are set to zero
+    template <typename number>
+    void
+    solve (const FullMatrix<number> &L,
+           const std::vector<bool>  &active,
+           const FullMatrix<number> &B,
+           const number              factor,
+           FullMatrix<number>       &X)
+    {
+      const unsigned int n = L.m();
+      X.reinit (n, B.n());
+      for (unsigned int c=0; c<B.n(); ++c)
+        {
+          for (unsigned int k=0; k<n; ++k)
+            if (active[k])
+              {
+                number sum = factor * B(k,c);
+                for (unsigned int j=0; j<k; ++j)
+                  sum -= L(k,j) * X(j,c);
+                X(k,c) = sum / L(k,k);
+              }
+          for (unsigned int k=n; k>0; )
+            {
+              --k;
+              if (active[k])
+                {
+                  number sum = X(k,c);
+                  for (unsigned int i=k+1; i<n; ++i)
+                    sum -= L(i,k) * X(i,c);
+                  X(k,c) = sum / L(k,k);
+                }
+            }
+        }
+    }
+
+
+
+    // Return the tolerance below which a column counts as converged. This is
+    // the tolerance of the solver control object, or for a ReductionControl
+    // the tolerance it derives from the initial residual of the solver, i.e.,
+    // the largest initial norm of all columns. The control object itself is
+    // only queried here, since its check() function stores the history and
+    // state of the solver and must only be called once per iteration
+    inline
+    double
+    column_tolerance (const SolverControl &solver_control,
+                      const double         initial_residual)
+    {
+      const ReductionControl *reduction_control =
+        dynamic_cast<const ReductionControl *>(&solver_control);
+      if (reduction_control != 0)
+        return std::max (solver_control.tolerance(),
+                         reduction_control->reduction() * initial_residual);
+      else
+        return solver_control.tolerance();
+    }
+
+
+
+    // Return the largest entry of the list of residual norms
+    template <typename real_type>
+    real_type
+    max_column_norm (const std::vector<real_type> &norms)
+    {
+      real_type max_norm = 0;
+      for (unsigned int k=0; k<norms.size(); ++k)
+        max_norm = std::max (max_norm, norms[k]);
+      return max_norm;
+    }
+
+
+
+    // Set the entries of factors to zero for the columns whose residual norm
+    // is below the tolerance and to one for all other columns
+    template <typename number, typename real_type>
+    void
+    check_columns (const std::vector<real_type> &norms,
+                   const double                  tolerance,
+                   std::vector<number>          &factors)
+    {
+      factors.resize (norms.size());
+      for (unsigned int k=0; k<norms.size(); ++k)
+        factors[k] = (norms[k] > tolerance) ? 1. : 0.;
+    }
+  }
+}
+
+
+
+template <class VECTOR>
+SolverBlockCG<VECTOR>::SolverBlockCG (SolverControl        &cn,
+                                      VectorMemory<VECTOR> &mem,
+                                      const AdditionalData &data)
+  :
+  Solver<VECTOR>(cn,mem),
+  additional_data(data),
+  solver_control(cn)
+{}
+
+
+
+template <class VECTOR>
+SolverBlockCG<VECTOR>::SolverBlockCG (SolverControl        &cn,
+                                      const AdditionalData &data)
+  :
+  Solver<VECTOR>(cn),
+  additional_data(data),
+  solver_control(cn)
+{}
+
+
+
+template <class VECTOR>
+template <class MATRIX, class PRECONDITIONER>
+void
+SolverBlockCG<VECTOR>::solve (const MATRIX         &A,
+                              VECTOR               &x,
+                              const VECTOR         &b,
+                              const PRECONDITIONER &precondition)
+{
+  typedef typename VECTOR::value_type number;
+  typedef typename VECTOR::real_type  real_type;
+
+  SolverControl::State conv = SolverControl::iterate;
+
+  deallog.push("block cg");
+
+  double res = -std::numeric_limits<double>::max();
+  unsigned int it = 0;
+
+  try
+    {
+      AssertDimension (x.n_columns(), b.n_columns());
+
+      // the multi-vectors of the algorithm: r is the residual, z the
+      // preconditioned residual, p the search directions, q=Ap, and t a
+      // temporary for the update of the search directions
+      typename VectorMemory<VECTOR>::Pointer r (this->memory), z (this->memory),
+               p (this->memory), q (this->memory), t (this->memory);
+      r->reinit (x, true);
+      z->reinit (x, true);
+      p->reinit (x, true);
+      q->reinit (x, true);
+      t->reinit (x, true);
+
+      // the small matrices: G=p^Tq, its Cholesky factor L, the right hand
+      // sides H=p^Tr and E=q^Tz of the projected systems, and their solutions
+      // alpha and beta
+      FullMatrix<number> G, L, H, E, alpha, beta;
+      std::vector<bool> active;
+      std::vector<real_type> norms;
+      std::vector<number> column_factors;
+
+      // compute residual. if vector is zero, then short-circuit the full
+      // computation
+      if (!x.all_zero())
+        {
+          A.vmult (*r, x);
+          r->sadd (-1., 1., b);
+        }
+      else
+        r->equ (1., b);
+
+      r->column_norms (norms);
+      res = internal::SolverBlockCG::max_column_norm (norms);
+      conv = this->iteration_status (0, res, x);
+      const double tolerance =
+        internal::SolverBlockCG::column_tolerance (solver_control, res);
+      internal::SolverBlockCG::check_columns (norms, tolerance, column_factors);
+
+      // the initial search directions are the preconditioned residuals of
+      // the columns that have not converged yet
+      if (conv == SolverControl::iterate)
+        {
+          precondition.vmult (*p, *r);
+          p->scale_columns (column_factors);
+        }
+
+      while (conv == SolverControl::iterate)
+        {
+          ++it;
+
+          A.vmult (*q, *p);
+
+          // X += P alpha and R -= Q alpha with alpha = (P^T Q)^{-1} P^T R,
+          // where dependent columns of P are left out
+          p->inner_products (*q, G);
+          internal::SolverBlockCG::factorize (G, L, active);
+          p->inner_products (*r, H);
+          internal::SolverBlockCG::solve (L, active, H, number(1.), alpha);
+          x.add_times (*p, alpha);
+          alpha *= -1.;
+          r->add_times (*q, alpha);
+
+          r->column_norms (norms);
+          res = internal::SolverBlockCG::max_column_norm (norms);
+          conv = this->iteration_status (it, res, x);
+          if (conv != SolverControl::iterate)
+            break;
+          internal::SolverBlockCG::check_columns (norms, tolerance, column_factors);
+
+          // P = Z + P beta with beta = -(P^T Q)^{-1} Q^T Z, which makes the
+          // new search directions A-orthogonal to the old ones. converged
+          // columns do not contribute new directions
+          precondition.vmult (*z, *r);
+          z->scale_columns (column_factors);
+          q->inner_products (*z, E);
+          internal::SolverBlockCG::solve (L, active, E, number(-1.), beta);
+          *t = *z;
+          t->add_times (*p, beta);
+          p->swap (*t);
+        }
+    }
+  catch (...)
+    {
+      deallog.pop();
+      throw;
+    }
+
+  deallog.pop();
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -27,6 +27,7 @@
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/non_blocking_inner_products.h>
 
 #include <vector>
 #include <cmath>
@@ -230,6 +231,23 @@ public:
      */
     bool force_re_orthogonalization;
 
+    /**
+     * Flag to orthogonalize new Arnoldi vectors with the classical instead
+     * of the modified Gram-Schmidt algorithm. The modified algorithm needs
+     * one global reduction for each vector in the basis, whereas the
+     * classical one computes all inner products, including the one for the
+     * norm of the new vector, in a single reduction (see
+     * internal::NonBlockingInnerProducts). This reduces the number of
+     * synchronization points in parallel computations considerably. To
+     * compensate for the inferior stability of the classical algorithm, the
+     * orthogonalization is repeated once whenever the norm of the new vector
+     * drops by more than a factor of $\sqrt{2}$, or in every step if
+     * #force_re_orthogonalization is set.
+     *
+     * This flag is not set by the constructors and defaults to false.
+     */
+    bool use_classical_gram_schmidt;
+
     /**
      * Compute all eigenvalues of the Hessenberg matrix generated while
      * solving, i.e., the projected system matrix. This gives an approximation
@@ -356,6 +374,23 @@ protected:
                          Vector<double>     &h,
                          bool               &re_orthogonalize);
 
+  /**
+   * Orthogonalize the vector @p vv against the @p dim (orthogonal) vectors
+   * given by the first argument using the classical Gram-Schmidt algorithm,
+   * with all inner products of one pass computed in a single reduction. The
+   * norm of the orthogonalized vector is obtained from the inner products
+   * as well. The orthogonalization is done twice if @p re_orthogonalize is
+   * true or if the norm of the vector decreases by more than a factor of
+   * $\sqrt{2}$ in the first pass. The factors used for orthogonalization
+   * are stored in @p h.
+   */
+  static double
+  classical_gram_schmidt (const internal::SolverGMRES::TmpVectors<VECTOR> &orthogonal_vectors,
+                          const unsigned int  dim,
+                          VECTOR             &vv,
+                          Vector<double>     &h,
+                          const bool          re_orthogonalize);
+
   /**
     * Estimates the eigenvalues from the Hessenberg matrix, H_orig, generated
     * during the inner iterations. Uses these estimate to compute the condition
@@ -543,6 +578,60 @@ namespace internal
     {
       return x.real() < y.real() || (x.real() == y.real() && x.imag() < y.imag());
     }
+
+
+    // Add the linear combination of the first coefficients.size() vectors in
+    // @p vectors with the given coefficients to @p dst. The general version
+    // calls add() once for each vector
+    template <class VECTOR>
+    inline
+    void
+    add_linear_combination (const TmpVectors<VECTOR>  &vectors,
+                            const std::vector<double> &coefficients,
+                            VECTOR                    &dst)
+    {
+      for (unsigned int i=0; i<coefficients.size(); ++i)
+        dst.add (coefficients[i], vectors[i]);
+    }
+
+
+    // Vector classes that provide a fused operation for this, traverse all
+    // vectors in one sweep, reading and writing @p dst only once
+    template <class VECTOR, typename Number>
+    inline
+    void
+    fused_add_linear_combination (const TmpVectors<VECTOR>  &vectors,
+                                  const std::vector<double> &coefficients,
+                                  VECTOR                    &dst)
+    {
+      std::vector<Number> a (coefficients.begin(), coefficients.end());
+      std::vector<const VECTOR *> v (coefficients.size());
+      for (unsigned int i=0; i<coefficients.size(); ++i)
+        v[i] = &vectors[i];
+      dst.add_linear_combination (a, v);
+    }
+
+
+    template <typename Number>
+    inline
+    void
+    add_linear_combination (const TmpVectors<dealii::Vector<Number> > &vectors,
+                            const std::vector<double>                &coefficients,
+                            dealii::Vector<Number>                   &dst)
+    {
+      fused_add_linear_combination<dealii::Vector<Number>,Number> (vectors, coefficients, dst);
+    }
+
+
+    template <typename Number>
+    inline
+    void
+    add_linear_combination (const TmpVectors<parallel::distributed::Vector<Number> > &vectors,
+                            const std::vector<double>                                &coefficients,
+                            parallel::distributed::Vector<Number>                    &dst)
+    {
+      fused_add_linear_combination<parallel::distributed::Vector<Number>,Number> (vectors, coefficients, dst);
+    }
   }
 }
 
@@ -560,6 +649,7 @@ AdditionalData (const unsigned int max_n_tmp_vectors,
   right_preconditioning(right_preconditioning),
   use_default_residual(use_default_residual),
   force_re_orthogonalization(force_re_orthogonalization),
+  use_classical_gram_schmidt(false),
   compute_eigenvalues(false)
 {}
 
@@ -578,6 +668,7 @@ AdditionalData (const unsigned int max_n_tmp_vectors,
   right_preconditioning(right_preconditioning),
   use_default_residual(use_default_residual),
   force_re_orthogonalization(force_re_orthogonalization),
+  use_classical_gram_schmidt(false),
   compute_eigenvalues(compute_eigenvalues)
 {}
 
@@ -693,6 +784,66 @@ SolverGMRES<VECTOR>::modified_gram_schmidt (const internal::SolverGMRES::TmpVect
 
 
 
+template <class VECTOR>
+inline
+double
+SolverGMRES<VECTOR>::classical_gram_schmidt (const internal::SolverGMRES::TmpVectors<VECTOR> &orthogonal_vectors,
+                                             const unsigned int  dim,
+                                             VECTOR             &vv,
+                                             Vector<double>     &h,
+                                             const bool          re_orthogonalize)
+{
+  Assert(dim > 0, ExcInternalError());
+
+  // inner products of vv with all basis vectors and with itself. vv is the
+  // first vector of each pair, such that it is read only once when all
+  // products are computed together
+  std::vector<std::pair<const VECTOR *, const VECTOR *> > pairs (dim+1);
+  for (unsigned int i=0; i<dim; ++i)
+    pairs[i] = std::make_pair (&vv, &orthogonal_vectors[i]);
+  pairs[dim] = std::make_pair (&vv, &vv);
+  std::vector<double> products (dim+1), coefficients (dim);
+  internal::NonBlockingInnerProducts<VECTOR> inner_products;
+
+  for (unsigned int i=0; i<dim; ++i)
+    h(i) = 0;
+
+  double norm_vv = 0;
+  for (unsigned int pass=0; pass<2; ++pass)
+    {
+      inner_products.start (pairs);
+      inner_products.finish (products);
+
+      // subtract the projections. as the basis vectors are orthonormal, the
+      // square of the norm of the result is the square of the norm of vv
+      // minus the squares of the projections
+      const double norm_vv_start_sq = products[dim];
+      double norm_vv_sq = norm_vv_start_sq;
+      for (unsigned int i=0; i<dim; ++i)
+        {
+          coefficients[i] = -products[i];
+          h(i) += products[i];
+          norm_vv_sq -= products[i] * products[i];
+        }
+      internal::SolverGMRES::add_linear_combination (orthogonal_vectors,
+                                                     coefficients, vv);
+
+      // accept the result of the first pass if there was little
+      // cancellation, following the criterion of Daniel, Gragg, Kaufman and
+      // Stewart
+      if (pass == 0 && re_orthogonalize == false &&
+          norm_vv_sq > 0.5 * norm_vv_start_sq)
+        return std::sqrt(norm_vv_sq);
+
+      norm_vv = (norm_vv_sq > 0.5 * norm_vv_start_sq ?
+                 std::sqrt(norm_vv_sq) : vv.l2_norm());
+    }
+
+  return norm_vv;
+}
+
+
+
 template<class VECTOR>
 inline void
 SolverGMRES<VECTOR>::compute_eigs_and_cond(
@@ -913,9 +1064,12 @@ SolverGMRES<VECTOR>::solve (const MATRIX         &A,
 
           dim = inner_iteration+1;
 
-          const double s = modified_gram_schmidt(tmp_vectors, dim,
-                                                 accumulated_iterations,
-                                                 vv, h, re_orthogonalize);
+          const double s = (additional_data.use_classical_gram_schmidt ?
+                            classical_gram_schmidt(tmp_vectors, dim, vv, h,
+                                                   re_orthogonalize) :
+                            modified_gram_schmidt(tmp_vectors, dim,
+                                                  accumulated_iterations,
+                                                  vv, h, re_orthogonalize));
           h(inner_iteration+1) = s;
 
           //s=0 is a lucky breakdown, the solver will reach convergence,
@@ -959,14 +1113,17 @@ SolverGMRES<VECTOR>::solve (const MATRIX         &A,
 
               H1.backward(h_,*gamma_);
 
+              const std::vector<double> coefficients (h_.begin(), h_.end());
               if (left_precondition)
-                for (unsigned int i=0 ; i<dim; ++i)
-                  x_->add(h_(i), tmp_vectors[i]);
+                internal::SolverGMRES::add_linear_combination (tmp_vectors,
+                                                               coefficients,
+                                                               *x_);
               else
                 {
                   p = 0.;
-                  for (unsigned int i=0; i<dim; ++i)
-                    p.add(h_(i), tmp_vectors[i]);
+                  internal::SolverGMRES::add_linear_combination (tmp_vectors,
+                                                                 coefficients,
+                                                                 p);
                   precondition.vmult(*r,p);
                   x_->add(1.,*r);
                 };
@@ -1006,14 +1163,15 @@ SolverGMRES<VECTOR>::solve (const MATRIX         &A,
 
       H1.backward(h,gamma);
 
+      const std::vector<double> coefficients (h.begin(), h.end());
       if (left_precondition)
-        for (unsigned int i=0 ; i<dim; ++i)
-          x.add(h(i), tmp_vectors[i]);
+        internal::SolverGMRES::add_linear_combination (tmp_vectors,
+                                                       coefficients, x);
       else
         {
           p = 0.;
-          for (unsigned int i=0; i<dim; ++i)
-            p.add(h(i), tmp_vectors[i]);
+          internal::SolverGMRES::add_linear_combination (tmp_vectors,
+                                                         coefficients, p);
           precondition.vmult(v,p);
           x.add(1.,v);
         };
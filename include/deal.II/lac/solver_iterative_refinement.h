@@ -0,0 +1,329 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__solver_iterative_refinement_h
+#define dealii__solver_iterative_refinement_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Mixed precision iterative refinement. The outer iteration of this solver
+ * computes the residual $r=b-Ax$ of the current approximation in the
+ * precision of the vector type @p VECTOR (usually double), converts it to
+ * the vector type @p INNER_VECTOR (usually float), and solves the correction
+ * equation $Ad=r$ approximately with an inner Krylov solver that runs
+ * entirely in the lower precision. The correction is converted back and
+ * added to the solution. Since the residual is always computed in high
+ * precision, the method converges to the accuracy of the high precision
+ * even though the inner solver only reduces the residual by a few orders of
+ * magnitude in each outer iteration.
+ *
+ * The inner operator and the inner preconditioner are given separately from
+ * the outer operator, e.g. a SparseMatrix<float> that is a copy of the
+ * SparseMatrix<double> of the outer iteration together with a
+ * PreconditionSSOR<SparseMatrix<float> > or a SparseILU<float>, or a
+ * matrix-free operator based on MatrixFree<dim,float> together with a
+ * PreconditionChebyshev acting on parallel::distributed::Vector<float>. As
+ * the inner iterations usually make up most of the work and their cost is
+ * dominated by memory transfer, running them in single precision halves the
+ * cost of most of the solution process. For matrix-free operators, also
+ * twice as many cells are processed per SIMD instruction.
+ *
+ * The inner vectors are initialized from the outer solution vector through
+ * <tt>INNER_VECTOR::reinit(const VECTOR&, bool)</tt>. For
+ * parallel::distributed::Vector, this requires the parallel layout of the
+ * outer vectors to be compatible with the inner operator, which is the case
+ * if both are set up from the same DoFHandler and ConstraintMatrix.
+ *
+ * The inner solver is SolverCG for symmetric problems or SolverGMRES
+ * otherwise, see AdditionalData. If the inner solver does not reach the
+ * requested reduction within the maximal number of inner iterations, the
+ * correction computed so far is used without raising an error. The
+ * convergence criterion of the outer iteration is the $l_2$ norm of the
+ * residual computed in high precision, which is evaluated at the beginning
+ * of each outer iteration.
+ */
+template <class VECTOR = Vector<double>, class INNER_VECTOR = Vector<float> >
+class SolverIterativeRefinement : public Solver<VECTOR>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Krylov methods available for the inner solver.
+     */
+    enum InnerSolver
+    {
+      /**
+       * Conjugate gradients, for symmetric positive definite operators and
+       * preconditioners.
+       */
+      cg,
+      /**
+       * Restarted GMRES with the default settings of SolverGMRES.
+       */
+      gmres
+    };
+
+    /**
+     * Constructor. By default, the inner solver reduces the residual by three
+     * orders of magnitude, which is safely above the accuracy of single
+     * precision arithmetic.
+     */
+    AdditionalData (const InnerSolver  inner_solver = cg,
+                    const double       inner_reduction = 1e-3,
+                    const unsigned int max_inner_iterations = 200);
+
+    /**
+     * The inner Krylov method.
+     */
+    InnerSolver inner_solver;
+
+    /**
+     * Relative reduction of the residual requested from the inner solver in
+     * each outer iteration.
+     */
+    double inner_reduction;
+
+    /**
+     * Maximal number of iterations of the inner solver in each outer
+     * iteration.
+     */
+    unsigned int max_inner_iterations;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverIterativeRefinement (SolverControl              &cn,
+                             VectorMemory<VECTOR>       &mem,
+                             VectorMemory<INNER_VECTOR> &inner_mem,
+                             const AdditionalData       &data = AdditionalData());
+
+  /**
+   * Constructor. Use objects of type GrowingVectorMemory as a default to
+   * allocate memory for the outer and the inner vectors.
+   */
+  SolverIterativeRefinement (SolverControl        &cn,
+                             const AdditionalData &data = AdditionalData());
+
+  /**
+   * Solve the linear system $Ax=b$ for x, using @p inner_A and @p
+   * inner_precondition in the inner solver. @p inner_A must be an
+   * approximation of @p A, usually the same operator in lower precision.
+   */
+  template <class MATRIX, class INNER_MATRIX, class INNER_PRECONDITIONER>
+  void
+  solve (const MATRIX               &A,
+         VECTOR                     &x,
+         const VECTOR               &b,
+         const INNER_MATRIX         &inner_A,
+         const INNER_PRECONDITIONER &inner_precondition);
+
+  /**
+   * Return the total number of inner iterations performed in the last call
+   * to solve().
+   */
+  unsigned int n_inner_iterations () const;
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * Memory for the inner vectors, used if no memory is given to the
+   * constructor.
+   */
+  GrowingVectorMemory<INNER_VECTOR> static_inner_memory;
+
+  /**
+   * Memory used for the inner vectors and the inner solver.
+   */
+  VectorMemory<INNER_VECTOR> &inner_memory;
+
+  /**
+   * Total number of inner iterations of the last solve.
+   */
+  unsigned int inner_iterations;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <class VECTOR, class INNER_VECTOR>
+inline
+SolverIterativeRefinement<VECTOR,INNER_VECTOR>::AdditionalData::
+AdditionalData (const InnerSolver  inner_solver,
+                const double       inner_reduction,
+                const unsigned int max_inner_iterations)
+  :
+  inner_solver (inner_solver),
+  inner_reduction (inner_reduction),
+  max_inner_iterations (max_inner_iterations)
+{}
+
+
+
+template <class VECTOR, class INNER_VECTOR>
+SolverIterativeRefinement<VECTOR,INNER_VECTOR>::
+SolverIterativeRefinement (SolverControl              &cn,
+                           VectorMemory<VECTOR>       &mem,
+                           VectorMemory<INNER_VECTOR> &inner_mem,
+                           const AdditionalData       &data)
+  :
+  Solver<VECTOR>(cn,mem),
+  additional_data(data),
+  inner_memory(inner_mem),
+  inner_iterations(0)
+{}
+
+
+
+template <class VECTOR, class INNER_VECTOR>
+SolverIterativeRefinement<VECTOR,INNER_VECTOR>::
+SolverIterativeRefinement (SolverControl        &cn,
+                           const AdditionalData &data)
+  :
+  Solver<VECTOR>(cn),
+  additional_data(data),
+  inner_memory(static_inner_memory),
+  inner_iterations(0)
+{}
+
+
+
+template <class VECTOR, class INNER_VECTOR>
+unsigned int
+SolverIterativeRefinement<VECTOR,INNER_VECTOR>::n_inner_iterations () const
+{
+  return inner_iterations;
+}
+
+
+
+template <class VECTOR, class INNER_VECTOR>
+template <class MATRIX, class INNER_MATRIX, class INNER_PRECONDITIONER>
+void
+SolverIterativeRefinement<VECTOR,INNER_VECTOR>::
+solve (const MATRIX               &A,
+       VECTOR                     &x,
+       const VECTOR               &b,
+       const INNER_MATRIX         &inner_A,
+       const INNER_PRECONDITIONER &inner_precondition)
+{
+  SolverControl::State conv = SolverControl::iterate;
+
+  deallog.push("iterative refinement");
+
+  double res = -std::numeric_limits<double>::max();
+  unsigned int it = 0;
+  inner_iterations = 0;
+
+  try
+    {
+      // r is the residual in high precision, which is also used to convert
+      // the correction back. the inner vectors hold the residual and the
+      // correction in low precision
+      typename VectorMemory<VECTOR>::Pointer r (this->memory);
+      typename VectorMemory<INNER_VECTOR>::Pointer inner_r (inner_memory),
+               inner_d (inner_memory);
+      r->reinit (x, true);
+      inner_r->reinit (x, true);
+      inner_d->reinit (x, true);
+
+      while (true)
+        {
+          A.vmult (*r, x);
+          r->sadd (-1., 1., b);
+          res = r->l2_norm();
+
+          conv = this->iteration_status (it, res, x);
+          if (conv != SolverControl::iterate)
+            break;
+
+          *inner_r = *r;
+          *inner_d = 0;
+
+          // solve for the correction. if the inner solver does not converge,
+          // the correction computed so far is still an improvement, and the
+          // outer iteration decides about convergence
+          ReductionControl inner_control (additional_data.max_inner_iterations,
+                                          0., additional_data.inner_reduction,
+                                          false, false);
+          try
+            {
+              if (additional_data.inner_solver == AdditionalData::gmres)
+                {
+                  SolverGMRES<INNER_VECTOR> inner_solver (inner_control, inner_memory);
+                  inner_solver.solve (inner_A, *inner_d, *inner_r, inner_precondition);
+                }
+              else
+                {
+                  SolverCG<INNER_VECTOR> inner_solver (inner_control, inner_memory);
+                  inner_solver.solve (inner_A, *inner_d, *inner_r, inner_precondition);
+                }
+            }
+          catch (SolverControl::NoConvergence &)
+            {}
+          inner_iterations += inner_control.last_step();
+
+          *r = *inner_d;
+          x += *r;
+          ++it;
+        }
+    }
+  catch (...)
+    {
+      deallog.pop();
+      throw;
+    }
+
+  deallog.pop();
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
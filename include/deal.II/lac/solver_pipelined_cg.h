@@ -0,0 +1,470 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__solver_pipelined_cg_h
+#define dealii__solver_pipelined_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/non_blocking_inner_products.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/parallel.h>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Pipelined preconditioned cg method for symmetric positive definite
+ * matrices, following P. Ghysels and W. Vanroose, "Hiding global
+ * synchronization latency in the preconditioned Conjugate Gradient
+ * algorithm", Parallel Computing 40 (2014), pp. 224-238.
+ *
+ * The classical cg method as implemented in SolverCG needs two global
+ * reductions per iteration that each have to complete before the iteration
+ * can proceed. On large parallel machines, the latency of these reductions
+ * can dominate the run time. The pipelined variant reformulates the
+ * recurrences with additional auxiliary vectors such that all inner products
+ * of an iteration (including the one for the residual norm) are computed in
+ * a single reduction, and such that this reduction can be overlapped with the
+ * application of the preconditioner and the matrix-vector product of the
+ * same iteration.
+ *
+ * For vectors of type parallel::distributed::Vector, the reduction is
+ * non-blocking (see internal::NonBlockingInnerProducts); for all other
+ * vector types, the method is mathematically equivalent to SolverCG but
+ * offers no advantage over it. The price to pay is a larger number of
+ * temporary vectors (nine instead of three) and more vector updates per
+ * iteration. For dealii::Vector and parallel::distributed::Vector, the eight
+ * vector updates of an iteration and the local parts of the inner products
+ * for the next iteration are done in a single sweep over the vectors to
+ * reduce the memory traffic. Moreover, the recurrences for the residual are known to be
+ * somewhat less stable than in classical cg, so the attainable accuracy
+ * may be slightly lower for very small tolerances.
+ *
+ * Like SolverCG, this class requires a symmetric preconditioner. The
+ * convergence criterion is the norm of the (unpreconditioned) residual as
+ * computed by the recurrence, which is evaluated at the beginning of each
+ * iteration.
+ */
+template <class VECTOR = Vector<double> >
+class SolverPipelinedCG : public Solver<VECTOR>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver. There is
+   * no data in here for this class.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor.
+   */
+  SolverPipelinedCG (SolverControl        &cn,
+                     VectorMemory<VECTOR> &mem,
+                     const AdditionalData &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverPipelinedCG (SolverControl        &cn,
+                     const AdditionalData &data = AdditionalData());
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <class MATRIX, class PRECONDITIONER>
+  void
+  solve (const MATRIX         &A,
+         VECTOR               &x,
+         const VECTOR         &b,
+         const PRECONDITIONER &precondition);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverPipelinedCG
+  {
+    // Update the search directions p, s, q, z and then the vectors x, r, u,
+    // w of one iteration, and start the reduction for the inner products
+    // (r,u), (w,u), (r,r) of the next iteration. The general version
+    // calls the vector operations one after the other
+    template <class VECTOR>
+    void
+    update_vectors (const bool first_iteration,
+                    const double alpha,
+                    const double beta,
+                    const VECTOR &m,
+                    const VECTOR &n,
+                    VECTOR &x, VECTOR &r, VECTOR &u, VECTOR &w,
+                    VECTOR &p, VECTOR &s, VECTOR &q, VECTOR &z,
+                    internal::NonBlockingInnerProducts<VECTOR> &inner_products)
+    {
+      if (first_iteration)
+        {
+          z.equ (1., n);
+          q.equ (1., m);
+          s.equ (1., w);
+          p.equ (1., u);
+        }
+      else
+        {
+          z.sadd (beta, 1., n);
+          q.sadd (beta, 1., m);
+          s.sadd (beta, 1., w);
+          p.sadd (beta, 1., u);
+        }
+
+      x.add (alpha, p);
+      r.add (-alpha, s);
+      u.add (-alpha, q);
+      w.add (-alpha, z);
+
+      std::vector<std::pair<const VECTOR *, const VECTOR *> > pairs (3);
+      pairs[0] = std::make_pair (&r, &u);
+      pairs[1] = std::make_pair (&w, &u);
+      pairs[2] = std::make_pair (&r, &r);
+      inner_products.start (pairs);
+    }
+
+
+
+    // Functor for the fused update of vectors with contiguous storage. All
+    // eight vector updates and the local parts of the three inner products
+    // are done in one sweep over the vector entries, so each vector is
+    // transferred from memory once instead of up to five times. The vector
+    // is split into blocks of fixed size whose inner product contributions
+    // are summed in a fixed order, which makes the result independent of
+    // the number of threads
+    template <typename Number>
+    struct FusedUpdate
+    {
+      static const unsigned int block_size = 512;
+
+      void operator() (const std::size_t begin_block,
+                       const std::size_t end_block) const
+      {
+        for (std::size_t block=begin_block; block<end_block; ++block)
+          {
+            const std::size_t start = block * block_size;
+            const std::size_t stop = std::min<std::size_t>(size, start+block_size);
+            double ru = 0, wu = 0, rr = 0;
+            for (std::size_t i=start; i<stop; ++i)
+              {
+                if (first_iteration)
+                  {
+                    z[i] = n[i];
+                    q[i] = m[i];
+                    s[i] = w[i];
+                    p[i] = u[i];
+                  }
+                else
+                  {
+                    z[i] = beta * z[i] + n[i];
+                    q[i] = beta * q[i] + m[i];
+                    s[i] = beta * s[i] + w[i];
+                    p[i] = beta * p[i] + u[i];
+                  }
+                x[i] += alpha * p[i];
+                r[i] -= alpha * s[i];
+                u[i] -= alpha * q[i];
+                w[i] -= alpha * z[i];
+                ru += r[i] * u[i];
+                wu += w[i] * u[i];
+                rr += r[i] * r[i];
+              }
+            (*block_sums)[3*block]   = ru;
+            (*block_sums)[3*block+1] = wu;
+            (*block_sums)[3*block+2] = rr;
+          }
+      }
+
+      // run the update on all entries and return the local inner products
+      void run (std::vector<double> &local_products)
+      {
+        const std::size_t n_blocks = (size + block_size - 1) / block_size;
+        std::vector<double> sums (3 * n_blocks);
+        block_sums = &sums;
+        if (size > internal::Vector::minimum_parallel_grain_size)
+          parallel::apply_to_subranges (std::size_t(0), n_blocks, *this,
+                                        internal::Vector::minimum_parallel_grain_size/block_size+1);
+        else
+          (*this)(0, n_blocks);
+
+        local_products.assign (3, 0.);
+        for (std::size_t block=0; block<n_blocks; ++block)
+          for (unsigned int c=0; c<3; ++c)
+            local_products[c] += sums[3*block+c];
+      }
+
+      bool first_iteration;
+      Number alpha, beta;
+      std::size_t size;
+      const Number *m, *n;
+      Number *x, *r, *u, *w, *p, *s, *q, *z;
+      std::vector<double> *block_sums;
+    };
+
+
+
+    // set up the fused update from the pointers to the (locally owned)
+    // vector entries
+    template <typename Number, class VECTOR>
+    void
+    run_fused_update (const bool first_iteration,
+                      const double alpha,
+                      const double beta,
+                      const std::size_t size,
+                      const VECTOR &m,
+                      const VECTOR &n,
+                      VECTOR &x, VECTOR &r, VECTOR &u, VECTOR &w,
+                      VECTOR &p, VECTOR &s, VECTOR &q, VECTOR &z,
+                      std::vector<double> &local_products)
+    {
+      FusedUpdate<Number> update;
+      update.first_iteration = first_iteration;
+      update.alpha = alpha;
+      update.beta = beta;
+      update.size = size;
+      update.m = m.begin();
+      update.n = n.begin();
+      update.x = x.begin();
+      update.r = r.begin();
+      update.u = u.begin();
+      update.w = w.begin();
+      update.p = p.begin();
+      update.s = s.begin();
+      update.q = q.begin();
+      update.z = z.begin();
+      update.run (local_products);
+    }
+
+
+
+    template <typename Number>
+    void
+    update_vectors (const bool first_iteration,
+                    const double alpha,
+                    const double beta,
+                    const dealii::Vector<Number> &m,
+                    const dealii::Vector<Number> &n,
+                    dealii::Vector<Number> &x, dealii::Vector<Number> &r,
+                    dealii::Vector<Number> &u, dealii::Vector<Number> &w,
+                    dealii::Vector<Number> &p, dealii::Vector<Number> &s,
+                    dealii::Vector<Number> &q, dealii::Vector<Number> &z,
+                    internal::NonBlockingInnerProducts<dealii::Vector<Number> > &inner_products)
+    {
+      std::vector<double> products;
+      run_fused_update<Number> (first_iteration, alpha, beta, x.size(),
+                                m, n, x, r, u, w, p, s, q, z, products);
+      inner_products.start_reduction (products);
+    }
+
+
+
+    template <typename Number>
+    void
+    update_vectors (const bool first_iteration,
+                    const double alpha,
+                    const double beta,
+                    const parallel::distributed::Vector<Number> &m,
+                    const parallel::distributed::Vector<Number> &n,
+                    parallel::distributed::Vector<Number> &x,
+                    parallel::distributed::Vector<Number> &r,
+                    parallel::distributed::Vector<Number> &u,
+                    parallel::distributed::Vector<Number> &w,
+                    parallel::distributed::Vector<Number> &p,
+                    parallel::distributed::Vector<Number> &s,
+                    parallel::distributed::Vector<Number> &q,
+                    parallel::distributed::Vector<Number> &z,
+                    internal::NonBlockingInnerProducts<parallel::distributed::Vector<Number> > &inner_products)
+    {
+      std::vector<double> products;
+      run_fused_update<Number> (first_iteration, alpha, beta, x.local_size(),
+                                m, n, x, r, u, w, p, s, q, z, products);
+
+      // the update only touched the locally owned elements, so bring the
+      // ghosts of the solution vector up to date in case the user asked for
+      // them
+      if (x.has_ghost_elements())
+        x.update_ghost_values();
+
+      inner_products.start_reduction (products, x.get_mpi_communicator());
+    }
+  }
+}
+
+
+template <class VECTOR>
+SolverPipelinedCG<VECTOR>::SolverPipelinedCG (SolverControl        &cn,
+                                              VectorMemory<VECTOR> &mem,
+                                              const AdditionalData &data)
+  :
+  Solver<VECTOR>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <class VECTOR>
+SolverPipelinedCG<VECTOR>::SolverPipelinedCG (SolverControl        &cn,
+                                              const AdditionalData &data)
+  :
+  Solver<VECTOR>(cn),
+  additional_data(data)
+{}
+
+
+
+template <class VECTOR>
+template <class MATRIX, class PRECONDITIONER>
+void
+SolverPipelinedCG<VECTOR>::solve (const MATRIX         &A,
+                                  VECTOR               &x,
+                                  const VECTOR         &b,
+                                  const PRECONDITIONER &precondition)
+{
+  SolverControl::State conv = SolverControl::iterate;
+
+  deallog.push("pipelined cg");
+
+  double res = -std::numeric_limits<double>::max();
+  unsigned int it = 0;
+
+  try
+    {
+      // the vectors of the algorithm, using the notation of Ghysels and
+      // Vanroose: r is the residual, u the preconditioned residual, w=Au,
+      // m=Pw, n=Am, and p, s, q, z are the search direction and its images
+      // under A, PA, and APA
+      typename VectorMemory<VECTOR>::Pointer r (this->memory), u (this->memory),
+               w (this->memory), m (this->memory), n (this->memory),
+               p (this->memory), s (this->memory), q (this->memory),
+               z (this->memory);
+
+      r->reinit (x, true);
+      u->reinit (x, true);
+      w->reinit (x, true);
+      m->reinit (x, true);
+      n->reinit (x, true);
+      p->reinit (x, true);
+      s->reinit (x, true);
+      q->reinit (x, true);
+      z->reinit (x, true);
+
+      // compute residual. if vector is zero, then short-circuit the full
+      // computation
+      if (!x.all_zero())
+        {
+          A.vmult (*r, x);
+          r->sadd (-1., 1., b);
+        }
+      else
+        r->equ (1., b);
+
+      precondition.vmult (*u, *r);
+      A.vmult (*w, *u);
+
+      // start the reduction for gamma=(r,u), delta=(w,u) and the residual
+      // norm. In each iteration, the reduction is overlapped with the
+      // preconditioner and the matrix-vector product, and the reduction for
+      // the next iteration is started right after the vector updates
+      internal::NonBlockingInnerProducts<VECTOR> inner_products;
+      std::vector<std::pair<const VECTOR *, const VECTOR *> > pairs (3);
+      pairs[0] = std::make_pair (&*r, &*u);
+      pairs[1] = std::make_pair (&*w, &*u);
+      pairs[2] = std::make_pair (&*r, &*r);
+      std::vector<double> products (3);
+      inner_products.start (pairs);
+
+      double gamma_old = 0, alpha = 0;
+      while (true)
+        {
+          precondition.vmult (*m, *w);
+          A.vmult (*n, *m);
+
+          inner_products.finish (products);
+          const double gamma = products[0];
+          const double delta = products[1];
+          res = std::sqrt (products[2]);
+
+          conv = this->iteration_status (it, res, x);
+          if (conv != SolverControl::iterate)
+            break;
+
+          double beta = 0;
+          if (it == 0)
+            {
+              Assert (delta != 0., ExcDivideByZero());
+              alpha = gamma / delta;
+            }
+          else
+            {
+              Assert (gamma_old != 0., ExcDivideByZero());
+              beta = gamma / gamma_old;
+              const double denominator = delta - beta * gamma / alpha;
+              Assert (denominator != 0., ExcDivideByZero());
+              alpha = gamma / denominator;
+            }
+          gamma_old = gamma;
+
+          internal::SolverPipelinedCG::update_vectors (it == 0, alpha, beta,
+                                                       *m, *n, x, *r, *u, *w,
+                                                       *p, *s, *q, *z,
+                                                       inner_products);
+
+          ++it;
+        }
+    }
+  catch (...)
+    {
+      deallog.pop();
+      throw;
+    }
+
+  deallog.pop();
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
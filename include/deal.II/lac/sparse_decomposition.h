@@ -17,6 +17,8 @@
 #define dealii__sparse_decomposition_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <cmath>
@@ -92,6 +94,35 @@ DEAL_II_NAMESPACE_OPEN
  * <code>*use_this_sparsity</code> is used to store the decomposed matrix. For
  * restrictions on the sparsity see section `Fill-in' above).
  *
+ * 5/ By setting <code>use_level_scheduling=true</code>, the rows are grouped
+ * into levels such that the rows within one level do not depend on each
+ * other in the forward and backward substitutions, see the section on
+ * parallelization below.
+ *
+ *
+ * <h3>Parallelization</h3>
+ *
+ * The factorization and the forward and backward substitutions in vmult()
+ * are inherently sequential: row $i$ can only be processed once all rows $j$
+ * with nonzero entries $a_{ij}$ left of (in the backward substitution: right
+ * of) the diagonal have been processed. If
+ * AdditionalData::use_level_scheduling is set, initialize() computes the
+ * level of each row in the directed graph of these dependencies, i.e., one
+ * plus the largest level among the rows the row depends on. All rows of a
+ * level can then be processed concurrently, and the levels are processed
+ * one after the other. SparseILU and SparseMIC use this schedule for the
+ * factorization and for vmult(). The result is identical to the sequential
+ * one, since the operations within each row are done in the same order.
+ *
+ * The available parallelism depends on the ordering of the unknowns: For
+ * the five-point stencil on an $n\times n$ grid with lexicographic
+ * numbering, there are $2n-1$ levels with up to $n$ rows each, while a
+ * numbering by Cuthill-McKee gives similar numbers. Orderings that color the
+ * unknowns such that no two neighbors have the same color (e.g. a red-black
+ * ordering) result in as many levels as there are colors, with the usual
+ * trade-off that the incomplete factorization is a weaker preconditioner
+ * for such orderings.
+ *
  *
  * <h3>Particular implementations</h3>
  *
@@ -148,7 +179,8 @@ public:
     AdditionalData (const double strengthen_diagonal=0,
                     const unsigned int extra_off_diagonals=0,
                     const bool use_previous_sparsity=false,
-                    const SparsityPattern *use_this_sparsity=0);
+                    const SparsityPattern *use_this_sparsity=0,
+                    const bool use_level_scheduling=false);
 
     /**
      * <code>strengthen_diag</code> times the sum of absolute row entries is
@@ -191,6 +223,14 @@ public:
      * matrix.
      */
     const SparsityPattern *use_this_sparsity;
+
+    /**
+     * If this flag is true, the factorization and the application of the
+     * preconditioner process independent rows in parallel, using the level
+     * schedule described in the class documentation. The default is
+     * <code>false</code>.
+     */
+    bool use_level_scheduling;
   };
 
   /**
@@ -312,10 +352,43 @@ protected:
   std::vector<const size_type *> prebuilt_lower_bound;
 
   /**
-   * Fills the #prebuilt_lower_bound array.
+   * Fills the #prebuilt_lower_bound array and, if requested in the
+   * AdditionalData object given to initialize(), the level schedule.
    */
   void prebuild_lower_bound ();
 
+  /**
+   * Call @p row_function with the index of each row of the matrix. If no
+   * level schedule has been computed, the rows are visited in ascending
+   * order or, if @p backward is true, in descending order. Otherwise, the
+   * levels of the forward (or backward) substitution are visited one after
+   * the other, and the rows within each level are visited in parallel.
+   */
+  template <typename RowFunction>
+  void apply_to_rows (const bool         backward,
+                      const RowFunction &row_function) const;
+
+  /**
+   * Whether to use the level schedule.
+   */
+  bool use_level_scheduling;
+
+  /**
+   * The rows of the matrix sorted by their level in the dependency graph of
+   * the forward substitution, i.e., of the entries left of the diagonal, and
+   * the position in this array where each level starts. Empty if no level
+   * schedule is used.
+   */
+  std::vector<size_type> forward_level_rows;
+  std::vector<size_type> forward_level_start;
+
+  /**
+   * The same as above for the backward substitution, i.e., the entries right
+   * of the diagonal.
+   */
+  std::vector<size_type> backward_level_rows;
+  std::vector<size_type> backward_level_start;
+
 private:
 
   /**
@@ -335,6 +408,64 @@ private:
 
 #ifndef DOXYGEN
 
+namespace internal
+{
+  namespace SparseLUDecomposition
+  {
+    /**
+     * Call @p row_function for the rows stored at positions
+     * <tt>[begin,end)</tt> of @p level_rows.
+     */
+    template <typename size_type, typename RowFunction>
+    void
+    apply_to_level_range (const size_type               begin,
+                          const size_type               end,
+                          const std::vector<size_type> &level_rows,
+                          const RowFunction            &row_function)
+    {
+      for (size_type i=begin; i<end; ++i)
+        row_function (level_rows[i]);
+    }
+  }
+}
+
+
+
+template <typename number>
+template <typename RowFunction>
+inline void
+SparseLUDecomposition<number>::apply_to_rows (const bool         backward,
+                                              const RowFunction &row_function) const
+{
+  const std::vector<size_type> &level_rows
+    = backward ? backward_level_rows : forward_level_rows;
+  const std::vector<size_type> &level_start
+    = backward ? backward_level_start : forward_level_start;
+
+  if (level_start.empty())
+    {
+      const size_type N = this->m();
+      if (backward == false)
+        for (size_type row=0; row<N; ++row)
+          row_function (row);
+      else
+        for (size_type row=N; row>0; --row)
+          row_function (row-1);
+      return;
+    }
+
+  for (unsigned int level=0; level+1<level_start.size(); ++level)
+    parallel::apply_to_subranges (level_start[level], level_start[level+1],
+                                  std_cxx11::bind (&internal::SparseLUDecomposition::
+                                                   apply_to_level_range<size_type,RowFunction>,
+                                                   std_cxx11::_1, std_cxx11::_2,
+                                                   std_cxx11::cref(level_rows),
+                                                   std_cxx11::cref(row_function)),
+                                  64);
+}
+
+
+
 template <typename number>
 inline number
 SparseLUDecomposition<number>::
@@ -409,11 +540,13 @@ SparseLUDecomposition<number>::AdditionalData::AdditionalData (
   const double strengthen_diag,
   const unsigned int extra_off_diag,
   const bool use_prev_sparsity,
-  const SparsityPattern *use_this_spars):
+  const SparsityPattern *use_this_spars,
+  const bool use_level_sched):
   strengthen_diagonal(strengthen_diag),
   extra_off_diagonals(extra_off_diag),
   use_previous_sparsity(use_prev_sparsity),
-  use_this_sparsity(use_this_spars)
+  use_this_sparsity(use_this_spars),
+  use_level_scheduling(use_level_sched)
 {}
 
 
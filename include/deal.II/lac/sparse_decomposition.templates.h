@@ -31,6 +31,7 @@ template<typename number>
 SparseLUDecomposition<number>::SparseLUDecomposition()
   :
   SparseMatrix<number>(),
+  use_level_scheduling(false),
   own_sparsity(0)
 {}
 
@@ -48,6 +49,11 @@ void SparseLUDecomposition<number>::clear()
 {
   std::vector<const size_type *> tmp;
   tmp.swap (prebuilt_lower_bound);
+  use_level_scheduling = false;
+  std::vector<size_type>().swap (forward_level_rows);
+  std::vector<size_type>().swap (forward_level_start);
+  std::vector<size_type>().swap (backward_level_rows);
+  std::vector<size_type>().swap (backward_level_start);
 
   SparseMatrix<number>::clear();
 
@@ -123,11 +129,48 @@ void SparseLUDecomposition<number>::initialize (
     std::vector<const size_type *> tmp;
     tmp.swap (prebuilt_lower_bound);
   }
+  use_level_scheduling = data.use_level_scheduling;
+  forward_level_rows.clear ();
+  forward_level_start.clear ();
+  backward_level_rows.clear ();
+  backward_level_start.clear ();
   SparseMatrix<number>::reinit (*sparsity_pattern_to_use);
 }
 
 
 
+namespace internal
+{
+  namespace SparseLUDecomposition
+  {
+    /**
+     * Sort the rows by the levels given in @p row_level into @p level_rows,
+     * and store the position where each level starts in @p level_start.
+     * Within each level, the rows are sorted in ascending order.
+     */
+    template <typename size_type>
+    void
+    sort_rows_by_level (const std::vector<size_type> &row_level,
+                        const size_type               n_levels,
+                        std::vector<size_type>       &level_rows,
+                        std::vector<size_type>       &level_start)
+    {
+      level_start.assign (n_levels+1, 0);
+      for (size_type row=0; row<row_level.size(); ++row)
+        ++level_start[row_level[row]+1];
+      for (size_type level=0; level<n_levels; ++level)
+        level_start[level+1] += level_start[level];
+
+      std::vector<size_type> position (level_start.begin(), level_start.end()-1);
+      level_rows.resize (row_level.size());
+      for (size_type row=0; row<row_level.size(); ++row)
+        level_rows[position[row_level[row]]++] = row;
+    }
+  }
+}
+
+
+
 template<typename number>
 void
 SparseLUDecomposition<number>::prebuild_lower_bound()
@@ -147,6 +190,44 @@ SparseLUDecomposition<number>::prebuild_lower_bound()
                                   &column_numbers[rowstart_indices[row+1]],
                                   row);
     }
+
+  if (use_level_scheduling == false)
+    return;
+
+  // the level of a row is one more than the largest level of the rows it
+  // depends on. in the forward substitution, these are the columns left of
+  // the diagonal, which all have smaller indices, so one sweep in ascending
+  // order determines all levels. the same holds for the backward
+  // substitution in descending order
+  std::vector<size_type> row_level (N, 0);
+  size_type n_levels = 0;
+  for (size_type row=0; row<N; ++row)
+    {
+      size_type level = 0;
+      for (const size_type *col=&column_numbers[rowstart_indices[row]+1];
+           col != prebuilt_lower_bound[row]; ++col)
+        level = std::max (level, row_level[*col]+1);
+      row_level[row] = level;
+      n_levels = std::max (n_levels, level+1);
+    }
+  internal::SparseLUDecomposition::sort_rows_by_level (row_level, n_levels,
+                                                       forward_level_rows,
+                                                       forward_level_start);
+
+  n_levels = 0;
+  for (size_type row=N; row>0; )
+    {
+      --row;
+      size_type level = 0;
+      for (const size_type *col=prebuilt_lower_bound[row];
+           col != &column_numbers[rowstart_indices[row+1]]; ++col)
+        level = std::max (level, row_level[*col]+1);
+      row_level[row] = level;
+      n_levels = std::max (n_levels, level+1);
+    }
+  internal::SparseLUDecomposition::sort_rows_by_level (row_level, n_levels,
+                                                       backward_level_rows,
+                                                       backward_level_start);
 }
 
 template <typename number>
@@ -226,7 +307,11 @@ std::size_t
 SparseLUDecomposition<number>::memory_consumption () const
 {
   return (SparseMatrix<number>::memory_consumption () +
-          MemoryConsumption::memory_consumption(prebuilt_lower_bound));
+          MemoryConsumption::memory_consumption(prebuilt_lower_bound) +
+          MemoryConsumption::memory_consumption(forward_level_rows) +
+          MemoryConsumption::memory_consumption(forward_level_start) +
+          MemoryConsumption::memory_consumption(backward_level_rows) +
+          MemoryConsumption::memory_consumption(backward_level_start));
 }
 
 
@@ -19,6 +19,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/sparse_decomposition.h>
 #include <deal.II/lac/exceptions.h>
@@ -40,6 +41,11 @@ DEAL_II_NAMESPACE_OPEN
  * given in the book Y. Saad: "Iterative methods for sparse linear systems",
  * second edition, in section 10.3.2.
  *
+ * If SparseLUDecomposition::AdditionalData::use_level_scheduling is set,
+ * the factorization and vmult() process independent rows in parallel, see
+ * the documentation of SparseLUDecomposition. Tvmult() is always
+ * sequential.
+ *
  *
  * <h3>Usage and state management</h3>
  *
@@ -154,6 +160,29 @@ public:
                   "that the matrix for which you try to compute a "
                   "decomposition is singular.");
   //@}
+
+private:
+  /**
+   * Compute row @p row of the decomposition, assuming that all rows it
+   * depends on have already been computed. @p workspace provides each thread
+   * with an array that maps column indices to positions within the row.
+   */
+  void factorize_row (const size_type row,
+                      Threads::ThreadLocalStorage<std::vector<size_type> > &workspace);
+
+  /**
+   * Perform the forward substitution with the lower factor for row @p row.
+   */
+  template <typename somenumber>
+  void forward_row (const size_type     row,
+                    Vector<somenumber> &dst) const;
+
+  /**
+   * Perform the backward substitution with the upper factor for row @p row.
+   */
+  template <typename somenumber>
+  void backward_row (const size_type     row,
+                     Vector<somenumber> &dst) const;
 };
 
 /*@}*/
@@ -19,6 +19,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/sparse_ilu.h>
 
@@ -57,7 +58,22 @@ void SparseILU<number>::initialize (const SparseMatrix<somenumber> &matrix,
 
   // in the following, we implement algorithm 10.4 in the book by Saad by
   // translating in essence the algorithm given at the end of section 10.3.2,
-  // using the names of variables used there
+  // using the names of variables used there. each row only depends on the
+  // rows given by its entries left of the diagonal, so we can use the level
+  // schedule of the forward substitution
+  Threads::ThreadLocalStorage<std::vector<size_type> > workspace;
+  this->apply_to_rows (false,
+                       std_cxx11::bind (&SparseILU<number>::factorize_row,
+                                        this, std_cxx11::_1,
+                                        std_cxx11::ref(workspace)));
+}
+
+
+
+template <typename number>
+void SparseILU<number>::factorize_row (const size_type k,
+                                       Threads::ThreadLocalStorage<std::vector<size_type> > &workspace)
+{
   const SparsityPattern     &sparsity = this->get_sparsity_pattern();
   const std::size_t *const ia    = sparsity.rowstart;
   const size_type *const ja      = sparsity.colnums;
@@ -67,72 +83,71 @@ void SparseILU<number>::initialize (const SparseMatrix<somenumber> &matrix,
   const size_type N = this->m();
   size_type jrow = 0;
 
-  std::vector<size_type> iw (N, numbers::invalid_size_type);
+  std::vector<size_type> &iw = workspace.get();
+  if (iw.size() != N)
+    iw.assign (N, numbers::invalid_size_type);
 
-  for (size_type k=0; k<N; ++k)
-    {
-      const size_type j1 = ia[k],
-                      j2 = ia[k+1]-1;
+  const size_type j1 = ia[k],
+                  j2 = ia[k+1]-1;
 
-      for (size_type j=j1; j<=j2; ++j)
-        iw[ja[j]] = j;
+  for (size_type j=j1; j<=j2; ++j)
+    iw[ja[j]] = j;
 
-      // the algorithm in the book works on the elements of row k left of the
-      // diagonal. however, since we store the diagonal element at the first
-      // position, start at the element after the diagonal and run as long as
-      // we don't walk into the right half
-      size_type j = j1+1;
+  // the algorithm in the book works on the elements of row k left of the
+  // diagonal. however, since we store the diagonal element at the first
+  // position, start at the element after the diagonal and run as long as
+  // we don't walk into the right half
+  size_type j = j1+1;
 
-      // pathological case: the current row of the matrix has only the
-      // diagonal entry. then we have nothing to do.
-      if (j > j2)
-        goto label_200;
+  // pathological case: the current row of the matrix has only the
+  // diagonal entry. then we have nothing to do.
+  if (j > j2)
+    goto label_200;
 
 label_150:
 
-      jrow = ja[j];
-      if (jrow >= k)
-        goto label_200;
+  jrow = ja[j];
+  if (jrow >= k)
+    goto label_200;
 
-      // actual computations:
+  // actual computations:
+  {
+    number t1 = luval[j] * luval[ia[jrow]];
+    luval[j] = t1;
+
+    // jj runs from just right of the diagonal to the end of the row
+    size_type jj = ia[jrow]+1;
+    while (ja[jj] < jrow)
+      ++jj;
+    for (; jj<ia[jrow+1]; ++jj)
       {
-        number t1 = luval[j] * luval[ia[jrow]];
-        luval[j] = t1;
-
-        // jj runs from just right of the diagonal to the end of the row
-        size_type jj = ia[jrow]+1;
-        while (ja[jj] < jrow)
-          ++jj;
-        for (; jj<ia[jrow+1]; ++jj)
-          {
-            const size_type jw = iw[ja[jj]];
-            if (jw != numbers::invalid_size_type)
-              luval[jw] -= t1 * luval[jj];
-          }
-
-        ++j;
-        if (j<=j2)
-          goto label_150;
+        const size_type jw = iw[ja[jj]];
+        if (jw != numbers::invalid_size_type)
+          luval[jw] -= t1 * luval[jj];
       }
 
+    ++j;
+    if (j<=j2)
+      goto label_150;
+  }
+
 label_200:
 
-      // in the book there is an assertion that we have hit the diagonal
-      // element, i.e. that jrow==k. however, we store the diagonal element at
-      // the front, so jrow must actually be larger than k or j is already in
-      // the next row
-      Assert ((jrow > k) || (j==ia[k+1]), ExcInternalError());
+  // in the book there is an assertion that we have hit the diagonal
+  // element, i.e. that jrow==k. however, we store the diagonal element at
+  // the front, so jrow must actually be larger than k or j is already in
+  // the next row
+  Assert ((jrow > k) || (j==ia[k+1]), ExcInternalError());
 
-      // now we have to deal with the diagonal element. in the book it is
-      // located at position 'j', but here we use the convention of storing
-      // the diagonal element first, so instead of j we use uptr[k]=ia[k]
-      Assert (luval[ia[k]] != 0, ExcZeroPivot(k));
+  // now we have to deal with the diagonal element. in the book it is
+  // located at position 'j', but here we use the convention of storing
+  // the diagonal element first, so instead of j we use uptr[k]=ia[k]
+  Assert (luval[ia[k]] != 0, ExcZeroPivot(k));
 
-      luval[ia[k]] = 1./luval[ia[k]];
+  luval[ia[k]] = 1./luval[ia[k]];
 
-      for (size_type j=j1; j<=j2; ++j)
-        iw[ja[j]] = numbers::invalid_size_type;
-    }
+  for (size_type j=j1; j<=j2; ++j)
+    iw[ja[j]] = numbers::invalid_size_type;
 }
 
 
@@ -145,12 +160,6 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   Assert (dst.size() == src.size(), ExcDimensionMismatch(dst.size(), src.size()));
   Assert (dst.size() == this->m(), ExcDimensionMismatch(dst.size(), this->m()));
 
-  const size_type N=dst.size();
-  const std::size_t *const rowstart_indices
-    = this->get_sparsity_pattern().rowstart;
-  const size_type *const column_numbers
-    = this->get_sparsity_pattern().colnums;
-
   // solve LUx=b in two steps:
   // first Ly = b, then
   //       Ux = y
@@ -164,50 +173,76 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // perform it at the outset of the
   // loop
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // get start of this row. skip the
-      // diagonal element
-      const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val +
-                            (rowstart - column_numbers);
-      for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-      dst(row) = dst_row;
-    }
+  this->apply_to_rows (false,
+                       std_cxx11::bind (&SparseILU<number>::template forward_row<somenumber>,
+                                        this, std_cxx11::_1, std_cxx11::ref(dst)));
 
   // now the backward solve. same
   // procedure, but we need not set
   // dst before, since this is already
   // done.
-  //
-  // note that we need to scale now,
-  // since the diagonal is not equal to
-  // one now
-  for (int row=N-1; row>=0; --row)
-    {
-      // get end of this row
-      const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+  this->apply_to_rows (true,
+                       std_cxx11::bind (&SparseILU<number>::template backward_row<somenumber>,
+                                        this, std_cxx11::_1, std_cxx11::ref(dst)));
+}
 
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val +
-                            (first_after_diagonal - column_numbers);
-      for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
 
-      // scale by the diagonal element.
-      // note that the diagonal element
-      // was stored inverted
-      dst(row) = dst_row * this->diag_element(row);
-    }
+
+template <typename number>
+template <typename somenumber>
+inline
+void SparseILU<number>::forward_row (const size_type     row,
+                                     Vector<somenumber> &dst) const
+{
+  const std::size_t *const rowstart_indices
+    = this->get_sparsity_pattern().rowstart;
+  const size_type *const column_numbers
+    = this->get_sparsity_pattern().colnums;
+
+  // get start of this row. skip the
+  // diagonal element
+  const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
+  // find the position where the part
+  // right of the diagonal starts
+  const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+  somenumber dst_row = dst(row);
+  const number *luval = this->SparseMatrix<number>::val +
+                        (rowstart - column_numbers);
+  for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
+    dst_row -= *luval * dst(*col);
+  dst(row) = dst_row;
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+inline
+void SparseILU<number>::backward_row (const size_type     row,
+                                      Vector<somenumber> &dst) const
+{
+  const std::size_t *const rowstart_indices
+    = this->get_sparsity_pattern().rowstart;
+  const size_type *const column_numbers
+    = this->get_sparsity_pattern().colnums;
+
+  // get end of this row
+  const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
+  // find the position where the part
+  // right of the diagonal starts
+  const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+  somenumber dst_row = dst(row);
+  const number *luval = this->SparseMatrix<number>::val +
+                        (first_after_diagonal - column_numbers);
+  for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
+    dst_row -= *luval * dst(*col);
+
+  // scale by the diagonal element.
+  // note that the diagonal element
+  // was stored inverted
+  dst(row) = dst_row * this->diag_element(row);
 }
 
 
@@ -28,6 +28,7 @@
 DEAL_II_NAMESPACE_OPEN
 
 template <typename number> class Vector;
+template <typename number> class MultiVector;
 template <typename number> class FullMatrix;
 template <typename Matrix> class BlockMatrixBase;
 template <typename number> class SparseILU;
@@ -1083,6 +1084,33 @@ public:
   void Tvmult_add (OutVector &dst,
                    const InVector &src) const;
 
+  /**
+   * Matrix-vector multiplication with all columns of a MultiVector: let
+   * <i>dst = M*src</i>. Each matrix entry is read once and applied to all
+   * columns of @p src, so the matrix is only transferred from memory once
+   * for all columns. Since the cost of a sparse matrix-vector product is
+   * dominated by loading the matrix, this is considerably faster than
+   * multiplying with each column separately.
+   *
+   * Source and destination must not be the same object.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void vmult (MultiVector<somenumber>       &dst,
+              const MultiVector<somenumber> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication with all columns of a MultiVector:
+   * add <i>M*src</i> to <i>dst</i>. See the vmult() function for
+   * MultiVector arguments above.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void vmult_add (MultiVector<somenumber>       &dst,
+                  const MultiVector<somenumber> &src) const;
+
   /**
    * Return the square of the norm of the vector $v$ with respect to the norm
    * induced by this matrix, i.e. $\left(v,Mv\right)$. This is useful, e.g. in
@@ -1230,6 +1258,15 @@ public:
                             const Vector<somenumber> &src,
                             const number              omega = 1.) const;
 
+  /**
+   * Apply the Jacobi preconditioner to all columns of a MultiVector. This
+   * allows to use PreconditionJacobi with SolverBlockCG.
+   */
+  template <typename somenumber>
+  void precondition_Jacobi (MultiVector<somenumber>       &dst,
+                            const MultiVector<somenumber> &src,
+                            const number                   omega = 1.) const;
+
   /**
    * Apply SSOR preconditioning to <tt>src</tt> with damping <tt>omega</tt>.
    * The optional argument <tt>pos_right_of_diagonal</tt> is supposed to
@@ -1242,6 +1279,46 @@ public:
                           const number                    omega = 1.,
                           const std::vector<std::size_t> &pos_right_of_diagonal=std::vector<std::size_t>()) const;
 
+  /**
+   * Apply SSOR preconditioning to <tt>src</tt> with damping <tt>omega</tt>,
+   * visiting the rows color by color rather than in the order of their
+   * indices. <tt>rows_by_color</tt> lists the rows of color <tt>c</tt> in
+   * the positions <tt>color_start[c]</tt> to <tt>color_start[c+1]-1</tt>,
+   * and <tt>row_colors</tt> contains the color of each row. Two rows of the
+   * same color must not be coupled by a matrix entry, such that all rows of
+   * one color can be processed in parallel. The lower and upper triangle of
+   * the SSOR method are then those entries whose column has a smaller or
+   * larger color, respectively, than their row. See PreconditionSSOR for
+   * how to set up the coloring.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void precondition_SSOR_multicolor (Vector<somenumber>              &dst,
+                                     const Vector<somenumber>        &src,
+                                     const number                     omega,
+                                     const std::vector<unsigned int> &row_colors,
+                                     const std::vector<size_type>    &rows_by_color,
+                                     const std::vector<size_type>    &color_start) const;
+
+  /**
+   * Apply a block Jacobi method with SSOR on each of the blocks to
+   * <tt>src</tt>, with damping <tt>omega</tt>. The blocks are the contiguous
+   * ranges of rows from <tt>block_start[b]</tt> to
+   * <tt>block_start[b+1]-1</tt>, and all matrix entries coupling different
+   * blocks are ignored. The blocks are processed in parallel. The argument
+   * <tt>pos_right_of_diagonal</tt> is the same as for precondition_SSOR()
+   * but must not be empty.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void precondition_SSOR_blockwise (Vector<somenumber>             &dst,
+                                    const Vector<somenumber>       &src,
+                                    const number                    omega,
+                                    const std::vector<size_type>   &block_start,
+                                    const std::vector<std::size_t> &pos_right_of_diagonal) const;
+
   /**
    * Apply SOR preconditioning matrix to <tt>src</tt>.
    */
@@ -26,6 +26,7 @@
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/multi_vector.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/vector_memory.h>
@@ -816,6 +817,232 @@ SparseMatrix<number>::Tvmult_add (OutVector &dst,
 }
 
 
+
+namespace internal
+{
+  namespace SparseMatrix
+  {
+    /**
+     * Perform a vmult with all columns of a MultiVector using the
+     * SparseMatrix data structures, but only using a subinterval for the row
+     * indices. Each matrix entry is applied to the entries of all columns in
+     * the respective row of the source, which are contiguous in memory.
+     */
+    template <typename number,
+              typename somenumber>
+    void vmult_multi_on_subrange (const size_type    begin_row,
+                                  const size_type    end_row,
+                                  const number      *values,
+                                  const std::size_t  *rowstart,
+                                  const size_type   *colnums,
+                                  const MultiVector<somenumber> &src,
+                                  MultiVector<somenumber>       &dst,
+                                  const bool         add)
+    {
+      const unsigned int n_columns = src.n_columns();
+      const somenumber *src_ptr = src.begin();
+      somenumber *dst_ptr = dst.begin() + begin_row*n_columns;
+      for (size_type row=begin_row; row<end_row; ++row, dst_ptr += n_columns)
+        {
+          if (add == false)
+            for (unsigned int k=0; k<n_columns; ++k)
+              dst_ptr[k] = somenumber();
+          for (std::size_t j=rowstart[row]; j<rowstart[row+1]; ++j)
+            {
+              const somenumber a = somenumber(values[j]);
+              const somenumber *src_row = src_ptr + colnums[j]*n_columns;
+              for (unsigned int k=0; k<n_columns; ++k)
+                dst_ptr[k] += a * src_row[k];
+            }
+        }
+    }
+
+
+
+    /**
+     * Functor for SparseMatrix::precondition_SSOR_multicolor that performs
+     * the forward or the backward sweep on a subrange of the rows of one
+     * color. Since rows of the same color are not coupled, the entries of
+     * other rows that are read have all been computed in a previous color.
+     * The backward sweep includes the multiplication by the diagonal that
+     * is done between the two sweeps, which is possible because an entry is
+     * scaled right before it is updated.
+     */
+    template <typename number, typename somenumber>
+    struct SSORMulticolorSweep
+    {
+      void operator() (const size_type begin,
+                       const size_type end) const
+      {
+        const number scaling = om*(number(2.)-om);
+        for (size_type i=begin; i<end; ++i)
+          {
+            const size_type row = rows[i];
+            const unsigned int color = row_colors[row];
+            const number diagonal = values[rowstart[row]];
+            Assert(diagonal != number(), ExcDivideByZero());
+            number s = 0;
+            if (forward)
+              {
+                for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+                  if (row_colors[colnums[j]] < color)
+                    s += values[j] * number(dst[colnums[j]]);
+                dst[row] = src[row];
+              }
+            else
+              {
+                for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+                  if (row_colors[colnums[j]] > color)
+                    s += values[j] * number(dst[colnums[j]]);
+                dst[row] *= somenumber(scaling) * somenumber(diagonal);
+              }
+            dst[row] -= s * om;
+            dst[row] /= diagonal;
+          }
+      }
+
+      const number       *values;
+      const std::size_t  *rowstart;
+      const size_type    *colnums;
+      const unsigned int *row_colors;
+      const size_type    *rows;
+      number              om;
+      bool                forward;
+      const somenumber   *src;
+      somenumber         *dst;
+    };
+
+
+
+    /**
+     * Functor for SparseMatrix::precondition_SSOR_blockwise that applies
+     * SSOR to a range of blocks, ignoring all entries outside the block.
+     * Columns are sorted within each row, so the entries left of the
+     * diagonal that belong to the block are at the end of the lower part and
+     * the entries right of the diagonal that belong to the block are at the
+     * beginning of the upper part.
+     */
+    template <typename number, typename somenumber>
+    struct SSORBlockwise
+    {
+      void operator() (const size_type begin_block,
+                       const size_type end_block) const
+      {
+        const number scaling = om*(number(2.)-om);
+        for (size_type block=begin_block; block<end_block; ++block)
+          {
+            const size_type first_row = block_start[block];
+            const size_type end_row   = block_start[block+1];
+
+            for (size_type row=first_row; row<end_row; ++row)
+              {
+                number s = 0;
+                for (std::size_t j=pos_right_of_diagonal[row]; j>rowstart[row]+1; )
+                  {
+                    --j;
+                    if (colnums[j] < first_row)
+                      break;
+                    s += values[j] * number(dst[colnums[j]]);
+                  }
+                Assert(values[rowstart[row]] != number(), ExcDivideByZero());
+                dst[row] = src[row];
+                dst[row] -= s * om;
+                dst[row] /= values[rowstart[row]];
+              }
+
+            for (size_type row=end_row; row>first_row; )
+              {
+                --row;
+                const number diagonal = values[rowstart[row]];
+                number s = 0;
+                for (std::size_t j=pos_right_of_diagonal[row]; j<rowstart[row+1]; ++j)
+                  {
+                    if (colnums[j] >= end_row)
+                      break;
+                    s += values[j] * number(dst[colnums[j]]);
+                  }
+                dst[row] *= somenumber(scaling) * somenumber(diagonal);
+                dst[row] -= s * om;
+                dst[row] /= diagonal;
+              }
+          }
+      }
+
+      const number      *values;
+      const std::size_t *rowstart;
+      const size_type   *colnums;
+      const std::size_t *pos_right_of_diagonal;
+      const size_type   *block_start;
+      number             om;
+      const somenumber  *src;
+      somenumber        *dst;
+    };
+  }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::vmult (MultiVector<somenumber>       &dst,
+                             const MultiVector<somenumber> &src) const
+{
+  Assert (cols != 0, ExcNotInitialized());
+  Assert (val != 0, ExcNotInitialized());
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+  AssertDimension (dst.n_columns(), src.n_columns());
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  // each row is src.n_columns() times as expensive as in the vmult with
+  // single vectors, so reduce the grain size accordingly
+  parallel::apply_to_subranges (0U, m(),
+                                std_cxx11::bind (&internal::SparseMatrix::vmult_multi_on_subrange
+                                                 <number,somenumber>,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 val,
+                                                 cols->rowstart,
+                                                 cols->colnums,
+                                                 std_cxx11::cref(src),
+                                                 std_cxx11::ref(dst),
+                                                 false),
+                                internal::SparseMatrix::minimum_parallel_grain_size /
+                                std::max(1U, src.n_columns()) + 1);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::vmult_add (MultiVector<somenumber>       &dst,
+                                 const MultiVector<somenumber> &src) const
+{
+  Assert (cols != 0, ExcNotInitialized());
+  Assert (val != 0, ExcNotInitialized());
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+  AssertDimension (dst.n_columns(), src.n_columns());
+
+  Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges (0U, m(),
+                                std_cxx11::bind (&internal::SparseMatrix::vmult_multi_on_subrange
+                                                 <number,somenumber>,
+                                                 std_cxx11::_1, std_cxx11::_2,
+                                                 val,
+                                                 cols->rowstart,
+                                                 cols->colnums,
+                                                 std_cxx11::cref(src),
+                                                 std_cxx11::ref(dst),
+                                                 true),
+                                internal::SparseMatrix::minimum_parallel_grain_size /
+                                std::max(1U, src.n_columns()) + 1);
+}
+
+
 namespace internal
 {
   namespace SparseMatrix
@@ -1400,6 +1627,34 @@ SparseMatrix<number>::precondition_Jacobi (Vector<somenumber>       &dst,
 
 
 
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_Jacobi (MultiVector<somenumber>       &dst,
+                                           const MultiVector<somenumber> &src,
+                                           const number                   om) const
+{
+  Assert (cols != 0, ExcNotInitialized());
+  Assert (val != 0, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  AssertDimension (dst.n_columns(), src.n_columns());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  // the diagonal entry is the first in each row since the matrix is square
+  const unsigned int n_columns = src.n_columns();
+  for (size_type i=0; i<n(); ++i)
+    {
+      const somenumber factor = somenumber(om) / somenumber(val[cols->rowstart[i]]);
+      for (unsigned int k=0; k<n_columns; ++k)
+        dst(i,k) = factor * src(i,k);
+    }
+}
+
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -1529,6 +1784,97 @@ SparseMatrix<number>::precondition_SSOR (Vector<somenumber>              &dst,
 }
 
 
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SSOR_multicolor (Vector<somenumber>              &dst,
+                                                    const Vector<somenumber>        &src,
+                                                    const number                     om,
+                                                    const std::vector<unsigned int> &row_colors,
+                                                    const std::vector<size_type>    &rows_by_color,
+                                                    const std::vector<size_type>    &color_start) const
+{
+  Assert (cols != 0, ExcNotInitialized());
+  Assert (val != 0, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  AssertDimension (row_colors.size(), n());
+  AssertDimension (rows_by_color.size(), n());
+  Assert (color_start.size() > 0 && color_start.back() == n(),
+          ExcMessage ("The color ranges must cover all rows of the matrix."));
+
+  if (n() == 0)
+    return;
+
+  internal::SparseMatrix::SSORMulticolorSweep<number,somenumber> sweep;
+  sweep.values     = val;
+  sweep.rowstart   = cols->rowstart;
+  sweep.colnums    = cols->colnums;
+  sweep.row_colors = &row_colors[0];
+  sweep.rows       = &rows_by_color[0];
+  sweep.om         = om;
+  sweep.src        = src.begin();
+  sweep.dst        = dst.begin();
+
+  // the colors need to be processed one after the other, but all rows within
+  // one color can be worked on in parallel
+  const unsigned int n_colors = color_start.size()-1;
+  sweep.forward = true;
+  for (unsigned int color=0; color<n_colors; ++color)
+    parallel::apply_to_subranges (color_start[color], color_start[color+1],
+                                  sweep,
+                                  internal::SparseMatrix::minimum_parallel_grain_size);
+
+  sweep.forward = false;
+  for (unsigned int color=n_colors; color>0; )
+    {
+      --color;
+      parallel::apply_to_subranges (color_start[color], color_start[color+1],
+                                    sweep,
+                                    internal::SparseMatrix::minimum_parallel_grain_size);
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SSOR_blockwise (Vector<somenumber>             &dst,
+                                                   const Vector<somenumber>       &src,
+                                                   const number                    om,
+                                                   const std::vector<size_type>   &block_start,
+                                                   const std::vector<std::size_t> &pos_right_of_diagonal) const
+{
+  Assert (cols != 0, ExcNotInitialized());
+  Assert (val != 0, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  AssertDimension (pos_right_of_diagonal.size(), n());
+  Assert (block_start.size() > 0 && block_start.back() == n(),
+          ExcMessage ("The blocks must cover all rows of the matrix."));
+
+  if (n() == 0)
+    return;
+
+  internal::SparseMatrix::SSORBlockwise<number,somenumber> ssor;
+  ssor.values                = val;
+  ssor.rowstart              = cols->rowstart;
+  ssor.colnums               = cols->colnums;
+  ssor.pos_right_of_diagonal = &pos_right_of_diagonal[0];
+  ssor.block_start           = &block_start[0];
+  ssor.om                    = om;
+  ssor.src                   = src.begin();
+  ssor.dst                   = dst.begin();
+
+  parallel::apply_to_subranges (size_type(0), size_type(block_start.size()-1),
+                                ssor, 1);
+}
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -39,6 +39,10 @@ DEAL_II_NAMESPACE_OPEN
  * defined by $B = (X-L)X^{-1}(X-L^T)$, where $X$ is a diagonal matrix defined
  * by the condition $\text{rowsum}(A) = \text{rowsum}(B)$.
  *
+ * If SparseLUDecomposition::AdditionalData::use_level_scheduling is set,
+ * the computation of $X$ and vmult() process independent rows in parallel,
+ * see the documentation of SparseLUDecomposition.
+ *
  * @author Stephen "Cheffo" Kolaroff, 2002, unified interface: Ralf Hartmann
  * 2003; extension for full compatibility with LinearOperator class: Jean-Paul
  * Pelteret, 2015.
@@ -172,6 +176,29 @@ private:
    * Compute the row-th "inner sum".
    */
   number get_rowsum (const size_type row) const;
+
+  /**
+   * Compute the entry of the diagonal $X$ for row @p row, assuming that the
+   * entries of all rows it depends on have already been computed.
+   */
+  template <typename somenumber>
+  void factorize_row (const size_type                 row,
+                      const SparseMatrix<somenumber> &matrix);
+
+  /**
+   * Perform the forward substitution $(X-L)u=b$ for row @p row.
+   */
+  template <typename somenumber>
+  void forward_row (const size_type     row,
+                    Vector<somenumber> &dst) const;
+
+  /**
+   * Multiply row @p row by the diagonal $X$ and perform the backward
+   * substitution with $X-U$ for this row.
+   */
+  template <typename somenumber>
+  void backward_row (const size_type     row,
+                     Vector<somenumber> &dst) const;
 };
 
 /*@}*/
@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/lac/sparse_mic.h>
 #include <deal.II/lac/vector.h>
 
@@ -97,24 +98,36 @@ void SparseMIC<number>::initialize (const SparseMatrix<somenumber> &matrix,
   for (size_type row=0; row<this->m(); row++)
     inner_sums[row] = get_rowsum(row);
 
-  for (size_type row=0; row<this->m(); row++)
-    {
-      const number temp = this->begin(row)->value();
-      number temp1 = 0;
-
-      // work on the lower left part of the matrix. we know
-      // it's symmetric, so we can work with this alone
-      for (typename SparseMatrix<somenumber>::const_iterator
-           p = matrix.begin(row)+1;
-           (p != matrix.end(row)) && (p->column() < row);
-           ++p)
-        temp1 += p->value() / diag[p->column()] * inner_sums[p->column()];
-
-      Assert(temp-temp1 > 0, ExcStrengthenDiagonalTooSmall());
-      diag[row] = temp - temp1;
-
-      inv_diag[row] = 1.0/diag[row];
-    }
+  // each row depends on the rows given by the entries left of the diagonal,
+  // so we can use the level schedule of the forward substitution
+  this->apply_to_rows (false,
+                       std_cxx11::bind (&SparseMIC<number>::template factorize_row<somenumber>,
+                                        this, std_cxx11::_1, std_cxx11::cref(matrix)));
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+inline
+void SparseMIC<number>::factorize_row (const size_type                 row,
+                                       const SparseMatrix<somenumber> &matrix)
+{
+  const number temp = this->begin(row)->value();
+  number temp1 = 0;
+
+  // work on the lower left part of the matrix. we know
+  // it's symmetric, so we can work with this alone
+  for (typename SparseMatrix<somenumber>::const_iterator
+       p = matrix.begin(row)+1;
+       (p != matrix.end(row)) && (p->column() < row);
+       ++p)
+    temp1 += p->value() / diag[p->column()] * inner_sums[p->column()];
+
+  Assert(temp-temp1 > 0, ExcStrengthenDiagonalTooSmall());
+  diag[row] = temp - temp1;
+
+  inv_diag[row] = 1.0/diag[row];
 }
 
 
@@ -146,44 +159,61 @@ SparseMIC<number>::vmult (Vector<somenumber>       &dst,
   Assert (dst.size() == src.size(), ExcDimensionMismatch(dst.size(), src.size()));
   Assert (dst.size() == this->m(), ExcDimensionMismatch(dst.size(), this->m()));
 
-  const size_type N=dst.size();
   // We assume the underlying matrix A is: A = X - L - U, where -L and -U are
   // strictly lower- and upper- diagonal parts of the system.
   //
-  // Solve (X-L)X{-1}(X-U) x = b in 3 steps:
+  // Solve (X-L)X{-1}(X-U) x = b in 3 steps: first (X-L)u = b, then v = Xu
+  // and x = (X-U)v. the second step is done row by row at the beginning of
+  // the third one
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // Now: (X-L)u = b
-
-      // get start of this row. skip
-      // the diagonal element
-      for (typename SparseMatrix<number>::const_iterator
-           p = this->begin(row)+1;
-           (p != this->end(row)) && (p->column() < row);
-           ++p)
-        dst(row) -= p->value() * dst(p->column());
-
-      dst(row) *= inv_diag[row];
-    }
-
-  // Now: v = Xu
-  for (size_type row=0; row<N; row++)
-    dst(row) *= diag[row];
-
-  // x = (X-U)v
-  for (int row=N-1; row>=0; --row)
-    {
-      // get end of this row
-      for (typename SparseMatrix<number>::const_iterator
-           p = this->begin(row)+1;
-           p != this->end(row);
-           ++p)
-        if (p->column() > static_cast<size_type>(row))
-          dst(row) -= p->value() * dst(p->column());
-
-      dst(row) *= inv_diag[row];
-    }
+  this->apply_to_rows (false,
+                       std_cxx11::bind (&SparseMIC<number>::template forward_row<somenumber>,
+                                        this, std_cxx11::_1, std_cxx11::ref(dst)));
+  this->apply_to_rows (true,
+                       std_cxx11::bind (&SparseMIC<number>::template backward_row<somenumber>,
+                                        this, std_cxx11::_1, std_cxx11::ref(dst)));
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+inline
+void
+SparseMIC<number>::forward_row (const size_type     row,
+                                Vector<somenumber> &dst) const
+{
+  // get start of this row. skip
+  // the diagonal element
+  for (typename SparseMatrix<number>::const_iterator
+       p = this->begin(row)+1;
+       (p != this->end(row)) && (p->column() < row);
+       ++p)
+    dst(row) -= p->value() * dst(p->column());
+
+  dst(row) *= inv_diag[row];
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+inline
+void
+SparseMIC<number>::backward_row (const size_type     row,
+                                 Vector<somenumber> &dst) const
+{
+  dst(row) *= diag[row];
+
+  // get end of this row
+  for (typename SparseMatrix<number>::const_iterator
+       p = this->begin(row)+1;
+       p != this->end(row);
+       ++p)
+    if (p->column() > row)
+      dst(row) -= p->value() * dst(p->column());
+
+  dst(row) *= inv_diag[row];
 }
 
 
@@ -30,6 +30,7 @@ DEAL_II_NAMESPACE_OPEN
 
 class SparsityPattern;
 class ChunkSparsityPattern;
+class SparsityPatternBuilder;
 template <typename number> class FullMatrix;
 template <typename number> class SparseMatrix;
 template <typename number> class SparseLUDecomposition;
@@ -625,6 +626,16 @@ public:
   template <typename CompressedSparsityType>
   void copy_from (const CompressedSparsityType &dsp);
 
+  /**
+   * Copy the entries collected by a SparsityPatternBuilder object. The
+   * entries of different ranges of rows are merged and written into this
+   * object in parallel. The memory held by @p builder is released along the
+   * way, so @p builder contains no entries afterwards. Previous content of
+   * this object is lost, and the sparsity pattern is in compressed mode
+   * afterwards.
+   */
+  void copy_from (SparsityPatternBuilder &builder);
+
 
   /**
    * Take a full matrix and use its nonzero entries to generate a sparse
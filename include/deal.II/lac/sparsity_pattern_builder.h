@@ -0,0 +1,311 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__sparsity_pattern_builder_h
+#define dealii__sparsity_pattern_builder_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+#include <utility>
+
+DEAL_II_NAMESPACE_OPEN
+
+class SparsityPattern;
+
+
+/*! @addtogroup Sparsity
+ *@{
+ */
+
+
+/**
+ * A class that collects the entries of a sparsity pattern from several
+ * threads at the same time and then builds a SparsityPattern from them. It
+ * is meant to replace DynamicSparsityPattern as the intermediate object when
+ * creating the sparsity pattern of a large matrix, e.g. in
+ * DoFTools::make_sparsity_pattern(), if the loop over cells runs in
+ * parallel.
+ *
+ * The functions add() and add_entries() may be called concurrently from
+ * different threads without any synchronization. Each thread appends the
+ * entries to its own set of lists ("buckets"), one for each contiguous range
+ * of rows. An entry is stored as a single 64-bit integer holding the column
+ * index and, in the bits above it, the position of the row within the range.
+ * The lists are sorted and duplicates are removed every time they have grown
+ * by a certain factor, so the memory consumption is bounded by a small
+ * multiple of the number of distinct entries each thread has added.
+ * SparsityPattern::copy_from() then merges the buckets of all threads for
+ * one range of rows at a time, which again happens in parallel, and writes
+ * the result directly into the compressed format of the SparsityPattern. The
+ * lists are released as soon as they have been merged, so the object is
+ * empty afterwards.
+ *
+ * In contrast to DynamicSparsityPattern, this class offers no way to query
+ * the entries added so far; the only thing one can do with it is to add
+ * entries and to copy it into a SparsityPattern.
+ */
+class SparsityPatternBuilder : public Subscriptor
+{
+public:
+  /**
+   * Declare the type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Default constructor. Initialize an empty object of size zero times zero.
+   */
+  SparsityPatternBuilder ();
+
+  /**
+   * Constructor. Initialize an object for a matrix with @p m rows and @p n
+   * columns.
+   */
+  SparsityPatternBuilder (const size_type m,
+                          const size_type n);
+
+  /**
+   * Reallocate memory and set up data structures for a matrix with @p m rows
+   * and @p n columns. All entries added before are deleted. This function
+   * must not be called concurrently with add() or add_entries().
+   */
+  void reinit (const size_type m,
+               const size_type n);
+
+  /**
+   * Add the entry (@p i, @p j). Adding an entry several times is allowed.
+   * This function may be called concurrently from several threads.
+   */
+  void add (const size_type i,
+            const size_type j);
+
+  /**
+   * Add several entries of the given row. This function may be called
+   * concurrently from several threads. The last argument is ignored and only
+   * present for compatibility with the other sparsity pattern classes.
+   */
+  template <typename ForwardIterator>
+  void add_entries (const size_type row,
+                    ForwardIterator begin,
+                    ForwardIterator end,
+                    const bool      indices_are_sorted = false);
+
+  /**
+   * Return the number of rows.
+   */
+  size_type n_rows () const;
+
+  /**
+   * Return the number of columns.
+   */
+  size_type n_cols () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The type of an entry in the buckets: the column index in the lower
+   * @p column_bits bits and the row relative to the first row of the bucket
+   * in the bits above. Sorting the entries of a bucket therefore sorts them
+   * by rows first and by columns second.
+   */
+  typedef unsigned long long int entry_type;
+
+  /**
+   * The entries added by one thread, sorted into one list per range of
+   * rows. The second array stores the length of each list after it has last
+   * been sorted and freed from duplicates.
+   */
+  struct ThreadData
+  {
+    std::vector<std::vector<entry_type> > buckets;
+    std::vector<std::size_t> compressed_sizes;
+  };
+
+  /**
+   * Return the list of entries of the calling thread for the range of rows
+   * that contains @p row.
+   */
+  std::vector<entry_type> &
+  get_bucket (const size_type row);
+
+  /**
+   * Return the entry (@p row, @p col) in the format stored in the buckets.
+   */
+  entry_type encode_entry (const size_type row,
+                           const size_type col) const;
+
+  /**
+   * Sort the list and remove duplicates if it has grown sufficiently since
+   * the last time this was done.
+   */
+  void compress_bucket_if_necessary (const size_type row);
+
+  /**
+   * Merge the lists of all threads for the row ranges <tt>[begin,end)</tt>
+   * into one sorted list without duplicates for each range, and compute the
+   * number of entries in each row. If @p add_diagonal is true, the length
+   * includes the diagonal entry, whether it was added or not. The list of
+   * each thread is released right after it has been merged. Used by
+   * SparsityPattern::copy_from().
+   */
+  void merge_buckets (const unsigned int begin,
+                      const unsigned int end,
+                      const bool         add_diagonal,
+                      std::vector<std::vector<entry_type> > &merged_buckets,
+                      std::vector<unsigned int> &row_lengths);
+
+  /**
+   * Write the column indices of the merged lists of the row ranges
+   * <tt>[begin,end)</tt> into the arrays of a SparsityPattern whose row
+   * lengths have been set according to merge_buckets(), and release the
+   * merged lists. Used by SparsityPattern::copy_from().
+   */
+  void fill_columns (const unsigned int begin,
+                     const unsigned int end,
+                     const bool         store_diagonal_first_in_row,
+                     std::vector<std::vector<entry_type> > &merged_buckets,
+                     const std::size_t *rowstart,
+                     size_type         *colnums) const;
+
+  /**
+   * Number of rows.
+   */
+  size_type rows;
+
+  /**
+   * Number of columns.
+   */
+  size_type cols;
+
+  /**
+   * Number of rows that go into one bucket.
+   */
+  size_type rows_per_bucket;
+
+  /**
+   * Number of buckets.
+   */
+  unsigned int n_buckets;
+
+  /**
+   * Number of bits of an entry that hold the column index.
+   */
+  unsigned int column_bits;
+
+  /**
+   * The entries added by each thread. Declared mutable so that
+   * memory_consumption(), which reads the data of all threads, can be a
+   * constant function.
+   */
+  mutable Threads::ThreadLocalStorage<ThreadData> thread_data;
+
+  friend class SparsityPattern;
+};
+
+/*@}*/
+/*---------------------- Inline functions -----------------------------------*/
+
+
+inline
+SparsityPatternBuilder::size_type
+SparsityPatternBuilder::n_rows () const
+{
+  return rows;
+}
+
+
+
+inline
+SparsityPatternBuilder::size_type
+SparsityPatternBuilder::n_cols () const
+{
+  return cols;
+}
+
+
+
+inline
+std::vector<SparsityPatternBuilder::entry_type> &
+SparsityPatternBuilder::get_bucket (const size_type row)
+{
+  ThreadData &data = thread_data.get();
+  if (data.buckets.size() != n_buckets)
+    {
+      data.buckets.resize (n_buckets);
+      data.compressed_sizes.resize (n_buckets, 0);
+    }
+  return data.buckets[row / rows_per_bucket];
+}
+
+
+
+inline
+SparsityPatternBuilder::entry_type
+SparsityPatternBuilder::encode_entry (const size_type row,
+                                      const size_type col) const
+{
+  return (static_cast<entry_type>(row % rows_per_bucket) << column_bits) |
+         static_cast<entry_type>(col);
+}
+
+
+
+inline
+void
+SparsityPatternBuilder::add (const size_type i,
+                             const size_type j)
+{
+  Assert (i<rows, ExcIndexRange(i, 0, rows));
+  Assert (j<cols, ExcIndexRange(j, 0, cols));
+
+  get_bucket(i).push_back (encode_entry(i, j));
+  compress_bucket_if_necessary (i);
+}
+
+
+
+template <typename ForwardIterator>
+void
+SparsityPatternBuilder::add_entries (const size_type row,
+                                     ForwardIterator begin,
+                                     ForwardIterator end,
+                                     const bool      /*indices_are_sorted*/)
+{
+  Assert (row<rows, ExcIndexRange(row, 0, rows));
+
+  std::vector<entry_type> &bucket = get_bucket (row);
+  const entry_type row_part = encode_entry (row, 0);
+  for (ForwardIterator it = begin; it != end; ++it)
+    {
+      Assert (*it<cols, ExcIndexRange(*it, 0, cols));
+      bucket.push_back (row_part | static_cast<entry_type>(*it));
+    }
+  compress_bucket_if_necessary (row);
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
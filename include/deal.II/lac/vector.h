@@ -533,6 +533,33 @@ public:
                       const Vector<Number> &V,
                       const Vector<Number> &W);
 
+  /**
+   * Add a linear combination of several vectors to this vector, i.e.,
+   * <tt>*this += a[0]*V[0] + a[1]*V[1] + ...</tt>.
+   *
+   * The vectors are traversed block by block in a single sweep, such that
+   * the calling vector is read and written only once, as opposed to once
+   * per vector when calling add() repeatedly. This is the typical update of
+   * the solution in GMRES and of the Gram-Schmidt orthogonalization.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  void add_linear_combination (const std::vector<Number>               &a,
+                               const std::vector<const Vector<Number> *> &V);
+
+  /**
+   * Compute the inner products of this vector with several other vectors,
+   * i.e., <tt>results[k] = *this * *V[k]</tt>, in a single sweep over the
+   * vectors. Like for add_linear_combination(), the calling vector is only
+   * read once.
+   *
+   * @dealiiOperationIsMultithreaded The inner products are computed by
+   * summing up contributions of fixed-size blocks in a fixed order, which
+   * gives fully repeatable results from one run to another.
+   */
+  void inner_products (const std::vector<const Vector<Number> *> &V,
+                       std::vector<Number>                       &results) const;
+
   //@}
 
 
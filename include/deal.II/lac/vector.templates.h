@@ -826,6 +826,66 @@ namespace internal
       else if (vec_size > 0)
         copy_subrange (0U, vec_size, src, dst);
     }
+
+
+    // Block size for the operations working on several vectors at once. The
+    // blocks of all vectors involved are small enough to stay in cache while
+    // the block is processed, such that the vector of the calling object is
+    // transferred from memory only once
+    const unsigned int multi_vector_block_size = 512;
+
+
+    template <typename Number>
+    void add_linear_combination_subrange (const typename dealii::Vector<Number>::size_type begin,
+                                          const typename dealii::Vector<Number>::size_type end,
+                                          const std::vector<Number> &a,
+                                          const std::vector<const dealii::Vector<Number> *> &V,
+                                          dealii::Vector<Number> &dst)
+    {
+      typedef typename dealii::Vector<Number>::size_type size_type;
+      Number *dst_ptr = dst.begin();
+      for (size_type block_begin=begin; block_begin<end;
+           block_begin+=multi_vector_block_size)
+        {
+          const size_type block_end = std::min<size_type>(end, block_begin+multi_vector_block_size);
+          for (unsigned int k=0; k<V.size(); ++k)
+            {
+              const Number factor = a[k];
+              const Number *src_ptr = V[k]->begin();
+              for (size_type i=block_begin; i<block_end; ++i)
+                dst_ptr[i] += factor * src_ptr[i];
+            }
+        }
+    }
+
+
+    // compute the inner products of the vector blocks with index in
+    // [begin_block, end_block). The result for block b and vector k is
+    // stored in block_results[b*V.size()+k]
+    template <typename Number>
+    void inner_products_subrange (const typename dealii::Vector<Number>::size_type begin_block,
+                                  const typename dealii::Vector<Number>::size_type end_block,
+                                  const dealii::Vector<Number> &W,
+                                  const std::vector<const dealii::Vector<Number> *> &V,
+                                  std::vector<Number> &block_results)
+    {
+      typedef typename dealii::Vector<Number>::size_type size_type;
+      const Number *w_ptr = W.begin();
+      const unsigned int n_vectors = V.size();
+      for (size_type block=begin_block; block<end_block; ++block)
+        {
+          const size_type start = block * multi_vector_block_size;
+          const size_type stop = std::min<size_type>(W.size(), start+multi_vector_block_size);
+          for (unsigned int k=0; k<n_vectors; ++k)
+            {
+              const Number *v_ptr = V[k]->begin();
+              Number sum = Number();
+              for (size_type i=start; i<stop; ++i)
+                sum += w_ptr[i] * Number(numbers::NumberTraits<Number>::conjugate(v_ptr[i]));
+              block_results[block*n_vectors+k] = sum;
+            }
+        }
+    }
   }
 }
 
@@ -1519,6 +1579,77 @@ Vector<Number>::add_and_dot (const Number          a,
 
 
 
+template <typename Number>
+void
+Vector<Number>::add_linear_combination (const std::vector<Number>               &a,
+                                        const std::vector<const Vector<Number> *> &V)
+{
+  AssertDimension (a.size(), V.size());
+  for (unsigned int k=0; k<V.size(); ++k)
+    {
+      AssertIsFinite(a[k]);
+      AssertDimension (vec_size, V[k]->size());
+    }
+
+  if (vec_size>internal::Vector::minimum_parallel_grain_size)
+    parallel::apply_to_subranges (0U, vec_size,
+                                  std_cxx11::bind(&internal::Vector::template
+                                                  add_linear_combination_subrange<Number>,
+                                                  std_cxx11::_1,
+                                                  std_cxx11::_2,
+                                                  std_cxx11::cref(a),
+                                                  std_cxx11::cref(V),
+                                                  std_cxx11::ref(*this)),
+                                  internal::Vector::minimum_parallel_grain_size);
+  else if (vec_size > 0)
+    internal::Vector::add_linear_combination_subrange<Number> (0U, vec_size, a, V, *this);
+}
+
+
+
+template <typename Number>
+void
+Vector<Number>::inner_products (const std::vector<const Vector<Number> *> &V,
+                                std::vector<Number>                       &results) const
+{
+  for (unsigned int k=0; k<V.size(); ++k)
+    AssertDimension (vec_size, V[k]->size());
+
+  results.resize (V.size());
+  std::fill (results.begin(), results.end(), Number());
+  if (vec_size == 0 || V.size() == 0)
+    return;
+
+  // compute the inner products blockwise and sum the contributions of the
+  // blocks in a fixed order afterwards, such that the result does not
+  // depend on how the blocks are distributed among threads
+  const size_type block_size = internal::Vector::multi_vector_block_size;
+  const size_type n_blocks = (vec_size + block_size - 1) / block_size;
+  std::vector<Number> block_results (n_blocks * V.size());
+  if (vec_size>internal::Vector::minimum_parallel_grain_size)
+    parallel::apply_to_subranges (0U, n_blocks,
+                                  std_cxx11::bind(&internal::Vector::template
+                                                  inner_products_subrange<Number>,
+                                                  std_cxx11::_1,
+                                                  std_cxx11::_2,
+                                                  std_cxx11::cref(*this),
+                                                  std_cxx11::cref(V),
+                                                  std_cxx11::ref(block_results)),
+                                  std::max<size_type>(1, internal::Vector::minimum_parallel_grain_size/block_size));
+  else
+    internal::Vector::inner_products_subrange<Number> (0U, n_blocks, *this, V,
+                                                       block_results);
+
+  for (size_type block=0; block<n_blocks; ++block)
+    for (unsigned int k=0; k<V.size(); ++k)
+      results[k] += block_results[block*V.size()+k];
+
+  for (unsigned int k=0; k<V.size(); ++k)
+    AssertIsFinite(results[k]);
+}
+
+
+
 template <typename Number>
 Vector<Number> &Vector<Number>::operator += (const Vector<Number> &v)
 {
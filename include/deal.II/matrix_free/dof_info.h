@@ -365,6 +365,15 @@ namespace internal
        */
       std::vector<unsigned int> plain_dof_indices;
 
+      /**
+       * Stores the indices of the degrees of freedom on the ghost cells that
+       * are the exterior cell of a face worked on by this processor (see
+       * FaceInfo), in MPI-local index space and lexicographic order, with
+       * <tt>dofs_per_cell[0]</tt> entries for each ghost cell. Constraints
+       * are not resolved on these cells.
+       */
+      std::vector<unsigned int> ghost_cell_dof_indices;
+
       /**
        * Stores the dimension of the underlying DoFHandler. Since the indices
        * are not templated, this is the variable that makes the dimension
@@ -136,6 +136,7 @@ namespace internal
       constrained_dofs (dof_info_in.constrained_dofs),
       row_starts_plain_indices (dof_info_in.row_starts_plain_indices),
       plain_dof_indices (dof_info_in.plain_dof_indices),
+      ghost_cell_dof_indices (dof_info_in.ghost_cell_dof_indices),
       dimension (dof_info_in.dimension),
       n_components (dof_info_in.n_components),
       dofs_per_cell (dof_info_in.dofs_per_cell),
@@ -163,6 +164,7 @@ namespace internal
       n_components = 0;
       row_starts_plain_indices.clear();
       plain_dof_indices.clear();
+      ghost_cell_dof_indices.clear();
       store_plain_indices = false;
       cell_active_fe_index.clear();
       max_fe_index = 0;
@@ -1926,6 +1928,7 @@ not_connect:
       memory += MemoryConsumption::memory_consumption (dof_indices);
       memory += MemoryConsumption::memory_consumption (row_starts_plain_indices);
       memory += MemoryConsumption::memory_consumption (plain_dof_indices);
+      memory += MemoryConsumption::memory_consumption (ghost_cell_dof_indices);
       memory += MemoryConsumption::memory_consumption (constraint_indicator);
       memory += MemoryConsumption::memory_consumption (*vector_partitioner);
       return memory;
@@ -0,0 +1,293 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii__matrix_free_face_info_h
+#define dealii__matrix_free_face_info_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/point.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/hp/q_collection.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/matrix_free/helper_functions.h>
+#include <deal.II/matrix_free/dof_info.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * The class that stores the connectivity and the geometry-dependent data
+     * of the faces for use in the matrix-free class. Faces are grouped into
+     * batches of VectorizedArray<Number>::n_array_elements faces that share
+     * the same face number on the interior and the exterior side (and the
+     * same subface in case of hanging nodes, or the same boundary id on
+     * boundary faces), such that all the lanes of a batch can be worked on
+     * with the same sequence of instructions by FEFaceEvaluation.
+     *
+     * For each face, the cell on the "interior" side is the finer of the two
+     * cells at hanging nodes, and the one that comes first in the MatrixFree
+     * numbering for faces between cells of the same refinement level. The
+     * "exterior" cell is the neighbor. Boundary faces only have an interior
+     * side. The quadrature points on faces are arranged in the face-intrinsic
+     * coordinate system of the interior cell, and the quadrature points of
+     * the exterior side are matched to these points during initialization.
+     *
+     * In parallel computations, a face between a locally owned cell and a
+     * ghost cell is worked on by exactly one of the two processors: by the
+     * one that owns the finer cell at hanging nodes, and by the one with the
+     * lower rank otherwise. On that processor, the ghost cell is the exterior
+     * cell of the face, numbered after all the cells of the MatrixFree
+     * object, and the degrees of freedom of the ghost cell are imported as
+     * ghost entries of the vectors (see DoFInfo::ghost_cell_dof_indices).
+     *
+     * Faces are currently only supported on meshes where the faces are in
+     * standard orientation, which is always the case in 2D and for most 3D
+     * meshes.
+     */
+    template <int dim, typename Number>
+    struct FaceInfo
+    {
+      /**
+       * An abbreviation for the length of vector lines of the current data
+       * type.
+       */
+      static const unsigned int n_vector_elements = VectorizedArray<Number>::n_array_elements;
+
+      /**
+       * A marker for subface indices that identifies faces that are not
+       * hanging, or boundary faces without an exterior cell.
+       */
+      static const unsigned char invalid_face_index = static_cast<unsigned char>(-1);
+
+      /**
+       * Data that describes the cells adjacent to one batch of faces.
+       */
+      struct FaceBatch
+      {
+        /**
+         * The indices of the cells on the interior side of the face within
+         * the numbering of MatrixFree, i.e., the macro cell number times
+         * n_vector_elements plus the lane within the macro cell.
+         */
+        unsigned int cells_interior[n_vector_elements];
+
+        /**
+         * The indices of the cells on the exterior side of the face within
+         * the numbering of MatrixFree. Ghost cells are numbered after the
+         * cells of the MatrixFree object in the order of the field
+         * ghost_cells. Set to numbers::invalid_unsigned_int on boundary
+         * faces.
+         */
+        unsigned int cells_exterior[n_vector_elements];
+
+        /**
+         * The face number of the face in the interior cell.
+         */
+        unsigned char interior_face_no;
+
+        /**
+         * The face number of the face in the exterior cell, or
+         * invalid_face_index for boundary faces.
+         */
+        unsigned char exterior_face_no;
+
+        /**
+         * In case the exterior cell is coarser than the interior one, this
+         * field stores which part of the exterior face is covered by the
+         * interior face, encoded as the sum of the half of the face in the
+         * first face-intrinsic coordinate direction (zero or one) and two
+         * times the half in the second direction. Set to invalid_face_index
+         * otherwise.
+         */
+        unsigned char subface_index;
+
+        /**
+         * The number of faces that are actually present in the batch. The
+         * remaining lanes repeat the data of the first face.
+         */
+        unsigned char n_filled_lanes;
+
+        /**
+         * The boundary id of boundary faces.
+         */
+        types::boundary_id boundary_id;
+      };
+
+      /**
+       * The geometry data for all face batches and one quadrature formula.
+       * The data is stored batch by batch, with the quadrature points running
+       * fastest.
+       */
+      struct MappingData
+      {
+        /**
+         * The number of quadrature points per face.
+         */
+        unsigned int n_q_points;
+
+        /**
+         * The quadrature weights times the surface element.
+         */
+        AlignedVector<VectorizedArray<Number> > JxW_values;
+
+        /**
+         * The unit normal vectors pointing from the interior cell to the
+         * exterior cell.
+         */
+        AlignedVector<Tensor<1,dim,VectorizedArray<Number> > > normal_vectors;
+
+        /**
+         * The transposed inverse Jacobians of the interior cell (index 0) and
+         * the exterior cell (index 1), in the same format as used for cells
+         * in MappingInfo. The data for the exterior cell is empty on boundary
+         * faces.
+         */
+        AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians[2];
+
+        /**
+         * The quadrature points in real coordinates. Only filled if
+         * update_quadrature_points has been requested.
+         */
+        AlignedVector<Point<dim,VectorizedArray<Number> > > quadrature_points;
+
+        /**
+         * Returns the memory consumption of this class in bytes.
+         */
+        std::size_t memory_consumption () const;
+      };
+
+      /**
+       * Empty constructor.
+       */
+      FaceInfo ();
+
+      /**
+       * Finds the ghost cells adjacent to the faces of the given locally
+       * owned cells that are worked on by this processor and stores them in
+       * the field ghost_cells. Needs to be called before the degrees of
+       * freedom are distributed to DoFInfo, such that the degrees of freedom
+       * on the ghost cells can be imported into ghost entries of the
+       * vectors, and before initialize().
+       */
+      void find_ghost_cells (const dealii::Triangulation<dim>                        &tria,
+                             const std::vector<std::pair<unsigned int,unsigned int> > &cells);
+
+      /**
+       * Collects the faces of the given cells (specified by level and index
+       * in the order used by MatrixFree, including the padding of partially
+       * filled macro cells), groups them into batches and computes the
+       * geometry data for all quadrature formulas. The finite element is
+       * only used for setting up FEValues objects for the mapping and can be
+       * any element on the triangulation. If @p use_coloring is set, the
+       * face batches are sorted into colors such that batches within the
+       * same color do not write into the same vector entries according to
+       * the indices stored in @p dof_info, which allows to work on them in
+       * parallel. Batches that access ghost entries of the vectors are
+       * placed after the other batches in each of the two groups of faces.
+       * The ghost cells found by find_ghost_cells() are kept.
+       */
+      void initialize (const dealii::Triangulation<dim>                        &tria,
+                       const std::vector<std::pair<unsigned int,unsigned int> > &cells,
+                       const std::vector<DoFInfo>                              &dof_info,
+                       const Mapping<dim>                                      &mapping,
+                       const FiniteElement<dim>                                &fe,
+                       const std::vector<dealii::hp::QCollection<1> >           &quad,
+                       const UpdateFlags                                        update_flags_inner_faces,
+                       const UpdateFlags                                        update_flags_boundary_faces,
+                       const bool                                               use_coloring);
+
+      /**
+       * Clears all data fields in this class, including the ghost cells.
+       */
+      void clear ();
+
+      /**
+       * Returns the memory consumption of this class in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+      /**
+       * The face batches, first all batches of inner faces and then all
+       * batches of boundary faces.
+       */
+      std::vector<FaceBatch> faces;
+
+      /**
+       * The number of batches of inner faces.
+       */
+      unsigned int n_inner_face_batches;
+
+      /**
+       * The number of batches of boundary faces.
+       */
+      unsigned int n_boundary_face_batches;
+
+      /**
+       * The first face batch of each color among the inner faces, with one
+       * additional entry at the end pointing to the end of the range. Face
+       * batches within one color can be worked on in parallel.
+       */
+      std::vector<unsigned int> inner_color_start;
+
+      /**
+       * The first face batch of each color among the boundary faces, with
+       * one additional entry at the end pointing to the end of the range.
+       */
+      std::vector<unsigned int> boundary_color_start;
+
+      /**
+       * The index of the first color in inner_color_start whose batches
+       * access ghost entries of the vectors. The colors before this one can
+       * be worked on while the ghost values are still being imported.
+       */
+      unsigned int first_inner_ghost_color;
+
+      /**
+       * Same as first_inner_ghost_color for the colors in
+       * boundary_color_start.
+       */
+      unsigned int first_boundary_ghost_color;
+
+      /**
+       * The ghost cells that are the exterior cell of some face, given by
+       * level and index.
+       */
+      std::vector<std::pair<unsigned int,unsigned int> > ghost_cells;
+
+      /**
+       * The geometry data, one entry per quadrature formula.
+       */
+      std::vector<MappingData> mapping_data;
+    };
+
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,720 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/matrix_free/face_info.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    // helper data structures and functions for setting up the faces
+    namespace FaceSetup
+    {
+      // a face as seen from the interior cell before batching
+      struct FaceEntry
+      {
+        unsigned int       interior;
+        unsigned int       exterior;
+        unsigned char      interior_face_no;
+        unsigned char      exterior_face_no;
+        unsigned char      subface_index;
+        types::boundary_id boundary_id;
+      };
+
+
+
+      // sort faces such that faces with the same face numbers and subfaces
+      // (or boundary ids) come next to each other, which then get merged
+      // into the same batch. within each group, keep the order of the cells
+      struct FaceComparator
+      {
+        bool operator() (const FaceEntry &face1,
+                         const FaceEntry &face2) const
+        {
+          if (face1.interior_face_no != face2.interior_face_no)
+            return face1.interior_face_no < face2.interior_face_no;
+          if (face1.exterior_face_no != face2.exterior_face_no)
+            return face1.exterior_face_no < face2.exterior_face_no;
+          if (face1.subface_index != face2.subface_index)
+            return face1.subface_index < face2.subface_index;
+          return face1.boundary_id < face2.boundary_id;
+        }
+      };
+
+
+
+      // returns whether a face between a locally owned cell and a ghost
+      // cell is worked on by the owner of the given cell: faces with hanging
+      // nodes are worked on by the owner of the finer cell, and the other
+      // faces by the processor with the lower rank. The neighbor must not be
+      // refined
+      template <typename CellIterator>
+      bool
+      ghost_face_is_local (const CellIterator &cell,
+                           const unsigned int  face_no)
+      {
+        return (cell->neighbor_is_coarser(face_no) ||
+                cell->subdomain_id() < cell->neighbor(face_no)->subdomain_id());
+      }
+
+
+
+      // appends the MPI-local indices of the vector entries that the given
+      // cell, in the numbering of FaceBatch, reads from and writes into,
+      // shifted by the given offset
+      inline
+      void
+      append_cell_indices (const DoFInfo                        &dof_info,
+                           const unsigned int                    cell,
+                           const unsigned int                    n_vector_elements,
+                           const types::global_dof_index         offset,
+                           std::vector<types::global_dof_index> &indices)
+      {
+        const unsigned int n_cells = (dof_info.row_starts.size()-1) *
+                                     n_vector_elements;
+        if (cell < n_cells)
+          for (const unsigned int *it =
+                 dof_info.begin_indices(cell/n_vector_elements);
+               it != dof_info.end_indices(cell/n_vector_elements); ++it)
+            indices.push_back (offset + *it);
+        else
+          {
+            const unsigned int dofs_per_cell = dof_info.dofs_per_cell[0];
+            const unsigned int ghost = cell - n_cells;
+            AssertIndexRange ((ghost+1)*dofs_per_cell - 1,
+                              dof_info.ghost_cell_dof_indices.size());
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              indices.push_back (offset + dof_info.ghost_cell_dof_indices
+                                 [ghost*dofs_per_cell+i]);
+          }
+      }
+
+
+
+      // returns the indices of all vector entries that a batch of faces
+      // reads from and writes into, as seen from DoFInfo, with the entries of
+      // the different DoFInfo objects placed one after the other
+      template <typename FaceBatch>
+      std::vector<types::global_dof_index>
+      batch_indices (const FaceBatch            &face,
+                     const std::vector<DoFInfo> &dof_info,
+                     const unsigned int          n_vector_elements)
+      {
+        std::vector<types::global_dof_index> indices;
+        for (unsigned int v=0; v<face.n_filled_lanes; ++v)
+          for (unsigned int side=0; side<2; ++side)
+            {
+              const unsigned int cell = side == 0 ? face.cells_interior[v] :
+                                        face.cells_exterior[v];
+              if (cell == numbers::invalid_unsigned_int)
+                continue;
+              types::global_dof_index offset = 0;
+              for (unsigned int no=0; no<dof_info.size(); ++no)
+                {
+                  append_cell_indices (dof_info[no], cell, n_vector_elements,
+                                       offset, indices);
+                  offset += dof_info[no].vector_partitioner->local_size() +
+                            dof_info[no].vector_partitioner->n_ghost_indices();
+                }
+            }
+        std::sort (indices.begin(), indices.end());
+        indices.erase (std::unique(indices.begin(), indices.end()),
+                       indices.end());
+        return indices;
+      }
+
+
+
+      // returns the indices of all vector entries that a batch of faces
+      // writes into. Used to find batches that can be worked on in parallel
+      template <typename FaceBatch>
+      struct ConflictIndices
+      {
+        ConflictIndices (const std::vector<FaceBatch> &faces,
+                         const std::vector<DoFInfo>   &dof_info,
+                         const unsigned int            n_vector_elements)
+          :
+          faces (faces),
+          dof_info (dof_info),
+          n_vector_elements (n_vector_elements)
+        {}
+
+        std::vector<types::global_dof_index>
+        operator() (const std::vector<unsigned int>::const_iterator &batch) const
+        {
+          return batch_indices (faces[*batch], dof_info, n_vector_elements);
+        }
+
+        const std::vector<FaceBatch> &faces;
+        const std::vector<DoFInfo>   &dof_info;
+        const unsigned int            n_vector_elements;
+      };
+
+
+
+      // returns whether a batch of faces accesses ghost entries of any of
+      // the vectors, i.e., whether it needs to wait for the import of ghost
+      // values
+      template <typename FaceBatch>
+      struct AccessesGhosts
+      {
+        typedef FaceBatch argument_type;
+        typedef bool      result_type;
+
+        AccessesGhosts (const std::vector<DoFInfo> &dof_info,
+                        const unsigned int          n_vector_elements)
+          :
+          dof_info (dof_info),
+          n_vector_elements (n_vector_elements)
+        {}
+
+        bool operator() (const FaceBatch &face) const
+        {
+          std::vector<types::global_dof_index> indices;
+          for (unsigned int no=0; no<dof_info.size(); ++no)
+            {
+              indices.clear();
+              for (unsigned int v=0; v<face.n_filled_lanes; ++v)
+                {
+                  append_cell_indices (dof_info[no], face.cells_interior[v],
+                                       n_vector_elements, 0, indices);
+                  if (face.cells_exterior[v] != numbers::invalid_unsigned_int)
+                    append_cell_indices (dof_info[no], face.cells_exterior[v],
+                                         n_vector_elements, 0, indices);
+                }
+              const unsigned int local_size =
+                dof_info[no].vector_partitioner->local_size();
+              for (unsigned int i=0; i<indices.size(); ++i)
+                if (indices[i] >= local_size)
+                  return true;
+            }
+          return false;
+        }
+
+        const std::vector<DoFInfo> &dof_info;
+        const unsigned int          n_vector_elements;
+      };
+
+
+
+      // sorts the face batches in the range [begin,end) into colors and
+      // returns the start of each color
+      template <typename FaceBatch>
+      std::vector<unsigned int>
+      color_face_batches (const unsigned int          begin,
+                          const unsigned int          end,
+                          const std::vector<DoFInfo> &dof_info,
+                          const unsigned int          n_vector_elements,
+                          const bool                  use_coloring,
+                          std::vector<FaceBatch>     &faces)
+      {
+        std::vector<unsigned int> color_start (1, begin);
+        if (use_coloring == false || end-begin < 2)
+          {
+            color_start.push_back (end);
+            return color_start;
+          }
+
+        std::vector<unsigned int> batch_indices (end-begin);
+        for (unsigned int i=begin; i<end; ++i)
+          batch_indices[i-begin] = i;
+        const std::vector<unsigned int> &const_batch_indices = batch_indices;
+        const ConflictIndices<FaceBatch>
+        conflict_indices (faces, dof_info, n_vector_elements);
+
+        std::vector<std::vector<std::vector<unsigned int>::const_iterator> >
+        coloring = GraphColoring::make_graph_coloring
+                   (const_batch_indices.begin(), const_batch_indices.end(),
+                    std_cxx11::function<std::vector<types::global_dof_index>
+                    (const std::vector<unsigned int>::const_iterator &)>
+                    (conflict_indices));
+
+        std::vector<FaceBatch> sorted_faces;
+        sorted_faces.reserve (end-begin);
+        for (unsigned int color=0; color<coloring.size(); ++color)
+          {
+            // keep the original order of batches within a color
+            std::vector<unsigned int> batches_in_color;
+            for (unsigned int i=0; i<coloring[color].size(); ++i)
+              batches_in_color.push_back (*coloring[color][i]);
+            std::sort (batches_in_color.begin(), batches_in_color.end());
+            for (unsigned int i=0; i<batches_in_color.size(); ++i)
+              sorted_faces.push_back (faces[batches_in_color[i]]);
+            color_start.push_back (begin + sorted_faces.size());
+          }
+        AssertDimension (sorted_faces.size(), end-begin);
+        std::copy (sorted_faces.begin(), sorted_faces.end(),
+                   faces.begin()+begin);
+        return color_start;
+      }
+
+
+
+      // the points on the unit cell at which the face integrals are
+      // evaluated, in the lexicographic order used by FEFaceEvaluation. In
+      // case a valid subface index is given, the points are compressed into
+      // the respective half of the face in each direction
+      template <int dim>
+      Quadrature<dim>
+      face_quadrature_on_cell (const Quadrature<1>  &quad_1d,
+                               const unsigned int    face_no,
+                               const unsigned char   subface_index,
+                               const unsigned char   invalid_face_index)
+      {
+        const unsigned int n_q_points_1d = quad_1d.size();
+        const unsigned int n_q_points = dim > 1 ?
+                                        Utilities::fixed_power<dim-1>(n_q_points_1d) : 1;
+        const unsigned int direction = face_no/2;
+        std::vector<Point<dim> > points (n_q_points);
+        for (unsigned int q=0; q<n_q_points; ++q)
+          {
+            points[q][direction] = face_no%2;
+            unsigned int index = q;
+            for (unsigned int k=0; k<dim-1; ++k)
+              {
+                double x = quad_1d.point(index%n_q_points_1d)[0];
+                index /= n_q_points_1d;
+                if (subface_index != invalid_face_index)
+                  x = 0.5 * (x + ((subface_index>>k)&1));
+                points[q][(direction+1+k)%dim] = x;
+              }
+          }
+        return Quadrature<dim> (points, std::vector<double>(n_q_points, 1.));
+      }
+    }
+
+
+
+    template <int dim, typename Number>
+    FaceInfo<dim,Number>::FaceInfo ()
+      :
+      n_inner_face_batches (0),
+      n_boundary_face_batches (0),
+      first_inner_ghost_color (0),
+      first_boundary_ghost_color (0)
+    {}
+
+
+
+    template <int dim, typename Number>
+    void
+    FaceInfo<dim,Number>::clear ()
+    {
+      faces.clear();
+      n_inner_face_batches = 0;
+      n_boundary_face_batches = 0;
+      inner_color_start.clear();
+      boundary_color_start.clear();
+      first_inner_ghost_color = 0;
+      first_boundary_ghost_color = 0;
+      ghost_cells.clear();
+      mapping_data.clear();
+    }
+
+
+
+    template <int dim, typename Number>
+    void
+    FaceInfo<dim,Number>::find_ghost_cells
+    (const dealii::Triangulation<dim>                        &tria,
+     const std::vector<std::pair<unsigned int,unsigned int> > &cells)
+    {
+      typedef typename dealii::Triangulation<dim>::cell_iterator cell_iterator;
+      std::set<std::pair<unsigned int,unsigned int> > ghosts;
+      for (unsigned int i=0; i<cells.size(); ++i)
+        {
+          const cell_iterator cell (&tria, cells[i].first, cells[i].second);
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            {
+              if (cell->at_boundary(f))
+                continue;
+              const cell_iterator neighbor = cell->neighbor(f);
+              if (neighbor->has_children() ||
+                  neighbor->subdomain_id() == cell->subdomain_id() ||
+                  FaceSetup::ghost_face_is_local (cell, f) == false)
+                continue;
+              Assert (neighbor->subdomain_id() != numbers::artificial_subdomain_id,
+                      ExcInternalError());
+              ghosts.insert (std::pair<unsigned int,unsigned int>
+                             (neighbor->level(), neighbor->index()));
+            }
+        }
+      ghost_cells.assign (ghosts.begin(), ghosts.end());
+    }
+
+
+
+    template <int dim, typename Number>
+    void
+    FaceInfo<dim,Number>::initialize
+    (const dealii::Triangulation<dim>                        &tria,
+     const std::vector<std::pair<unsigned int,unsigned int> > &cells,
+     const std::vector<DoFInfo>                              &dof_info,
+     const Mapping<dim>                                      &mapping,
+     const FiniteElement<dim>                                &fe,
+     const std::vector<dealii::hp::QCollection<1> >           &quad,
+     const UpdateFlags                                        update_flags_inner_faces,
+     const UpdateFlags                                        update_flags_boundary_faces,
+     const bool                                               use_coloring)
+    {
+      {
+        std::vector<std::pair<unsigned int,unsigned int> > ghosts;
+        ghosts.swap (ghost_cells);
+        clear();
+        ghost_cells.swap (ghosts);
+      }
+      Assert (dim > 1, ExcNotImplemented());
+      typedef typename dealii::Triangulation<dim>::cell_iterator cell_iterator;
+
+      // find the position of each cell in the numbering of MatrixFree. The
+      // padding at the end of partially filled macro cells repeats cells
+      // that have already been seen, so only insert the first occurrence
+      std::map<std::pair<unsigned int,unsigned int>, unsigned int> cell_position;
+      for (unsigned int i=0; i<cells.size(); ++i)
+        cell_position.insert (std::make_pair(cells[i], i));
+      std::map<std::pair<unsigned int,unsigned int>, unsigned int> ghost_position;
+      for (unsigned int i=0; i<ghost_cells.size(); ++i)
+        ghost_position.insert (std::make_pair(ghost_cells[i], cells.size()+i));
+
+      // collect the faces as seen from the interior side
+      std::vector<FaceSetup::FaceEntry> inner_faces, boundary_faces;
+      for (unsigned int i=0; i<cells.size(); ++i)
+        {
+          if (cell_position[cells[i]] != i)
+            continue;
+          const cell_iterator cell (&tria, cells[i].first, cells[i].second);
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            {
+              FaceSetup::FaceEntry face;
+              face.interior = i;
+              face.exterior = numbers::invalid_unsigned_int;
+              face.interior_face_no = f;
+              face.exterior_face_no = invalid_face_index;
+              face.subface_index = invalid_face_index;
+              face.boundary_id = 0;
+              if (cell->at_boundary(f))
+                {
+                  if (update_flags_boundary_faces == update_default)
+                    continue;
+                  face.boundary_id = cell->face(f)->boundary_id();
+                  boundary_faces.push_back (face);
+                  continue;
+                }
+              if (update_flags_inner_faces == update_default)
+                continue;
+
+              const cell_iterator neighbor = cell->neighbor(f);
+
+              // faces towards finer neighbors are visited from the other side
+              if (neighbor->has_children())
+                continue;
+
+              const std::pair<unsigned int,unsigned int>
+              neighbor_index (neighbor->level(), neighbor->index());
+              typename std::map<std::pair<unsigned int,unsigned int>,
+                       unsigned int>::const_iterator neighbor_position =
+                         cell_position.find (neighbor_index);
+              if (neighbor_position == cell_position.end())
+                {
+                  // faces towards ghost cells are only worked on by one of
+                  // the two processors
+                  if (FaceSetup::ghost_face_is_local (cell, f) == false)
+                    continue;
+                  neighbor_position = ghost_position.find (neighbor_index);
+                  AssertThrow (neighbor_position != ghost_position.end(),
+                               ExcMessage ("The ghost cells adjacent to the faces "
+                                           "of this processor have not been set up "
+                                           "together with the indices of MatrixFree."));
+                }
+              face.exterior = neighbor_position->second;
+
+              if (cell->neighbor_is_coarser(f))
+                {
+                  const std::pair<unsigned int,unsigned int> neighbor_face =
+                    cell->neighbor_of_coarser_neighbor(f);
+                  face.exterior_face_no = neighbor_face.first;
+
+                  // find out which part of the neighbor's face is covered by
+                  // this face in terms of the face-intrinsic coordinates used
+                  // by FEFaceEvaluation
+                  const Point<dim> center =
+                    mapping.transform_real_to_unit_cell (neighbor,
+                                                         cell->face(f)->center());
+                  const unsigned int direction = face.exterior_face_no/2;
+                  face.subface_index = 0;
+                  for (unsigned int k=0; k<dim-1; ++k)
+                    if (center[(direction+1+k)%dim] > 0.5)
+                      face.subface_index += (1U<<k);
+                }
+              else
+                {
+                  // faces between cells of the same level are only added
+                  // once, from the cell that comes first
+                  if (face.exterior < face.interior)
+                    continue;
+                  face.exterior_face_no = cell->neighbor_of_neighbor(f);
+                }
+              inner_faces.push_back (face);
+            }
+        }
+
+      std::stable_sort (inner_faces.begin(), inner_faces.end(),
+                        FaceSetup::FaceComparator());
+      std::stable_sort (boundary_faces.begin(), boundary_faces.end(),
+                        FaceSetup::FaceComparator());
+
+      // merge faces into batches
+      for (unsigned int type=0; type<2; ++type)
+        {
+          const std::vector<FaceSetup::FaceEntry> &face_list =
+            type == 0 ? inner_faces : boundary_faces;
+          const unsigned int n_batches_before = faces.size();
+          for (unsigned int i=0; i<face_list.size(); )
+            {
+              FaceBatch batch;
+              batch.interior_face_no = face_list[i].interior_face_no;
+              batch.exterior_face_no = face_list[i].exterior_face_no;
+              batch.subface_index = face_list[i].subface_index;
+              batch.boundary_id = face_list[i].boundary_id;
+              unsigned int v = 0;
+              for ( ; v<n_vector_elements && i<face_list.size(); ++v, ++i)
+                {
+                  if (v > 0 && FaceSetup::FaceComparator()(face_list[i-1],
+                                                           face_list[i]))
+                    break;
+                  batch.cells_interior[v] = face_list[i].interior;
+                  batch.cells_exterior[v] = face_list[i].exterior;
+                }
+              batch.n_filled_lanes = v;
+              for ( ; v<n_vector_elements; ++v)
+                {
+                  batch.cells_interior[v] = batch.cells_interior[0];
+                  batch.cells_exterior[v] = batch.cells_exterior[0];
+                }
+              faces.push_back (batch);
+            }
+          if (type == 0)
+            n_inner_face_batches = faces.size() - n_batches_before;
+          else
+            n_boundary_face_batches = faces.size() - n_batches_before;
+        }
+
+      // place the batches that access ghost entries of the vectors at the
+      // end of each group, such that the other batches can be worked on
+      // while the ghost values are imported, and color both parts separately
+      for (unsigned int type=0; type<2; ++type)
+        {
+          const unsigned int begin = type == 0 ? 0 : n_inner_face_batches;
+          const unsigned int end = type == 0 ? n_inner_face_batches : faces.size();
+          const unsigned int ghost_begin =
+            std::stable_partition (faces.begin()+begin, faces.begin()+end,
+                                   std::not1(FaceSetup::AccessesGhosts<FaceBatch>
+                                             (dof_info, n_vector_elements)))
+            - faces.begin();
+
+          std::vector<unsigned int> &color_start =
+            type == 0 ? inner_color_start : boundary_color_start;
+          color_start = FaceSetup::color_face_batches (begin, ghost_begin, dof_info,
+                                                       n_vector_elements,
+                                                       use_coloring, faces);
+          if (type == 0)
+            first_inner_ghost_color = color_start.size() - 1;
+          else
+            first_boundary_ghost_color = color_start.size() - 1;
+          const std::vector<unsigned int> ghost_color_start =
+            FaceSetup::color_face_batches (ghost_begin, end, dof_info,
+                                           n_vector_elements, use_coloring,
+                                           faces);
+          color_start.insert (color_start.end(), ghost_color_start.begin()+1,
+                              ghost_color_start.end());
+        }
+
+      // compute the geometry data. the reference points are generated in
+      // the order used by FEFaceEvaluation and evaluated with FEValues on
+      // the cells, caching one FEValues object per side, face number and
+      // subface
+      const UpdateFlags fe_values_flags = update_JxW_values |
+                                          update_inverse_jacobians |
+                                          update_quadrature_points;
+      const bool store_points = (update_flags_inner_faces |
+                                 update_flags_boundary_faces) &
+                                update_quadrature_points;
+
+      mapping_data.resize (quad.size());
+      for (unsigned int my_q=0; my_q<quad.size(); ++my_q)
+        {
+          AssertDimension (quad[my_q].size(), 1);
+          const Quadrature<1> &quad_1d = quad[my_q][0];
+          const Quadrature<dim-1> face_quad (quad_1d);
+          MappingData &data = mapping_data[my_q];
+          data.n_q_points = face_quad.size();
+          const unsigned int n_q_points = data.n_q_points;
+
+          data.JxW_values.resize (faces.size()*n_q_points);
+          data.normal_vectors.resize (faces.size()*n_q_points);
+          data.jacobians[0].resize (faces.size()*n_q_points);
+          data.jacobians[1].resize (n_inner_face_batches*n_q_points);
+          if (store_points)
+            data.quadrature_points.resize (faces.size()*n_q_points);
+
+          std::map<std::pair<unsigned int,unsigned int>,
+              std_cxx11::shared_ptr<dealii::FEValues<dim> > > fe_values;
+
+          for (unsigned int face=0; face<faces.size(); ++face)
+            {
+              const FaceBatch &batch = faces[face];
+              for (unsigned int v=0; v<n_vector_elements; ++v)
+                {
+                  const unsigned int lane = v<batch.n_filled_lanes ? v : 0;
+                  for (unsigned int side=0; side<2; ++side)
+                    {
+                      if (side == 1 && face >= n_inner_face_batches)
+                        break;
+                      const unsigned int face_no =
+                        side == 0 ? batch.interior_face_no : batch.exterior_face_no;
+                      const unsigned char subface_index =
+                        side == 0 ? invalid_face_index : batch.subface_index;
+                      const std::pair<unsigned int,unsigned int>
+                      key (side*GeometryInfo<dim>::faces_per_cell + face_no,
+                           subface_index);
+                      if (fe_values.find(key) == fe_values.end())
+                        fe_values[key].reset
+                        (new dealii::FEValues<dim>(mapping, fe,
+                                           FaceSetup::face_quadrature_on_cell<dim>
+                                           (quad_1d, face_no, subface_index,
+                                            invalid_face_index),
+                                           fe_values_flags));
+                      dealii::FEValues<dim> &fe_eval = *fe_values[key];
+
+                      const unsigned int cell_number =
+                        side == 0 ? batch.cells_interior[lane] :
+                        batch.cells_exterior[lane];
+                      const std::pair<unsigned int,unsigned int> cell_index =
+                        cell_number < cells.size() ? cells[cell_number] :
+                        ghost_cells[cell_number - cells.size()];
+                      const cell_iterator cell (&tria, cell_index.first,
+                                                cell_index.second);
+                      fe_eval.reinit (cell);
+
+                      const unsigned int direction = face_no/2;
+                      for (unsigned int q=0; q<n_q_points; ++q)
+                        {
+                          const unsigned int index = face*n_q_points+q;
+                          const DerivativeForm<1,dim,dim> &inv_jac =
+                            fe_eval.inverse_jacobian(q);
+                          for (unsigned int d=0; d<dim; ++d)
+                            for (unsigned int e=0; e<dim; ++e)
+                              data.jacobians[side][index][d][e][v] = inv_jac[e][d];
+
+                          if (side == 0)
+                            {
+                              // normal vector and surface element by the
+                              // transformation of the reference normal
+                              Tensor<1,dim> normal;
+                              for (unsigned int e=0; e<dim; ++e)
+                                normal[e] = (face_no%2 == 0 ? -1. : 1.) *
+                                            inv_jac[direction][e];
+                              const double norm = normal.norm();
+                              for (unsigned int e=0; e<dim; ++e)
+                                data.normal_vectors[index][e][v] = normal[e] / norm;
+                              data.JxW_values[index][v] =
+                                face_quad.weight(q) * std::abs(fe_eval.JxW(q)) * norm;
+                              if (store_points)
+                                for (unsigned int d=0; d<dim; ++d)
+                                  data.quadrature_points[index][d][v] =
+                                    fe_eval.quadrature_point(q)[d];
+                            }
+                        }
+
+#ifdef DEBUG
+                      // check that the points on both sides coincide. the
+                      // FEValues object of the interior side has been set to
+                      // the interior cell of this lane just before
+                      if (side == 1)
+                        {
+                          const dealii::FEValues<dim> &fe_eval_interior =
+                            *fe_values[std::make_pair(static_cast<unsigned int>
+                                                      (batch.interior_face_no),
+                                                      static_cast<unsigned int>
+                                                      (invalid_face_index))];
+                          for (unsigned int q=0; q<n_q_points; ++q)
+                            Assert (fe_eval.quadrature_point(q).distance
+                                    (fe_eval_interior.quadrature_point(q)) <
+                                    1e-8 * cell->diameter(),
+                                    ExcMessage ("The quadrature points on the two sides "
+                                                "of a face do not match. Faces in "
+                                                "non-standard orientation are not "
+                                                "supported by MatrixFree."));
+                        }
+#endif
+                    }
+                }
+            }
+        }
+    }
+
+
+
+    template <int dim, typename Number>
+    std::size_t
+    FaceInfo<dim,Number>::MappingData::memory_consumption () const
+    {
+      std::size_t memory = sizeof(*this);
+      memory += MemoryConsumption::memory_consumption (JxW_values);
+      memory += MemoryConsumption::memory_consumption (normal_vectors);
+      memory += MemoryConsumption::memory_consumption (jacobians[0]);
+      memory += MemoryConsumption::memory_consumption (jacobians[1]);
+      memory += MemoryConsumption::memory_consumption (quadrature_points);
+      return memory;
+    }
+
+
+
+    template <int dim, typename Number>
+    std::size_t
+    FaceInfo<dim,Number>::memory_consumption () const
+    {
+      std::size_t memory = sizeof(*this);
+      memory += faces.capacity() * sizeof(FaceBatch);
+      memory += MemoryConsumption::memory_consumption (inner_color_start);
+      memory += MemoryConsumption::memory_consumption (boundary_color_start);
+      memory += MemoryConsumption::memory_consumption (ghost_cells);
+      for (unsigned int i=0; i<mapping_data.size(); ++i)
+        memory += mapping_data[i].memory_consumption();
+      return memory;
+    }
+
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,1063 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii__matrix_free_fe_face_evaluation_h
+#define dealii__matrix_free_fe_face_evaluation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/block_vector_base.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/face_info.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace internal
+{
+  /**
+   * Selects the data types returned by FEFaceEvaluation: scalars and
+   * gradient tensors for a single component, and tensors thereof for
+   * vector-valued problems.
+   */
+  template <int n_components, int dim, typename Number>
+  struct FaceEvaluationTypes
+  {
+    typedef Tensor<1,n_components,VectorizedArray<Number> > value_type;
+    typedef Tensor<1,n_components,Tensor<1,dim,VectorizedArray<Number> > > gradient_type;
+
+    static VectorizedArray<Number> &
+    value_component (value_type &value, const unsigned int comp)
+    {
+      return value[comp];
+    }
+
+    static const VectorizedArray<Number> &
+    value_component (const value_type &value, const unsigned int comp)
+    {
+      return value[comp];
+    }
+
+    static Tensor<1,dim,VectorizedArray<Number> > &
+    gradient_component (gradient_type &gradient, const unsigned int comp)
+    {
+      return gradient[comp];
+    }
+
+    static const Tensor<1,dim,VectorizedArray<Number> > &
+    gradient_component (const gradient_type &gradient, const unsigned int comp)
+    {
+      return gradient[comp];
+    }
+  };
+
+  template <int dim, typename Number>
+  struct FaceEvaluationTypes<1,dim,Number>
+  {
+    typedef VectorizedArray<Number> value_type;
+    typedef Tensor<1,dim,VectorizedArray<Number> > gradient_type;
+
+    static VectorizedArray<Number> &
+    value_component (value_type &value, const unsigned int)
+    {
+      return value;
+    }
+
+    static const VectorizedArray<Number> &
+    value_component (const value_type &value, const unsigned int)
+    {
+      return value;
+    }
+
+    static Tensor<1,dim,VectorizedArray<Number> > &
+    gradient_component (gradient_type &gradient, const unsigned int)
+    {
+      return gradient;
+    }
+
+    static const Tensor<1,dim,VectorizedArray<Number> > &
+    gradient_component (const gradient_type &gradient, const unsigned int)
+    {
+      return gradient;
+    }
+  };
+
+
+
+  /**
+   * Tensor product evaluation within the face, i.e., in dim-1 dimensions,
+   * with possibly different 1D shape data in the face-intrinsic coordinate
+   * directions. This is needed for the coarse side of faces with hanging
+   * nodes where only part of the face is evaluated.
+   */
+  template <int face_dim, int fe_degree, int n_q_points_1d, typename Number>
+  struct FaceTensorProduct
+  {
+    static const unsigned int n_max =
+      (fe_degree+1 > n_q_points_1d ? fe_degree+1 : n_q_points_1d);
+    static const unsigned int n_tmp =
+      Utilities::fixed_int_power<n_max,face_dim>::value;
+
+    template <bool dof_to_quad, bool add>
+    static void apply (const Number *const shape_data[],
+                       const Number        in [],
+                       Number              out [])
+    {
+      typedef EvaluatorTensorProduct<evaluate_general,face_dim,fe_degree,
+              n_q_points_1d,Number> Eval;
+      switch (face_dim)
+        {
+        case 1:
+          Eval::template apply<0,dof_to_quad,add>(shape_data[0], in, out);
+          break;
+        case 2:
+        {
+          Number tmp[n_tmp];
+          Eval::template apply<0,dof_to_quad,false>(shape_data[0], in, tmp);
+          Eval::template apply<1,dof_to_quad,add>(shape_data[1], tmp, out);
+          break;
+        }
+        default:
+          Assert (false, ExcNotImplemented());
+        }
+    }
+  };
+
+
+
+  /**
+   * Interpolates the values (or the normal derivative if @p shape_data
+   * points to the derivatives) of the cell degrees of freedom to the face
+   * degrees of freedom of face @p face_no, or applies the transpose operation.
+   */
+  template <int dim, int fe_degree, typename Number, bool dof_to_quad, bool add>
+  inline
+  void
+  apply_face_interpolation (const unsigned int face_direction,
+                            const Number      *shape_data,
+                            const Number       in [],
+                            Number             out [])
+  {
+    switch (face_direction)
+      {
+      case 0:
+        apply_tensor_product_face<dim,fe_degree,Number,0,dof_to_quad,add>
+        (shape_data, in, out);
+        break;
+      case 1:
+        apply_tensor_product_face<dim,fe_degree,Number,(dim>1?1:0),dof_to_quad,add>
+        (shape_data, in, out);
+        break;
+      case 2:
+        apply_tensor_product_face<dim,fe_degree,Number,(dim>2?2:0),dof_to_quad,add>
+        (shape_data, in, out);
+        break;
+      default:
+        Assert (false, ExcNotImplemented());
+      }
+  }
+}
+
+
+
+/**
+ * The class that provides all functions necessary to evaluate functions at
+ * quadrature points on faces and to integrate over faces, in analogy to what
+ * FEEvaluation does on cells. The class works on batches of faces as set up
+ * by MatrixFree when AdditionalData::mapping_update_flags_inner_faces or
+ * AdditionalData::mapping_update_flags_boundary_faces are given, and it is
+ * usually used from the face and boundary operations passed to
+ * MatrixFree::loop().
+ *
+ * Each face has an interior and an exterior side. The side that is worked on
+ * is selected at construction, so that one needs two objects of this class
+ * for evaluating jump terms in discontinuous Galerkin methods. The degrees of
+ * freedom are read from the cells adjacent to the face with the usual
+ * read_dof_values() function, and are interpolated to the face by a sum
+ * factorization kernel that first reduces the cell values to the face and
+ * then evaluates the result on the face quadrature points. The vector
+ * operations are done lane by lane because the cells adjacent to the faces
+ * of a batch are not stored in the same macro cell in general, whereas all
+ * the arithmetic works on full VectorizedArray entries.
+ *
+ * The normal vector returned by get_normal_vector() points from the interior
+ * side to the exterior side on both sides of the face. On faces with hanging
+ * nodes, the interior side is the finer one, and the exterior side evaluates
+ * the coarse cell on the appropriate part of its face.
+ *
+ * The class only supports tensor product elements (FE_Q, FE_DGQ and systems
+ * of them) as FEEvaluation with the general evaluation kernels.
+ */
+template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1,
+          int n_components_ = 1, typename Number = double >
+class FEFaceEvaluation
+{
+public:
+  typedef Number                                 number_type;
+  typedef typename internal::FaceEvaluationTypes<n_components_,dim,Number>::value_type    value_type;
+  typedef typename internal::FaceEvaluationTypes<n_components_,dim,Number>::gradient_type gradient_type;
+  static const unsigned int dimension     = dim;
+  static const unsigned int n_components  = n_components_;
+  static const unsigned int static_dofs_per_cell =
+    Utilities::fixed_int_power<fe_degree+1,dim>::value;
+  static const unsigned int static_dofs_per_face =
+    Utilities::fixed_int_power<fe_degree+1,dim-1>::value;
+  static const unsigned int n_q_points =
+    Utilities::fixed_int_power<n_q_points_1d,dim-1>::value;
+
+  /**
+   * Constructor. Takes all data stored in MatrixFree. If @p is_interior_face
+   * is true, the object works on the interior side of the faces, otherwise
+   * on the exterior side. The remaining arguments select the DoFHandler and
+   * the quadrature formula among the ones given to MatrixFree::reinit().
+   */
+  FEFaceEvaluation (const MatrixFree<dim,Number> &matrix_free,
+                    const bool                    is_interior_face = true,
+                    const unsigned int            fe_no = 0,
+                    const unsigned int            quad_no = 0);
+
+  /**
+   * Initializes the operation pointer to the batch of faces with the given
+   * index, in the range [0, n_inner_face_batches() +
+   * n_boundary_face_batches()) of the underlying MatrixFree object.
+   */
+  void reinit (const unsigned int face_batch_number);
+
+  /**
+   * Reads the degrees of freedom of the cells on the selected side of the
+   * current face batch from the vector @p src, resolving constraints in the
+   * same way as FEEvaluation::read_dof_values().
+   */
+  template <typename VectorType>
+  void read_dof_values (const VectorType &src);
+
+  /**
+   * Adds the degrees of freedom on the cells of the selected side of the
+   * current face batch into the vector @p dst, resolving constraints in the
+   * same way as FEEvaluation::distribute_local_to_global().
+   */
+  template <typename VectorType>
+  void distribute_local_to_global (VectorType &dst) const;
+
+  /**
+   * Evaluates the function values and/or the gradients of the finite element
+   * function given by the cell degrees of freedom on the face quadrature
+   * points.
+   */
+  void evaluate (const bool evaluate_values,
+                 const bool evaluate_gradients);
+
+  /**
+   * Multiplies the values and/or gradients submitted on the quadrature
+   * points by the values and/or gradients of the test functions and sums
+   * over the quadrature points, writing the result into the cell degrees of
+   * freedom.
+   */
+  void integrate (const bool integrate_values,
+                  const bool integrate_gradients);
+
+  /**
+   * Returns the value of the finite element function at quadrature point
+   * @p q_point.
+   */
+  value_type get_value (const unsigned int q_point) const;
+
+  /**
+   * Returns the gradient of the finite element function in real coordinates
+   * at quadrature point @p q_point.
+   */
+  gradient_type get_gradient (const unsigned int q_point) const;
+
+  /**
+   * Returns the derivative of the finite element function in direction of
+   * the normal vector at quadrature point @p q_point.
+   */
+  value_type get_normal_gradient (const unsigned int q_point) const;
+
+  /**
+   * Writes a value to the field containing the values on quadrature point
+   * @p q_point to be tested by the values of the test functions in
+   * integrate(). The value is multiplied by the quadrature weight and the
+   * surface element.
+   */
+  void submit_value (const value_type   value,
+                     const unsigned int q_point);
+
+  /**
+   * Writes a gradient to the field containing the gradients on quadrature
+   * point @p q_point to be tested by the gradients of the test functions in
+   * integrate(). The gradient is multiplied by the quadrature weight and the
+   * surface element.
+   */
+  void submit_gradient (const gradient_type grad_in,
+                        const unsigned int  q_point);
+
+  /**
+   * Writes a value to be tested by the normal derivative of the test
+   * functions at quadrature point @p q_point. This overwrites any data
+   * submitted by submit_gradient() on the same point.
+   */
+  void submit_normal_gradient (const value_type   value,
+                               const unsigned int q_point);
+
+  /**
+   * Returns the unit normal vector pointing from the interior to the
+   * exterior side of the face.
+   */
+  Tensor<1,dim,VectorizedArray<Number> >
+  get_normal_vector (const unsigned int q_point) const;
+
+  /**
+   * Returns the quadrature weight times the surface element on the given
+   * quadrature point.
+   */
+  VectorizedArray<Number> JxW (const unsigned int q_point) const;
+
+  /**
+   * Returns the position of the quadrature point in real coordinates. Only
+   * available if update_quadrature_points has been set for the faces.
+   */
+  Point<dim,VectorizedArray<Number> >
+  quadrature_point (const unsigned int q_point) const;
+
+  /**
+   * Returns the boundary id of the current face batch. Only valid for
+   * boundary faces.
+   */
+  types::boundary_id boundary_id () const;
+
+  /**
+   * Returns a read and write pointer to the first entry of the degrees of
+   * freedom of the given component, in lexicographic ordering.
+   */
+  VectorizedArray<Number> *begin_dof_values (const unsigned int component = 0);
+
+  /**
+   * Returns the number of the face batch the object currently points to.
+   */
+  unsigned int get_face_batch_index () const;
+
+private:
+  /**
+   * Shared implementation of read_dof_values() and
+   * distribute_local_to_global(), going through the index storage of the
+   * cells lane by lane.
+   */
+  template<typename VectorType, typename VectorOperation>
+  void read_write_operation (const VectorOperation &operation,
+                             VectorType            *vectors[]) const;
+
+  /**
+   * Sets the pointers to the 1D shape data used within the face for the
+   * current subface.
+   */
+  void set_face_shape_data (const VectorizedArray<Number> *values[],
+                            const VectorizedArray<Number> *gradients[]) const;
+
+  mutable VectorizedArray<Number> values_dofs[n_components][static_dofs_per_cell];
+  VectorizedArray<Number> values_quad[n_components][n_q_points];
+  VectorizedArray<Number> gradients_quad[n_components][dim][n_q_points];
+
+  const MatrixFree<dim,Number> &matrix_info;
+  const internal::MatrixFreeFunctions::DoFInfo &dof_info;
+  const internal::MatrixFreeFunctions::ShapeInfo<Number> &data;
+  const internal::MatrixFreeFunctions::FaceInfo<dim,Number> &face_info;
+  const typename internal::MatrixFreeFunctions::FaceInfo<dim,Number>::MappingData &mapping_data;
+  const bool is_interior_face;
+  const unsigned int n_fe_components;
+
+  unsigned int face_batch;
+  unsigned int face_no;
+  unsigned char subface_index;
+  const VectorizedArray<Number> *J_values;
+  const Tensor<1,dim,VectorizedArray<Number> > *normal_vectors;
+  const Tensor<2,dim,VectorizedArray<Number> > *jacobians;
+  const Point<dim,VectorizedArray<Number> > *quadrature_points;
+
+#ifdef DEBUG
+  bool dof_values_initialized;
+  bool values_quad_initialized;
+  bool gradients_quad_initialized;
+  bool values_quad_submitted;
+  bool gradients_quad_submitted;
+#endif
+};
+
+
+
+/*----------------------- Inline functions ----------------------------------*/
+
+#ifndef DOXYGEN
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::FEFaceEvaluation (const MatrixFree<dim,Number> &matrix_free,
+                    const bool                    is_interior_face,
+                    const unsigned int            fe_no,
+                    const unsigned int            quad_no)
+  :
+  matrix_info       (matrix_free),
+  dof_info          (matrix_free.get_dof_info(fe_no)),
+  data              (matrix_free.get_shape_info(fe_no, quad_no)),
+  face_info         (matrix_free.get_face_info()),
+  mapping_data      (matrix_free.get_face_info().mapping_data[quad_no]),
+  is_interior_face  (is_interior_face),
+  n_fe_components   (matrix_free.get_dof_info(fe_no).n_components),
+  face_batch        (numbers::invalid_unsigned_int),
+  face_no           (numbers::invalid_unsigned_int),
+  subface_index     (internal::MatrixFreeFunctions::FaceInfo<dim,Number>::invalid_face_index),
+  J_values          (0),
+  normal_vectors    (0),
+  jacobians         (0),
+  quadrature_points (0)
+{
+  Assert (dim > 1, ExcNotImplemented());
+  Assert (data.element_type != internal::MatrixFreeFunctions::truncated_tensor &&
+          data.element_type != internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
+          ExcNotImplemented());
+  AssertDimension (static_cast<int>(data.fe_degree), fe_degree);
+  AssertDimension (data.n_q_points_face, n_q_points);
+  AssertDimension (mapping_data.n_q_points, n_q_points);
+  AssertDimension (data.dofs_per_cell, static_dofs_per_cell);
+  Assert (n_fe_components == 1 || n_components == n_fe_components,
+          ExcMessage ("The underlying FE is vector-valued. In this case, the "
+                      "template argument n_components must be a the same "
+                      "as the number of underlying vector components."));
+#ifdef DEBUG
+  dof_values_initialized     = false;
+  values_quad_initialized    = false;
+  gradients_quad_initialized = false;
+  values_quad_submitted      = false;
+  gradients_quad_submitted   = false;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::reinit (const unsigned int face_batch_number)
+{
+  AssertIndexRange (face_batch_number, face_info.faces.size());
+  const typename internal::MatrixFreeFunctions::FaceInfo<dim,Number>::FaceBatch &batch =
+    face_info.faces[face_batch_number];
+  Assert ((is_interior_face == true ||
+           batch.exterior_face_no != internal::MatrixFreeFunctions::FaceInfo<dim,Number>::invalid_face_index),
+          ExcMessage ("Boundary faces do not have an exterior side"));
+
+  face_batch = face_batch_number;
+  face_no = is_interior_face ? batch.interior_face_no : batch.exterior_face_no;
+  subface_index = is_interior_face ?
+                  internal::MatrixFreeFunctions::FaceInfo<dim,Number>::invalid_face_index :
+                  batch.subface_index;
+
+  const unsigned int offset = face_batch_number * n_q_points;
+  J_values = &mapping_data.JxW_values[offset];
+  normal_vectors = &mapping_data.normal_vectors[offset];
+  jacobians = &mapping_data.jacobians[is_interior_face ? 0 : 1][offset];
+  quadrature_points = mapping_data.quadrature_points.size() > 0 ?
+                      &mapping_data.quadrature_points[offset] : 0;
+
+#ifdef DEBUG
+  dof_values_initialized     = false;
+  values_quad_initialized    = false;
+  gradients_quad_initialized = false;
+  values_quad_submitted      = false;
+  gradients_quad_submitted   = false;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+template<typename VectorType, typename VectorOperation>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::read_write_operation (const VectorOperation &operation,
+                        VectorType            *vectors[]) const
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+  Assert (matrix_info.indices_initialized() == true, ExcNotInitialized());
+
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const typename internal::MatrixFreeFunctions::FaceInfo<dim,Number>::FaceBatch &batch =
+    face_info.faces[face_batch];
+  const unsigned int n_local_dofs = n_lanes * static_dofs_per_cell *
+                                    (n_fe_components == 1 ? 1 : n_components);
+
+  if (n_fe_components == 1)
+    for (unsigned int comp=0; comp<n_components; ++comp)
+      internal::check_vector_compatibility (*vectors[comp], dof_info);
+  else
+    internal::check_vector_compatibility (*vectors[0], dof_info);
+
+  // In the vector-valued case, all components are stored in the same
+  // vector, one after the other. Index the local data as one long array.
+  VectorizedArray<Number> *local_data = &values_dofs[0][0];
+
+  for (unsigned int lane=0; lane<n_lanes; ++lane)
+    {
+      if (lane >= batch.n_filled_lanes)
+        {
+          for (unsigned int comp=0; comp<n_components; ++comp)
+            for (unsigned int i=0; i<static_dofs_per_cell; ++i)
+              operation.process_empty (values_dofs[comp][i][lane]);
+          continue;
+        }
+
+      // The indices of a macro cell are stored interleaved between the
+      // vectorization lanes. Run through all of them but only act on the
+      // ones that belong to the cell adjacent to the face in this lane.
+      const unsigned int cell_index = is_interior_face ?
+                                      batch.cells_interior[lane] :
+                                      batch.cells_exterior[lane];
+
+      // ghost cells are numbered after the cells of the MatrixFree object and
+      // store their indices separately, without constraints
+      if (cell_index >= matrix_info.n_macro_cells()*n_lanes)
+        {
+          const unsigned int *dof_indices =
+            &dof_info.ghost_cell_dof_indices[0] +
+            (cell_index - matrix_info.n_macro_cells()*n_lanes) *
+            dof_info.dofs_per_cell[0];
+          AssertDimension (dof_info.dofs_per_cell[0], n_local_dofs/n_lanes);
+          for (unsigned int i=0; i<n_local_dofs/n_lanes; ++i)
+            {
+              if (n_fe_components == 1)
+                for (unsigned int comp=0; comp<n_components; ++comp)
+                  operation.process_dof (dof_indices[i], *vectors[comp],
+                                         values_dofs[comp][i][lane]);
+              else
+                operation.process_dof (dof_indices[i], *vectors[0],
+                                       local_data[i][lane]);
+            }
+          continue;
+        }
+
+      const unsigned int cell = cell_index / n_lanes;
+      const unsigned int cell_lane = cell_index % n_lanes;
+
+      const unsigned int *dof_indices = dof_info.begin_indices(cell);
+      const std::pair<unsigned short,unsigned short> *indicators =
+        dof_info.begin_indicators(cell);
+      const std::pair<unsigned short,unsigned short> *indicators_end =
+        dof_info.end_indicators(cell);
+      const unsigned int n_irreg_components_filled = dof_info.row_starts[cell][2];
+      unsigned int ind_local = 0;
+
+      for ( ; indicators != indicators_end; ++indicators)
+        {
+          for (unsigned int j=0; j<indicators->first; ++j, ++dof_indices)
+            {
+              if (ind_local % n_lanes == cell_lane)
+                {
+                  if (n_fe_components == 1)
+                    for (unsigned int comp=0; comp<n_components; ++comp)
+                      operation.process_dof (*dof_indices, *vectors[comp],
+                                             values_dofs[comp][ind_local/n_lanes][lane]);
+                  else
+                    operation.process_dof (*dof_indices, *vectors[0],
+                                           local_data[ind_local/n_lanes][lane]);
+                }
+              ++ind_local;
+              if (n_irreg_components_filled > 0)
+                while (ind_local % n_lanes >= n_irreg_components_filled)
+                  ++ind_local;
+            }
+
+          // constrained case: build the local value as a linear combination
+          // of the global values according to constraints
+          const Number *data_val =
+            matrix_info.constraint_pool_begin(indicators->second);
+          const Number *end_pool =
+            matrix_info.constraint_pool_end(indicators->second);
+          if (ind_local % n_lanes == cell_lane)
+            {
+              if (n_fe_components == 1)
+                for (unsigned int comp=0; comp<n_components; ++comp)
+                  {
+                    Number &local = values_dofs[comp][ind_local/n_lanes][lane];
+                    Number value;
+                    operation.pre_constraints (local, value);
+                    for (unsigned int k=0; k<end_pool-data_val; ++k)
+                      operation.process_constraint (dof_indices[k], data_val[k],
+                                                    *vectors[comp], value);
+                    operation.post_constraints (value, local);
+                  }
+              else
+                {
+                  Number &local = local_data[ind_local/n_lanes][lane];
+                  Number value;
+                  operation.pre_constraints (local, value);
+                  for (unsigned int k=0; k<end_pool-data_val; ++k)
+                    operation.process_constraint (dof_indices[k], data_val[k],
+                                                  *vectors[0], value);
+                  operation.post_constraints (value, local);
+                }
+            }
+          dof_indices += end_pool-data_val;
+          ++ind_local;
+          if (n_irreg_components_filled > 0)
+            while (ind_local % n_lanes >= n_irreg_components_filled)
+              ++ind_local;
+        }
+
+      // get the dof values past the last constraint
+      for ( ; ind_local < n_local_dofs; ++dof_indices)
+        {
+          Assert (dof_indices != dof_info.end_indices(cell),
+                  ExcInternalError());
+          if (ind_local % n_lanes == cell_lane)
+            {
+              if (n_fe_components == 1)
+                for (unsigned int comp=0; comp<n_components; ++comp)
+                  operation.process_dof (*dof_indices, *vectors[comp],
+                                         values_dofs[comp][ind_local/n_lanes][lane]);
+              else
+                operation.process_dof (*dof_indices, *vectors[0],
+                                       local_data[ind_local/n_lanes][lane]);
+            }
+          ++ind_local;
+          if (n_irreg_components_filled > 0)
+            while (ind_local % n_lanes >= n_irreg_components_filled)
+              ++ind_local;
+        }
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+template<typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::read_dof_values (const VectorType &src)
+{
+  typename internal::BlockVectorSelector<VectorType,
+           IsBlockVector<VectorType>::value>::BaseVectorType *src_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    src_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(const_cast<VectorType &>(src), d);
+
+  internal::VectorReader<Number> reader;
+  read_write_operation (reader, src_data);
+
+#ifdef DEBUG
+  dof_values_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+template<typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::distribute_local_to_global (VectorType &dst) const
+{
+  Assert (dof_values_initialized==true,
+          internal::ExcAccessToUninitializedField());
+
+  typename internal::BlockVectorSelector<VectorType,
+           IsBlockVector<VectorType>::value>::BaseVectorType *dst_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    dst_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(dst, d);
+
+  internal::VectorDistributorLocalToGlobal<Number> distributor;
+  read_write_operation (distributor, dst_data);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::set_face_shape_data (const VectorizedArray<Number> *values[],
+                       const VectorizedArray<Number> *gradients[]) const
+{
+  for (unsigned int k=0; k<dim-1; ++k)
+    if (subface_index == internal::MatrixFreeFunctions::FaceInfo<dim,Number>::invalid_face_index)
+      {
+        values[k] = data.shape_values.begin();
+        gradients[k] = data.shape_gradients.begin();
+      }
+    else
+      {
+        values[k] = data.values_within_subface[(subface_index>>k)&1].begin();
+        gradients[k] = data.gradients_within_subface[(subface_index>>k)&1].begin();
+      }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::evaluate (const bool evaluate_values,
+            const bool evaluate_gradients)
+{
+  Assert (dof_values_initialized == true,
+          internal::ExcAccessToUninitializedField());
+  Assert (face_no != numbers::invalid_unsigned_int, ExcNotInitialized());
+
+  typedef internal::FaceTensorProduct<(dim>1?dim-1:1),fe_degree,n_q_points_1d,
+          VectorizedArray<Number> > FaceEval;
+  const VectorizedArray<Number> *values[dim>1?dim-1:1];
+  const VectorizedArray<Number> *gradients[dim>1?dim-1:1];
+  set_face_shape_data (values, gradients);
+
+  const unsigned int direction = face_no/2;
+  const VectorizedArray<Number> *shape_on_face =
+    data.shape_data_on_face[face_no%2].begin();
+
+  VectorizedArray<Number> face_values[static_dofs_per_face];
+  VectorizedArray<Number> face_normal_derivatives[static_dofs_per_face];
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    {
+      internal::apply_face_interpolation<dim,fe_degree,VectorizedArray<Number>,true,false>
+      (direction, shape_on_face, values_dofs[comp], face_values);
+      if (evaluate_values == true)
+        FaceEval::template apply<true,false>(values, face_values, values_quad[comp]);
+      if (evaluate_gradients == true)
+        {
+          internal::apply_face_interpolation<dim,fe_degree,VectorizedArray<Number>,true,false>
+          (direction, shape_on_face+fe_degree+1, values_dofs[comp],
+           face_normal_derivatives);
+          FaceEval::template apply<true,false>(values, face_normal_derivatives,
+                                               gradients_quad[comp][direction]);
+
+          // derivatives within the face: use the derivative shape data in
+          // face-intrinsic direction k and values in the other direction
+          for (unsigned int k=0; k<dim-1; ++k)
+            {
+              const VectorizedArray<Number> *shape_k[dim>1?dim-1:1];
+              for (unsigned int l=0; l<dim-1; ++l)
+                shape_k[l] = (l==k) ? gradients[l] : values[l];
+              FaceEval::template apply<true,false>
+              (shape_k, face_values, gradients_quad[comp][(direction+1+k)%dim]);
+            }
+        }
+    }
+
+#ifdef DEBUG
+  if (evaluate_values == true)
+    values_quad_initialized = true;
+  if (evaluate_gradients == true)
+    gradients_quad_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::integrate (const bool integrate_values,
+             const bool integrate_gradients)
+{
+  if (integrate_values == true)
+    Assert (values_quad_submitted == true,
+            internal::ExcAccessToUninitializedField());
+  if (integrate_gradients == true)
+    Assert (gradients_quad_submitted == true,
+            internal::ExcAccessToUninitializedField());
+  Assert (face_no != numbers::invalid_unsigned_int, ExcNotInitialized());
+  Assert (integrate_values == true || integrate_gradients == true,
+          ExcMessage ("Either values or gradients must be integrated"));
+
+  typedef internal::FaceTensorProduct<(dim>1?dim-1:1),fe_degree,n_q_points_1d,
+          VectorizedArray<Number> > FaceEval;
+  const VectorizedArray<Number> *values[dim>1?dim-1:1];
+  const VectorizedArray<Number> *gradients[dim>1?dim-1:1];
+  set_face_shape_data (values, gradients);
+
+  const unsigned int direction = face_no/2;
+  const VectorizedArray<Number> *shape_on_face =
+    data.shape_data_on_face[face_no%2].begin();
+
+  VectorizedArray<Number> face_values[static_dofs_per_face];
+  VectorizedArray<Number> face_normal_derivatives[static_dofs_per_face];
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    {
+      if (integrate_values == true)
+        FaceEval::template apply<false,false>(values, values_quad[comp], face_values);
+      if (integrate_gradients == true)
+        {
+          for (unsigned int k=0; k<dim-1; ++k)
+            {
+              const VectorizedArray<Number> *shape_k[dim>1?dim-1:1];
+              for (unsigned int l=0; l<dim-1; ++l)
+                shape_k[l] = (l==k) ? gradients[l] : values[l];
+              if (integrate_values == false && k == 0)
+                FaceEval::template apply<false,false>
+                (shape_k, gradients_quad[comp][(direction+1+k)%dim], face_values);
+              else
+                FaceEval::template apply<false,true>
+                (shape_k, gradients_quad[comp][(direction+1+k)%dim], face_values);
+            }
+          FaceEval::template apply<false,false>(values, gradients_quad[comp][direction],
+                                                face_normal_derivatives);
+        }
+
+      internal::apply_face_interpolation<dim,fe_degree,VectorizedArray<Number>,false,false>
+      (direction, shape_on_face, face_values, values_dofs[comp]);
+      if (integrate_gradients == true)
+        internal::apply_face_interpolation<dim,fe_degree,VectorizedArray<Number>,false,true>
+        (direction, shape_on_face+fe_degree+1, face_normal_derivatives,
+         values_dofs[comp]);
+    }
+
+#ifdef DEBUG
+  dof_values_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::value_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_value (const unsigned int q_point) const
+{
+  Assert (values_quad_initialized==true,
+          internal::ExcAccessToUninitializedField());
+  AssertIndexRange (q_point, n_q_points);
+  typedef internal::FaceEvaluationTypes<n_components_,dim,Number> Types;
+  value_type value;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    Types::value_component(value, comp) = values_quad[comp][q_point];
+  return value;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::gradient_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_gradient (const unsigned int q_point) const
+{
+  Assert (gradients_quad_initialized==true,
+          internal::ExcAccessToUninitializedField());
+  AssertIndexRange (q_point, n_q_points);
+  typedef internal::FaceEvaluationTypes<n_components_,dim,Number> Types;
+  const Tensor<2,dim,VectorizedArray<Number> > &jac = jacobians[q_point];
+  gradient_type grad;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        VectorizedArray<Number> tmp = jac[d][0] * gradients_quad[comp][0][q_point];
+        for (unsigned int e=1; e<dim; ++e)
+          tmp += jac[d][e] * gradients_quad[comp][e][q_point];
+        Types::gradient_component(grad, comp)[d] = tmp;
+      }
+  return grad;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::value_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_gradient (const unsigned int q_point) const
+{
+  typedef internal::FaceEvaluationTypes<n_components_,dim,Number> Types;
+  const gradient_type grad = get_gradient(q_point);
+  const Tensor<1,dim,VectorizedArray<Number> > &normal = normal_vectors[q_point];
+  value_type value;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    {
+      const Tensor<1,dim,VectorizedArray<Number> > &grad_comp =
+        Types::gradient_component(grad, comp);
+      VectorizedArray<Number> tmp = grad_comp[0] * normal[0];
+      for (unsigned int d=1; d<dim; ++d)
+        tmp += grad_comp[d] * normal[d];
+      Types::value_component(value, comp) = tmp;
+    }
+  return value;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_value (const value_type   value,
+                const unsigned int q_point)
+{
+  AssertIndexRange (q_point, n_q_points);
+  Assert (J_values != 0, ExcNotInitialized());
+  typedef internal::FaceEvaluationTypes<n_components_,dim,Number> Types;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    values_quad[comp][q_point] = Types::value_component(value, comp) * J_values[q_point];
+#ifdef DEBUG
+  values_quad_submitted = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_gradient (const gradient_type grad_in,
+                   const unsigned int  q_point)
+{
+  AssertIndexRange (q_point, n_q_points);
+  Assert (J_values != 0, ExcNotInitialized());
+  typedef internal::FaceEvaluationTypes<n_components_,dim,Number> Types;
+  const Tensor<2,dim,VectorizedArray<Number> > &jac = jacobians[q_point];
+  const VectorizedArray<Number> JxW = J_values[q_point];
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    {
+      const Tensor<1,dim,VectorizedArray<Number> > &grad =
+        Types::gradient_component(grad_in, comp);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          VectorizedArray<Number> tmp = jac[0][d] * grad[0];
+          for (unsigned int e=1; e<dim; ++e)
+            tmp += jac[e][d] * grad[e];
+          gradients_quad[comp][d][q_point] = tmp * JxW;
+        }
+    }
+#ifdef DEBUG
+  gradients_quad_submitted = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_normal_gradient (const value_type   value,
+                          const unsigned int q_point)
+{
+  typedef internal::FaceEvaluationTypes<n_components_,dim,Number> Types;
+  const Tensor<1,dim,VectorizedArray<Number> > &normal = normal_vectors[q_point];
+  gradient_type grad;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    for (unsigned int d=0; d<dim; ++d)
+      Types::gradient_component(grad, comp)[d] =
+        Types::value_component(value, comp) * normal[d];
+  submit_gradient (grad, q_point);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_vector (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, n_q_points);
+  Assert (normal_vectors != 0, ExcNotInitialized());
+  return normal_vectors[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+VectorizedArray<Number>
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::JxW (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, n_q_points);
+  Assert (J_values != 0, ExcNotInitialized());
+  return J_values[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+Point<dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::quadrature_point (const unsigned int q_point) const
+{
+  AssertIndexRange (q_point, n_q_points);
+  Assert (quadrature_points != 0,
+          ExcMessage ("Quadrature points on faces have not been computed. "
+                      "Set update_quadrature_points in the face update flags."));
+  return quadrature_points[q_point];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+types::boundary_id
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::boundary_id () const
+{
+  Assert (face_batch != numbers::invalid_unsigned_int, ExcNotInitialized());
+  return matrix_info.get_boundary_id (face_batch);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+VectorizedArray<Number> *
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::begin_dof_values (const unsigned int component)
+{
+  AssertIndexRange (component, n_components);
+  return &values_dofs[component][0];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_, typename Number>
+inline
+unsigned int
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_face_batch_index () const
+{
+  return face_batch;
+}
+
+
+#endif  // ifndef DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -36,6 +36,7 @@
 #include <deal.II/matrix_free/shape_info.h>
 #include <deal.II/matrix_free/dof_info.h>
 #include <deal.II/matrix_free/mapping_info.h>
+#include <deal.II/matrix_free/face_info.h>
 
 #ifdef DEAL_II_WITH_THREADS
 #include <tbb/task.h>
@@ -78,8 +79,10 @@ DEAL_II_NAMESPACE_OPEN
  * - ShapeInfo: It contains the shape functions of the finite element,
  * evaluated on the unit cell.
  *
- * Besides the initialization routines, this class implements only a single
- * operation, namely a loop over all cells (cell_loop()). This loop is
+ * Besides the initialization routines, this class implements only two
+ * operations, namely a loop over all cells (cell_loop()) and a loop over all
+ * cells and faces (loop()) for operators with face integrals such as
+ * discontinuous Galerkin methods. The cell loop is
  * scheduled in such a way that cells that share degrees of freedom are not
  * worked on simultaneously, which implies that it is possible to write to
  * vectors (or matrices) in parallel without having to explicitly synchronize
@@ -125,13 +128,18 @@ public:
    * class should also allow for access to vectors without resolving
    * constraints.
    *
-   * The last two parameters allow the user to disable some of the
+   * The next two parameters allow the user to disable some of the
    * initialization processes. For example, if only the scheduling that avoids
    * touching the same vector/matrix indices simultaneously is to be found,
    * the mapping needs not be initialized. Likewise, if the mapping has
    * changed from one iteration to the next but the topology has not (like
    * when using a deforming mesh with MappingQEulerian), it suffices to
    * initialize the mapping only.
+   *
+   * The last two parameters specify the update flags for the geometry data
+   * on interior faces and on boundary faces, respectively. If any of them is
+   * different from update_default, the faces are set up for use in loop()
+   * and FEFaceEvaluation.
    */
   struct AdditionalData
   {
@@ -150,7 +158,9 @@ public:
                     const unsigned int level_mg_handler = numbers::invalid_unsigned_int,
                     const bool                store_plain_indices = true,
                     const bool                initialize_indices = true,
-                    const bool                initialize_mapping = true)
+                    const bool                initialize_mapping = true,
+                    const UpdateFlags         mapping_update_flags_inner_faces = update_default,
+                    const UpdateFlags         mapping_update_flags_boundary_faces = update_default)
       :
       mpi_communicator      (mpi_communicator),
       tasks_parallel_scheme (tasks_parallel_scheme),
@@ -159,7 +169,9 @@ public:
       level_mg_handler      (level_mg_handler),
       store_plain_indices   (store_plain_indices),
       initialize_indices    (initialize_indices),
-      initialize_mapping    (initialize_mapping)
+      initialize_mapping    (initialize_mapping),
+      mapping_update_flags_inner_faces (mapping_update_flags_inner_faces),
+      mapping_update_flags_boundary_faces (mapping_update_flags_boundary_faces)
     {};
 
     /**
@@ -259,6 +271,31 @@ public:
      * independent cells should be computed).
      */
     bool                initialize_mapping;
+
+    /**
+     * This flag determines the geometry data to be cached on faces between
+     * two cells. If set to anything else than update_default (the default),
+     * the interior faces are collected into batches during initialization
+     * and the face operation in loop() is called on them. The normal
+     * vectors, the surface elements, and the inverse Jacobians of both
+     * adjacent cells are always computed in that case; quadrature points
+     * must be requested by update_quadrature_points.
+     *
+     * Faces are only supported for the initialization with DoFHandler
+     * objects (not hp::DoFHandler) on the active cells and on meshes where
+     * all faces are in standard orientation. In parallel, the degrees of
+     * freedom on the ghost cells adjacent to faces are added to the ghost
+     * entries of the vectors and must not be constrained, which is the case
+     * for discontinuous elements.
+     */
+    UpdateFlags         mapping_update_flags_inner_faces;
+
+    /**
+     * Same as mapping_update_flags_inner_faces, but for faces at the
+     * boundary of the domain. If set to anything else than update_default,
+     * the boundary operation in loop() is called on the boundary faces.
+     */
+    UpdateFlags         mapping_update_flags_boundary_faces;
   };
 
   /**
@@ -471,6 +508,111 @@ public:
                   OutVector      &dst,
                   const InVector &src) const;
 
+  /**
+   * This method runs a loop over all cells, all interior faces, and all
+   * boundary faces and performs the MPI data exchange on the source vector
+   * and destination vector. It is the basis for matrix-free operators with
+   * face integrals, such as discontinuous Galerkin discretizations or
+   * Nitsche-type boundary conditions, where the face terms are evaluated with
+   * FEFaceEvaluation. The faces must have been set up at initialization by
+   * setting AdditionalData::mapping_update_flags_inner_faces or
+   * AdditionalData::mapping_update_flags_boundary_faces.
+   *
+   * The three function objects have the same signature as the one in
+   * cell_loop(). The cell operation receives ranges of macro cells as in
+   * cell_loop(), which are scheduled by the same task partitioning. The face
+   * operation receives ranges of face batches in the interval
+   * [0,n_inner_face_batches()), and the boundary operation receives ranges in
+   * the interval [n_inner_face_batches(),
+   * n_inner_face_batches()+n_boundary_face_batches()). With task
+   * parallelism enabled, the face batches are sorted into colors such that
+   * batches that write into the same vector entries are never worked on
+   * concurrently, and the batches within each color are processed in
+   * parallel.
+   *
+   * The face integrals are performed before the cell integrals. The face
+   * batches that do not access ghost entries of the vectors are worked on
+   * while the ghost values of @p src are imported, and the remaining ones,
+   * including the faces towards ghost cells, after the import has finished.
+   * A face between cells owned by two different processors is only worked
+   * on by one of them, which writes the contributions of the ghost cell into
+   * ghost entries of @p dst. The compress operation on @p dst is started
+   * within the cell part of the loop and collects the contributions of both
+   * cells and faces.
+   *
+   * @note The face batches are not part of the task partitioning of the
+   * cells described by TaskInfo. They are worked on in a separate phase
+   * before the cells, one color after the other with a synchronization point
+   * between colors, so the face work does not overlap with the cell work.
+   */
+  template <typename OutVector, typename InVector>
+  void loop (const std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                                             OutVector &,
+                                             const InVector &,
+                                             const std::pair<unsigned int,
+                                             unsigned int> &)> &cell_operation,
+             const std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                                             OutVector &,
+                                             const InVector &,
+                                             const std::pair<unsigned int,
+                                             unsigned int> &)> &face_operation,
+             const std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                                             OutVector &,
+                                             const InVector &,
+                                             const std::pair<unsigned int,
+                                             unsigned int> &)> &boundary_operation,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * This is the second variant to run the loop over all cells and faces, now
+   * providing three pointers to member functions of class @p CLASS with the
+   * signature <code>operation (const MatrixFree<dim,Number> &, OutVector &,
+   * InVector &, std::pair<unsigned int,unsigned int>&)const</code>.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &)const,
+             const CLASS    *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &),
+             CLASS          *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
   /**
    * In the hp adaptive case, a subrange of cells as computed during the cell
    * loop might contain elements of different degrees. Use this function to
@@ -601,6 +743,25 @@ public:
    */
   unsigned int n_macro_cells () const;
 
+  /**
+   * Returns the number of batches of interior faces that the face operation
+   * in loop() works on. Each batch contains up to
+   * VectorizedArray::n_array_elements faces.
+   */
+  unsigned int n_inner_face_batches () const;
+
+  /**
+   * Returns the number of batches of boundary faces that the boundary
+   * operation in loop() works on.
+   */
+  unsigned int n_boundary_face_batches () const;
+
+  /**
+   * Returns the boundary id of the faces in the given batch of boundary
+   * faces. All faces in a batch share the same boundary id.
+   */
+  types::boundary_id get_boundary_id (const unsigned int face_batch) const;
+
   /**
    * In case this structure was built based on a DoFHandler, this returns the
    * DoFHandler.
@@ -763,6 +924,12 @@ public:
   const internal::MatrixFreeFunctions::MappingInfo<dim,Number> &
   get_mapping_info () const;
 
+  /**
+   * Returns connectivity and geometry information on the faces.
+   */
+  const internal::MatrixFreeFunctions::FaceInfo<dim,Number> &
+  get_face_info () const;
+
   /**
    * Returns information on indexation degrees of freedom.
    */
@@ -891,6 +1058,12 @@ private:
    */
   internal::MatrixFreeFunctions::MappingInfo<dim,Number> mapping_info;
 
+  /**
+   * Holds the batches of faces together with the geometry information
+   * needed for evaluating face integrals.
+   */
+  internal::MatrixFreeFunctions::FaceInfo<dim,Number> face_info;
+
   /**
    * Contains shape value information on the unit cell.
    */
@@ -1022,6 +1195,40 @@ MatrixFree<dim,Number>::n_macro_cells () const
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_inner_face_batches () const
+{
+  return face_info.n_inner_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_boundary_face_batches () const
+{
+  return face_info.n_boundary_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+types::boundary_id
+MatrixFree<dim,Number>::get_boundary_id (const unsigned int face_batch) const
+{
+  Assert (face_batch >= face_info.n_inner_face_batches,
+          ExcIndexRange (face_batch, face_info.n_inner_face_batches,
+                         face_info.faces.size()));
+  AssertIndexRange (face_batch, face_info.faces.size());
+  return face_info.faces[face_batch].boundary_id;
+}
+
+
+
 template <int dim, typename Number>
 inline
 unsigned int
@@ -1042,6 +1249,16 @@ MatrixFree<dim,Number>::get_mapping_info () const
 
 
 
+template <int dim, typename Number>
+inline
+const internal::MatrixFreeFunctions::FaceInfo<dim,Number> &
+MatrixFree<dim,Number>::get_face_info () const
+{
+  return face_info;
+}
+
+
+
 template <int dim, typename Number>
 inline
 const internal::MatrixFreeFunctions::DoFInfo &
@@ -2149,6 +2366,28 @@ namespace internal
   } // end of namespace color
 
 
+  namespace faces
+  {
+    template <typename Worker>
+    class FaceWork
+    {
+    public:
+      FaceWork (const Worker &worker_in)
+        :
+        worker (worker_in)
+      {};
+      void operator()(const tbb::blocked_range<unsigned int> &r) const
+      {
+        worker (std::make_pair(r.begin(), r.end()));
+      }
+    private:
+      const Worker &worker;
+    };
+
+  } // end of namespace faces
+
+
+
   template<typename VectorStruct>
   class MPIComDistribute : public tbb::task
   {
@@ -2191,6 +2430,37 @@ namespace internal
 
 #endif // DEAL_II_WITH_THREADS
 
+
+
+  // runs the given worker on the face batches of the colors [first_color,
+  // end_color), one color after the other such that batches that write into
+  // the same vector entries are never worked on concurrently
+  template <typename Worker>
+  void run_face_colors (const Worker                                  &worker,
+                        const std::vector<unsigned int>               &color_start,
+                        const unsigned int                             first_color,
+                        const unsigned int                             end_color,
+                        const internal::MatrixFreeFunctions::TaskInfo &task_info)
+  {
+    Assert (end_color == 0 || end_color < color_start.size(),
+            ExcInternalError());
+    for (unsigned int color=first_color; color<end_color; ++color)
+      {
+        if (color_start[color+1] == color_start[color])
+          continue;
+#ifdef DEAL_II_WITH_THREADS
+        if (task_info.use_multithreading == true)
+          parallel_for(tbb::blocked_range<unsigned int>
+                       (color_start[color], color_start[color+1],
+                        std::max(task_info.block_size, 1U)),
+                       internal::faces::FaceWork<Worker>(worker));
+        else
+#endif
+          worker (std::make_pair(color_start[color], color_start[color+1]));
+      }
+    (void)task_info;
+  }
+
 } // end of namespace internal
 
 
@@ -2539,6 +2809,186 @@ MatrixFree<dim,Number>::cell_loop
 }
 
 
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::loop
+(const std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &)> &cell_operation,
+ const std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &)> &face_operation,
+ const std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &)> &boundary_operation,
+ OutVector       &dst,
+ const InVector  &src) const
+{
+  Assert (face_info.faces.size() ==
+          face_info.n_inner_face_batches + face_info.n_boundary_face_batches,
+          ExcNotInitialized());
+
+  typedef
+  std_cxx11::function<void (const std::pair<unsigned int,unsigned int> &range)>
+  Worker;
+  const Worker face_func = std_cxx11::bind (std_cxx11::ref(face_operation),
+                                            std_cxx11::cref(*this),
+                                            std_cxx11::ref(dst),
+                                            std_cxx11::cref(src),
+                                            std_cxx11::_1);
+  const Worker boundary_func = std_cxx11::bind (std_cxx11::ref(boundary_operation),
+                                                std_cxx11::cref(*this),
+                                                std_cxx11::ref(dst),
+                                                std_cxx11::cref(src),
+                                                std_cxx11::_1);
+
+  // start the import of the ghost values and work on the face batches that
+  // do not access ghost entries in the meantime. Then, finish the import and
+  // work on the remaining batches, which include the faces towards ghost
+  // cells. The contributions into ghost entries of dst are sent to their
+  // owners by the compress operation in the cell loop, which does not import
+  // the ghost values of src again.
+  const bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+
+  internal::run_face_colors (face_func, face_info.inner_color_start, 0,
+                             face_info.first_inner_ghost_color, task_info);
+  internal::run_face_colors (boundary_func, face_info.boundary_color_start, 0,
+                             face_info.first_boundary_ghost_color, task_info);
+
+  internal::update_ghost_values_finish (src);
+
+  const unsigned int n_inner_colors = face_info.inner_color_start.empty() ?
+                                      0 : face_info.inner_color_start.size()-1;
+  const unsigned int n_boundary_colors = face_info.boundary_color_start.empty() ?
+                                         0 : face_info.boundary_color_start.size()-1;
+  internal::run_face_colors (face_func, face_info.inner_color_start,
+                             face_info.first_inner_ghost_color,
+                             n_inner_colors, task_info);
+  internal::run_face_colors (boundary_func, face_info.boundary_color_start,
+                             face_info.first_boundary_ghost_color,
+                             n_boundary_colors, task_info);
+
+  cell_loop (cell_operation, dst, src);
+
+  internal::reset_ghost_values (src, ghosts_were_not_set);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  typedef
+  std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                            OutVector &,
+                            const InVector &,
+                            const std::pair<unsigned int,
+                            unsigned int> &)> Function;
+  const Function cell_function = std_cxx11::bind<void>(cell_operation,
+                                                       owning_class,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       std_cxx11::_3,
+                                                       std_cxx11::_4);
+  const Function face_function = std_cxx11::bind<void>(face_operation,
+                                                       owning_class,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       std_cxx11::_3,
+                                                       std_cxx11::_4);
+  const Function boundary_function = std_cxx11::bind<void>(boundary_operation,
+                                                           owning_class,
+                                                           std_cxx11::_1,
+                                                           std_cxx11::_2,
+                                                           std_cxx11::_3,
+                                                           std_cxx11::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &),
+ CLASS          *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  typedef
+  std_cxx11::function<void (const MatrixFree<dim,Number> &,
+                            OutVector &,
+                            const InVector &,
+                            const std::pair<unsigned int,
+                            unsigned int> &)> Function;
+  const Function cell_function = std_cxx11::bind<void>(cell_operation,
+                                                       owning_class,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       std_cxx11::_3,
+                                                       std_cxx11::_4);
+  const Function face_function = std_cxx11::bind<void>(face_operation,
+                                                       owning_class,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       std_cxx11::_3,
+                                                       std_cxx11::_4);
+  const Function boundary_function = std_cxx11::bind<void>(boundary_operation,
+                                                           owning_class,
+                                                           std_cxx11::_1,
+                                                           std_cxx11::_2,
+                                                           std_cxx11::_3,
+                                                           std_cxx11::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
 #endif  // ifndef DOXYGEN
 
 
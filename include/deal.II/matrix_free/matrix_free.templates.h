@@ -28,6 +28,7 @@
 #include <deal.II/matrix_free/shape_info.templates.h>
 #include <deal.II/matrix_free/mapping_info.templates.h>
 #include <deal.II/matrix_free/dof_info.templates.h>
+#include <deal.II/matrix_free/face_info.templates.h>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -60,6 +61,7 @@ copy_from (const MatrixFree<dim,Number> &v)
   constraint_pool_data = v.constraint_pool_data;
   constraint_pool_row_index = v.constraint_pool_row_index;
   mapping_info = v.mapping_info;
+  face_info = v.face_info;
   shape_info = v.shape_info;
   cell_level_index = v.cell_level_index;
   task_info = v.task_info;
@@ -153,6 +155,15 @@ internal_reinit(const Mapping<dim>                          &mapping,
       for (unsigned int no=0; no<dof_handler.size(); ++no)
         dof_info[no].store_plain_indices = additional_data.store_plain_indices;
 
+      // the degrees of freedom on the ghost cells adjacent to the faces
+      // worked on by this processor need to be imported, so find these cells
+      // before setting up the indices
+      if (additional_data.mapping_update_flags_inner_faces != update_default &&
+          size_info.n_procs > 1 &&
+          additional_data.level_mg_handler == numbers::invalid_unsigned_int)
+        face_info.find_ghost_cells (dof_handler[0]->get_tria(),
+                                    cell_level_index);
+
       // initialize the basic multithreading information that needs to be
       // passed to the DoFInfo structure
 #ifdef DEAL_II_WITH_THREADS
@@ -217,6 +228,23 @@ internal_reinit(const Mapping<dim>                          &mapping,
                                dof_info[0].cell_active_fe_index, mapping, quad,
                                additional_data.mapping_update_flags);
 
+      // Collects the faces into batches and computes the transformation data
+      // on the faces, if so requested. The ghost cells found before setting
+      // up the indices are kept.
+      if (additional_data.mapping_update_flags_inner_faces != update_default ||
+          additional_data.mapping_update_flags_boundary_faces != update_default)
+        {
+          Assert (additional_data.level_mg_handler == numbers::invalid_unsigned_int,
+                  ExcNotImplemented());
+          face_info.initialize (dof_handler[0]->get_tria(), cell_level_index,
+                                dof_info, mapping, dof_handler[0]->get_fe(), quad,
+                                additional_data.mapping_update_flags_inner_faces,
+                                additional_data.mapping_update_flags_boundary_faces,
+                                task_info.use_multithreading);
+        }
+      else
+        face_info.clear();
+
       mapping_is_initialized = true;
     }
 }
@@ -345,6 +373,11 @@ internal_reinit(const Mapping<dim>                            &mapping,
                                dof_info[0].cell_active_fe_index, mapping, quad,
                                additional_data.mapping_update_flags);
 
+      Assert (additional_data.mapping_update_flags_inner_faces == update_default &&
+              additional_data.mapping_update_flags_boundary_faces == update_default,
+              ExcMessage ("Face integrals are not implemented for hp::DoFHandler"));
+      face_info.clear();
+
       mapping_is_initialized = true;
     }
 }
@@ -628,6 +661,40 @@ void MatrixFree<dim,Number>::initialize_indices
         boundary_cells.push_back(counter);
     }
 
+  // the degrees of freedom on the ghost cells adjacent to faces are
+  // imported as ghosts, too. Their indices are stored without resolving
+  // constraints
+  std::vector<std::vector<types::global_dof_index> >
+  ghost_cell_indices (face_info.ghost_cells.empty() ? 0 : n_fe);
+  for (unsigned int no=0; no<ghost_cell_indices.size(); ++no)
+    {
+      AssertThrow (dof_handlers.active_dof_handler == DoFHandlers::usual,
+                   ExcNotImplemented());
+      const DoFHandler<dim> *dofh = &*dof_handlers.dof_handler[no];
+      const std::vector<unsigned int> &lexicographic =
+        shape_info(no,0,0,0).lexicographic_numbering;
+      local_dof_indices.resize (dof_info[no].dofs_per_cell[0]);
+      for (unsigned int c=0; c<face_info.ghost_cells.size(); ++c)
+        {
+          typename DoFHandler<dim>::active_cell_iterator
+          cell_it (&dofh->get_tria(), face_info.ghost_cells[c].first,
+                   face_info.ghost_cells[c].second, dofh);
+          cell_it->get_dof_indices (local_dof_indices);
+          for (unsigned int i=0; i<local_dof_indices.size(); ++i)
+            {
+              const types::global_dof_index index =
+                local_dof_indices[lexicographic[i]];
+              AssertThrow (constraint[no]->is_constrained(index) == false,
+                           ExcMessage ("Face integrals in MatrixFree do not support "
+                                       "constrained degrees of freedom on ghost "
+                                       "cells."));
+              ghost_cell_indices[no].push_back (index);
+              if (locally_owned_set[no].is_element(index) == false)
+                dof_info[no].ghost_dofs.push_back (index);
+            }
+        }
+    }
+
   const unsigned int vectorization_length =
     VectorizedArray<Number>::n_array_elements;
   std::vector<unsigned int> irregular_cells;
@@ -637,6 +704,14 @@ void MatrixFree<dim,Number>::initialize_indices
   for (unsigned int no=0; no<n_fe; ++no)
     dof_info[no].assign_ghosts (boundary_cells);
 
+  for (unsigned int no=0; no<ghost_cell_indices.size(); ++no)
+    {
+      dof_info[no].ghost_cell_dof_indices.resize (ghost_cell_indices[no].size());
+      for (unsigned int i=0; i<ghost_cell_indices[no].size(); ++i)
+        dof_info[no].ghost_cell_dof_indices[i] =
+          dof_info[no].vector_partitioner->global_to_local (ghost_cell_indices[no][i]);
+    }
+
   // reorganize the indices in order to overlap communication in MPI with
   // computations: Place all cells with ghost indices into one chunk. Also
   // reorder cells so that we can parallelize by threads
@@ -745,6 +820,7 @@ void MatrixFree<dim,Number>::clear()
 {
   dof_info.clear();
   mapping_info.clear();
+  face_info.clear();
   cell_level_index.clear();
   size_info.clear();
   task_info.clear();
@@ -767,6 +843,7 @@ std::size_t MatrixFree<dim,Number>::memory_consumption () const
   memory += MemoryConsumption::memory_consumption (task_info);
   memory += sizeof(*this);
   memory += mapping_info.memory_consumption();
+  memory += face_info.memory_consumption();
   return memory;
 }
 
@@ -789,6 +866,12 @@ void MatrixFree<dim,Number>::print_memory_consumption (STREAM &out) const
   out << "   Memory mapping info" << std::endl;
   mapping_info.print_memory_consumption(out, size_info);
 
+  if (face_info.faces.size() > 0)
+    {
+      out << "   Memory face info:                 ";
+      size_info.print_memory_statistics (out, face_info.memory_consumption());
+    }
+
   out << "   Memory unit cell shape data:      ";
   size_info.print_memory_statistics
   (out, MemoryConsumption::memory_consumption (shape_info));
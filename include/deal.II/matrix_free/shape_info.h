@@ -168,6 +168,33 @@ namespace internal
        */
       std::vector<Number>    subface_value[2];
 
+      /**
+       * Stores the values (first <tt>n_dofs_1d</tt> entries) and the
+       * gradients (last <tt>n_dofs_1d</tt> entries) of the one-dimensional
+       * shape functions evaluated in zero (index 0) and one (index 1) in
+       * vectorized format. Used for interpolating from cells to faces in
+       * FEFaceEvaluation.
+       */
+      AlignedVector<VectorizedArray<Number> > shape_data_on_face[2];
+
+      /**
+       * Stores the shape values of the 1D finite element evaluated on the
+       * quadrature points compressed into the lower (index 0) and upper
+       * (index 1) half of the unit interval in vectorized format, with the
+       * same layout as shape_values. Used for evaluating the coarse side of
+       * faces with hanging nodes in FEFaceEvaluation.
+       */
+      AlignedVector<VectorizedArray<Number> > values_within_subface[2];
+
+      /**
+       * Stores the shape gradients of the 1D finite element evaluated on the
+       * quadrature points compressed into the lower (index 0) and upper
+       * (index 1) half of the unit interval in vectorized format. The
+       * derivatives are taken with respect to the coordinate on the whole
+       * unit interval.
+       */
+      AlignedVector<VectorizedArray<Number> > gradients_within_subface[2];
+
       /**
        * Non-vectorized version of shape values. Needed when evaluating face
        * info.
@@ -166,6 +166,12 @@ namespace internal
       this->subface_value[1].resize(array_size);
       this->shape_values_number.resize (array_size);
       this->shape_gradient_number.resize (array_size);
+      for (unsigned int i=0; i<2; ++i)
+        {
+          this->shape_data_on_face[i].resize_fast (2*n_dofs_1d);
+          this->values_within_subface[i].resize_fast (array_size);
+          this->gradients_within_subface[i].resize_fast (array_size);
+        }
 
       for (unsigned int i=0; i<n_dofs_1d; ++i)
         {
@@ -190,8 +196,16 @@ namespace internal
                 fe->shape_grad_grad(my_i,q_point)[0][0];
               q_point[0] *= 0.5;
               subface_value[0][i*n_q_points_1d+q] = fe->shape_value(my_i,q_point);
+              values_within_subface[0][i*n_q_points_1d+q] =
+                subface_value[0][i*n_q_points_1d+q];
+              gradients_within_subface[0][i*n_q_points_1d+q] =
+                fe->shape_grad(my_i,q_point)[0];
               q_point[0] += 0.5;
               subface_value[1][i*n_q_points_1d+q] = fe->shape_value(my_i,q_point);
+              values_within_subface[1][i*n_q_points_1d+q] =
+                subface_value[1][i*n_q_points_1d+q];
+              gradients_within_subface[1][i*n_q_points_1d+q] =
+                fe->shape_grad(my_i,q_point)[0];
             }
           Point<dim> q_point;
           this->face_value[0][i] = fe->shape_value(my_i,q_point);
@@ -199,6 +213,12 @@ namespace internal
           q_point[0] = 1;
           this->face_value[1][i] = fe->shape_value(my_i,q_point);
           this->face_gradient[1][i] = fe->shape_grad(my_i,q_point)[0];
+          for (unsigned int side=0; side<2; ++side)
+            {
+              this->shape_data_on_face[side][i] = this->face_value[side][i];
+              this->shape_data_on_face[side][i+n_dofs_1d] =
+                this->face_gradient[side][i];
+            }
         }
 
       if (element_type == tensor_general &&
@@ -404,6 +424,9 @@ namespace internal
         {
           memory += MemoryConsumption::memory_consumption(face_value[i]);
           memory += MemoryConsumption::memory_consumption(face_gradient[i]);
+          memory += MemoryConsumption::memory_consumption(shape_data_on_face[i]);
+          memory += MemoryConsumption::memory_consumption(values_within_subface[i]);
+          memory += MemoryConsumption::memory_consumption(gradients_within_subface[i]);
         }
       memory += MemoryConsumption::memory_consumption(shape_values_number);
       memory += MemoryConsumption::memory_consumption(shape_gradient_number);
@@ -0,0 +1,307 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__mg_transfer_matrix_free_h
+#define dealii__mg_transfer_matrix_free_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+
+#include <deal.II/lac/parallel_vector.h>
+
+#include <deal.II/multigrid/mg_base.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Implementation of the MGTransferBase interface for which the transfer
+ * operations are implemented in a matrix-free way based on the interpolation
+ * matrices of the underlying finite element. As opposed to
+ * MGTransferPrebuilt, this class does not store a sparse matrix for the
+ * prolongation of each level. Instead, it applies the prolongation and
+ * restriction cell by cell on the parent cells of each level, using the
+ * tensor product structure of the element: the one-dimensional embedding
+ * of a coarse cell into its two children is applied direction by direction
+ * with the sum factorization kernels also used by FEEvaluation. The parent
+ * cells are processed in batches of the width of VectorizedArray.
+ *
+ * This requires less memory than MGTransferPrebuilt, in particular for
+ * higher polynomial degrees, and avoids the assembly of the transfer
+ * matrices in the setup. The class works on parallel::distributed::Vector
+ * level vectors and supports FE_Q and FE_DGQ elements of degree up to eight
+ * (FE_DGQ also with degree zero), as well as FESystem objects with a single
+ * base element of these types. Only isotropic refinement is supported.
+ *
+ * For continuous elements, the degrees of freedom on the fine level that
+ * are shared between several parent cells are weighted by the inverse of
+ * their multiplicity, such that the result matches the assembled
+ * prolongation matrix and its transpose.
+ *
+ * In parallel, each parent cell is worked on by the processor that owns its
+ * first child on the next finer level, which is also the level owner of the
+ * parent on a parallel::distributed::Triangulation. The children of the
+ * parent are at least level ghosts on that processor, and the contributions
+ * to level degrees of freedom owned by other processors are sent to their
+ * owners by the compress operation of the level vector.
+ */
+template <int dim, typename Number>
+class MGTransferMatrixFree : public MGTransferBase<parallel::distributed::Vector<Number> >
+{
+public:
+  /**
+   * Constructor without constraint matrices. Use this constructor only with
+   * discontinuous finite elements or with no local refinement.
+   */
+  MGTransferMatrixFree ();
+
+  /**
+   * Constructor with constraints. Equivalent to the default constructor
+   * followed by initialize_constraints().
+   */
+  MGTransferMatrixFree (const MGConstrainedDoFs &mg_constrained_dofs);
+
+  /**
+   * Destructor.
+   */
+  virtual ~MGTransferMatrixFree ();
+
+  /**
+   * Initialize the constraints to be used in build().
+   */
+  void initialize_constraints (const MGConstrainedDoFs &mg_constrained_dofs);
+
+  /**
+   * Reset the object to the state it had right after the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Extract the indices of the parent and child cells on all levels and
+   * set up the one-dimensional embedding matrices and the ghosted vectors
+   * needed for the transfer.
+   */
+  void build (const DoFHandler<dim,dim> &mg_dof);
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> using the embedding matrices of the underlying finite
+   * element. The previous content of <tt>dst</tt> is overwritten.
+   */
+  virtual void prolongate (const unsigned int                           to_level,
+                           parallel::distributed::Vector<Number>       &dst,
+                           const parallel::distributed::Vector<Number> &src) const;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> using the transpose operation of the prolongate()
+   * method and add the result to <tt>dst</tt>.
+   */
+  virtual void restrict_and_add (const unsigned int                           from_level,
+                                 parallel::distributed::Vector<Number>       &dst,
+                                 const parallel::distributed::Vector<Number> &src) const;
+
+  /**
+   * Transfer from a vector on the global grid to vectors defined on each of
+   * the levels separately, i.a. an @p MGVector.
+   */
+  template <typename Number2>
+  void
+  copy_to_mg (const DoFHandler<dim,dim>                            &mg_dof,
+              MGLevelObject<parallel::distributed::Vector<Number> > &dst,
+              const parallel::distributed::Vector<Number2>          &src) const;
+
+  /**
+   * Transfer from multi-level vector to normal vector.
+   *
+   * Copies data from active portions of an MGVector into the respective
+   * positions of a global vector.
+   */
+  template <typename Number2>
+  void
+  copy_from_mg (const DoFHandler<dim,dim>                                  &mg_dof,
+                parallel::distributed::Vector<Number2>                     &dst,
+                const MGLevelObject<parallel::distributed::Vector<Number> > &src) const;
+
+  /**
+   * Add a multi-level vector to a normal vector.
+   *
+   * Works as the previous function, but probably not for continuous elements.
+   */
+  template <typename Number2>
+  void
+  copy_from_mg_add (const DoFHandler<dim,dim>                                  &mg_dof,
+                    parallel::distributed::Vector<Number2>                     &dst,
+                    const MGLevelObject<parallel::distributed::Vector<Number> > &src) const;
+
+  /**
+   * Finite element is not supported by this class.
+   */
+  DeclException1(ExcElementNotSupported,
+                 std::string,
+                 << "The finite element " << arg1 << " is not supported by "
+                 << "MGTransferMatrixFree. Only FE_Q and FE_DGQ elements of "
+                 << "degree up to eight and systems thereof are implemented.");
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+
+  /**
+   * Performs the prolongation operation for the given polynomial degree
+   * and number of one-dimensional degrees of freedom on the children.
+   */
+  template <int degree, int n_child_dofs_1d>
+  void do_prolongate_add (const unsigned int                           to_level,
+                          parallel::distributed::Vector<Number>       &dst,
+                          const parallel::distributed::Vector<Number> &src) const;
+
+  /**
+   * Performs the restriction operation for the given polynomial degree and
+   * number of one-dimensional degrees of freedom on the children.
+   */
+  template <int degree, int n_child_dofs_1d>
+  void do_restrict_add (const unsigned int                           from_level,
+                        parallel::distributed::Vector<Number>       &dst,
+                        const parallel::distributed::Vector<Number> &src) const;
+
+  /**
+   * Calls do_prolongate_add() or do_restrict_add() with the template
+   * arguments matching the element.
+   */
+  void dispatch (const bool                                    prolongate,
+                 const unsigned int                            level,
+                 parallel::distributed::Vector<Number>       &dst,
+                 const parallel::distributed::Vector<Number> &src) const;
+
+  /**
+   * The polynomial degree of the finite element.
+   */
+  unsigned int fe_degree;
+
+  /**
+   * Whether the element is continuous, i.e., whether degrees of freedom are
+   * shared between the children of a cell.
+   */
+  bool element_is_continuous;
+
+  /**
+   * The number of vector components of the finite element.
+   */
+  unsigned int n_components;
+
+  /**
+   * The number of degrees of freedom per direction on the patch of children
+   * of a parent cell, i.e., 2*fe_degree+1 for continuous and 2*fe_degree+2
+   * for discontinuous elements.
+   */
+  unsigned int n_child_dofs_1d;
+
+  /**
+   * The one-dimensional embedding matrix from the parent cell to the two
+   * children, stored with the parent degrees of freedom running slowest.
+   */
+  AlignedVector<VectorizedArray<Number> > prolongation_matrix_1d;
+
+  /**
+   * For each level, the number of refined parent cells the current
+   * processor works on, i.e., the ones whose first child is owned by the
+   * current processor on the next finer level.
+   */
+  std::vector<unsigned int> n_parent_cells;
+
+  /**
+   * For each level, the local indices of the degrees of freedom of the
+   * parent cells within the ghosted level vector, in lexicographic order
+   * with the components running slowest. Degrees of freedom that are
+   * constrained on the boundary are marked as numbers::invalid_unsigned_int.
+   */
+  std::vector<std::vector<unsigned int> > parent_dof_indices;
+
+  /**
+   * For each level, the local indices of the degrees of freedom on the
+   * children of the parent cells on the next coarser level within the
+   * ghosted vector of the current level, in lexicographic order on the
+   * patch of children.
+   */
+  std::vector<std::vector<unsigned int> > child_dof_indices;
+
+  /**
+   * For continuous elements, the inverse of the number of parent cells
+   * that share a degree of freedom on the next finer level.
+   */
+  MGLevelObject<parallel::distributed::Vector<Number> > weights_on_refined;
+
+  /**
+   * The layout of the ghosted level vectors used during the transfer.
+   */
+  std::vector<std_cxx11::shared_ptr<const Utilities::MPI::Partitioner> > vector_partitioners;
+
+  /**
+   * Ghosted vectors used for the cell-wise access during the transfer.
+   */
+  mutable MGLevelObject<parallel::distributed::Vector<Number> > ghosted_level_vector;
+
+  /**
+   * Mapping for the copy_to_mg() and copy_from_mg() functions. Here only
+   * index pairs locally owned.
+   */
+  std::vector<std::vector<std::pair<types::global_dof_index, types::global_dof_index> > >
+  copy_indices;
+
+  /**
+   * Additional degrees of freedom for the copy_to_mg() function. These are
+   * the ones where the global degree of freedom is locally owned and the
+   * level degree of freedom is not.
+   */
+  std::vector<std::vector<std::pair<types::global_dof_index, types::global_dof_index> > >
+  copy_indices_global_mine;
+
+  /**
+   * Additional degrees of freedom for the copy_from_mg() function. These
+   * are the ones where the level degree of freedom is locally owned and the
+   * global degree of freedom is not.
+   */
+  std::vector<std::vector<std::pair<types::global_dof_index, types::global_dof_index> > >
+  copy_indices_level_mine;
+
+  /**
+   * The mg_constrained_dofs of the level systems.
+   */
+  SmartPointer<const MGConstrainedDoFs, MGTransferMatrixFree<dim,Number> > mg_constrained_dofs;
+};
+
+
+/*@}*/
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -35,6 +35,8 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/std_cxx11/shared_ptr.h>
 #include <deal.II/base/mpi.h>
@@ -243,11 +245,62 @@ namespace
       }
   }
 
+  /**
+   * The size in bytes of the blocks into
+   * which write_compressed_block() splits
+   * its data. Blocks are compressed
+   * independently of each other, which
+   * allows to do so in parallel. Data
+   * that fits into one block results in
+   * exactly the same output as if it
+   * had been compressed in one piece.
+   */
+  const std::size_t vtu_compression_block_size = 1048576;
+
+
+  /**
+   * Compress the blocks with numbers
+   * in the half open range [begin,end)
+   * of the given data into the
+   * respective elements of
+   * compressed_blocks.
+   */
+  void compress_blocks (const unsigned int               begin,
+                        const unsigned int               end,
+                        const char                      *data,
+                        const std::size_t                data_size,
+                        const int                        compression_level,
+                        std::vector<std::vector<char> > &compressed_blocks)
+  {
+    for (unsigned int block=begin; block<end; ++block)
+      {
+        const std::size_t offset = block * vtu_compression_block_size;
+        const std::size_t size = std::min (vtu_compression_block_size,
+                                           data_size - offset);
+        uLongf compressed_data_length = compressBound (size);
+        compressed_blocks[block].resize (compressed_data_length);
+        int err = compress2 ((Bytef *) &compressed_blocks[block][0],
+                             &compressed_data_length,
+                             (const Bytef *) (data + offset),
+                             size,
+                             compression_level);
+        (void)err;
+        Assert (err == Z_OK, ExcInternalError());
+        compressed_blocks[block].resize (compressed_data_length);
+      }
+  }
+
+
   /**
    * Do a zlib compression followed
    * by a base64 encoding of the
    * given data. The result is then
    * written to the given stream.
+   *
+   * Large arrays are split into blocks
+   * of size vtu_compression_block_size
+   * that are compressed in parallel, as
+   * allowed by the VTK format.
    */
   template <typename T>
   void write_compressed_block (const std::vector<T>        &data,
@@ -256,37 +309,68 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing
-        // data and do so
-        uLongf compressed_data_length
-          = compressBound (data.size() * sizeof(T));
-        char *compressed_data = new char[compressed_data_length];
-        int err = compress2 ((Bytef *) compressed_data,
-                             &compressed_data_length,
-                             (const Bytef *) &data[0],
-                             data.size() * sizeof(T),
-                             get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert (err == Z_OK, ExcInternalError());
-
-        // now encode the compression header
-        const uint32_t compression_header[4]
-          = { 1,                                   /* number of blocks */
-              (uint32_t)(data.size() * sizeof(T)), /* size of block */
-              (uint32_t)(data.size() * sizeof(T)), /* size of last block */
-              (uint32_t)compressed_data_length
-            }; /* list of compressed sizes of blocks */
+        const std::size_t data_size = data.size() * sizeof(T);
+        const unsigned int n_blocks
+          = (data_size + vtu_compression_block_size - 1) /
+            vtu_compression_block_size;
+
+        // compress the blocks in
+        // parallel
+        std::vector<std::vector<char> > compressed_blocks (n_blocks);
+        parallel::apply_to_subranges (0U, n_blocks,
+                                      std_cxx11::bind (&compress_blocks,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       (const char *) &data[0],
+                                                       data_size,
+                                                       get_zlib_compression_level(flags.compression_level),
+                                                       std_cxx11::ref(compressed_blocks)),
+                                      1);
+
+        // now encode the compression
+        // header, consisting of the
+        // number of blocks, the size of
+        // a block, the size of the last
+        // block and the list of
+        // compressed sizes of blocks
+        std::vector<uint32_t> compression_header (3 + n_blocks);
+        compression_header[0] = n_blocks;
+        compression_header[1] = (n_blocks > 1 ?
+                                 vtu_compression_block_size : data_size);
+        compression_header[2] = data_size - (n_blocks-1) * vtu_compression_block_size;
+        std::size_t compressed_data_length = 0;
+        for (unsigned int block=0; block<n_blocks; ++block)
+          {
+            compression_header[3+block] = compressed_blocks[block].size();
+            compressed_data_length += compressed_blocks[block].size();
+          }
 
         char *encoded_header = encode_block ((char *)&compression_header[0],
-                                             4 * sizeof(compression_header[0]));
+                                             compression_header.size() *
+                                             sizeof(compression_header[0]));
         output_stream << encoded_header;
         delete[] encoded_header;
 
         // next do the compressed
-        // data encoding in base64
-        char *encoded_data = encode_block (compressed_data,
+        // data encoding in base64. the
+        // blocks are encoded as one
+        // contiguous stream
+        std::vector<char> compressed_data;
+        if (n_blocks == 1)
+          compressed_data.swap (compressed_blocks[0]);
+        else
+          {
+            compressed_data.reserve (compressed_data_length);
+            for (unsigned int block=0; block<n_blocks; ++block)
+              {
+                compressed_data.insert (compressed_data.end(),
+                                        compressed_blocks[block].begin(),
+                                        compressed_blocks[block].end());
+                std::vector<char>().swap (compressed_blocks[block]);
+              }
+          }
+        char *encoded_data = encode_block (&compressed_data[0],
                                            compressed_data_length);
-        delete[] compressed_data;
 
         output_stream << encoded_data;
         delete[] encoded_data;
@@ -5994,6 +6078,136 @@ namespace DataOutBase
 
     return std::make_pair (dim, spacedim);
   }
+
+
+
+  namespace
+  {
+    /**
+     * Open the given file and let the function write into it. This is the
+     * function run on the tasks of BackgroundWriter. An exception that
+     * escaped from a task would terminate the program, so exceptions are
+     * caught here and their message is stored in @p error for the thread
+     * that waits for the task.
+     */
+    void
+    write_file_in_background (const std_cxx11::function<void (std::ostream &)> &write_function,
+                              const std::string &filename,
+                              std::string       *error)
+    {
+      try
+        {
+          std::ofstream out (filename.c_str());
+          AssertThrow (out, ExcFileNotOpen(filename.c_str()));
+          write_function (out);
+          out.flush ();
+          AssertThrow (out, ExcIO());
+        }
+      catch (const std::exception &exc)
+        {
+          *error = exc.what();
+        }
+      catch (...)
+        {
+          *error = "Unknown exception";
+        }
+    }
+  }
+
+
+
+  BackgroundWriter::BackgroundWriter (const std::size_t memory_budget)
+    :
+    memory_budget (memory_budget),
+    current_memory (0)
+  {}
+
+
+
+  BackgroundWriter::~BackgroundWriter ()
+  {
+    // wait for all jobs, but do not throw exceptions from the destructor
+    while (jobs.size() > 0)
+      wait_for_oldest_job ();
+  }
+
+
+
+  void
+  BackgroundWriter::submit (const std_cxx11::function<void (std::ostream &)> &write_function,
+                            const std::string &filename,
+                            const std::size_t  memory)
+  {
+    // make room for the new job by waiting for the oldest ones
+    while (jobs.size() > 0 && current_memory + memory > memory_budget)
+      {
+        const std::string error = wait_for_oldest_job ();
+        AssertThrow (error.empty(),
+                     ExcMessage ("Writing a file in the background failed: " +
+                                 error));
+      }
+
+    // bind the arguments by value: Threads::new_task() would only store
+    // references to them, but they go out of scope once we return
+    Job job;
+    job.memory = memory;
+    job.error.reset (new std::string());
+    const std_cxx11::function<void ()> write_job
+      = std_cxx11::bind (&write_file_in_background, write_function, filename,
+                         job.error.get());
+    job.task = Threads::new_task (write_job);
+
+    current_memory += memory;
+    jobs.push_back (job);
+  }
+
+
+
+  void
+  BackgroundWriter::wait ()
+  {
+    // wait for all jobs before throwing, such that no job is left behind
+    std::string error;
+    while (jobs.size() > 0)
+      {
+        const std::string job_error = wait_for_oldest_job ();
+        if (error.empty())
+          error = job_error;
+      }
+    AssertThrow (error.empty(),
+                 ExcMessage ("Writing a file in the background failed: " +
+                             error));
+  }
+
+
+
+  unsigned int
+  BackgroundWriter::n_pending_jobs () const
+  {
+    return jobs.size();
+  }
+
+
+
+  std::size_t
+  BackgroundWriter::memory_in_flight () const
+  {
+    return current_memory;
+  }
+
+
+
+  std::string
+  BackgroundWriter::wait_for_oldest_job ()
+  {
+    Assert (jobs.size() > 0, ExcInternalError());
+
+    const Job job = jobs.front();
+    jobs.pop_front ();
+    current_memory -= job.memory;
+    job.task.join ();
+    return *job.error;
+  }
 } // namespace DataOutBase
 
 
@@ -6111,6 +6325,57 @@ void DataOutInterface<dim,spacedim>::write_vtu (std::ostream &out) const
                           vtk_flags, out);
 }
 
+namespace
+{
+  /**
+   * A copy of all the data needed to write a vtu file, to be used by
+   * DataOutInterface::write_vtu_in_background().
+   */
+  template <int dim, int spacedim>
+  struct VtuJobData
+  {
+    std::vector<DataOutBase::Patch<dim,spacedim> > patches;
+    std::vector<std::string> data_names;
+    std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > vector_data_ranges;
+    DataOutBase::VtkFlags flags;
+  };
+
+
+  template <int dim, int spacedim>
+  void
+  write_vtu_job (const std_cxx11::shared_ptr<const VtuJobData<dim,spacedim> > &data,
+                 std::ostream                                               &out)
+  {
+    DataOutBase::write_vtu (data->patches, data->data_names,
+                            data->vector_data_ranges,
+                            data->flags, out);
+  }
+}
+
+
+template <int dim, int spacedim>
+void
+DataOutInterface<dim,spacedim>::
+write_vtu_in_background (const std::string             &filename,
+                         DataOutBase::BackgroundWriter &writer) const
+{
+  std_cxx11::shared_ptr<VtuJobData<dim,spacedim> >
+  data (new VtuJobData<dim,spacedim>());
+  data->patches = get_patches();
+  data->data_names = get_dataset_names();
+  data->vector_data_ranges = get_vector_data_ranges();
+  data->flags = vtk_flags;
+
+  const std::size_t memory = MemoryConsumption::memory_consumption (data->patches) +
+                             MemoryConsumption::memory_consumption (data->data_names);
+
+  writer.submit (std_cxx11::bind (&write_vtu_job<dim,spacedim>,
+                                  std_cxx11::shared_ptr<const VtuJobData<dim,spacedim> >(data),
+                                  std_cxx11::_1),
+                 filename, memory);
+}
+
+
 template <int dim, int spacedim>
 void DataOutInterface<dim,spacedim>::write_svg (std::ostream &out) const
 {
@@ -15,7 +15,6 @@
 
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/index_set.h>
-#include <list>
 
 #ifdef DEAL_II_WITH_TRILINOS
 #  ifdef DEAL_II_WITH_MPI
@@ -28,6 +27,55 @@
 DEAL_II_NAMESPACE_OPEN
 
 
+const unsigned int IndexSet::bits_per_word;
+const unsigned int IndexSet::words_per_block;
+const unsigned int IndexSet::min_ranges_per_bitmap_block;
+
+
+namespace
+{
+  /**
+   * Set the bits of the given bitmap, which represents the indices starting
+   * at @p first_index, for all indices in the given ranges that lie within
+   * the bitmap. Full words are set at once.
+   */
+  template <typename RangeIterator>
+  void
+  set_bits (const RangeIterator            &ranges_begin,
+            const RangeIterator            &ranges_end,
+            const types::global_dof_index   first_index,
+            unsigned long long int         *words,
+            const std::size_t               n_words)
+  {
+    const types::global_dof_index last_index = first_index + 64*n_words;
+    for (RangeIterator r=ranges_begin; r!=ranges_end; ++r)
+      {
+        if (r->end <= first_index)
+          continue;
+        if (r->begin >= last_index)
+          break;
+
+        const types::global_dof_index begin = std::max (r->begin, first_index) - first_index;
+        const types::global_dof_index end   = std::min (r->end, last_index) - first_index;
+        const std::size_t first_word = begin / 64, last_word = (end-1) / 64;
+        const unsigned long long int all_bits = ~0ULL;
+        const unsigned long long int
+        first_mask = all_bits << (begin % 64),
+        last_mask  = all_bits >> (63 - (end-1) % 64);
+        if (first_word == last_word)
+          words[first_word] |= (first_mask & last_mask);
+        else
+          {
+            words[first_word] |= first_mask;
+            for (std::size_t w=first_word+1; w<last_word; ++w)
+              words[w] = all_bits;
+            words[last_word] |= last_mask;
+          }
+      }
+  }
+}
+
+
 
 #ifdef DEAL_II_WITH_TRILINOS
 
@@ -167,6 +215,8 @@ IndexSet::do_compress () const
           largest_range = i - ranges.begin();
         }
     }
+
+  compute_bitmap_blocks ();
   is_compressed = true;
 
   // check that next_index is correct. needs to be after the previous
@@ -176,6 +226,160 @@ IndexSet::do_compress () const
 
 
 
+void
+IndexSet::compute_bitmap_blocks () const
+{
+  bitmap_blocks.clear ();
+  if (ranges.size() < min_ranges_per_bitmap_block)
+    return;
+
+  // count the number of ranges that start or end in each block. since the
+  // ranges are sorted and disjoint, the blocks come in ascending order. a
+  // range that spans several blocks only covers the ones in between
+  // completely, so these need not be counted
+  const size_type block_size = bits_per_word * words_per_block;
+  std::vector<std::pair<size_type,unsigned int> > ranges_per_block;
+  for (std::vector<Range>::const_iterator r = ranges.begin();
+       r != ranges.end(); ++r)
+    {
+      const size_type first_block = r->begin / block_size;
+      const size_type last_block  = (r->end - 1) / block_size;
+      for (size_type block = first_block; block <= last_block;
+           block += std::max<size_type> (last_block-first_block, 1))
+        if (ranges_per_block.empty() || ranges_per_block.back().first != block)
+          ranges_per_block.push_back (std::make_pair (block, 1U));
+        else
+          ++ranges_per_block.back().second;
+    }
+
+  // then set up the bitmaps of all blocks that are fragmented enough
+  std::vector<Range>::const_iterator r = ranges.begin();
+  const std::vector<Range>::const_iterator end_range = ranges.end();
+  for (unsigned int b=0; b<ranges_per_block.size(); ++b)
+    if (ranges_per_block[b].second >= min_ranges_per_bitmap_block)
+      {
+        BitmapBlock block;
+        block.first_index = ranges_per_block[b].first * block_size;
+        std::fill (block.words, block.words + words_per_block, 0ULL);
+
+        // find the first range that intersects this block
+        while (r->end <= block.first_index)
+          ++r;
+        block.nth_index_in_set = (r->nth_index_in_set +
+                                  (block.first_index > r->begin ?
+                                   block.first_index - r->begin : 0));
+
+        set_bits (r, end_range, block.first_index,
+                  block.words, words_per_block);
+
+        unsigned int offset = 0;
+        for (unsigned int w=0; w<words_per_block; ++w)
+          {
+            block.word_offsets[w] = offset;
+            offset += internal::IndexSetImplementation::count_bits (block.words[w]);
+          }
+
+        bitmap_blocks.push_back (block);
+      }
+}
+
+
+
+bool
+IndexSet::combine_as_bitmaps (const IndexSet        &other,
+                              const BitmapOperation  operation,
+                              std::vector<Range>    &result) const
+{
+  Assert (is_compressed && other.is_compressed, ExcInternalError());
+  if (ranges.empty() || other.ranges.empty())
+    return false;
+
+  // determine the indices the result can contain
+  size_type first_index = 0, last_index = 0;
+  switch (operation)
+    {
+    case bitmap_union:
+      first_index = std::min (ranges.front().begin, other.ranges.front().begin);
+      last_index  = std::max (ranges.back().end, other.ranges.back().end);
+      break;
+    case bitmap_intersection:
+      first_index = std::max (ranges.front().begin, other.ranges.front().begin);
+      last_index  = std::min (ranges.back().end, other.ranges.back().end);
+      break;
+    case bitmap_difference:
+      first_index = ranges.front().begin;
+      last_index  = ranges.back().end;
+      break;
+    default:
+      Assert (false, ExcNotImplemented());
+    }
+  if (first_index >= last_index)
+    return false;
+
+  // only use bitmaps if they are shorter than the lists of ranges
+  first_index -= first_index % bits_per_word;
+  const std::size_t n_words = (last_index - first_index + bits_per_word - 1) /
+                              bits_per_word;
+  if (n_words > ranges.size() + other.ranges.size())
+    return false;
+
+  std::vector<unsigned long long int> words (n_words, 0ULL),
+      other_words (n_words, 0ULL);
+  set_bits (ranges.begin(), ranges.end(), first_index,
+            &words[0], n_words);
+  set_bits (other.ranges.begin(), other.ranges.end(), first_index,
+            &other_words[0], n_words);
+
+  // combine the words. these loops contain no branches and can be
+  // vectorized by the compiler
+  switch (operation)
+    {
+    case bitmap_union:
+      for (std::size_t w=0; w<n_words; ++w)
+        words[w] |= other_words[w];
+      break;
+    case bitmap_intersection:
+      for (std::size_t w=0; w<n_words; ++w)
+        words[w] &= other_words[w];
+      break;
+    case bitmap_difference:
+      for (std::size_t w=0; w<n_words; ++w)
+        words[w] &= ~other_words[w];
+      break;
+    default:
+      Assert (false, ExcNotImplemented());
+    }
+
+  // convert the bitmap back into ranges, skipping words that are entirely
+  // inside or outside of a range
+  result.clear ();
+  bool in_range = false;
+  size_type range_begin = 0;
+  for (std::size_t w=0; w<n_words; ++w)
+    {
+      if ((in_range == false && words[w] == 0ULL) ||
+          (in_range == true && words[w] == ~0ULL))
+        continue;
+
+      for (unsigned int bit=0; bit<bits_per_word; ++bit)
+        if (((words[w] >> bit) & 1ULL) != static_cast<unsigned long long int>(in_range))
+          {
+            const size_type index = first_index + w*bits_per_word + bit;
+            if (in_range)
+              result.push_back (Range (range_begin, index));
+            else
+              range_begin = index;
+            in_range = !in_range;
+          }
+    }
+  if (in_range)
+    result.push_back (Range (range_begin, first_index + n_words*bits_per_word));
+
+  return true;
+}
+
+
+
 IndexSet
 IndexSet::operator & (const IndexSet &is) const
 {
@@ -185,9 +389,16 @@ IndexSet::operator & (const IndexSet &is) const
   compress ();
   is.compress ();
 
+  IndexSet result (size());
+  if (combine_as_bitmaps (is, bitmap_intersection, result.ranges))
+    {
+      result.is_compressed = false;
+      result.compress ();
+      return result;
+    }
+
   std::vector<Range>::const_iterator r1 = ranges.begin(),
                                      r2 = is.ranges.begin();
-  IndexSet result (size());
 
   while ((r1 != ranges.end())
          &&
@@ -270,71 +481,41 @@ IndexSet::subtract_set (const IndexSet &other)
 {
   compress();
   other.compress();
-  is_compressed = false;
 
-
-  // we save new ranges to be added to our IndexSet in an temporary list and
-  // add all of them in one go at the end. This is necessary because a growing
-  // ranges vector invalidates iterators.
-  std::list<Range> temp_list;
-
-  std::vector<Range>::iterator own_it = ranges.begin();
-  std::vector<Range>::iterator other_it = other.ranges.begin();
-
-  while (own_it != ranges.end() && other_it != other.ranges.end())
+  std::vector<Range> new_ranges;
+  if (combine_as_bitmaps (other, bitmap_difference, new_ranges) == false)
     {
-      //advance own iterator until we get an overlap
-      if (own_it->end <= other_it->begin)
-        {
-          ++own_it;
-          continue;
-        }
-      //we are done with other_it, so advance
-      if (own_it->begin >= other_it->end)
-        {
-          ++other_it;
-          continue;
-        }
-
-      //Now own_it and other_it overlap.  First save the part of own_it that
-      //is before other_it (if not empty).
-      if (own_it->begin < other_it->begin)
-        {
-          Range r(own_it->begin, other_it->begin);
-          r.nth_index_in_set = 0; //fix warning of unused variable
-          temp_list.push_back(r);
-        }
-      // change own_it to the sub range behind other_it. Do not delete own_it
-      // in any case. As removal would invalidate iterators, we just shrink
-      // the range to an empty one.
-      own_it->begin = other_it->end;
-      if (own_it->begin > own_it->end)
+      // go through our ranges and cut out the parts covered by ranges of the
+      // other set. the iterator into the other set is only advanced past
+      // ranges that end before the current range of ours starts, since a
+      // range of the other set may overlap several of ours
+      std::vector<Range>::const_iterator other_it = other.ranges.begin();
+      for (std::vector<Range>::const_iterator own_it = ranges.begin();
+           own_it != ranges.end(); ++own_it)
         {
-          own_it->begin = own_it->end;
-          ++own_it;
+          size_type begin = own_it->begin;
+          const size_type end = own_it->end;
+
+          while (other_it != other.ranges.end() && other_it->end <= begin)
+            ++other_it;
+
+          for (std::vector<Range>::const_iterator p = other_it;
+               p != other.ranges.end() && p->begin < end; ++p)
+            {
+              if (p->begin > begin)
+                new_ranges.push_back (Range (begin, p->begin));
+              begin = std::max (begin, p->end);
+              if (begin >= end)
+                break;
+            }
+
+          if (begin < end)
+            new_ranges.push_back (Range (begin, end));
         }
-
-      // continue without advancing iterators, the right one will be advanced
-      // next.
     }
 
-  // Now delete all empty ranges we might
-  // have created.
-  for (std::vector<Range>::iterator it = ranges.begin();
-       it != ranges.end(); )
-    {
-      if (it->begin >= it->end)
-        it = ranges.erase(it);
-      else
-        ++it;
-    }
-
-  // done, now add the temporary ranges
-  for (std::list<Range>::iterator it = temp_list.begin();
-       it != temp_list.end();
-       ++it)
-    add_range(it->begin, it->end);
-
+  ranges.swap (new_ranges);
+  is_compressed = false;
   compress();
 }
 
@@ -350,10 +531,18 @@ IndexSet::add_indices(const IndexSet &other,
   compress();
   other.compress();
 
+  std::vector<Range> new_ranges;
+  if (offset == 0 && combine_as_bitmaps (other, bitmap_union, new_ranges))
+    {
+      ranges.swap(new_ranges);
+      is_compressed = false;
+      compress();
+      return;
+    }
+
   std::vector<Range>::const_iterator r1 = ranges.begin(),
                                      r2 = other.ranges.begin();
 
-  std::vector<Range> new_ranges;
   // just get the start and end of the ranges right in this method, everything
   // else will be done in compress()
   while (r1 != ranges.end() || r2 != other.ranges.end())
@@ -412,7 +601,7 @@ IndexSet::read(std::istream &in)
   unsigned int numranges;
 
   in >> s >> numranges;
-  ranges.clear();
+  clear();
   set_size(s);
   for (unsigned int i=0; i<numranges; ++i)
     {
@@ -446,7 +635,7 @@ IndexSet::block_read(std::istream &in)
   in.read(reinterpret_cast<char *>(&size), sizeof(size));
   in.read(reinterpret_cast<char *>(&n_ranges), sizeof(n_ranges));
   // we have to clear ranges first
-  ranges.clear();
+  clear();
   set_size(size);
   ranges.resize(n_ranges, Range(0,0));
   if (n_ranges)
@@ -549,6 +738,7 @@ std::size_t
 IndexSet::memory_consumption () const
 {
   return (MemoryConsumption::memory_consumption (ranges) +
+          bitmap_blocks.capacity() * sizeof(BitmapBlock) +
           MemoryConsumption::memory_consumption (is_compressed) +
           MemoryConsumption::memory_consumption (index_space_size));
 }
@@ -14,6 +14,9 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/partitioner.h>
+#include <deal.II/base/thread_management.h>
+
+#include <algorithm>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -21,6 +24,152 @@ namespace Utilities
 {
   namespace MPI
   {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+    namespace
+    {
+      /**
+       * An entry in the list of communicators created by partitioners. Along
+       * with the communicator, we keep the group of the communicator it was
+       * derived from, since all processes in that group created the
+       * communicator together and must also free it together.
+       */
+      struct CommunicatorEntry
+      {
+        MPI_Comm  comm;
+        MPI_Group parent_group;
+        bool      released;
+      };
+
+      /**
+       * The communicators created by partitioners that have not been freed
+       * yet, in the order of their creation.
+       */
+      struct CommunicatorList
+      {
+        std::vector<CommunicatorEntry> entries;
+        Threads::Mutex                 mutex;
+      };
+
+      /**
+       * Returns the list of communicators. The object is intentionally never
+       * destroyed, such that partitioners destroyed during the destruction
+       * of static objects at the end of the program can still access it.
+       */
+      CommunicatorList &get_communicator_list ()
+      {
+        static CommunicatorList *list = new CommunicatorList();
+        return *list;
+      }
+
+
+
+      /**
+       * Adds a communicator derived from @p parent to the list above.
+       */
+      void register_communicator (const MPI_Comm comm,
+                                  const MPI_Comm parent)
+      {
+        CommunicatorEntry entry;
+        entry.comm = comm;
+        const int ierr = MPI_Comm_group (parent, &entry.parent_group);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        entry.released = false;
+
+        CommunicatorList &list = get_communicator_list();
+        Threads::Mutex::ScopedLock lock (list.mutex);
+        list.entries.push_back (entry);
+      }
+
+
+
+      /**
+       * Deleter for the communicators created by the partitioner. Since
+       * MPI_Comm_free() is collective and the last copy of a partitioner
+       * can go away at different times on different processes, the
+       * communicator is not freed here but only marked as no longer in
+       * use. It is freed by free_released_communicators() at a point all
+       * processes reach together.
+       */
+      void release_communicator (MPI_Comm *comm)
+      {
+        {
+          CommunicatorList &list = get_communicator_list();
+          Threads::Mutex::ScopedLock lock (list.mutex);
+          for (unsigned int i=0; i<list.entries.size(); ++i)
+            if (list.entries[i].comm == *comm)
+              {
+                list.entries[i].released = true;
+                break;
+              }
+        }
+        delete comm;
+      }
+
+
+
+      /**
+       * Frees the communicators that were derived from a communicator with
+       * the same group as @p comm and that have been released on all
+       * processes of @p comm. This function is collective on @p comm.
+       *
+       * Since all processes of the group create these communicators in the
+       * same order, the sublists of matching entries agree among the
+       * processes. As a safeguard, nothing is freed if their lengths differ.
+       */
+      void free_released_communicators (const MPI_Comm comm)
+      {
+        MPI_Group group;
+        int ierr = MPI_Comm_group (comm, &group);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+
+        CommunicatorList &list = get_communicator_list();
+        Threads::Mutex::ScopedLock lock (list.mutex);
+        std::vector<unsigned int> matching_entries;
+        for (unsigned int i=0; i<list.entries.size(); ++i)
+          {
+            int result = MPI_UNEQUAL;
+            ierr = MPI_Group_compare (group, list.entries[i].parent_group,
+                                      &result);
+            AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+            if (result == MPI_IDENT)
+              matching_entries.push_back (i);
+          }
+        ierr = MPI_Group_free (&group);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+
+        const unsigned int n_entries = matching_entries.size();
+        if (Utilities::MPI::min (n_entries, comm) !=
+            Utilities::MPI::max (n_entries, comm) ||
+            n_entries == 0)
+          return;
+
+        std::vector<int> released (n_entries), released_everywhere (n_entries);
+        for (unsigned int i=0; i<n_entries; ++i)
+          released[i] = list.entries[matching_entries[i]].released;
+        ierr = MPI_Allreduce (&released[0], &released_everywhere[0], n_entries,
+                              MPI_INT, MPI_MIN, comm);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+
+        // free the communicators in the order of their creation, and go
+        // backward through the list when erasing entries
+        for (unsigned int i=0; i<n_entries; ++i)
+          if (released_everywhere[i] == 1)
+            {
+              CommunicatorEntry &entry = list.entries[matching_entries[i]];
+              ierr = MPI_Comm_free (&entry.comm);
+              AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+              ierr = MPI_Group_free (&entry.parent_group);
+              AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+            }
+        for (int i=n_entries-1; i>=0; --i)
+          if (released_everywhere[i] == 1)
+            list.entries.erase (list.entries.begin() + matching_entries[i]);
+      }
+    }
+#endif
+
+
+
     Partitioner::Partitioner ()
       :
       global_size (0),
@@ -140,6 +289,19 @@ namespace Utilities
       ghost_indices_data.compress();
       n_ghost_indices_data = ghost_indices_data.n_elements();
 
+      // the communication pattern changes, so forget about the
+      // communicators set up for the previous one
+      neighborhood_communicator.reset ();
+      shared_memory_communicator.reset ();
+      neighborhood_ghost_counts_data.clear ();
+      neighborhood_ghost_offsets_data.clear ();
+      neighborhood_import_counts_data.clear ();
+      neighborhood_import_offsets_data.clear ();
+      ghost_targets_shared_memory_rank_data.clear ();
+      import_targets_shared_memory_rank_data.clear ();
+      shared_memory_ghost_indices_data.clear ();
+      shared_memory_import_offsets_data.clear ();
+
       have_ghost_indices =
         Utilities::MPI::sum(n_ghost_indices_data, communicator) > 0;
 
@@ -333,6 +495,221 @@ namespace Utilities
 
 
 
+    void
+    Partitioner::initialize_neighborhood_communicator ()
+    {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (n_procs < 2 || has_neighborhood_communicator())
+        return;
+
+      // the neighbors are all processes we send data to or receive data
+      // from. use the same list for both directions, such that compress()
+      // can use the communicator with the roles of ghosts and imports
+      // swapped
+      std::vector<int> neighbors;
+      for (unsigned int i=0; i<ghost_targets_data.size(); ++i)
+        neighbors.push_back (ghost_targets_data[i].first);
+      for (unsigned int i=0; i<import_targets_data.size(); ++i)
+        neighbors.push_back (import_targets_data[i].first);
+      std::sort (neighbors.begin(), neighbors.end());
+      neighbors.erase (std::unique (neighbors.begin(), neighbors.end()),
+                       neighbors.end());
+
+      free_released_communicators (communicator);
+
+      int dummy = 0;
+      int *neighbor_list = neighbors.empty() ? &dummy : &neighbors[0];
+      MPI_Comm *graph_comm = new MPI_Comm (MPI_COMM_NULL);
+      const int ierr = MPI_Dist_graph_create_adjacent (communicator,
+                                                       neighbors.size(),
+                                                       neighbor_list,
+                                                       MPI_UNWEIGHTED,
+                                                       neighbors.size(),
+                                                       neighbor_list,
+                                                       MPI_UNWEIGHTED,
+                                                       MPI_INFO_NULL, 0,
+                                                       graph_comm);
+      AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+      register_communicator (*graph_comm, communicator);
+      neighborhood_communicator.reset (graph_comm, &release_communicator);
+
+      compute_neighborhood_counts ();
+#endif
+    }
+
+
+
+    void
+    Partitioner::compute_neighborhood_counts ()
+    {
+      if (has_neighborhood_communicator() == false)
+        return;
+
+      // walk through the (sorted) lists of ghost and import targets in
+      // parallel to the sorted list of neighbors. processes on the same
+      // node get a zero count if their data is exchanged through shared
+      // memory
+      std::vector<unsigned int> neighbors;
+      for (unsigned int i=0; i<ghost_targets_data.size(); ++i)
+        neighbors.push_back (ghost_targets_data[i].first);
+      for (unsigned int i=0; i<import_targets_data.size(); ++i)
+        neighbors.push_back (import_targets_data[i].first);
+      std::sort (neighbors.begin(), neighbors.end());
+      neighbors.erase (std::unique (neighbors.begin(), neighbors.end()),
+                       neighbors.end());
+
+      const bool use_shared_memory = has_shared_memory_communicator();
+      neighborhood_ghost_counts_data.assign (neighbors.size(), 0);
+      neighborhood_ghost_offsets_data.assign (neighbors.size(), 0);
+      neighborhood_import_counts_data.assign (neighbors.size(), 0);
+      neighborhood_import_offsets_data.assign (neighbors.size(), 0);
+      unsigned int ghost_offset = 0, import_offset = 0;
+      for (unsigned int n=0, g=0, i=0; n<neighbors.size(); ++n)
+        {
+          neighborhood_ghost_offsets_data[n] = ghost_offset;
+          if (g < ghost_targets_data.size() &&
+              ghost_targets_data[g].first == neighbors[n])
+            {
+              if (use_shared_memory == false ||
+                  ghost_targets_shared_memory_rank_data[g] ==
+                  numbers::invalid_unsigned_int)
+                neighborhood_ghost_counts_data[n] = ghost_targets_data[g].second;
+              ghost_offset += ghost_targets_data[g].second;
+              ++g;
+            }
+
+          neighborhood_import_offsets_data[n] = import_offset;
+          if (i < import_targets_data.size() &&
+              import_targets_data[i].first == neighbors[n])
+            {
+              if (use_shared_memory == false ||
+                  import_targets_shared_memory_rank_data[i] ==
+                  numbers::invalid_unsigned_int)
+                neighborhood_import_counts_data[n] = import_targets_data[i].second;
+              import_offset += import_targets_data[i].second;
+              ++i;
+            }
+        }
+      AssertDimension (ghost_offset, n_ghost_indices_data);
+      AssertDimension (import_offset, n_import_indices_data);
+    }
+
+
+
+    void
+    Partitioner::initialize_shared_memory_communicator ()
+    {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (n_procs < 2 || has_shared_memory_communicator())
+        return;
+
+      free_released_communicators (communicator);
+
+      MPI_Comm *node_comm = new MPI_Comm (MPI_COMM_NULL);
+      int ierr = MPI_Comm_split_type (communicator, MPI_COMM_TYPE_SHARED,
+                                      my_pid, MPI_INFO_NULL, node_comm);
+      AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+      register_communicator (*node_comm, communicator);
+      shared_memory_communicator.reset (node_comm, &release_communicator);
+
+      // translate the ranks of all processes to the shared memory
+      // communicator. processes on other nodes get MPI_UNDEFINED
+      std::vector<int> node_ranks (n_procs);
+      {
+        std::vector<int> ranks (n_procs);
+        for (unsigned int p=0; p<n_procs; ++p)
+          ranks[p] = p;
+        MPI_Group group, node_group;
+        MPI_Comm_group (communicator, &group);
+        MPI_Comm_group (*node_comm, &node_group);
+        MPI_Group_translate_ranks (group, n_procs, &ranks[0], node_group,
+                                   &node_ranks[0]);
+        MPI_Group_free (&group);
+        MPI_Group_free (&node_group);
+      }
+
+      ghost_targets_shared_memory_rank_data.resize (ghost_targets_data.size());
+      for (unsigned int i=0; i<ghost_targets_data.size(); ++i)
+        ghost_targets_shared_memory_rank_data[i] =
+          (node_ranks[ghost_targets_data[i].first] == MPI_UNDEFINED ?
+           numbers::invalid_unsigned_int :
+           node_ranks[ghost_targets_data[i].first]);
+      import_targets_shared_memory_rank_data.resize (import_targets_data.size());
+      for (unsigned int i=0; i<import_targets_data.size(); ++i)
+        import_targets_shared_memory_rank_data[i] =
+          (node_ranks[import_targets_data[i].first] == MPI_UNDEFINED ?
+           numbers::invalid_unsigned_int :
+           node_ranks[import_targets_data[i].first]);
+
+      // translate the ghost indices owned by processes on the same node to
+      // the local index space of the owner
+      int n_node_procs = 0;
+      MPI_Comm_size (*node_comm, &n_node_procs);
+      std::vector<types::global_dof_index> node_first_index (n_node_procs);
+      MPI_Allgather (&local_range_data.first, 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                     &node_first_index[0], 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                     *node_comm);
+
+      std::vector<types::global_dof_index> expanded_ghost_indices;
+      ghost_indices_data.fill_index_vector (expanded_ghost_indices);
+      shared_memory_ghost_indices_data.clear ();
+      std::vector<unsigned int> ghost_offsets (ghost_targets_data.size());
+      for (unsigned int i=0, offset=0; i<ghost_targets_data.size(); ++i)
+        {
+          ghost_offsets[i] = local_size() + offset;
+          const unsigned int node_rank = ghost_targets_shared_memory_rank_data[i];
+          if (node_rank != numbers::invalid_unsigned_int)
+            for (unsigned int j=offset; j<offset+ghost_targets_data[i].second; ++j)
+              {
+                const unsigned int index = expanded_ghost_indices[j] -
+                                           node_first_index[node_rank];
+                if (j > offset &&
+                    shared_memory_ghost_indices_data.back().second == index)
+                  ++shared_memory_ghost_indices_data.back().second;
+                else
+                  shared_memory_ghost_indices_data.push_back
+                  (std::pair<unsigned int,unsigned int>(index, index+1));
+              }
+          offset += ghost_targets_data[i].second;
+        }
+
+      // tell the owners on the same node where in our vector their entries
+      // are located, such that they can read our contributions in compress()
+      shared_memory_import_offsets_data.assign (import_targets_data.size(),
+                                                numbers::invalid_unsigned_int);
+      std::vector<MPI_Request> requests;
+      requests.reserve (ghost_targets_data.size() + import_targets_data.size());
+      for (unsigned int i=0; i<import_targets_data.size(); ++i)
+        if (import_targets_shared_memory_rank_data[i] !=
+            numbers::invalid_unsigned_int)
+          {
+            requests.push_back (MPI_Request());
+            MPI_Irecv (&shared_memory_import_offsets_data[i], 1, MPI_UNSIGNED,
+                       import_targets_shared_memory_rank_data[i], 0,
+                       *node_comm, &requests.back());
+          }
+      for (unsigned int i=0; i<ghost_targets_data.size(); ++i)
+        if (ghost_targets_shared_memory_rank_data[i] !=
+            numbers::invalid_unsigned_int)
+          {
+            requests.push_back (MPI_Request());
+            MPI_Isend (&ghost_offsets[i], 1, MPI_UNSIGNED,
+                       ghost_targets_shared_memory_rank_data[i], 0,
+                       *node_comm, &requests.back());
+          }
+      if (requests.size() > 0)
+        {
+          ierr = MPI_Waitall (requests.size(), &requests[0],
+                              MPI_STATUSES_IGNORE);
+          AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        }
+
+      compute_neighborhood_counts ();
+#endif
+    }
+
+
+
     bool
     Partitioner::is_compatible (const Partitioner &part) const
     {
@@ -377,6 +754,14 @@ namespace Utilities
       memory += MemoryConsumption::memory_consumption(import_targets_data);
       memory += MemoryConsumption::memory_consumption(import_indices_data);
       memory += MemoryConsumption::memory_consumption(ghost_indices_data);
+      memory += MemoryConsumption::memory_consumption(neighborhood_ghost_counts_data);
+      memory += MemoryConsumption::memory_consumption(neighborhood_ghost_offsets_data);
+      memory += MemoryConsumption::memory_consumption(neighborhood_import_counts_data);
+      memory += MemoryConsumption::memory_consumption(neighborhood_import_offsets_data);
+      memory += MemoryConsumption::memory_consumption(ghost_targets_shared_memory_rank_data);
+      memory += MemoryConsumption::memory_consumption(import_targets_shared_memory_rank_data);
+      memory += MemoryConsumption::memory_consumption(shared_memory_ghost_indices_data);
+      memory += MemoryConsumption::memory_consumption(shared_memory_import_offsets_data);
       return memory;
     }
 
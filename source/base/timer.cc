@@ -31,6 +31,13 @@
 #  include <windows.h>
 #endif
 
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  include <cstring>
+#endif
+
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -263,6 +270,163 @@ void Timer::reset ()
 
 /* ---------------------------- TimerOutput -------------------------- */
 
+namespace
+{
+  // Return pointers to the objects of all threads that have accessed the
+  // given thread local storage
+  template <typename T>
+  std::vector<T *>
+  get_all_thread_objects (Threads::ThreadLocalStorage<T> &storage)
+  {
+    std::vector<T *> objects;
+#ifdef DEAL_II_WITH_THREADS
+    for (typename tbb::enumerable_thread_specific<T>::iterator
+         it = storage.get_implementation().begin();
+         it != storage.get_implementation().end(); ++it)
+      objects.push_back (&*it);
+#else
+    objects.push_back (&storage.get_implementation());
+#endif
+    return objects;
+  }
+
+
+
+  // Compare two nesting paths of sections such that each section comes
+  // right before the sections nested in it, i.e., compare the names
+  // component by component
+  bool
+  compare_section_paths (const TimerOutput::SectionStatistics &a,
+                         const TimerOutput::SectionStatistics &b)
+  {
+    const std::size_t length = std::min (a.name.size(), b.name.size());
+    for (std::size_t i=0; i<length; ++i)
+      if (a.name[i] != b.name[i])
+        {
+          if (a.name[i] == '/')
+            return true;
+          if (b.name[i] == '/')
+            return false;
+          return a.name[i] < b.name[i];
+        }
+    return a.name.size() < b.name.size();
+  }
+
+
+
+  // Return the given string as a quoted JSON string
+  std::string
+  json_string (const std::string &text)
+  {
+    std::ostringstream result;
+    result << '"';
+    for (std::size_t i=0; i<text.size(); ++i)
+      switch (text[i])
+        {
+        case '"':
+          result << "\\\"";
+          break;
+        case '\\':
+          result << "\\\\";
+          break;
+        case '\n':
+          result << "\\n";
+          break;
+        case '\t':
+          result << "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(text[i]) < 0x20)
+            result << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                   << static_cast<unsigned int>(text[i]) << std::dec
+                   << std::setfill(' ');
+          else
+            result << text[i];
+        }
+    result << '"';
+    return result.str();
+  }
+
+
+
+  // Return the given amount per second in units of 1e9, or zero if no time
+  // has been spent
+  double
+  giga_rate (const double amount,
+             const double time)
+  {
+    return (time > 0. ? amount / time * 1e-9 : 0.);
+  }
+
+
+
+  // Read the current values of the hardware counters with the given file
+  // descriptors. Return false if one of the counters cannot be read.
+  bool
+  read_hardware_counters (const int               *fds,
+                          const unsigned int       n_counters,
+                          unsigned long long int  *values)
+  {
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+    for (unsigned int i=0; i<n_counters; ++i)
+      if (fds[i] < 0 ||
+          read (fds[i], &values[i], sizeof(values[i])) != sizeof(values[i]))
+        return false;
+    return true;
+#else
+    (void)fds;
+    (void)n_counters;
+    (void)values;
+    return false;
+#endif
+  }
+
+
+
+  // Return the given string as a quoted CSV field
+  std::string
+  csv_string (const std::string &text)
+  {
+    std::string result = "\"";
+    for (std::size_t i=0; i<text.size(); ++i)
+      {
+        if (text[i] == '"')
+          result += '"';
+        result += text[i];
+      }
+    result += '"';
+    return result;
+  }
+}
+
+
+
+TimerOutput::SectionData::SectionData ()
+  :
+  n_calls (0),
+  cpu_time (0.),
+  wall_time (0.),
+  summary_cpu_time (0.),
+  summary_wall_time (0.),
+  flops (0.),
+  bytes (0.)
+{
+  for (unsigned int i=0; i<n_hardware_counters; ++i)
+    counters[i] = 0;
+}
+
+
+
+TimerOutput::ThreadData::ThreadData ()
+  :
+  counters_initialized (false)
+{
+  for (unsigned int i=0; i<n_hardware_counters; ++i)
+    counter_fds[i] = -1;
+}
+
+
+
 TimerOutput::TimerOutput (std::ostream &stream,
                           const enum OutputFrequency output_frequency,
                           const enum OutputType output_type)
@@ -270,10 +434,10 @@ TimerOutput::TimerOutput (std::ostream &stream,
   output_frequency (output_frequency),
   output_type (output_type),
   out_stream (stream, true),
-  output_is_enabled (true)
-#ifdef DEAL_II_WITH_MPI
-  , mpi_communicator (MPI_COMM_SELF)
-#endif
+  output_is_enabled (true),
+  mpi_communicator (MPI_COMM_SELF),
+  main_thread_id (Threads::this_thread_id()),
+  use_hardware_counters (false)
 {}
 
 
@@ -285,10 +449,10 @@ TimerOutput::TimerOutput (ConditionalOStream &stream,
   output_frequency (output_frequency),
   output_type (output_type),
   out_stream (stream),
-  output_is_enabled (true)
-#ifdef DEAL_II_WITH_MPI
-  , mpi_communicator (MPI_COMM_SELF)
-#endif
+  output_is_enabled (true),
+  mpi_communicator (MPI_COMM_SELF),
+  main_thread_id (Threads::this_thread_id()),
+  use_hardware_counters (false)
 {}
 
 
@@ -303,7 +467,9 @@ TimerOutput::TimerOutput (MPI_Comm      mpi_communicator,
   output_type (output_type),
   out_stream (stream, true),
   output_is_enabled (true),
-  mpi_communicator (mpi_communicator)
+  mpi_communicator (mpi_communicator),
+  main_thread_id (Threads::this_thread_id()),
+  use_hardware_counters (false)
 {}
 
 
@@ -317,7 +483,9 @@ TimerOutput::TimerOutput (MPI_Comm      mpi_communicator,
   output_type (output_type),
   out_stream (stream),
   output_is_enabled (true),
-  mpi_communicator (mpi_communicator)
+  mpi_communicator (mpi_communicator),
+  main_thread_id (Threads::this_thread_id()),
+  use_hardware_counters (false)
 {}
 
 #endif
@@ -325,56 +493,144 @@ TimerOutput::TimerOutput (MPI_Comm      mpi_communicator,
 
 TimerOutput::~TimerOutput()
 {
-  while (active_sections.size() > 0)
+  while (thread_data.get().active_sections.size() > 0)
     leave_subsection();
 
   if ( (output_frequency == summary || output_frequency == every_call_and_summary)
        && output_is_enabled == true)
     print_summary();
+
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+  const std::vector<ThreadData *> all_data = get_all_thread_objects (thread_data);
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    for (unsigned int i=0; i<n_hardware_counters; ++i)
+      if (all_data[t]->counter_fds[i] >= 0)
+        close (all_data[t]->counter_fds[i]);
+#endif
+}
+
+
+
+bool
+TimerOutput::open_hardware_counters (ThreadData &data)
+{
+  if (data.counters_initialized == false)
+    {
+      data.counters_initialized = true;
+#ifdef DEAL_II_HAVE_LINUX_PERF_EVENT_H
+      const unsigned long long int events[n_hardware_counters]
+        = { PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES
+          };
+      for (unsigned int i=0; i<n_hardware_counters; ++i)
+        {
+          // count the events of the calling thread on any processor, in
+          // user space only
+          struct perf_event_attr attributes;
+          std::memset (&attributes, 0, sizeof(attributes));
+          attributes.type = PERF_TYPE_HARDWARE;
+          attributes.size = sizeof(attributes);
+          attributes.config = events[i];
+          attributes.exclude_kernel = 1;
+          attributes.exclude_hv = 1;
+          data.counter_fds[i] = syscall (__NR_perf_event_open, &attributes,
+                                         0, -1, -1, 0);
+          if (data.counter_fds[i] < 0)
+            {
+              for (unsigned int j=0; j<i; ++j)
+                {
+                  close (data.counter_fds[j]);
+                  data.counter_fds[j] = -1;
+                }
+              break;
+            }
+        }
+#endif
+    }
+  return data.counter_fds[n_hardware_counters-1] >= 0;
 }
 
 
 
 void
-TimerOutput::enter_subsection (const std::string &section_name)
+TimerOutput::enable_hardware_counters ()
 {
-  Threads::Mutex::ScopedLock lock (mutex);
+  use_hardware_counters = true;
+}
 
-  Assert (section_name.empty() == false,
-          ExcMessage ("Section string is empty."));
 
-  Assert (std::find (active_sections.begin(), active_sections.end(),
-                     section_name) == active_sections.end(),
-          ExcMessage (std::string("Cannot enter the already active section <")
-                      + section_name + ">."));
 
-  if (sections.find (section_name) == sections.end())
+bool
+TimerOutput::hardware_counters_available () const
+{
+  return (use_hardware_counters && open_hardware_counters (thread_data.get()));
+}
+
+
+
+void
+TimerOutput::add_work (const double n_flops,
+                       const double n_bytes)
+{
+  ThreadData &data = thread_data.get();
+  Assert (!data.active_sections.empty(),
+          ExcMessage("Cannot add work because no section has been entered!"));
+  for (unsigned int i=0; i<data.active_sections.size(); ++i)
     {
-#ifdef DEAL_II_WITH_MPI
-      if (mpi_communicator != MPI_COMM_SELF)
-        {
-          // create a new timer for this section. the second argument
-          // will ensure that we have an MPI barrier before starting
-          // and stopping a timer, and this ensures that we get the
-          // maximum run time for this section over all processors.
-          // The mpi_communicator from TimerOutput is passed to the
-          // Timer here, so this Timer will collect timing information
-          // among all processes inside mpi_communicator.
-          sections[section_name].timer = Timer(mpi_communicator, true);
-        }
-#endif
+      data.active_sections[i].flops += n_flops;
+      data.active_sections[i].bytes += n_bytes;
+    }
+}
+
+
+
+void
+TimerOutput::enter_subsection (const std::string &section_name)
+{
+  Assert (section_name.empty() == false,
+          ExcMessage ("Section string is empty."));
 
+  // all data is kept separately for each thread, so no lock is necessary
+  ThreadData &data = thread_data.get();
+  for (unsigned int i=0; i<data.active_sections.size(); ++i)
+    Assert (data.active_sections[i].name != section_name,
+            ExcMessage (std::string("Cannot enter the already active section <")
+                        + section_name + ">."));
+
+  data.active_sections.push_back (ActiveSection());
+  ActiveSection &section = data.active_sections.back();
+  section.name = section_name;
+  section.path = (data.active_sections.size() > 1 ?
+                  data.active_sections[data.active_sections.size()-2].path
+                  + "/" + section_name :
+                  section_name);
+  section.synchronized = false;
+  section.flops = 0.;
+  section.bytes = 0.;
+  section.counted = false;
 
-      sections[section_name].total_cpu_time = 0;
-      sections[section_name].total_wall_time = 0;
-      sections[section_name].n_calls = 0;
+#ifdef DEAL_II_WITH_MPI
+  if (mpi_communicator != MPI_COMM_SELF &&
+      Threads::this_thread_id() == main_thread_id)
+    {
+      // create a new timer for this section. the second argument will
+      // ensure that we have an MPI barrier before starting and stopping a
+      // timer, and this ensures that we get the maximum run time for this
+      // section over all processors. The mpi_communicator from TimerOutput
+      // is passed to the Timer here, so this Timer will collect timing
+      // information among all processes inside mpi_communicator.
+      section.synchronized = true;
+      section.synchronized_timer = Timer(mpi_communicator, true);
     }
+#endif
 
-  sections[section_name].timer.reset();
-  sections[section_name].timer.start();
-  sections[section_name].n_calls++;
+  section.timer.restart();
 
-  active_sections.push_back (section_name);
+  if (use_hardware_counters && open_hardware_counters (data))
+    section.counted = read_hardware_counters (data.counter_fds,
+                                              n_hardware_counters,
+                                              section.counters_at_start);
 }
 
 
@@ -382,36 +638,56 @@ TimerOutput::enter_subsection (const std::string &section_name)
 void
 TimerOutput::leave_subsection (const std::string &section_name)
 {
-  Assert (!active_sections.empty(),
+  ThreadData &data = thread_data.get();
+  Assert (!data.active_sections.empty(),
           ExcMessage("Cannot exit any section because none has been entered!"));
 
-  Threads::Mutex::ScopedLock lock (mutex);
-
+  // if no string is given, exit the last active section of this thread
+  unsigned int index = data.active_sections.size()-1;
   if (section_name != "")
     {
-      Assert (sections.find (section_name) != sections.end(),
-              ExcMessage ("Cannot delete a section that was never created."));
-      Assert (std::find (active_sections.begin(), active_sections.end(),
-                         section_name) != active_sections.end(),
+      while (index > 0 && data.active_sections[index].name != section_name)
+        --index;
+      Assert (data.active_sections[index].name == section_name,
               ExcMessage ("Cannot delete a section that has not been entered."));
     }
+  ActiveSection &section = data.active_sections[index];
+
+  unsigned long long int counters_at_end[n_hardware_counters] = {};
+  if (section.counted)
+    section.counted = read_hardware_counters (data.counter_fds,
+                                              n_hardware_counters,
+                                              counters_at_end);
+
+  section.timer.stop();
+  const double wall_time = section.timer.wall_time();
+  const double cpu_time = section.timer();
+  double summary_wall_time = wall_time;
+  double summary_cpu_time = cpu_time;
+
+  // On MPI systems, if constructed with an mpi_communicator like
+  // MPI_COMM_WORLD, then the synchronized Timer will return the maximum wall
+  // time and sum up the CPU time between processors among the provided
+  // mpi_communicator. Therefore, no further communication is needed here.
+  if (section.synchronized)
+    {
+      section.synchronized_timer.stop();
+      summary_wall_time = section.synchronized_timer.wall_time();
+      summary_cpu_time = section.synchronized_timer();
+    }
 
-  // if no string is given, exit the last
-  // active section.
-  const std::string actual_section_name = (section_name == "" ?
-                                           active_sections.back () :
-                                           section_name);
-
-  sections[actual_section_name].timer.stop();
-  sections[actual_section_name].total_wall_time
-  += sections[actual_section_name].timer.wall_time();
-
-  // Get cpu time. On MPI systems, if constructed with an mpi_communicator
-  // like MPI_COMM_WORLD, then the Timer will sum up the CPU time between
-  // processors among the provided mpi_communicator. Therefore, no
-  // communication is needed here.
-  const double cpu_time = sections[actual_section_name].timer();
-  sections[actual_section_name].total_cpu_time += cpu_time;
+  SectionData &section_data = data.sections[section.path];
+  section_data.name = section.name;
+  ++section_data.n_calls;
+  section_data.cpu_time += cpu_time;
+  section_data.wall_time += wall_time;
+  section_data.summary_cpu_time += summary_cpu_time;
+  section_data.summary_wall_time += summary_wall_time;
+  section_data.flops += section.flops;
+  section_data.bytes += section.bytes;
+  if (section.counted)
+    for (unsigned int i=0; i<n_hardware_counters; ++i)
+      section_data.counters[i] += counters_at_end[i] - section.counters_at_start[i];
 
   // in case we have to print out something, do that here...
   if ((output_frequency == every_call || output_frequency == every_call_and_summary)
@@ -419,9 +695,9 @@ TimerOutput::leave_subsection (const std::string &section_name)
     {
       std::string output_time;
       std::ostringstream cpu;
-      cpu << cpu_time << "s";
+      cpu << summary_cpu_time << "s";
       std::ostringstream wall;
-      wall << sections[actual_section_name].timer.wall_time() << "s";
+      wall << summary_wall_time << "s";
       if (output_type == cpu_times)
         output_time = ", CPU time: " + cpu.str();
       else if (output_type == wall_times)
@@ -429,14 +705,219 @@ TimerOutput::leave_subsection (const std::string &section_name)
       else
         output_time = ", CPU/wall time: " + cpu.str() + " / " + wall.str() + ".";
 
-      out_stream << actual_section_name << output_time
+      Threads::Mutex::ScopedLock lock (mutex);
+      out_stream << section.name << output_time
                  << std::endl;
     }
 
-  // delete the index from the list of
-  // active ones
-  active_sections.erase (std::find (active_sections.begin(), active_sections.end(),
-                                    actual_section_name));
+  // delete the section from the list of active ones
+  data.active_sections.erase (data.active_sections.begin() + index);
+}
+
+
+
+std::map<std::string, TimerOutput::Section>
+TimerOutput::collect_sections () const
+{
+  std::map<std::string, Section> sections;
+  const std::vector<ThreadData *> all_data = get_all_thread_objects (thread_data);
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    for (std::map<std::string, SectionData>::const_iterator
+         it = all_data[t]->sections.begin(); it != all_data[t]->sections.end(); ++it)
+      {
+        std::map<std::string, Section>::iterator section
+          = sections.find (it->second.name);
+        if (section == sections.end())
+          {
+            Section new_section;
+            new_section.total_cpu_time = 0;
+            new_section.total_wall_time = 0;
+            new_section.n_calls = 0;
+            new_section.flops = 0;
+            new_section.bytes = 0;
+            new_section.measured_bytes = 0;
+            section = sections.insert (std::make_pair (it->second.name,
+                                                       new_section)).first;
+          }
+        section->second.total_cpu_time += it->second.summary_cpu_time;
+        section->second.total_wall_time += it->second.summary_wall_time;
+        section->second.n_calls += it->second.n_calls;
+        section->second.flops += it->second.flops;
+        section->second.bytes += it->second.bytes;
+        // the cache misses count the cache lines of 64 bytes loaded from
+        // memory
+        section->second.measured_bytes += 64. * it->second.counters[2];
+      }
+  return sections;
+}
+
+
+
+std::vector<TimerOutput::SectionStatistics>
+TimerOutput::get_statistics () const
+{
+  std::map<std::string, SectionStatistics> paths;
+  const std::vector<ThreadData *> all_data = get_all_thread_objects (thread_data);
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    for (std::map<std::string, SectionData>::const_iterator
+         it = all_data[t]->sections.begin(); it != all_data[t]->sections.end(); ++it)
+      {
+        std::map<std::string, SectionStatistics>::iterator path
+          = paths.find (it->first);
+        if (path == paths.end())
+          {
+            SectionStatistics statistics;
+            statistics.name = it->first;
+            statistics.depth = std::count (it->first.begin(), it->first.end(), '/');
+            statistics.n_calls = 0;
+            statistics.n_threads = 0;
+            statistics.cpu_time = 0;
+            statistics.wall_time = 0;
+            statistics.max_thread_wall_time = 0;
+            statistics.expected_flops = 0;
+            statistics.expected_bytes = 0;
+            statistics.cycles = 0;
+            statistics.instructions = 0;
+            statistics.measured_bytes = 0;
+            path = paths.insert (std::make_pair (it->first, statistics)).first;
+          }
+        path->second.n_calls += it->second.n_calls;
+        ++path->second.n_threads;
+        path->second.cpu_time += it->second.cpu_time;
+        path->second.wall_time += it->second.wall_time;
+        path->second.max_thread_wall_time = std::max (path->second.max_thread_wall_time,
+                                                      it->second.wall_time);
+        path->second.expected_flops += it->second.flops;
+        path->second.expected_bytes += it->second.bytes;
+        path->second.cycles += it->second.counters[0];
+        path->second.instructions += it->second.counters[1];
+        path->second.measured_bytes += 64. * it->second.counters[2];
+      }
+
+  std::vector<SectionStatistics> statistics;
+  statistics.reserve (paths.size());
+  for (std::map<std::string, SectionStatistics>::const_iterator
+       it = paths.begin(); it != paths.end(); ++it)
+    statistics.push_back (it->second);
+  std::sort (statistics.begin(), statistics.end(), &compare_section_paths);
+
+#ifdef DEAL_II_WITH_MPI
+  if (mpi_communicator != MPI_COMM_SELF)
+    {
+      // the statistics over the processes are computed entry by entry, so
+      // all processes must have the same paths in the same order. compare
+      // the list of paths of each process with the one of the first process
+      std::string path_list;
+      for (unsigned int i=0; i<statistics.size(); ++i)
+        path_list += statistics[i].name + '\n';
+      unsigned int length = path_list.size();
+      MPI_Bcast (&length, 1, MPI_UNSIGNED, 0, mpi_communicator);
+      std::vector<char> root_path_list (path_list.begin(), path_list.end());
+      root_path_list.resize (length);
+      if (length > 0)
+        MPI_Bcast (&root_path_list[0], length, MPI_CHAR, 0, mpi_communicator);
+      const unsigned int same_paths
+        = (length == path_list.size() &&
+           std::equal (path_list.begin(), path_list.end(),
+                       root_path_list.begin())) ? 1 : 0;
+      AssertThrow (Utilities::MPI::min (same_paths, mpi_communicator) == 1,
+                   ExcMessage ("All processes must have entered the same sections "
+                               "to compute statistics over the processes."));
+    }
+#endif
+  for (unsigned int i=0; i<statistics.size(); ++i)
+    statistics[i].wall_time_over_processes
+      = Utilities::MPI::min_max_avg (statistics[i].wall_time, mpi_communicator);
+
+  return statistics;
+}
+
+
+
+void
+TimerOutput::write_statistics (std::ostream           &out,
+                               const StatisticsFormat  format) const
+{
+  const std::vector<SectionStatistics> statistics = get_statistics();
+  const double total_wall_time
+    = Utilities::MPI::max (timer_all.wall_time(), mpi_communicator);
+
+  if (mpi_communicator != MPI_COMM_SELF &&
+      Utilities::MPI::this_mpi_process (mpi_communicator) != 0)
+    return;
+
+  if (format == json)
+    {
+      out << "{\n"
+          << "  \"total_wall_time\": " << total_wall_time << ",\n"
+          << "  \"sections\": [";
+      for (unsigned int i=0; i<statistics.size(); ++i)
+        {
+          const SectionStatistics &s = statistics[i];
+          out << (i>0 ? "," : "") << "\n"
+              << "    {\"name\": " << json_string (s.name)
+              << ", \"depth\": " << s.depth
+              << ", \"calls\": " << s.n_calls
+              << ", \"threads\": " << s.n_threads
+              << ", \"cpu_time\": " << s.cpu_time
+              << ", \"wall_time\": " << s.wall_time
+              << ", \"max_thread_wall_time\": " << s.max_thread_wall_time
+              << ", \"min_wall_time\": " << s.wall_time_over_processes.min
+              << ", \"min_wall_time_rank\": " << s.wall_time_over_processes.min_index
+              << ", \"avg_wall_time\": " << s.wall_time_over_processes.avg
+              << ", \"max_wall_time\": " << s.wall_time_over_processes.max
+              << ", \"max_wall_time_rank\": " << s.wall_time_over_processes.max_index
+              << ", \"flops\": " << s.expected_flops
+              << ", \"bytes\": " << s.expected_bytes
+              << ", \"gflops_per_second\": "
+              << giga_rate (s.expected_flops, s.max_thread_wall_time)
+              << ", \"gbytes_per_second\": "
+              << giga_rate (s.expected_bytes, s.max_thread_wall_time)
+              << ", \"cycles\": " << s.cycles
+              << ", \"instructions\": " << s.instructions
+              << ", \"measured_bytes\": " << s.measured_bytes
+              << ", \"measured_gbytes_per_second\": "
+              << giga_rate (s.measured_bytes, s.max_thread_wall_time)
+              << "}";
+        }
+      out << "\n  ]\n}" << std::endl;
+    }
+  else if (format == csv)
+    {
+      out << "section,depth,calls,threads,cpu_time,wall_time,max_thread_wall_time,"
+          << "min_wall_time,min_wall_time_rank,avg_wall_time,max_wall_time,"
+          << "max_wall_time_rank,flops,bytes,gflops_per_second,"
+          << "gbytes_per_second,cycles,instructions,measured_bytes,"
+          << "measured_gbytes_per_second\n";
+      for (unsigned int i=0; i<statistics.size(); ++i)
+        {
+          const SectionStatistics &s = statistics[i];
+          out << csv_string (s.name)
+              << ',' << s.depth
+              << ',' << s.n_calls
+              << ',' << s.n_threads
+              << ',' << s.cpu_time
+              << ',' << s.wall_time
+              << ',' << s.max_thread_wall_time
+              << ',' << s.wall_time_over_processes.min
+              << ',' << s.wall_time_over_processes.min_index
+              << ',' << s.wall_time_over_processes.avg
+              << ',' << s.wall_time_over_processes.max
+              << ',' << s.wall_time_over_processes.max_index
+              << ',' << s.expected_flops
+              << ',' << s.expected_bytes
+              << ',' << giga_rate (s.expected_flops, s.max_thread_wall_time)
+              << ',' << giga_rate (s.expected_bytes, s.max_thread_wall_time)
+              << ',' << s.cycles
+              << ',' << s.instructions
+              << ',' << s.measured_bytes
+              << ',' << giga_rate (s.measured_bytes, s.max_thread_wall_time)
+              << '\n';
+        }
+      out << std::flush;
+    }
+  else
+    Assert (false, ExcNotImplemented());
 }
 
 
@@ -444,6 +925,8 @@ TimerOutput::leave_subsection (const std::string &section_name)
 void
 TimerOutput::print_summary () const
 {
+  const std::map<std::string, Section> sections = collect_sections();
+
   // we are going to change the
   // precision and width of output
   // below. store the old values so we
@@ -575,6 +1058,51 @@ TimerOutput::print_summary () const
                  << std::endl;
     }
 
+  // in case work has been attached to the sections or hardware counters
+  // have been read, write the rates achieved in the wall time of each
+  // section
+  bool have_work = false;
+  for (std::map<std::string, Section>::const_iterator
+       i = sections.begin(); i!=sections.end(); ++i)
+    if (i->second.flops > 0 || i->second.bytes > 0 ||
+        i->second.measured_bytes > 0)
+      have_work = true;
+  if (have_work)
+    {
+      out_stream << "\n\n"
+                 << "+---------------------------------+------------+"
+                 << "------------+------------+\n"
+                 << "| Section                         |    GFLOP/s |"
+                 << "       GB/s |  GB/s (HW) |\n"
+                 << "+---------------------------------+------------+"
+                 << "------------+------------+";
+      for (std::map<std::string, Section>::const_iterator
+           i = sections.begin(); i!=sections.end(); ++i)
+        {
+          std::string name_out = i->first;
+          unsigned int pos_non_space = name_out.find_first_not_of (" ");
+          name_out.erase(0, pos_non_space);
+          name_out.resize (32, ' ');
+          out_stream << std::endl;
+          out_stream << "| " << name_out << "|";
+          out_stream << std::setprecision(3);
+          out_stream << ' ' << std::setw(10)
+                     << giga_rate (i->second.flops, i->second.total_wall_time)
+                     << " |";
+          out_stream << ' ' << std::setw(10)
+                     << giga_rate (i->second.bytes, i->second.total_wall_time)
+                     << " |";
+          out_stream << ' ' << std::setw(10)
+                     << giga_rate (i->second.measured_bytes,
+                                   i->second.total_wall_time)
+                     << " |";
+        }
+      out_stream << std::endl
+                 << "+---------------------------------+------------+"
+                 << "------------+------------+\n"
+                 << std::endl;
+    }
+
   // restore previous precision and width
   out_stream.get_stream().precision (old_precision);
   out_stream.get_stream().width (old_width);
@@ -600,9 +1128,15 @@ TimerOutput::enable_output ()
 void
 TimerOutput::reset ()
 {
-  Threads::Mutex::ScopedLock lock (mutex);
-  sections.clear();
-  active_sections.clear();
+  // the objects of all threads need to be reset explicitly because
+  // ThreadLocalStorage::clear() does not do anything without threads. the
+  // hardware counters of the threads stay open
+  const std::vector<ThreadData *> all_data = get_all_thread_objects (thread_data);
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    {
+      all_data[t]->active_sections.clear();
+      all_data[t]->sections.clear();
+    }
   timer_all.restart();
 }
 
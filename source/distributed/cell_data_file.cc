@@ -0,0 +1,281 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/cell_data_file.h>
+
+#ifdef DEAL_II_WITH_ZLIB
+#  include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+#ifdef DEAL_II_WITH_MPI
+
+namespace parallel
+{
+  namespace distributed
+  {
+    namespace CellDataFile
+    {
+      namespace
+      {
+        /**
+         * The file starts with a header of n_header_entries integers,
+         * followed by n_index_entries integers for each block (see the
+         * documentation of the namespace).
+         */
+        typedef unsigned long long int file_index_t;
+        const file_index_t format_version = 1;
+        const unsigned int n_header_entries = 5;
+        const unsigned int n_index_entries = 3;
+      }
+
+
+
+      void write (const std::string       &filename,
+                  const std::vector<char> &local_data,
+                  const std::size_t        record_size,
+                  const bool               compress,
+                  const MPI_Comm          &mpi_communicator,
+                  const std::size_t        block_size)
+      {
+        Assert (record_size > 0, ExcMessage ("Records must not be empty."));
+        Assert (local_data.size() % record_size == 0,
+                ExcMessage ("The data must consist of whole records."));
+
+#ifdef DEAL_II_WITH_ZLIB
+        const bool use_compression = compress;
+#else
+        (void)compress;
+        const bool use_compression = false;
+#endif
+
+        // split the data into blocks and compress each of them separately.
+        // the numbers of the records and the positions in the index are
+        // relative to this processor for now
+        const std::size_t n_local_records = local_data.size() / record_size;
+        const std::size_t records_per_block
+          = std::max<std::size_t> (1, block_size/record_size);
+        const std::size_t n_local_blocks
+          = (n_local_records + records_per_block - 1) / records_per_block;
+        std::vector<file_index_t> index (n_local_blocks*n_index_entries);
+        std::vector<char> block_data;
+        for (std::size_t b=0; b<n_local_blocks; ++b)
+          {
+            const std::size_t begin = b*records_per_block;
+            const std::size_t size = std::min (records_per_block, n_local_records-begin) * record_size;
+            const std::size_t position = block_data.size();
+            index[b*n_index_entries]   = begin;
+            index[b*n_index_entries+1] = position;
+#ifdef DEAL_II_WITH_ZLIB
+            if (use_compression)
+              {
+                uLongf compressed_size = compressBound (size);
+                block_data.resize (position + compressed_size);
+                const int err = compress2 ((Bytef *) &block_data[position],
+                                           &compressed_size,
+                                           (const Bytef *) &local_data[begin*record_size],
+                                           size, Z_BEST_SPEED);
+                AssertThrow (err == Z_OK, ExcInternalError());
+                block_data.resize (position + compressed_size);
+              }
+            else
+#endif
+              block_data.insert (block_data.end(),
+                                 local_data.begin() + begin*record_size,
+                                 local_data.begin() + begin*record_size + size);
+            index[b*n_index_entries+2] = block_data.size() - position;
+          }
+        AssertThrow (block_data.size() <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                     ExcMessage ("The data of one processor exceeds the size "
+                                 "that can be written at once."));
+
+        // find the first record, the first entry of the index and the
+        // position of the data of this processor
+        file_index_t local_sizes[3] = { n_local_records, n_local_blocks,
+                                        block_data.size()
+                                      };
+        file_index_t offsets[3] = { 0, 0, 0 };
+        int ierr = MPI_Exscan (local_sizes, offsets, 3, MPI_UNSIGNED_LONG_LONG,
+                               MPI_SUM, mpi_communicator);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        // the result of MPI_Exscan is undefined on the first processor
+        const unsigned int my_id = Utilities::MPI::this_mpi_process (mpi_communicator);
+        if (my_id == 0)
+          offsets[0] = offsets[1] = offsets[2] = 0;
+        const file_index_t n_records = Utilities::MPI::sum (local_sizes[0],
+                                                            mpi_communicator);
+        const file_index_t n_blocks = Utilities::MPI::sum (local_sizes[1],
+                                                           mpi_communicator);
+        const file_index_t data_start
+          = (n_header_entries + n_blocks*n_index_entries) * sizeof(file_index_t);
+        for (std::size_t b=0; b<n_local_blocks; ++b)
+          {
+            index[b*n_index_entries]   += offsets[0];
+            index[b*n_index_entries+1] += data_start + offsets[2];
+          }
+
+        const file_index_t header[n_header_entries] =
+        {
+          format_version,
+          record_size,
+          n_records,
+          n_blocks,
+          use_compression
+        };
+
+        // all processors write their part of the index and the data with
+        // collective operations
+        MPI_File fh;
+        ierr = MPI_File_open (mpi_communicator, const_cast<char *>(filename.c_str()),
+                              MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+        AssertThrow (ierr == MPI_SUCCESS,
+                     ExcMessage ("Could not open file " + filename + " for writing."));
+        ierr = MPI_File_set_size (fh, 0);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+
+        ierr = MPI_File_write_at_all (fh, 0, const_cast<file_index_t *>(header),
+                                      my_id == 0 ? n_header_entries : 0,
+                                      MPI_UNSIGNED_LONG_LONG, MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        ierr = MPI_File_write_at_all (fh, (n_header_entries + offsets[1]*n_index_entries) *
+                                      sizeof(file_index_t),
+                                      index.empty() ? NULL : &index[0], index.size(),
+                                      MPI_UNSIGNED_LONG_LONG, MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        ierr = MPI_File_write_at_all (fh, data_start + offsets[2],
+                                      block_data.empty() ? NULL : &block_data[0],
+                                      block_data.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+
+        ierr = MPI_File_close (&fh);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+      }
+
+
+
+      void read (const std::string            &filename,
+                 const unsigned long long int  first_record,
+                 const unsigned long long int  n_local_records,
+                 const unsigned long long int  n_global_records,
+                 const std::size_t             record_size,
+                 std::vector<char>            &local_data,
+                 const MPI_Comm               &mpi_communicator)
+      {
+        MPI_File fh;
+        int ierr = MPI_File_open (mpi_communicator, const_cast<char *>(filename.c_str()),
+                                  MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+        AssertThrow (ierr == MPI_SUCCESS,
+                     ExcMessage ("Could not open file " + filename + " for reading."));
+
+        // read the header and the index of all blocks
+        file_index_t header[n_header_entries];
+        ierr = MPI_File_read_at_all (fh, 0, header, n_header_entries,
+                                     MPI_UNSIGNED_LONG_LONG, MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        AssertThrow (header[0] == format_version,
+                     ExcMessage ("Incompatible version found in file " + filename + "."));
+        AssertThrow (header[1] == record_size &&
+                     header[2] == n_global_records,
+                     ExcMessage ("The file " + filename + " does not contain the "
+                                 "expected number of records of the expected size."));
+        AssertThrow (first_record + n_local_records <= n_global_records,
+                     ExcMessage ("The range of records to be read exceeds the "
+                                 "number of records in the file."));
+#ifndef DEAL_II_WITH_ZLIB
+        AssertThrow (header[4] == 0,
+                     ExcMessage ("The file " + filename + " contains compressed data, "
+                                 "which requires deal.II to be configured with zlib."));
+#endif
+        const file_index_t n_blocks = header[3];
+
+        std::vector<file_index_t> index (n_blocks*n_index_entries);
+        ierr = MPI_File_read_at_all (fh, n_header_entries*sizeof(file_index_t),
+                                     index.empty() ? NULL : &index[0], index.size(),
+                                     MPI_UNSIGNED_LONG_LONG, MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        std::vector<file_index_t> block_first_record (n_blocks+1, header[2]);
+        for (file_index_t b=0; b<n_blocks; ++b)
+          block_first_record[b] = index[b*n_index_entries];
+
+        // find the blocks that overlap with the range of records of this
+        // processor and read them at once
+        const file_index_t end_record = first_record + n_local_records;
+        std::size_t begin_block = 0, end_block = 0;
+        if (n_local_records > 0)
+          {
+            begin_block = std::upper_bound (block_first_record.begin(),
+                                            block_first_record.begin()+n_blocks,
+                                            first_record) - block_first_record.begin() - 1;
+            end_block = std::lower_bound (block_first_record.begin(),
+                                          block_first_record.begin()+n_blocks,
+                                          end_record) - block_first_record.begin();
+          }
+        const file_index_t read_start = (begin_block < end_block) ?
+                                        index[begin_block*n_index_entries+1] : 0;
+        const file_index_t read_size = (begin_block < end_block) ?
+                                       index[(end_block-1)*n_index_entries+1] +
+                                       index[(end_block-1)*n_index_entries+2] - read_start : 0;
+        AssertThrow (read_size <= static_cast<file_index_t>(std::numeric_limits<int>::max()),
+                     ExcMessage ("The data of one processor exceeds the size "
+                                 "that can be read at once."));
+        std::vector<char> block_data (read_size);
+        ierr = MPI_File_read_at_all (fh, read_start,
+                                     block_data.empty() ? NULL : &block_data[0],
+                                     block_data.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        ierr = MPI_File_close (&fh);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+
+        // extract the records of this processor from the blocks
+        local_data.resize (n_local_records*record_size);
+        std::vector<char> uncompressed;
+        for (std::size_t b=begin_block; b<end_block; ++b)
+          {
+            const char *block = &block_data[index[b*n_index_entries+1]-read_start];
+            const std::size_t size = (block_first_record[b+1]-block_first_record[b]) * record_size;
+#ifdef DEAL_II_WITH_ZLIB
+            if (header[4] != 0)
+              {
+                uncompressed.resize (size);
+                uLongf uncompressed_size = size;
+                const int err = uncompress ((Bytef *) &uncompressed[0], &uncompressed_size,
+                                            (const Bytef *) block,
+                                            index[b*n_index_entries+2]);
+                AssertThrow (err == Z_OK && uncompressed_size == size,
+                             ExcMessage ("The file " + filename + " is corrupted."));
+                block = &uncompressed[0];
+              }
+#endif
+            const file_index_t copy_begin = std::max (first_record, block_first_record[b]);
+            const file_index_t copy_end = std::min (end_record, block_first_record[b+1]);
+            std::copy (block + (copy_begin-block_first_record[b])*record_size,
+                       block + (copy_end-block_first_record[b])*record_size,
+                       local_data.begin() + (copy_begin-first_record)*record_size);
+          }
+      }
+    }
+  }
+}
+
+#endif
+
+DEAL_II_NAMESPACE_CLOSE
@@ -24,6 +24,7 @@
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/distributed/tria.h>
+#include <deal.II/distributed/cell_data_file.h>
 
 #ifdef DEAL_II_WITH_P4EST
 #  include <p4est_bits.h>
@@ -45,6 +46,7 @@
 #include <numeric>
 #include <iostream>
 #include <fstream>
+#include <cstring>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -2652,7 +2654,8 @@ namespace parallel
     template <int dim, int spacedim>
     void
     Triangulation<dim,spacedim>::
-    save(const char *filename) const
+    save(const char *filename,
+         const bool  compress_data) const
     {
       Assert(n_attached_deserialize==0,
              ExcMessage ("not all SolutionTransfer's got deserialized after the last load()"));
@@ -2667,7 +2670,7 @@ namespace parallel
           std::string fname=std::string(filename)+".info";
           std::ofstream f(fname.c_str());
           f << "version nproc attached_bytes n_attached_objs n_coarse_cells" << std::endl
-            << 2 << " "
+            << 3 << " "
             << Utilities::MPI::n_mpi_processes (this->mpi_communicator) << " "
             << real_data_size << " "
             << attached_data_pack_callbacks.size() << " "
@@ -2681,7 +2684,11 @@ namespace parallel
           ->attach_mesh_data();
         }
 
-      dealii::internal::p4est::functions<dim>::save(filename, parallel_forest, attached_data_size>0);
+      // the forest is written by p4est without any data, the attached data
+      // goes into a separate file that is read block-wise in load()
+      dealii::internal::p4est::functions<dim>::save(filename, parallel_forest, false);
+      if (attached_data_size>0)
+        write_attached_data (filename, compress_data);
 
       dealii::parallel::distributed::Triangulation<dim, spacedim> *tria
         = const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this);
@@ -2726,7 +2733,12 @@ namespace parallel
         f >> version >> numcpus >> attached_size >> attached_count >> n_coarse_cells;
       }
 
-      Assert(version == 2, ExcMessage("Incompatible version found in .info file."));
+      AssertThrow(version == 2 || version == 3,
+                  ExcMessage("Incompatible version found in .info file."));
+
+      // in files of version 2, the attached data is part of the p4est file,
+      // whereas version 3 stores it separately
+      const bool data_in_forest = (version == 2 && attached_size>0);
       Assert(this->n_cells(0) == n_coarse_cells, ExcMessage("Number of coarse cells differ!"));
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
 #else
@@ -2743,7 +2755,7 @@ namespace parallel
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
       parallel_forest = dealii::internal::p4est::functions<dim>::load_ext (
                           filename, this->mpi_communicator,
-                          attached_size, attached_size>0,
+                          data_in_forest ? attached_size : 0, data_in_forest,
                           autopartition, 0,
                           this,
                           &connectivity);
@@ -2751,7 +2763,7 @@ namespace parallel
       (void)autopartition;
       parallel_forest = dealii::internal::p4est::functions<dim>::load (
                           filename, this->mpi_communicator,
-                          attached_size, attached_size>0,
+                          data_in_forest ? attached_size : 0, data_in_forest,
                           this,
                           &connectivity);
 #endif
@@ -2766,6 +2778,11 @@ namespace parallel
                    /* prepare coarsening */ 1,
                    /* weight_callback */ NULL);
 
+      // now that the final partition is known, read the attached data of
+      // the cells we own
+      if (version == 3 && attached_size>0)
+        read_attached_data (filename, attached_size);
+
       try
         {
           copy_local_forest_to_triangulation ();
@@ -2784,6 +2801,80 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    write_attached_data (const std::string &filename,
+                         const bool         compress_data) const
+    {
+      const std::size_t record_size = attached_data_size+sizeof(CellStatus);
+      Assert (parallel_forest->data_size == record_size, ExcInternalError());
+
+      // collect the data of the locally owned quadrants in the order of
+      // p4est
+      std::vector<char> local_data (parallel_forest->local_num_quadrants*record_size);
+      std::size_t position = 0;
+      for (typename dealii::internal::p4est::types<dim>::topidx
+           tree_index = parallel_forest->first_local_tree;
+           tree_index <= parallel_forest->last_local_tree; ++tree_index)
+        {
+          typename dealii::internal::p4est::types<dim>::tree *tree
+            = static_cast<typename dealii::internal::p4est::types<dim>::tree *>
+              (sc_array_index (parallel_forest->trees, tree_index));
+          for (std::size_t q=0; q<tree->quadrants.elem_count; ++q, position+=record_size)
+            std::memcpy (&local_data[position],
+                         static_cast<typename dealii::internal::p4est::types<dim>::quadrant *>
+                         (sc_array_index (&tree->quadrants, q))->p.user_data,
+                         record_size);
+        }
+      AssertDimension (position, local_data.size());
+
+      CellDataFile::write (filename + ".data", local_data, record_size,
+                           compress_data, this->mpi_communicator);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    read_attached_data (const std::string  &filename,
+                        const unsigned int  data_size)
+    {
+      // read the data of the cells this processor owns in the partition
+      // determined by load()
+      std::vector<char> local_data;
+      CellDataFile::read (filename + ".data",
+                          parallel_forest->global_first_quadrant[this->my_subdomain],
+                          parallel_forest->local_num_quadrants,
+                          parallel_forest->global_num_quadrants,
+                          data_size, local_data, this->mpi_communicator);
+
+      // attach the data to the quadrants
+      void *userptr = parallel_forest->user_pointer;
+      dealii::internal::p4est::functions<dim>::reset_data (parallel_forest, data_size,
+                                                           NULL, NULL);
+      parallel_forest->user_pointer = userptr;
+
+      std::size_t position = 0;
+      for (typename dealii::internal::p4est::types<dim>::topidx
+           tree_index = parallel_forest->first_local_tree;
+           tree_index <= parallel_forest->last_local_tree; ++tree_index)
+        {
+          typename dealii::internal::p4est::types<dim>::tree *tree
+            = static_cast<typename dealii::internal::p4est::types<dim>::tree *>
+              (sc_array_index (parallel_forest->trees, tree_index));
+          for (std::size_t q=0; q<tree->quadrants.elem_count; ++q, position+=data_size)
+            std::memcpy (static_cast<typename dealii::internal::p4est::types<dim>::quadrant *>
+                         (sc_array_index (&tree->quadrants, q))->p.user_data,
+                         &local_data[position],
+                         data_size);
+        }
+      AssertDimension (position, local_data.size());
+    }
+
+
+
     template <int dim, int spacedim>
     unsigned int
     Triangulation<dim,spacedim>::get_checksum () const
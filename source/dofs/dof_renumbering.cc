@@ -462,6 +462,258 @@ namespace DoFRenumbering
 
 
 
+  namespace
+  {
+    // helper function for compute_distributed_Cuthill_McKee(): number the
+    // rows given in @p rows, which form one or several connected components
+    // of @p sparsity, with the Cuthill-McKee algorithm started from
+    // @p starting_rows, and append them in their new order (or in reverse
+    // order) to @p order. @p position is a scratch array with one entry per
+    // row of @p sparsity
+    void
+    append_Cuthill_McKee_order (const DynamicSparsityPattern               &sparsity,
+                                const std::vector<types::global_dof_index> &rows,
+                                const std::vector<types::global_dof_index> &starting_rows,
+                                const bool                                  reverse,
+                                std::vector<types::global_dof_index>       &position,
+                                std::vector<types::global_dof_index>       &order)
+    {
+      if (rows.size() == 0)
+        return;
+
+      for (unsigned int i=0; i<rows.size(); ++i)
+        position[rows[i]] = i;
+
+      DynamicSparsityPattern component_sparsity (rows.size(), rows.size());
+      std::vector<types::global_dof_index> row_entries;
+      for (unsigned int i=0; i<rows.size(); ++i)
+        {
+          row_entries.clear();
+          for (DynamicSparsityPattern::iterator it = sparsity.begin(rows[i]);
+               it != sparsity.end(rows[i]); ++it)
+            row_entries.push_back (position[it->column()]);
+          std::sort (row_entries.begin(), row_entries.end());
+          component_sparsity.add_entries (i, row_entries.begin(),
+                                          row_entries.end(), true);
+        }
+
+      std::vector<types::global_dof_index> component_starting_rows (starting_rows.size());
+      for (unsigned int i=0; i<starting_rows.size(); ++i)
+        component_starting_rows[i] = position[starting_rows[i]];
+
+      std::vector<types::global_dof_index> new_indices (rows.size());
+      SparsityTools::reorder_Cuthill_McKee (component_sparsity, new_indices,
+                                            component_starting_rows);
+
+      std::vector<types::global_dof_index> component_order (rows.size());
+      for (unsigned int i=0; i<rows.size(); ++i)
+        component_order[new_indices[i]] = rows[i];
+      if (reverse)
+        order.insert (order.end(), component_order.rbegin(), component_order.rend());
+      else
+        order.insert (order.end(), component_order.begin(), component_order.end());
+    }
+  }
+
+
+
+  template <class DH>
+  void
+  distributed_Cuthill_McKee (DH         &dof_handler,
+                             const bool  reversed_numbering,
+                             const bool  use_constraints)
+  {
+    std::vector<types::global_dof_index> renumbering(dof_handler.locally_owned_dofs().n_elements(),
+                                                     DH::invalid_dof_index);
+    compute_distributed_Cuthill_McKee(renumbering, dof_handler,
+                                      reversed_numbering, use_constraints);
+
+    dof_handler.renumber_dofs (renumbering);
+  }
+
+
+
+  template <class DH>
+  void
+  compute_distributed_Cuthill_McKee (std::vector<types::global_dof_index> &new_indices,
+                                     const DH                             &dof_handler,
+                                     const bool                            reversed_numbering,
+                                     const bool                            use_constraints)
+  {
+    const IndexSet locally_owned = dof_handler.locally_owned_dofs();
+    AssertDimension(new_indices.size(), locally_owned.n_elements());
+    if (locally_owned.n_elements() == 0)
+      return;
+
+    IndexSet locally_relevant;
+    DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant);
+
+    ConstraintMatrix constraints (locally_relevant);
+    if (use_constraints)
+      DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+    constraints.close ();
+
+    // the rows of the locally owned dofs contain the couplings to the ghost
+    // dofs on locally owned cells as well
+    DynamicSparsityPattern dsp (dof_handler.n_dofs(),
+                                dof_handler.n_dofs(),
+                                locally_owned);
+    DoFTools::make_sparsity_pattern (dof_handler, dsp, constraints);
+    constraints.clear ();
+
+    // translate the couplings between locally owned dofs to processor-local
+    // index space and sort out the dofs that couple to other processors. a
+    // ghost dof on a locally owned cell belongs to a processor with a lower
+    // number if its index lies below the locally owned range, since the
+    // locally owned ranges are sorted by processor number
+    const types::global_dof_index n_owned = locally_owned.n_elements();
+    const types::global_dof_index first_owned = locally_owned.nth_index_in_set(0);
+    DynamicSparsityPattern sparsity (n_owned, n_owned);
+    std::vector<bool> couples_to_lower (n_owned, false),
+        couples_to_higher (n_owned, false);
+    std::vector<types::global_dof_index> row_entries;
+    for (types::global_dof_index i=0; i<n_owned; ++i)
+      {
+        const types::global_dof_index row = locally_owned.nth_index_in_set(i);
+        row_entries.clear();
+        for (DynamicSparsityPattern::iterator it =
+               dsp.begin(row); it != dsp.end(row); ++it)
+          if (locally_owned.is_element(it->column()))
+            {
+              if (it->column() != row)
+                row_entries.push_back(locally_owned.index_within_set(it->column()));
+            }
+          else if (it->column() < first_owned)
+            couples_to_lower[i] = true;
+          else
+            couples_to_higher[i] = true;
+
+        sparsity.add_entries(i, row_entries.begin(), row_entries.end(),
+                             true);
+      }
+
+    // the sparsity pattern does not contain the couplings of the locally
+    // owned dofs on the interface to the dofs of the ghost cells they are
+    // located on. on a parallel::distributed::Triangulation, the interface
+    // dofs are owned by the processor with the lowest subdomain id, so these
+    // are the only couplings to processors with higher numbers. look at the
+    // ghost cells to find them; whether a ghost dof is owned by a processor
+    // with a lower or a higher number is again told by its index
+    std::vector<types::global_dof_index> local_dof_indices;
+    for (typename DH::active_cell_iterator cell = dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      if (cell->is_ghost())
+        {
+          local_dof_indices.resize (cell->get_fe().dofs_per_cell);
+          cell->get_dof_indices (local_dof_indices);
+
+          bool cell_has_lower = false, cell_has_higher = false,
+               cell_has_owned = false;
+          for (unsigned int i=0; i<local_dof_indices.size(); ++i)
+            if (locally_owned.is_element (local_dof_indices[i]))
+              cell_has_owned = true;
+            else if (local_dof_indices[i] < first_owned)
+              cell_has_lower = true;
+            else
+              cell_has_higher = true;
+
+          if (cell_has_owned)
+            for (unsigned int i=0; i<local_dof_indices.size(); ++i)
+              if (locally_owned.is_element (local_dof_indices[i]))
+                {
+                  const types::global_dof_index index
+                    = locally_owned.index_within_set (local_dof_indices[i]);
+                  if (cell_has_lower)
+                    couples_to_lower[index] = true;
+                  if (cell_has_higher)
+                    couples_to_higher[index] = true;
+                }
+        }
+
+    // the locally owned part of the mesh need not be connected. find the
+    // connected components of the graph, since the Cuthill-McKee algorithm
+    // needs a starting index in every component
+    std::vector<unsigned int> component (n_owned, numbers::invalid_unsigned_int);
+    unsigned int n_components = 0;
+    std::vector<types::global_dof_index> front;
+    for (types::global_dof_index i=0; i<n_owned; ++i)
+      if (component[i] == numbers::invalid_unsigned_int)
+        {
+          component[i] = n_components;
+          front.push_back (i);
+          while (front.size() > 0)
+            {
+              const types::global_dof_index row = front.back();
+              front.pop_back();
+              for (DynamicSparsityPattern::iterator it =
+                     sparsity.begin(row); it != sparsity.end(row); ++it)
+                if (component[it->column()] == numbers::invalid_unsigned_int)
+                  {
+                    component[it->column()] = n_components;
+                    front.push_back (it->column());
+                  }
+            }
+          ++n_components;
+        }
+
+    // the numbering is started from the interface that should come first
+    // (or, with reversed numbering, from the one that should come last) in
+    // all components that touch it. components that only touch the other
+    // interface are started from there and numbered backward, such that the
+    // interface again ends up at the correct end of the range, and are put
+    // at the end. components without any interface go in between
+    const std::vector<bool> &primary
+      = (reversed_numbering ? couples_to_higher : couples_to_lower);
+    const std::vector<bool> &secondary
+      = (reversed_numbering ? couples_to_lower : couples_to_higher);
+
+    std::vector<bool> touches_primary (n_components, false),
+        touches_secondary (n_components, false);
+    for (types::global_dof_index i=0; i<n_owned; ++i)
+      {
+        if (primary[i])
+          touches_primary[component[i]] = true;
+        if (secondary[i])
+          touches_secondary[component[i]] = true;
+      }
+
+    std::vector<types::global_dof_index> primary_rows, primary_start,
+        interior_rows, secondary_rows, secondary_start;
+    for (types::global_dof_index i=0; i<n_owned; ++i)
+      if (touches_primary[component[i]])
+        {
+          primary_rows.push_back (i);
+          if (primary[i])
+            primary_start.push_back (i);
+        }
+      else if (touches_secondary[component[i]])
+        {
+          secondary_rows.push_back (i);
+          if (secondary[i])
+            secondary_start.push_back (i);
+        }
+      else
+        interior_rows.push_back (i);
+
+    std::vector<types::global_dof_index> position (n_owned), order;
+    order.reserve (n_owned);
+    append_Cuthill_McKee_order (sparsity, primary_rows, primary_start,
+                                false, position, order);
+    append_Cuthill_McKee_order (sparsity, interior_rows,
+                                std::vector<types::global_dof_index>(),
+                                false, position, order);
+    append_Cuthill_McKee_order (sparsity, secondary_rows, secondary_start,
+                                true, position, order);
+    AssertDimension (order.size(), n_owned);
+
+    // convert indices back to global index space
+    for (types::global_dof_index i=0; i<n_owned; ++i)
+      new_indices[order[reversed_numbering ? n_owned-1-i : i]]
+        = locally_owned.nth_index_in_set(i);
+  }
+
+
+
   template <class DH>
   void Cuthill_McKee (DH               &dof_handler,
                       const unsigned int               level,
@@ -1937,6 +2189,194 @@ namespace DoFRenumbering
             ExcInternalError());
   }
 
+
+
+  namespace
+  {
+    // helper function for compute_space_filling_curve_cell_order(): compute
+    // the position of a point with integer coordinates of n_bits bits each
+    // along the given curve. for the Hilbert curve, the coordinates are first
+    // transformed into the 'transposed' Hilbert index following J. Skilling,
+    // "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004). the index
+    // is then obtained by interleaving the bits of the coordinates, which is
+    // all that needs to be done for the Morton curve. in 1d, both curves
+    // simply run from left to right
+    template <int spacedim>
+    unsigned long long int
+    compute_curve_index (unsigned int            (&x)[spacedim],
+                         const unsigned int       n_bits,
+                         const SpaceFillingCurve  curve)
+    {
+      if (curve == hilbert_curve && spacedim > 1)
+        {
+          const unsigned int M = 1U << (n_bits-1);
+
+          // undo the excess work of the recursive construction
+          for (unsigned int Q=M; Q>1; Q>>=1)
+            {
+              const unsigned int P = Q-1;
+              for (unsigned int i=0; i<spacedim; ++i)
+                if (x[i] & Q)
+                  x[0] ^= P;
+                else
+                  {
+                    const unsigned int t = (x[0] ^ x[i]) & P;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                  }
+            }
+
+          // Gray encode
+          for (unsigned int i=1; i<spacedim; ++i)
+            x[i] ^= x[i-1];
+          unsigned int t = 0;
+          for (unsigned int Q=M; Q>1; Q>>=1)
+            if (x[spacedim-1] & Q)
+              t ^= Q-1;
+          for (unsigned int i=0; i<spacedim; ++i)
+            x[i] ^= t;
+        }
+
+      unsigned long long int index = 0;
+      for (int bit=n_bits-1; bit>=0; --bit)
+        for (unsigned int i=0; i<spacedim; ++i)
+          index = (index << 1) | ((x[i] >> bit) & 1U);
+      return index;
+    }
+  }
+
+
+
+  template <class DH>
+  void
+  space_filling_curve (DH                      &dof_handler,
+                       const SpaceFillingCurve  curve)
+  {
+    std::vector<types::global_dof_index> renumbering(dof_handler.n_locally_owned_dofs(),
+                                                     DH::invalid_dof_index);
+    compute_space_filling_curve(renumbering, dof_handler, curve);
+
+    dof_handler.renumber_dofs(renumbering);
+  }
+
+
+
+  template <class DH>
+  void
+  compute_space_filling_curve (std::vector<types::global_dof_index> &new_dof_indices,
+                               const DH                             &dof_handler,
+                               const SpaceFillingCurve               curve)
+  {
+    const IndexSet locally_owned = dof_handler.locally_owned_dofs();
+    AssertDimension (new_dof_indices.size(), locally_owned.n_elements());
+
+    std::fill (new_dof_indices.begin(), new_dof_indices.end(),
+               numbers::invalid_dof_index);
+
+    const std::vector<typename DH::active_cell_iterator>
+    cells = compute_space_filling_curve_cell_order (dof_handler, curve);
+
+    // number the locally owned dofs in the order of the first cell they
+    // belong to. the dofs of one cell are sorted first, like in cell_wise(),
+    // so that their relative order does not change
+    std::vector<types::global_dof_index> local_dof_indices;
+    types::global_dof_index next_free = 0;
+    for (unsigned int c=0; c<cells.size(); ++c)
+      {
+        local_dof_indices.resize (cells[c]->get_fe().dofs_per_cell);
+        cells[c]->get_dof_indices (local_dof_indices);
+        std::sort (local_dof_indices.begin(), local_dof_indices.end());
+
+        for (unsigned int i=0; i<local_dof_indices.size(); ++i)
+          if (locally_owned.is_element (local_dof_indices[i]))
+            {
+              const types::global_dof_index
+              idx = locally_owned.index_within_set (local_dof_indices[i]);
+              if (new_dof_indices[idx] == numbers::invalid_dof_index)
+                {
+                  new_dof_indices[idx] = locally_owned.nth_index_in_set (next_free);
+                  ++next_free;
+                }
+            }
+      }
+
+    // every locally owned dof sits on at least one locally owned cell, so
+    // all of them must have been numbered
+    Assert (next_free == locally_owned.n_elements(),
+            ExcRenumberingIncomplete());
+  }
+
+
+
+  template <class DH>
+  std::vector<typename DH::active_cell_iterator>
+  compute_space_filling_curve_cell_order (const DH                &dof_handler,
+                                          const SpaceFillingCurve  curve)
+  {
+    const unsigned int spacedim = DH::space_dimension;
+
+    // determine the bounding box of the triangulation. on a distributed
+    // triangulation, the vertices of the coarse mesh are known on all
+    // processors, so all of them get the same box
+    const std::vector<Point<spacedim> > &vertices
+      = dof_handler.get_tria().get_vertices();
+    const std::vector<bool> &used_vertices
+      = dof_handler.get_tria().get_used_vertices();
+    Point<spacedim> lower, upper;
+    bool first_vertex = true;
+    for (unsigned int v=0; v<vertices.size(); ++v)
+      if (used_vertices[v])
+        {
+          for (unsigned int d=0; d<spacedim; ++d)
+            if (first_vertex)
+              lower[d] = upper[d] = vertices[v][d];
+            else
+              {
+                lower[d] = std::min (lower[d], vertices[v][d]);
+                upper[d] = std::max (upper[d], vertices[v][d]);
+              }
+          first_vertex = false;
+        }
+
+    // the number of bits per coordinate direction is chosen such that the
+    // index of the curve fits into 64 bits
+    const unsigned int n_bits = (spacedim == 1 ? 32 : (spacedim == 2 ? 31 : 21));
+    const double max_coordinate = static_cast<double>((1ULL << n_bits) - 1);
+
+    std::vector<typename DH::active_cell_iterator> cells;
+    std::vector<std::pair<unsigned long long int, unsigned int> > curve_indices;
+    for (typename DH::active_cell_iterator cell = dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      if (cell->is_locally_owned())
+        {
+          const Point<spacedim> center = cell->center();
+          unsigned int coordinates[spacedim];
+          for (unsigned int d=0; d<spacedim; ++d)
+            coordinates[d] = (upper[d] > lower[d]
+                              ?
+                              static_cast<unsigned int>((center[d] - lower[d]) /
+                                                        (upper[d] - lower[d]) *
+                                                        max_coordinate)
+                              :
+                              0);
+
+          curve_indices.push_back (std::make_pair (compute_curve_index<spacedim> (coordinates,
+                                                   n_bits,
+                                                   curve),
+                                                   static_cast<unsigned int>(cells.size())));
+          cells.push_back (cell);
+        }
+
+    // sorting the pairs keeps cells with the same index of the curve in the
+    // order of the triangulation
+    std::sort (curve_indices.begin(), curve_indices.end());
+
+    std::vector<typename DH::active_cell_iterator> ordered_cells (cells.size());
+    for (unsigned int c=0; c<cells.size(); ++c)
+      ordered_cells[c] = cells[curve_indices[c].second];
+    return ordered_cells;
+  }
+
 } // namespace DoFRenumbering
 
 
@@ -1256,8 +1256,9 @@ namespace DoFTools
     // artificial cells). Otherwise we are good to use subdomain_id as stored
     // in cell->subdomain_id().
     std::vector<types::subdomain_id> cell_owners (dof_handler.get_tria().n_active_cells());
-    if (const parallel::shared::Triangulation<DH::dimension, DH::space_dimension> *tr =
-          (dynamic_cast<const parallel::shared::Triangulation<DH::dimension, DH::space_dimension>*> (&dof_handler.get_tria ())))
+    const parallel::shared::Triangulation<DH::dimension, DH::space_dimension> *tr =
+      (dynamic_cast<const parallel::shared::Triangulation<DH::dimension, DH::space_dimension>*> (&dof_handler.get_tria ()));
+    if (tr != 0 && tr->with_artificial_cells())
       {
         cell_owners = tr->get_true_subdomain_ids_of_cells();
       }
@@ -1265,8 +1266,7 @@ namespace DoFTools
       {
         for (typename DH::active_cell_iterator cell = dof_handler.begin_active();
              cell!= dof_handler.end(); cell++)
-          if (cell->is_locally_owned())
-            cell_owners[cell->active_cell_index()] = cell->subdomain_id();
+          cell_owners[cell->active_cell_index()] = cell->subdomain_id();
       }
 
     // preset all values by an invalid value
@@ -14,12 +14,15 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern_builder.h>
 #include <deal.II/lac/trilinos_sparsity_pattern.h>
 #include <deal.II/lac/block_sparsity_pattern.h>
 #include <deal.II/lac/vector.h>
@@ -109,6 +112,86 @@ namespace DoFTools
 
 
 
+  namespace internal
+  {
+    // add the entries of the cells in the range [begin,end) of the given
+    // list to the sparsity pattern
+    template <class DH>
+    void
+    add_cell_entries (const unsigned int begin,
+                      const unsigned int end,
+                      const std::vector<typename DH::active_cell_iterator> &cells,
+                      const ConstraintMatrix &constraints,
+                      const bool              keep_constrained_dofs,
+                      SparsityPatternBuilder &sparsity)
+    {
+      std::vector<types::global_dof_index> dofs_on_this_cell;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          dofs_on_this_cell.resize (cells[c]->get_fe().dofs_per_cell);
+          cells[c]->get_dof_indices (dofs_on_this_cell);
+          constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                   sparsity,
+                                                   keep_constrained_dofs);
+        }
+    }
+  }
+
+
+
+  template <class DH>
+  void
+  make_sparsity_pattern (const DH               &dof,
+                         SparsityPatternBuilder &sparsity,
+                         const ConstraintMatrix &constraints,
+                         const bool              keep_constrained_dofs,
+                         const types::subdomain_id subdomain_id)
+  {
+    const types::global_dof_index n_dofs = dof.n_dofs();
+    (void)n_dofs;
+
+    Assert (sparsity.n_rows() == n_dofs,
+            ExcDimensionMismatch (sparsity.n_rows(), n_dofs));
+    Assert (sparsity.n_cols() == n_dofs,
+            ExcDimensionMismatch (sparsity.n_cols(), n_dofs));
+    Assert (
+      (dof.get_tria().locally_owned_subdomain() == numbers::invalid_subdomain_id)
+      ||
+      (subdomain_id == numbers::invalid_subdomain_id)
+      ||
+      (subdomain_id == dof.get_tria().locally_owned_subdomain()),
+      ExcMessage ("For parallel::distributed::Triangulation objects and "
+                  "associated DoF handler objects, asking for any subdomain other "
+                  "than the locally owned one does not make sense."));
+
+    // collect the cells to work on, such that the work can be split into
+    // ranges of cells
+    std::vector<typename DH::active_cell_iterator> cells;
+    for (typename DH::active_cell_iterator cell = dof.begin_active();
+         cell != dof.end(); ++cell)
+      if (((subdomain_id == numbers::invalid_subdomain_id)
+           ||
+           (subdomain_id == cell->subdomain_id()))
+          &&
+          cell->is_locally_owned())
+        cells.push_back (cell);
+
+    // the constraint matrix keeps its scratch data in thread-local storage
+    // and the builder takes entries from several threads, so the cells can
+    // be worked on independently
+    parallel::apply_to_subranges (0U, cells.size(),
+                                  std_cxx11::bind (&internal::add_cell_entries<DH>,
+                                                   std_cxx11::_1,
+                                                   std_cxx11::_2,
+                                                   std_cxx11::cref(cells),
+                                                   std_cxx11::cref(constraints),
+                                                   keep_constrained_dofs,
+                                                   std_cxx11::ref(sparsity)),
+                                  64);
+  }
+
+
+
   template <class DH, class SparsityPattern>
   void
   make_sparsity_pattern (const DH                &dof,
@@ -3595,7 +3595,10 @@ FEValues<dim,spacedim>::FEValues (const Mapping<dim,spacedim>       &mapping,
                               update_default,
                               mapping,
                               fe),
-  quadrature (q)
+  quadrature (q),
+  max_n_cached_geometries (0),
+  next_cached_geometry (0),
+  n_cache_hits (0)
 {
   initialize (update_flags);
 }
@@ -3612,7 +3615,10 @@ FEValues<dim,spacedim>::FEValues (const FiniteElement<dim,spacedim> &fe,
                               update_default,
                               StaticMappingQ1<dim,spacedim>::mapping,
                               fe),
-  quadrature (q)
+  quadrature (q),
+  max_n_cached_geometries (0),
+  next_cached_geometry (0),
+  n_cache_hits (0)
 {
   initialize (update_flags);
 }
@@ -3756,6 +3762,35 @@ void FEValues<dim,spacedim>::do_reinit ()
                                          *this->mapping_data,
                                          this->mapping_output);
 
+  // if the cell is not a translation of the previous one, look for a cell
+  // with the same geometry in the cache. if there is one, copy the shape
+  // function derivatives from there and let the finite element treat the
+  // present cell like a translation, i.e., only fill the data that do not
+  // depend on the geometry
+  CellSimilarity::Similarity fe_cell_similarity = this->cell_similarity;
+  bool store_in_cache = false;
+  if (max_n_cached_geometries > 0 &&
+      this->cell_similarity != CellSimilarity::translation &&
+      dim == spacedim &&
+      this->get_fe().is_primitive())
+    {
+      const unsigned int index = find_cached_geometry ();
+      if (index != numbers::invalid_unsigned_int)
+        {
+          const CachedGeometry &geometry = cached_geometries[index];
+          if (this->update_flags & update_gradients)
+            this->finite_element_output.shape_gradients = geometry.shape_gradients;
+          if (this->update_flags & update_hessians)
+            this->finite_element_output.shape_hessians = geometry.shape_hessians;
+          if (this->update_flags & update_3rd_derivatives)
+            this->finite_element_output.shape_3rd_derivatives = geometry.shape_3rd_derivatives;
+          fe_cell_similarity = CellSimilarity::translation;
+          ++n_cache_hits;
+        }
+      else
+        store_in_cache = true;
+    }
+
   // then call the finite element and, with the data
   // already filled by the mapping, let it compute the
   // data for the mapped shape function values, gradients,
@@ -3767,19 +3802,173 @@ void FEValues<dim,spacedim>::do_reinit ()
                                 *this->fe_data,
                                 this->mapping_output,
                                 this->finite_element_output,
-                                this->cell_similarity);
+                                fe_cell_similarity);
+
+  if (store_in_cache)
+    store_cached_geometry ();
 
   this->fe_data->clear_first_cell ();
 }
 
 
 
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::enable_cell_similarity_cache (const unsigned int max_n_geometries)
+{
+  // the Jacobians identify the geometry of a cell, so make sure they are
+  // computed. this requires to set up the data of the mapping and the
+  // finite element again, which invalidates the data of the present cell
+  if (max_n_geometries > 0 && !(this->update_flags & update_jacobians))
+    {
+      initialize (this->update_flags | update_jacobians);
+      this->cell_similarity = CellSimilarity::invalid_next_cell;
+    }
+
+  max_n_cached_geometries = max_n_geometries;
+  cached_geometries.clear ();
+  next_cached_geometry = 0;
+  n_cache_hits = 0;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+FEValues<dim,spacedim>::n_cell_similarity_cache_hits () const
+{
+  return n_cache_hits;
+}
+
+
+
+namespace
+{
+  // Return whether the two arrays of tensors are equal up to a tolerance
+  // relative to the norm of the first array. Since the derivatives of the
+  // Jacobians are zero up to roundoff on affine cells, the tolerance is at
+  // least relative to the given reference value of the norm
+  template <typename TensorType>
+  bool
+  tensors_are_close (const std::vector<TensorType> &a,
+                     const std::vector<TensorType> &b,
+                     const double                   reference_norm_square)
+  {
+    if (a.size() != b.size())
+      return false;
+    double norm_square = 0, difference_square = 0;
+    for (unsigned int q=0; q<a.size(); ++q)
+      {
+        norm_square += a[q].norm_square();
+        difference_square += (a[q] - b[q]).norm_square();
+      }
+    return difference_square <= 1e-24 * std::max (norm_square,
+                                                  reference_norm_square);
+  }
+
+
+
+  // Same for the Jacobians, whose rows are tensors
+  template <int dim, int spacedim>
+  bool
+  tensors_are_close (const std::vector<DerivativeForm<1,dim,spacedim> > &a,
+                     const std::vector<DerivativeForm<1,dim,spacedim> > &b)
+  {
+    if (a.size() != b.size())
+      return false;
+    double norm_square = 0, difference_square = 0;
+    for (unsigned int q=0; q<a.size(); ++q)
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          norm_square += a[q][d].norm_square();
+          difference_square += (a[q][d] - b[q][d]).norm_square();
+        }
+    return difference_square <= 1e-24 * norm_square;
+  }
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+FEValues<dim,spacedim>::find_cached_geometry () const
+{
+  // the squared size of the cell as seen from the Jacobians, which
+  // determines the scale of the derivatives of the Jacobians
+  const unsigned int n_q_points = this->mapping_output.jacobians.size();
+  double h_square = 0;
+  for (unsigned int q=0; q<n_q_points; ++q)
+    for (unsigned int d=0; d<spacedim; ++d)
+      h_square += this->mapping_output.jacobians[q][d].norm_square();
+  h_square /= (n_q_points * dim);
+
+  for (unsigned int i=0; i<cached_geometries.size(); ++i)
+    if (tensors_are_close (cached_geometries[i].jacobians,
+                           this->mapping_output.jacobians)
+        &&
+        (!(this->update_flags & update_jacobian_pushed_forward_grads) ||
+         tensors_are_close (cached_geometries[i].jacobian_pushed_forward_grads,
+                            this->mapping_output.jacobian_pushed_forward_grads,
+                            n_q_points / h_square))
+        &&
+        (!(this->update_flags & update_jacobian_pushed_forward_2nd_derivatives) ||
+         tensors_are_close (cached_geometries[i].jacobian_pushed_forward_2nd_derivatives,
+                            this->mapping_output.jacobian_pushed_forward_2nd_derivatives,
+                            n_q_points / (h_square * h_square))))
+      return i;
+  return numbers::invalid_unsigned_int;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::store_cached_geometry ()
+{
+  // add a new entry until the cache is full, then replace the entries in
+  // the order in which they have been stored
+  if (cached_geometries.size() < max_n_cached_geometries)
+    {
+      cached_geometries.push_back (CachedGeometry());
+      next_cached_geometry = cached_geometries.size()-1;
+    }
+  CachedGeometry &geometry = cached_geometries[next_cached_geometry];
+  next_cached_geometry = (next_cached_geometry+1) % max_n_cached_geometries;
+
+  geometry.jacobians = this->mapping_output.jacobians;
+  if (this->update_flags & update_jacobian_pushed_forward_grads)
+    geometry.jacobian_pushed_forward_grads
+      = this->mapping_output.jacobian_pushed_forward_grads;
+  if (this->update_flags & update_jacobian_pushed_forward_2nd_derivatives)
+    geometry.jacobian_pushed_forward_2nd_derivatives
+      = this->mapping_output.jacobian_pushed_forward_2nd_derivatives;
+  if (this->update_flags & update_gradients)
+    geometry.shape_gradients = this->finite_element_output.shape_gradients;
+  if (this->update_flags & update_hessians)
+    geometry.shape_hessians = this->finite_element_output.shape_hessians;
+  if (this->update_flags & update_3rd_derivatives)
+    geometry.shape_3rd_derivatives = this->finite_element_output.shape_3rd_derivatives;
+}
+
+
+
 template <int dim, int spacedim>
 std::size_t
 FEValues<dim,spacedim>::memory_consumption () const
 {
+  std::size_t cache_memory = 0;
+  for (unsigned int i=0; i<cached_geometries.size(); ++i)
+    cache_memory +=
+      (MemoryConsumption::memory_consumption (cached_geometries[i].jacobians) +
+       MemoryConsumption::memory_consumption (cached_geometries[i].jacobian_pushed_forward_grads) +
+       MemoryConsumption::memory_consumption (cached_geometries[i].jacobian_pushed_forward_2nd_derivatives) +
+       MemoryConsumption::memory_consumption (cached_geometries[i].shape_gradients) +
+       MemoryConsumption::memory_consumption (cached_geometries[i].shape_hessians) +
+       MemoryConsumption::memory_consumption (cached_geometries[i].shape_3rd_derivatives));
+
   return (FEValuesBase<dim,spacedim>::memory_consumption () +
-          MemoryConsumption::memory_consumption (quadrature));
+          MemoryConsumption::memory_consumption (quadrature) +
+          cache_memory);
 }
 
 
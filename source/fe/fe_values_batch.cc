@@ -0,0 +1,175 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q1.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+const unsigned int FEValuesBatch<dim,spacedim>::n_lanes;
+
+
+
+template <int dim, int spacedim>
+FEValuesBatch<dim,spacedim>::FEValuesBatch (const Mapping<dim,spacedim>       &mapping,
+                                            const FiniteElement<dim,spacedim> &fe,
+                                            const Quadrature<dim>             &quadrature,
+                                            const UpdateFlags                  update_flags)
+  :
+  n_quadrature_points (quadrature.size()),
+  dofs_per_cell (fe.dofs_per_cell),
+  fe_values (mapping, fe, quadrature, update_flags),
+  n_filled_lanes (0),
+  update_flags (update_flags)
+{
+  initialize ();
+}
+
+
+
+template <int dim, int spacedim>
+FEValuesBatch<dim,spacedim>::FEValuesBatch (const FiniteElement<dim,spacedim> &fe,
+                                            const Quadrature<dim>             &quadrature,
+                                            const UpdateFlags                  update_flags)
+  :
+  n_quadrature_points (quadrature.size()),
+  dofs_per_cell (fe.dofs_per_cell),
+  fe_values (StaticMappingQ1<dim,spacedim>::mapping, fe, quadrature, update_flags),
+  n_filled_lanes (0),
+  update_flags (update_flags)
+{
+  initialize ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValuesBatch<dim,spacedim>::initialize ()
+{
+  const FiniteElement<dim,spacedim> &fe = fe_values.get_fe();
+
+  // number the nonzero components of all shape functions consecutively, in
+  // the same way as FEValues does internally
+  shape_function_to_row_table.resize (fe.dofs_per_cell * fe.n_components(),
+                                      numbers::invalid_unsigned_int);
+  unsigned int row = 0;
+  for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+    for (unsigned int c=0; c<fe.n_components(); ++c)
+      if (fe.get_nonzero_components(i)[c] == true)
+        shape_function_to_row_table[i*fe.n_components()+c] = row++;
+
+  if (update_flags & update_values)
+    shape_values.reinit (row, n_quadrature_points);
+  if (update_flags & update_gradients)
+    shape_gradients.reinit (row, n_quadrature_points);
+  if (update_flags & update_JxW_values)
+    JxW_values.resize (n_quadrature_points);
+  if (update_flags & update_quadrature_points)
+    quadrature_points.resize (n_quadrature_points);
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValuesBatch<dim,spacedim>::copy_lane (const unsigned int lane)
+{
+  const FiniteElement<dim,spacedim> &fe = fe_values.get_fe();
+  const unsigned int n_components = fe.n_components();
+
+  if (update_flags & (update_values | update_gradients))
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          const unsigned int row = shape_function_to_row_table[i*n_components+c];
+          if (row == numbers::invalid_unsigned_int)
+            continue;
+
+          if (update_flags & update_values)
+            for (unsigned int q=0; q<n_quadrature_points; ++q)
+              shape_values(row,q)[lane] = fe_values.shape_value_component(i,q,c);
+
+          if (update_flags & update_gradients)
+            for (unsigned int q=0; q<n_quadrature_points; ++q)
+              {
+                const Tensor<1,spacedim> grad = fe_values.shape_grad_component(i,q,c);
+                for (unsigned int d=0; d<spacedim; ++d)
+                  shape_gradients(row,q)[d][lane] = grad[d];
+              }
+        }
+
+  if (update_flags & update_JxW_values)
+    for (unsigned int q=0; q<n_quadrature_points; ++q)
+      JxW_values[q][lane] = fe_values.JxW(q);
+
+  if (update_flags & update_quadrature_points)
+    for (unsigned int q=0; q<n_quadrature_points; ++q)
+      for (unsigned int d=0; d<spacedim; ++d)
+        quadrature_points[q][d][lane] = fe_values.quadrature_point(q)[d];
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValuesBatch<dim,spacedim>::fill_unused_lanes ()
+{
+  if (n_filled_lanes == n_lanes)
+    return;
+
+  for (unsigned int row=0; row<shape_values.size(0); ++row)
+    for (unsigned int q=0; q<shape_values.size(1); ++q)
+      for (unsigned int lane=n_filled_lanes; lane<n_lanes; ++lane)
+        shape_values(row,q)[lane] = shape_values(row,q)[0];
+
+  for (unsigned int row=0; row<shape_gradients.size(0); ++row)
+    for (unsigned int q=0; q<shape_gradients.size(1); ++q)
+      for (unsigned int d=0; d<spacedim; ++d)
+        for (unsigned int lane=n_filled_lanes; lane<n_lanes; ++lane)
+          shape_gradients(row,q)[d][lane] = shape_gradients(row,q)[d][0];
+
+  for (unsigned int q=0; q<JxW_values.size(); ++q)
+    for (unsigned int lane=n_filled_lanes; lane<n_lanes; ++lane)
+      JxW_values[q][lane] = JxW_values[q][0];
+
+  for (unsigned int q=0; q<quadrature_points.size(); ++q)
+    for (unsigned int d=0; d<spacedim; ++d)
+      for (unsigned int lane=n_filled_lanes; lane<n_lanes; ++lane)
+        quadrature_points[q][d][lane] = quadrature_points[q][d][0];
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+FEValuesBatch<dim,spacedim>::memory_consumption () const
+{
+  return (fe_values.memory_consumption () +
+          MemoryConsumption::memory_consumption (shape_function_to_row_table) +
+          shape_values.memory_consumption () +
+          shape_gradients.memory_consumption () +
+          JxW_values.memory_consumption () +
+          quadrature_points.memory_consumption ());
+}
+
+
+/*------------------------------- Explicit Instantiations -------------*/
+#include "fe_values_batch.inst"
+
+DEAL_II_NAMESPACE_CLOSE
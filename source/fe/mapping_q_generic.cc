@@ -659,9 +659,129 @@ namespace internal
 
 
 
+namespace
+{
+  template <int dim>
+  std::vector<unsigned int>
+  get_dpo_vector (const unsigned int degree)
+  {
+    std::vector<unsigned int> dpo(dim+1, 1U);
+    for (unsigned int i=1; i<dpo.size(); ++i)
+      dpo[i]=dpo[i-1]*(degree-1);
+    return dpo;
+  }
+
+
+
+  /**
+   * Check whether the given points are the tensor product of a set of
+   * one-dimensional points, enumerated with the first coordinate running
+   * fastest, as done by the constructor of Quadrature that takes a
+   * one-dimensional formula. If so, return the one-dimensional points in
+   * the second argument.
+   */
+  template <int dim>
+  bool
+  extract_tensor_product_points (const std::vector<Point<dim> > &points,
+                                 std::vector<double>            &points_1d)
+  {
+    const unsigned int n_points = points.size();
+    unsigned int n_points_1d = 0;
+    while (Utilities::fixed_power<dim>(n_points_1d+1) <= n_points)
+      ++n_points_1d;
+    if (n_points_1d == 0 || Utilities::fixed_power<dim>(n_points_1d) != n_points)
+      return false;
+
+    points_1d.resize (n_points_1d);
+    for (unsigned int i=0; i<n_points_1d; ++i)
+      points_1d[i] = points[i][0];
+
+    for (unsigned int q=0; q<n_points; ++q)
+      for (unsigned int d=0, index=q; d<dim; ++d, index /= n_points_1d)
+        if (std::abs(points[q][d] - points_1d[index % n_points_1d]) > 1e-15)
+          return false;
+    return true;
+  }
+
+
+
+  /**
+   * Apply a one-dimensional kernel with @p n_rows rows and @p n_columns
+   * columns, stored with the rows running slowest, along the given
+   * direction of a tensor of dimension @p dim. The directions below
+   * @p direction have extent @p n_columns, the ones above extent @p n_rows.
+   */
+  template <int dim>
+  void
+  apply_tensor_product_kernel (const double       *kernel,
+                               const unsigned int  n_rows,
+                               const unsigned int  n_columns,
+                               const unsigned int  direction,
+                               const double       *in,
+                               double             *out)
+  {
+    unsigned int n_before = 1, n_after = 1;
+    for (unsigned int d=0; d<direction; ++d)
+      n_before *= n_columns;
+    for (unsigned int d=direction+1; d<dim; ++d)
+      n_after *= n_rows;
+
+    for (unsigned int a=0; a<n_after; ++a)
+      for (unsigned int b=0; b<n_before; ++b)
+        {
+          const double *in_line = in + a*n_rows*n_before + b;
+          double *out_line = out + a*n_columns*n_before + b;
+          for (unsigned int q=0; q<n_columns; ++q)
+            {
+              double sum = kernel[q] * in_line[0];
+              for (unsigned int i=1; i<n_rows; ++i)
+                sum += kernel[i*n_columns+q] * in_line[i*n_before];
+              out_line[q*n_before] = sum;
+            }
+        }
+  }
+
+
+
+  /**
+   * Evaluate the interpolant given by one coordinate of the mapping support
+   * points, stored in the first part of the scratch array of @p data in
+   * lexicographic order, at all quadrature points. The derivative is taken
+   * in direction @p derivative_direction, or no derivative if it equals
+   * @p dim. The result is written to the scratch array after the input.
+   */
+  template <int dim, int spacedim>
+  const double *
+  evaluate_tensor_product (const typename MappingQGeneric<dim,spacedim>::InternalData &data,
+                           const unsigned int derivative_direction)
+  {
+    const unsigned int n_rows = data.polynomial_degree+1;
+    const unsigned int n_columns = data.shape_values_1d.size() / n_rows;
+    const unsigned int size = data.tensor_product_scratch.size()/3;
+    double *values = &data.tensor_product_scratch[0];
+    double *buffers[2] = { values + size, values + 2*size };
+
+    const double *in = values;
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        // alternate between the two buffers, ending in the first one
+        double *out = buffers[(dim-1-d)%2];
+        apply_tensor_product_kernel<dim> (d == derivative_direction ?
+                                          &data.shape_gradients_1d[0] :
+                                          &data.shape_values_1d[0],
+                                          n_rows, n_columns, d, in, out);
+        in = out;
+      }
+    return in;
+  }
+}
+
+
+
 template<int dim, int spacedim>
 MappingQGeneric<dim,spacedim>::InternalData::InternalData (const unsigned int polynomial_degree)
   :
+  tensor_product_quadrature (false),
   polynomial_degree (polynomial_degree),
   n_shape_functions (Utilities::fixed_power<dim>(polynomial_degree+1))
 {}
@@ -675,6 +795,10 @@ MappingQGeneric<dim,spacedim>::InternalData::memory_consumption () const
   return (Mapping<dim,spacedim>::InternalDataBase::memory_consumption() +
           MemoryConsumption::memory_consumption (shape_values) +
           MemoryConsumption::memory_consumption (shape_derivatives) +
+          MemoryConsumption::memory_consumption (shape_values_1d) +
+          MemoryConsumption::memory_consumption (shape_gradients_1d) +
+          MemoryConsumption::memory_consumption (lexicographic_to_support_point) +
+          MemoryConsumption::memory_consumption (tensor_product_scratch) +
           MemoryConsumption::memory_consumption (covariant) +
           MemoryConsumption::memory_consumption (contravariant) +
           MemoryConsumption::memory_consumption (unit_tangentials) +
@@ -743,6 +867,47 @@ initialize (const UpdateFlags      update_flags,
 
   // now also fill the various fields with their correct values
   compute_shape_function_values (q.get_points());
+
+  // for quadrature formulas on cells that are the tensor product of a
+  // one-dimensional formula, set up the data for evaluating positions and
+  // Jacobians by sum factorization. formulas projected to faces have more
+  // points than the original formula and are never of this form
+  std::vector<double> points_1d;
+  tensor_product_quadrature =
+    (n_q_points == n_original_q_points) &&
+    (this->update_each & (update_quadrature_points |
+                          update_covariant_transformation |
+                          update_contravariant_transformation |
+                          update_JxW_values |
+                          update_jacobians |
+                          update_inverse_jacobians)) &&
+    extract_tensor_product_points (q.get_points(), points_1d);
+
+  if (tensor_product_quadrature)
+    {
+      const unsigned int n_points_1d = points_1d.size();
+      const std::vector<Polynomials::Polynomial<double> >
+      polynomials (Polynomials::generate_complete_Lagrange_basis
+                   (QGaussLobatto<1>(polynomial_degree+1).get_points()));
+      shape_values_1d.resize ((polynomial_degree+1) * n_points_1d);
+      shape_gradients_1d.resize ((polynomial_degree+1) * n_points_1d);
+      std::vector<double> values (2);
+      for (unsigned int i=0; i<=polynomial_degree; ++i)
+        for (unsigned int q=0; q<n_points_1d; ++q)
+          {
+            polynomials[i].value (points_1d[q], values);
+            shape_values_1d[i*n_points_1d+q] = values[0];
+            shape_gradients_1d[i*n_points_1d+q] = values[1];
+          }
+
+      lexicographic_to_support_point =
+        FETools::lexicographic_to_hierarchic_numbering
+        (FiniteElementData<dim> (get_dpo_vector<dim>(polynomial_degree), 1,
+                                 polynomial_degree));
+
+      tensor_product_scratch.resize
+      (3*Utilities::fixed_power<dim>(std::max(polynomial_degree+1, n_points_1d)));
+    }
 }
 
 
@@ -815,21 +980,6 @@ initialize_face (const UpdateFlags      update_flags,
 
 
 
-namespace
-{
-  template <int dim>
-  std::vector<unsigned int>
-  get_dpo_vector (const unsigned int degree)
-  {
-    std::vector<unsigned int> dpo(dim+1, 1U);
-    for (unsigned int i=1; i<dpo.size(); ++i)
-      dpo[i]=dpo[i-1]*(degree-1);
-    return dpo;
-  }
-}
-
-
-
 template<int dim, int spacedim>
 void
 MappingQGeneric<dim,spacedim>::InternalData::
@@ -1983,7 +2133,25 @@ namespace internal
     {
       const UpdateFlags update_flags = data.update_each;
 
-      if (update_flags & update_quadrature_points)
+      if ((update_flags & update_quadrature_points) &&
+          data.tensor_product_quadrature)
+        {
+          // evaluate the interpolant of each coordinate of the support
+          // points by sum factorization
+          AssertDimension (quadrature_points.size(),
+                           Utilities::fixed_power<dim>(data.shape_values_1d.size() /
+                                                       (data.polynomial_degree+1)));
+          for (unsigned int i=0; i<spacedim; ++i)
+            {
+              for (unsigned int k=0; k<data.n_shape_functions; ++k)
+                data.tensor_product_scratch[k] =
+                  data.mapping_support_points[data.lexicographic_to_support_point[k]][i];
+              const double *values = evaluate_tensor_product<dim,spacedim> (data, dim);
+              for (unsigned int point=0; point<quadrature_points.size(); ++point)
+                quadrature_points[point][i] = values[point];
+            }
+        }
+      else if (update_flags & update_quadrature_points)
         {
           for (unsigned int point=0; point<quadrature_points.size(); ++point)
             {
@@ -2018,7 +2186,26 @@ namespace internal
         // if the current cell is just a
         // translation of the previous one, no
         // need to recompute jacobians...
-        if (cell_similarity != CellSimilarity::translation)
+        if (cell_similarity != CellSimilarity::translation &&
+            data.tensor_product_quadrature)
+          {
+            // compute the derivative of each coordinate of the support
+            // points in each unit direction by sum factorization
+            const unsigned int n_q_points = data.contravariant.size();
+            for (unsigned int i=0; i<spacedim; ++i)
+              {
+                for (unsigned int k=0; k<data.n_shape_functions; ++k)
+                  data.tensor_product_scratch[k] =
+                    data.mapping_support_points[data.lexicographic_to_support_point[k]][i];
+                for (unsigned int j=0; j<dim; ++j)
+                  {
+                    const double *derivatives = evaluate_tensor_product<dim,spacedim> (data, j);
+                    for (unsigned int point=0; point<n_q_points; ++point)
+                      data.contravariant[point][i][j] = derivatives[point];
+                  }
+              }
+          }
+        else if (cell_similarity != CellSimilarity::translation)
           {
             const unsigned int n_q_points = data.contravariant.size();
 
@@ -41,6 +41,7 @@ namespace internal
       present_fe_values_index (numbers::invalid_unsigned_int,
                                numbers::invalid_unsigned_int,
                                numbers::invalid_unsigned_int),
+      present_fe_values (0),
       update_flags (update_flags)
     {}
 
@@ -61,6 +62,7 @@ namespace internal
       present_fe_values_index (numbers::invalid_unsigned_int,
                                numbers::invalid_unsigned_int,
                                numbers::invalid_unsigned_int),
+      present_fe_values (0),
       update_flags (update_flags)
     {}
 
@@ -81,27 +83,69 @@ namespace internal
               ExcIndexRange (q_index, 0, q_collection.size()));
 
 
-      // set the triple of indices
-      // that we want to work with
-      present_fe_values_index = TableIndices<3> (fe_index,
-                                                 mapping_index,
-                                                 q_index);
+      // set the triple of indices that we want to work with. if it is the
+      // same as last time, we are done
+      const TableIndices<3> fe_values_index (fe_index,
+                                             mapping_index,
+                                             q_index);
+      if (fe_values_index == present_fe_values_index)
+        return *present_fe_values;
+      present_fe_values_index = fe_values_index;
 
-      // first check whether we
-      // already have an object for
-      // this particular combination
-      // of indices
-      if (fe_values_table(present_fe_values_index).get() == 0)
-        fe_values_table(present_fe_values_index)
+      // first check whether we already have an object for this particular
+      // combination of indices. if not, create it
+      precompute_fe_values (fe_index, mapping_index, q_index);
+
+      // now there definitely is one!
+      present_fe_values = fe_values_table(present_fe_values_index).get();
+      return *present_fe_values;
+    }
+
+
+
+    template <int dim, int q_dim, class FEValues>
+    void
+    FEValuesBase<dim,q_dim,FEValues>::
+    precompute_fe_values (const unsigned int fe_index,
+                          const unsigned int mapping_index,
+                          const unsigned int q_index)
+    {
+      Assert (fe_index < fe_collection->size(),
+              ExcIndexRange (fe_index, 0, fe_collection->size()));
+      Assert (mapping_index < mapping_collection->size(),
+              ExcIndexRange (mapping_index, 0, mapping_collection->size()));
+      Assert (q_index < q_collection.size(),
+              ExcIndexRange (q_index, 0, q_collection.size()));
+
+      if (fe_values_table(fe_index, mapping_index, q_index).get() == 0)
+        fe_values_table(fe_index, mapping_index, q_index)
           =
             std_cxx11::shared_ptr<FEValues>
             (new FEValues ((*mapping_collection)[mapping_index],
                            (*fe_collection)[fe_index],
                            q_collection[q_index],
                            update_flags));
+    }
 
-      // now there definitely is one!
-      return *fe_values_table(present_fe_values_index);
+
+
+    template <int dim, int q_dim, class FEValues>
+    void
+    FEValuesBase<dim,q_dim,FEValues>::precompute_fe_values ()
+    {
+      // use the same rules for the default indices as the reinit()
+      // functions of the derived classes, but skip combinations that
+      // reinit() would reject because one of the collections is too short
+      for (unsigned int fe_index=0; fe_index<fe_collection->size(); ++fe_index)
+        {
+          const unsigned int mapping_index
+            = (mapping_collection->size() > 1 ? fe_index : 0);
+          const unsigned int q_index
+            = (q_collection.size() > 1 ? fe_index : 0);
+          if (mapping_index < mapping_collection->size() &&
+              q_index < q_collection.size())
+            precompute_fe_values (fe_index, mapping_index, q_index);
+        }
     }
   }
 }
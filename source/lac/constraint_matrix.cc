@@ -18,6 +18,7 @@
 
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern_builder.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/block_sparse_matrix.h>
 #include <deal.II/lac/sparse_matrix_ez.h>
@@ -1180,6 +1181,76 @@ ConstraintMatrix::memory_consumption () const
 
 
 
+namespace
+{
+  typedef std::vector<std::vector<types::global_dof_index> >::const_iterator
+  index_iterator;
+
+  // return the global rows written into when distributing the data of the
+  // cell given by the iterator, as precomputed in conflicts
+  std::vector<types::global_dof_index>
+  get_conflict_indices (const std::vector<std::vector<types::global_dof_index> > &conflicts,
+                        const index_iterator                                       &begin,
+                        const index_iterator                                       &cell)
+  {
+    return conflicts[cell - begin];
+  }
+}
+
+
+
+void
+ConstraintMatrix::setup_local_to_global_batch (const std::vector<std::vector<size_type> > &local_dof_indices,
+                                               LocalToGlobalBatch                         &batch) const
+{
+  Assert (lines.empty() || sorted == true, ExcMatrixNotClosed());
+  const unsigned int n_cells = local_dof_indices.size();
+
+  // find the constraints of all degrees of freedom and collect the global
+  // rows each cell writes into: the rows of its own degrees of freedom
+  // (constrained rows get their diagonal entry set) and the rows the
+  // constraints resolve to
+  batch.constraint_lines.resize (n_cells);
+  std::vector<std::vector<types::global_dof_index> > conflicts (n_cells);
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      const std::vector<size_type> &indices = local_dof_indices[cell];
+      std::vector<size_type> &cell_lines = batch.constraint_lines[cell];
+      cell_lines.assign (indices.size(), numbers::invalid_size_type);
+      std::vector<types::global_dof_index> &rows = conflicts[cell];
+      rows.assign (indices.begin(), indices.end());
+      for (unsigned int i=0; i<indices.size(); ++i)
+        if (is_constrained(indices[i]))
+          {
+            cell_lines[i] = lines_cache[calculate_line_index(indices[i])];
+            const ConstraintLine::Entries &entries = lines[cell_lines[i]].entries;
+            for (unsigned int j=0; j<entries.size(); ++j)
+              rows.push_back (entries[j].first);
+          }
+      std::sort (rows.begin(), rows.end());
+      rows.erase (std::unique(rows.begin(), rows.end()), rows.end());
+    }
+
+  const std::vector<std::vector<index_iterator> > colors
+    = GraphColoring::make_graph_coloring
+      (local_dof_indices.begin(), local_dof_indices.end(),
+       static_cast<std_cxx11::function<std::vector<types::global_dof_index> (const index_iterator &)> >
+       (std_cxx11::bind(&get_conflict_indices,
+                        std_cxx11::cref(conflicts),
+                        local_dof_indices.begin(),
+                        std_cxx11::_1)));
+
+  batch.colors.resize (colors.size());
+  for (unsigned int c=0; c<colors.size(); ++c)
+    {
+      batch.colors[c].resize (colors[c].size());
+      for (unsigned int i=0; i<colors[c].size(); ++i)
+        batch.colors[c][i] = colors[c][i] - local_dof_indices.begin();
+    }
+}
+
+
+
 void
 ConstraintMatrix::resolve_indices (std::vector<types::global_dof_index> &indices) const
 {
@@ -1253,7 +1324,8 @@ PARALLEL_VECTOR_FUNCTIONS(TrilinosWrappers::MPI::BlockVector);
                                                       MatrixType                      &, \
                                                       VectorType                      &, \
                                                       bool                             , \
-                                                      internal::bool2type<false>) const
+                                                      internal::bool2type<false>, \
+                                                      const std::vector<ConstraintMatrix::size_type> *) const
 #define MATRIX_FUNCTIONS(MatrixType) \
   template void ConstraintMatrix:: \
   distribute_local_to_global<MatrixType,Vector<MatrixType::value_type> > (const FullMatrix<MatrixType::value_type>        &, \
@@ -1262,7 +1334,8 @@ PARALLEL_VECTOR_FUNCTIONS(TrilinosWrappers::MPI::BlockVector);
       MatrixType                      &, \
       Vector<MatrixType::value_type>                  &, \
       bool                             , \
-      internal::bool2type<false>) const
+      internal::bool2type<false>, \
+      const std::vector<ConstraintMatrix::size_type> *) const
 #define BLOCK_MATRIX_VECTOR_FUNCTIONS(MatrixType, VectorType)   \
   template void ConstraintMatrix:: \
   distribute_local_to_global<MatrixType,VectorType > (const FullMatrix<MatrixType::value_type>        &, \
@@ -1271,7 +1344,8 @@ PARALLEL_VECTOR_FUNCTIONS(TrilinosWrappers::MPI::BlockVector);
                                                       MatrixType                      &, \
                                                       VectorType                      &, \
                                                       bool                             , \
-                                                      internal::bool2type<true>) const
+                                                      internal::bool2type<true>, \
+                                                      const std::vector<ConstraintMatrix::size_type> *) const
 #define BLOCK_MATRIX_FUNCTIONS(MatrixType)      \
   template void ConstraintMatrix:: \
   distribute_local_to_global<MatrixType,Vector<MatrixType::value_type> > (const FullMatrix<MatrixType::value_type>        &, \
@@ -1280,7 +1354,8 @@ PARALLEL_VECTOR_FUNCTIONS(TrilinosWrappers::MPI::BlockVector);
       MatrixType                      &, \
       Vector<MatrixType::value_type>                  &, \
       bool                             , \
-      internal::bool2type<true>) const
+      internal::bool2type<true>, \
+      const std::vector<ConstraintMatrix::size_type> *) const
 
 MATRIX_FUNCTIONS(SparseMatrix<double>);
 MATRIX_FUNCTIONS(SparseMatrix<float>);
@@ -1322,6 +1397,31 @@ BLOCK_MATRIX_VECTOR_FUNCTIONS(TrilinosWrappers::BlockSparseMatrix, TrilinosWrapp
 #endif
 
 
+// the batched version is only provided for matrices and vectors that allow
+// for simultaneous access to different rows
+#define BATCH_MATRIX_VECTOR_FUNCTIONS(MatrixType, VectorType) \
+  template void ConstraintMatrix:: \
+  distribute_local_to_global<MatrixType,VectorType > (const std::vector<FullMatrix<MatrixType::value_type> > &, \
+                                                      const std::vector<Vector<VectorType::value_type> >     &, \
+                                                      const std::vector<std::vector<ConstraintMatrix::size_type> > &, \
+                                                      MatrixType                      &, \
+                                                      VectorType                      &, \
+                                                      bool                             ) const; \
+  template void ConstraintMatrix:: \
+  distribute_local_to_global<MatrixType,VectorType > (const std::vector<FullMatrix<MatrixType::value_type> > &, \
+                                                      const std::vector<Vector<VectorType::value_type> >     &, \
+                                                      const std::vector<std::vector<ConstraintMatrix::size_type> > &, \
+                                                      const ConstraintMatrix::LocalToGlobalBatch &, \
+                                                      MatrixType                      &, \
+                                                      VectorType                      &, \
+                                                      bool                             ) const
+
+BATCH_MATRIX_VECTOR_FUNCTIONS(SparseMatrix<double>, Vector<double>);
+BATCH_MATRIX_VECTOR_FUNCTIONS(SparseMatrix<float>, Vector<float>);
+BATCH_MATRIX_VECTOR_FUNCTIONS(BlockSparseMatrix<double>, BlockVector<double>);
+BATCH_MATRIX_VECTOR_FUNCTIONS(BlockSparseMatrix<float>, BlockVector<float>);
+
+
 #define SPARSITY_FUNCTIONS(SparsityType) \
   template void ConstraintMatrix::add_entries_local_to_global<SparsityType> (\
       const std::vector<ConstraintMatrix::size_type> &, \
@@ -1351,6 +1451,7 @@ BLOCK_MATRIX_VECTOR_FUNCTIONS(TrilinosWrappers::BlockSparseMatrix, TrilinosWrapp
 
 SPARSITY_FUNCTIONS(SparsityPattern);
 SPARSITY_FUNCTIONS(DynamicSparsityPattern);
+SPARSITY_FUNCTIONS(SparsityPatternBuilder);
 BLOCK_SPARSITY_FUNCTIONS(BlockSparsityPattern);
 BLOCK_SPARSITY_FUNCTIONS(BlockDynamicSparsityPattern);
 
@@ -20,6 +20,9 @@
 #include <deal.II/lac/sparsity_tools.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern_builder.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
 
 #include <iostream>
 #include <iomanip>
@@ -523,6 +526,47 @@ SparsityPattern::copy_from (const DSP &dsp)
 
 
 
+void
+SparsityPattern::copy_from (SparsityPatternBuilder &builder)
+{
+  const bool do_diag_optimize = (builder.n_rows() == builder.n_cols());
+  std::vector<std::vector<SparsityPatternBuilder::entry_type> >
+  merged_buckets (builder.n_buckets);
+  std::vector<unsigned int> row_lengths (builder.n_rows());
+
+  // first merge the lists of all threads and count the entries in each row,
+  // then allocate the memory and finally write the column indices
+  parallel::apply_to_subranges (0U, builder.n_buckets,
+                                std_cxx11::bind (&SparsityPatternBuilder::merge_buckets,
+                                                 std_cxx11::ref(builder),
+                                                 std_cxx11::_1,
+                                                 std_cxx11::_2,
+                                                 do_diag_optimize,
+                                                 std_cxx11::ref(merged_buckets),
+                                                 std_cxx11::ref(row_lengths)),
+                                1);
+
+  reinit (builder.n_rows(), builder.n_cols(), row_lengths);
+
+  if (n_rows() != 0 && n_cols() != 0)
+    parallel::apply_to_subranges (0U, builder.n_buckets,
+                                  std_cxx11::bind (&SparsityPatternBuilder::fill_columns,
+                                                   std_cxx11::cref(builder),
+                                                   std_cxx11::_1,
+                                                   std_cxx11::_2,
+                                                   store_diagonal_first_in_row,
+                                                   std_cxx11::ref(merged_buckets),
+                                                   rowstart,
+                                                   colnums),
+                                  1);
+
+  // the rows are sorted and have exactly the right length, so there is no
+  // need to compress
+  compressed = true;
+}
+
+
+
 template <typename number>
 void SparsityPattern::copy_from (const FullMatrix<number> &matrix)
 {
@@ -0,0 +1,239 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/sparsity_pattern_builder.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/multithread_info.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+SparsityPatternBuilder::SparsityPatternBuilder ()
+  :
+  rows (0),
+  cols (0),
+  rows_per_bucket (1),
+  n_buckets (0),
+  column_bits (0)
+{}
+
+
+
+SparsityPatternBuilder::SparsityPatternBuilder (const size_type m,
+                                                const size_type n)
+  :
+  rows (0),
+  cols (0),
+  rows_per_bucket (1),
+  n_buckets (0),
+  column_bits (0)
+{
+  reinit (m, n);
+}
+
+
+
+void
+SparsityPatternBuilder::reinit (const size_type m,
+                                const size_type n)
+{
+  rows = m;
+  cols = n;
+
+  // use enough buckets to give each thread several of them when merging
+  // the buckets, but keep the buckets large enough to make the lists of
+  // each thread worth their overhead
+  const size_type n_desired_buckets = 16 * MultithreadInfo::n_threads();
+  rows_per_bucket = std::max<size_type> (256,
+                                         (rows + n_desired_buckets - 1) /
+                                         n_desired_buckets);
+
+  // an entry holds the column index in the lowest bits and the row within
+  // the bucket above, so the number of rows per bucket is limited by the
+  // bits left over by the columns
+  column_bits = 0;
+  while (column_bits < 64 && (static_cast<entry_type>(1) << column_bits) < cols)
+    ++column_bits;
+  const unsigned int row_bits = 64 - column_bits;
+  if (row_bits < 64 && rows_per_bucket > (static_cast<entry_type>(1) << row_bits))
+    rows_per_bucket = static_cast<size_type>(static_cast<entry_type>(1) << row_bits);
+  AssertThrow (rows_per_bucket > 0 && (rows == 0 || row_bits > 0),
+               ExcMessage ("The number of columns is too large to be stored "
+                           "in a SparsityPatternBuilder."));
+  n_buckets = (rows + rows_per_bucket - 1) / rows_per_bucket;
+
+  thread_data.clear ();
+}
+
+
+
+void
+SparsityPatternBuilder::compress_bucket_if_necessary (const size_type row)
+{
+  ThreadData &data = thread_data.get();
+  const unsigned int bucket = row / rows_per_bucket;
+  std::vector<entry_type> &entries = data.buckets[bucket];
+
+  // sort the list when it has doubled its size since the last time, such
+  // that the cost for sorting is proportional to the number of added
+  // entries times a logarithmic factor
+  if (entries.size() > 2*data.compressed_sizes[bucket] + 1024)
+    {
+      std::sort (entries.begin(), entries.end());
+      entries.erase (std::unique (entries.begin(), entries.end()),
+                     entries.end());
+      data.compressed_sizes[bucket] = entries.size();
+    }
+}
+
+
+
+void
+SparsityPatternBuilder::merge_buckets (const unsigned int begin,
+                                       const unsigned int end,
+                                       const bool         add_diagonal,
+                                       std::vector<std::vector<entry_type> > &merged_buckets,
+                                       std::vector<unsigned int> &row_lengths)
+{
+#ifdef DEAL_II_WITH_THREADS
+  typedef tbb::enumerable_thread_specific<ThreadData> ThreadDataStorage;
+  ThreadDataStorage &all_data = thread_data.get_implementation();
+#endif
+  const entry_type column_mask = (column_bits < 64 ?
+                                  (static_cast<entry_type>(1) << column_bits) - 1 :
+                                  ~static_cast<entry_type>(0));
+
+  for (unsigned int bucket=begin; bucket<end; ++bucket)
+    {
+      std::vector<entry_type> &entries = merged_buckets[bucket];
+      entries.clear ();
+
+      // append the list of each thread and release its memory right away,
+      // such that the memory of the lists of all threads and of the merged
+      // lists is not held at the same time
+#ifdef DEAL_II_WITH_THREADS
+      for (ThreadDataStorage::iterator data = all_data.begin();
+           data != all_data.end(); ++data)
+        if (data->buckets.size() == n_buckets)
+          {
+            entries.insert (entries.end(), data->buckets[bucket].begin(),
+                            data->buckets[bucket].end());
+            std::vector<entry_type>().swap (data->buckets[bucket]);
+            data->compressed_sizes[bucket] = 0;
+          }
+#else
+      ThreadData &data = thread_data.get_implementation();
+      if (data.buckets.size() == n_buckets)
+        {
+          entries.insert (entries.end(), data.buckets[bucket].begin(),
+                          data.buckets[bucket].end());
+          std::vector<entry_type>().swap (data.buckets[bucket]);
+          data.compressed_sizes[bucket] = 0;
+        }
+#endif
+
+      std::sort (entries.begin(), entries.end());
+      entries.erase (std::unique (entries.begin(), entries.end()),
+                     entries.end());
+
+      // count the entries in each row of this bucket. the rows of different
+      // buckets are disjoint, so no two threads write to the same element
+      const size_type first_row = bucket * rows_per_bucket;
+      const size_type last_row = std::min (rows, first_row + rows_per_bucket);
+      for (size_type row=first_row; row<last_row; ++row)
+        row_lengths[row] = 0;
+      for (std::size_t i=0; i<entries.size(); ++i)
+        ++row_lengths[first_row + (entries[i] >> column_bits)];
+      if (add_diagonal)
+        {
+          std::size_t i = 0;
+          for (size_type row=first_row; row<last_row; ++row)
+            {
+              bool has_diagonal = false;
+              for ( ; i<entries.size() &&
+                    first_row + (entries[i] >> column_bits) == row; ++i)
+                if ((entries[i] & column_mask) == row)
+                  has_diagonal = true;
+              if (has_diagonal == false)
+                ++row_lengths[row];
+            }
+        }
+    }
+}
+
+
+
+void
+SparsityPatternBuilder::fill_columns (const unsigned int begin,
+                                      const unsigned int end,
+                                      const bool         store_diagonal_first_in_row,
+                                      std::vector<std::vector<entry_type> > &merged_buckets,
+                                      const std::size_t *rowstart,
+                                      size_type         *colnums) const
+{
+  const entry_type column_mask = (column_bits < 64 ?
+                                  (static_cast<entry_type>(1) << column_bits) - 1 :
+                                  ~static_cast<entry_type>(0));
+
+  // in case the diagonal is stored first, it has already been set by
+  // SparsityPattern::reinit() and we skip it here
+  for (unsigned int bucket=begin; bucket<end; ++bucket)
+    {
+      const std::vector<entry_type> &entries = merged_buckets[bucket];
+      const size_type first_row = bucket * rows_per_bucket;
+      std::size_t i = 0;
+      while (i < entries.size())
+        {
+          const size_type row = first_row + (entries[i] >> column_bits);
+          size_type *cols = colnums + rowstart[row] +
+                            (store_diagonal_first_in_row ? 1 : 0);
+          for ( ; i<entries.size() &&
+                first_row + (entries[i] >> column_bits) == row; ++i)
+            {
+              const size_type col = entries[i] & column_mask;
+              if (!store_diagonal_first_in_row || col != row)
+                *cols++ = col;
+            }
+          Assert (cols == colnums + rowstart[row+1], ExcInternalError());
+        }
+      std::vector<entry_type>().swap (merged_buckets[bucket]);
+    }
+}
+
+
+
+std::size_t
+SparsityPatternBuilder::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+#ifdef DEAL_II_WITH_THREADS
+  typedef tbb::enumerable_thread_specific<ThreadData> ThreadDataStorage;
+  ThreadDataStorage &all_data = thread_data.get_implementation();
+  for (ThreadDataStorage::const_iterator data = all_data.begin();
+       data != all_data.end(); ++data)
+    memory += MemoryConsumption::memory_consumption (data->buckets) +
+              MemoryConsumption::memory_consumption (data->compressed_sizes);
+#else
+  const ThreadData &data = thread_data.get_implementation();
+  memory += MemoryConsumption::memory_consumption (data.buckets) +
+            MemoryConsumption::memory_consumption (data.compressed_sizes);
+#endif
+  return memory;
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
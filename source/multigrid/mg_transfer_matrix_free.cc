@@ -0,0 +1,708 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_poly.h>
+#include <deal.II/base/tensor_product_polynomials.h>
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/multigrid/mg_transfer_internal.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // copies the locally owned part of a vector into a vector with possibly
+  // different ghost layout
+  template <typename Number, typename Number2>
+  void copy_locally_owned (parallel::distributed::Vector<Number>        &dst,
+                           const parallel::distributed::Vector<Number2> &src)
+  {
+    AssertDimension (dst.local_size(), src.local_size());
+    for (unsigned int i=0; i<dst.local_size(); ++i)
+      dst.local_element(i) = src.local_element(i);
+  }
+}
+
+
+
+template <int dim, typename Number>
+MGTransferMatrixFree<dim,Number>::MGTransferMatrixFree ()
+  :
+  fe_degree (0),
+  element_is_continuous (false),
+  n_components (0),
+  n_child_dofs_1d (0)
+{}
+
+
+
+template <int dim, typename Number>
+MGTransferMatrixFree<dim,Number>::MGTransferMatrixFree (const MGConstrainedDoFs &mg_c)
+  :
+  fe_degree (0),
+  element_is_continuous (false),
+  n_components (0),
+  n_child_dofs_1d (0),
+  mg_constrained_dofs (&mg_c)
+{}
+
+
+
+template <int dim, typename Number>
+MGTransferMatrixFree<dim,Number>::~MGTransferMatrixFree ()
+{}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>::initialize_constraints
+(const MGConstrainedDoFs &mg_c)
+{
+  mg_constrained_dofs = &mg_c;
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>::clear ()
+{
+  fe_degree = 0;
+  element_is_continuous = false;
+  n_components = 0;
+  n_child_dofs_1d = 0;
+  prolongation_matrix_1d.clear();
+  n_parent_cells.clear();
+  parent_dof_indices.clear();
+  child_dof_indices.clear();
+  weights_on_refined.resize(0, 0);
+  vector_partitioners.clear();
+  ghosted_level_vector.resize(0, 0);
+  copy_indices.clear();
+  copy_indices_global_mine.clear();
+  copy_indices_level_mine.clear();
+  mg_constrained_dofs = 0;
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>::build
+(const DoFHandler<dim,dim>  &mg_dof)
+{
+  const FiniteElement<dim> &fe = mg_dof.get_fe();
+  AssertThrow (fe.n_base_elements() == 1,
+               ExcElementNotSupported(fe.get_name()));
+  const FiniteElement<dim> &base = fe.base_element(0);
+  AssertThrow ((dynamic_cast<const FE_Poly<TensorProductPolynomials<dim>,dim,dim>*>
+                (&base) != 0 && base.degree <= 8),
+               ExcElementNotSupported(fe.get_name()));
+
+  fe_degree = base.degree;
+  element_is_continuous = base.dofs_per_vertex > 0;
+  n_components = fe.n_components();
+  n_child_dofs_1d = element_is_continuous ? 2*fe_degree+1 : 2*fe_degree+2;
+
+  // the lexicographic numbering of the element is the same as used in
+  // FEEvaluation, i.e., with all dofs of the first component first
+  internal::MatrixFreeFunctions::ShapeInfo<Number> shape_info;
+  shape_info.reinit (QGauss<1>(1), fe);
+  const std::vector<unsigned int> &lexicographic = shape_info.lexicographic_numbering;
+  const unsigned int n_scalar_dofs = Utilities::fixed_power<dim>(fe_degree+1);
+  AssertDimension (lexicographic.size(), n_scalar_dofs*n_components);
+  std::vector<unsigned int> scalar_lexicographic (n_scalar_dofs);
+  for (unsigned int i=0; i<n_scalar_dofs; ++i)
+    scalar_lexicographic[i] = fe.system_to_base_index(lexicographic[i]).second;
+
+  // extract the one-dimensional embedding matrix from the embedding of the
+  // first two children that are adjacent in x-direction, evaluated along
+  // the line y=z=0. this assumes that the first one-dimensional shape
+  // function is one at zero, as does ShapeInfo
+  {
+    const unsigned int shift = element_is_continuous ? fe_degree : fe_degree+1;
+    prolongation_matrix_1d.resize ((fe_degree+1)*n_child_dofs_1d);
+    for (unsigned int c=0; c<2; ++c)
+      {
+        const FullMatrix<double> &prolongation = base.get_prolongation_matrix (c);
+        AssertThrow (prolongation.n() != 0, ExcElementNotSupported(fe.get_name()));
+        for (unsigned int i=0; i<=fe_degree; ++i)
+          for (unsigned int j=0; j<=fe_degree; ++j)
+            prolongation_matrix_1d[j*n_child_dofs_1d+c*shift+i] =
+              prolongation(scalar_lexicographic[i], scalar_lexicographic[j]);
+      }
+    AssertThrow (std::abs(base.get_prolongation_matrix(0)(scalar_lexicographic[0],
+                                                           scalar_lexicographic[0]) - 1.)
+                 < 1e-12, ExcElementNotSupported(fe.get_name()));
+  }
+
+  const unsigned int n_levels = mg_dof.get_tria().n_global_levels();
+  const unsigned int n_parent_dofs = n_scalar_dofs * n_components;
+  const unsigned int n_child_dofs = Utilities::fixed_power<dim>(n_child_dofs_1d) *
+                                    n_components;
+  const types::subdomain_id my_subdomain = mg_dof.get_tria().locally_owned_subdomain();
+  const parallel::Triangulation<dim,dim> *tria =
+    dynamic_cast<const parallel::Triangulation<dim,dim>*>(&mg_dof.get_tria());
+  const MPI_Comm communicator = tria != 0 ? tria->get_communicator() : MPI_COMM_SELF;
+
+  // collect the global indices of parents and children level by level
+  std::vector<std::vector<types::global_dof_index> > parent_global (n_levels),
+      child_global (n_levels);
+  n_parent_cells.clear();
+  n_parent_cells.resize (n_levels, 0);
+  std::vector<types::global_dof_index> local_dof_indices (fe.dofs_per_cell);
+  for (unsigned int level=0; level+1<n_levels; ++level)
+    for (typename DoFHandler<dim>::cell_iterator cell=mg_dof.begin(level);
+         cell != mg_dof.end(level); ++cell)
+      if (cell->has_children() &&
+          (my_subdomain == numbers::invalid_subdomain_id ||
+           cell->child(0)->level_subdomain_id() == my_subdomain))
+        {
+          // each parent is worked on by exactly one process, namely the one
+          // owning its first child on the finer level. that process holds
+          // the level dofs of all the children, since the siblings share a
+          // vertex with the first child and are thus at least level ghosts.
+          // the contributions to child dofs owned by other processes are
+          // sent to the owners by the compress operation of the level vector
+          AssertThrow (cell->n_children() == GeometryInfo<dim>::max_children_per_cell,
+                       ExcNotImplemented());
+          for (unsigned int child=0; child<cell->n_children(); ++child)
+            AssertThrow (cell->child(child)->level_subdomain_id() !=
+                         numbers::artificial_subdomain_id,
+                         ExcMessage ("The level dofs of all children of a cell "
+                                     "must be available on the process that owns "
+                                     "the first child."));
+          ++n_parent_cells[level];
+
+          cell->get_mg_dof_indices (local_dof_indices);
+          for (unsigned int i=0; i<n_parent_dofs; ++i)
+            {
+              const types::global_dof_index index = local_dof_indices[lexicographic[i]];
+              if (mg_constrained_dofs != 0 &&
+                  mg_constrained_dofs->set_boundary_values() &&
+                  mg_constrained_dofs->is_boundary_index(level, index))
+                parent_global[level].push_back (numbers::invalid_dof_index);
+              else
+                parent_global[level].push_back (index);
+            }
+
+          // the children are numbered lexicographically for isotropic
+          // refinement, so place their dofs on a tensor product patch
+          const std::size_t offset = child_global[level+1].size();
+          child_global[level+1].resize (offset + n_child_dofs);
+          const unsigned int shift = element_is_continuous ? fe_degree : fe_degree+1;
+          for (unsigned int child=0; child<cell->n_children(); ++child)
+            {
+              cell->child(child)->get_mg_dof_indices (local_dof_indices);
+              for (unsigned int c=0; c<n_components; ++c)
+                for (unsigned int i=0; i<n_scalar_dofs; ++i)
+                  {
+                    unsigned int patch_index = 0, stride = 1, index = i;
+                    for (unsigned int d=0; d<dim; ++d)
+                      {
+                        patch_index += stride * (((child>>d)&1)*shift + index%(fe_degree+1));
+                        index /= fe_degree+1;
+                        stride *= n_child_dofs_1d;
+                      }
+                    child_global[level+1][offset + c*(n_child_dofs/n_components) + patch_index]
+                      = local_dof_indices[lexicographic[c*n_scalar_dofs+i]];
+                  }
+            }
+        }
+
+  // set up the ghosted level vectors and translate to local indices
+  vector_partitioners.clear();
+  vector_partitioners.resize (n_levels);
+  ghosted_level_vector.resize (0, n_levels-1);
+  parent_dof_indices.clear();
+  parent_dof_indices.resize (n_levels);
+  child_dof_indices.clear();
+  child_dof_indices.resize (n_levels);
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      const IndexSet &owned = mg_dof.locally_owned_mg_dofs(level);
+      std::vector<types::global_dof_index> ghosts;
+      for (unsigned int i=0; i<parent_global[level].size(); ++i)
+        if (parent_global[level][i] != numbers::invalid_dof_index &&
+            !owned.is_element(parent_global[level][i]))
+          ghosts.push_back (parent_global[level][i]);
+      for (unsigned int i=0; i<child_global[level].size(); ++i)
+        if (!owned.is_element(child_global[level][i]))
+          ghosts.push_back (child_global[level][i]);
+      std::sort (ghosts.begin(), ghosts.end());
+      ghosts.erase (std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+      IndexSet ghost_set (mg_dof.n_dofs(level));
+      ghost_set.add_indices (ghosts.begin(), ghosts.end());
+
+      std_cxx11::shared_ptr<Utilities::MPI::Partitioner> partitioner
+      (new Utilities::MPI::Partitioner (owned, ghost_set, communicator));
+      vector_partitioners[level] = partitioner;
+      ghosted_level_vector[level].reinit (partitioner);
+
+      parent_dof_indices[level].resize (parent_global[level].size());
+      for (unsigned int i=0; i<parent_global[level].size(); ++i)
+        parent_dof_indices[level][i] =
+          parent_global[level][i] == numbers::invalid_dof_index ?
+          numbers::invalid_unsigned_int :
+          partitioner->global_to_local (parent_global[level][i]);
+      child_dof_indices[level].resize (child_global[level].size());
+      for (unsigned int i=0; i<child_global[level].size(); ++i)
+        child_dof_indices[level][i] =
+          partitioner->global_to_local (child_global[level][i]);
+    }
+
+  // for continuous elements, count how many parents share a dof
+  weights_on_refined.resize(0, 0);
+  if (element_is_continuous)
+    {
+      weights_on_refined.resize (0, n_levels-1);
+      for (unsigned int level=1; level<n_levels; ++level)
+        {
+          weights_on_refined[level].reinit (vector_partitioners[level]);
+          for (unsigned int i=0; i<child_dof_indices[level].size(); ++i)
+            weights_on_refined[level].local_element(child_dof_indices[level][i]) += 1.;
+          weights_on_refined[level].compress (VectorOperation::add);
+          for (unsigned int i=0; i<weights_on_refined[level].local_size(); ++i)
+            if (weights_on_refined[level].local_element(i) > 0)
+              weights_on_refined[level].local_element(i) =
+                1./weights_on_refined[level].local_element(i);
+          weights_on_refined[level].update_ghost_values();
+        }
+    }
+
+  internal::MGTransfer::fill_copy_indices (mg_dof, mg_constrained_dofs,
+                                           copy_indices,
+                                           copy_indices_global_mine,
+                                           copy_indices_level_mine);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::prolongate (const unsigned int                           to_level,
+              parallel::distributed::Vector<Number>       &dst,
+              const parallel::distributed::Vector<Number> &src) const
+{
+  Assert ((to_level >= 1) && (to_level<=ghosted_level_vector.max_level()),
+          ExcIndexRange (to_level, 1, ghosted_level_vector.max_level()+1));
+
+  copy_locally_owned (ghosted_level_vector[to_level-1], src);
+  ghosted_level_vector[to_level-1].update_ghost_values();
+  ghosted_level_vector[to_level] = 0.;
+
+  dispatch (true, to_level, ghosted_level_vector[to_level],
+            ghosted_level_vector[to_level-1]);
+
+  ghosted_level_vector[to_level].compress (VectorOperation::add);
+  copy_locally_owned (dst, ghosted_level_vector[to_level]);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::restrict_and_add (const unsigned int                           from_level,
+                    parallel::distributed::Vector<Number>       &dst,
+                    const parallel::distributed::Vector<Number> &src) const
+{
+  Assert ((from_level >= 1) && (from_level<=ghosted_level_vector.max_level()),
+          ExcIndexRange (from_level, 1, ghosted_level_vector.max_level()+1));
+
+  copy_locally_owned (ghosted_level_vector[from_level], src);
+  ghosted_level_vector[from_level].update_ghost_values();
+  ghosted_level_vector[from_level-1] = 0.;
+
+  dispatch (false, from_level, ghosted_level_vector[from_level-1],
+            ghosted_level_vector[from_level]);
+
+  ghosted_level_vector[from_level-1].compress (VectorOperation::add);
+  AssertDimension (dst.local_size(), ghosted_level_vector[from_level-1].local_size());
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += ghosted_level_vector[from_level-1].local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferMatrixFree<dim,Number>
+::dispatch (const bool                                    prolongate,
+            const unsigned int                            level,
+            parallel::distributed::Vector<Number>       &dst,
+            const parallel::distributed::Vector<Number> &src) const
+{
+  if (element_is_continuous)
+    switch (fe_degree)
+      {
+      case 1:
+        prolongate ? do_prolongate_add<1,3>(level, dst, src) : do_restrict_add<1,3>(level, dst, src);
+        break;
+      case 2:
+        prolongate ? do_prolongate_add<2,5>(level, dst, src) : do_restrict_add<2,5>(level, dst, src);
+        break;
+      case 3:
+        prolongate ? do_prolongate_add<3,7>(level, dst, src) : do_restrict_add<3,7>(level, dst, src);
+        break;
+      case 4:
+        prolongate ? do_prolongate_add<4,9>(level, dst, src) : do_restrict_add<4,9>(level, dst, src);
+        break;
+      case 5:
+        prolongate ? do_prolongate_add<5,11>(level, dst, src) : do_restrict_add<5,11>(level, dst, src);
+        break;
+      case 6:
+        prolongate ? do_prolongate_add<6,13>(level, dst, src) : do_restrict_add<6,13>(level, dst, src);
+        break;
+      case 7:
+        prolongate ? do_prolongate_add<7,15>(level, dst, src) : do_restrict_add<7,15>(level, dst, src);
+        break;
+      case 8:
+        prolongate ? do_prolongate_add<8,17>(level, dst, src) : do_restrict_add<8,17>(level, dst, src);
+        break;
+      default:
+        AssertThrow (false, ExcNotImplemented());
+      }
+  else
+    switch (fe_degree)
+      {
+      case 0:
+        prolongate ? do_prolongate_add<0,2>(level, dst, src) : do_restrict_add<0,2>(level, dst, src);
+        break;
+      case 1:
+        prolongate ? do_prolongate_add<1,4>(level, dst, src) : do_restrict_add<1,4>(level, dst, src);
+        break;
+      case 2:
+        prolongate ? do_prolongate_add<2,6>(level, dst, src) : do_restrict_add<2,6>(level, dst, src);
+        break;
+      case 3:
+        prolongate ? do_prolongate_add<3,8>(level, dst, src) : do_restrict_add<3,8>(level, dst, src);
+        break;
+      case 4:
+        prolongate ? do_prolongate_add<4,10>(level, dst, src) : do_restrict_add<4,10>(level, dst, src);
+        break;
+      case 5:
+        prolongate ? do_prolongate_add<5,12>(level, dst, src) : do_restrict_add<5,12>(level, dst, src);
+        break;
+      case 6:
+        prolongate ? do_prolongate_add<6,14>(level, dst, src) : do_restrict_add<6,14>(level, dst, src);
+        break;
+      case 7:
+        prolongate ? do_prolongate_add<7,16>(level, dst, src) : do_restrict_add<7,16>(level, dst, src);
+        break;
+      case 8:
+        prolongate ? do_prolongate_add<8,18>(level, dst, src) : do_restrict_add<8,18>(level, dst, src);
+        break;
+      default:
+        AssertThrow (false, ExcNotImplemented());
+      }
+}
+
+
+
+template <int dim, typename Number>
+template <int degree, int n_child_dofs_1d_>
+void MGTransferMatrixFree<dim,Number>
+::do_prolongate_add (const unsigned int                           to_level,
+                     parallel::distributed::Vector<Number>       &dst,
+                     const parallel::distributed::Vector<Number> &src) const
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_scalar_parent = Utilities::fixed_int_power<degree+1,dim>::value;
+  const unsigned int n_scalar_child = Utilities::fixed_int_power<n_child_dofs_1d_,dim>::value;
+  const unsigned int n_parent_dofs = n_scalar_parent * n_components;
+  const unsigned int n_child_dofs = n_scalar_child * n_components;
+  const unsigned int n_parents = n_parent_cells[to_level-1];
+  const std::vector<unsigned int> &parent_indices = parent_dof_indices[to_level-1];
+  const std::vector<unsigned int> &child_indices = child_dof_indices[to_level];
+
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,
+          n_child_dofs_1d_,VectorizedArray<Number> > Evaluator;
+  const VectorizedArray<Number> *shape = prolongation_matrix_1d.begin();
+
+  AlignedVector<VectorizedArray<Number> > evaluation_data (n_scalar_parent + 2*n_scalar_child);
+  VectorizedArray<Number> *parent_values = evaluation_data.begin();
+  VectorizedArray<Number> *child_values = parent_values + n_scalar_parent;
+  VectorizedArray<Number> *tmp = child_values + n_scalar_child;
+
+  for (unsigned int cell=0; cell<n_parents; cell += n_lanes)
+    {
+      const unsigned int n_filled = std::min (n_lanes, n_parents-cell);
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          // read the values of the parent cells in all lanes
+          for (unsigned int i=0; i<n_scalar_parent; ++i)
+            for (unsigned int v=0; v<n_lanes; ++v)
+              {
+                const unsigned int index = v < n_filled ?
+                                           parent_indices[(cell+v)*n_parent_dofs +
+                                                          c*n_scalar_parent + i] :
+                                           numbers::invalid_unsigned_int;
+                parent_values[i][v] = index == numbers::invalid_unsigned_int ?
+                                      Number() : src.local_element(index);
+              }
+
+          // apply the one-dimensional embedding in all directions
+          if (dim == 1)
+            Evaluator::template apply<0,true,false>(shape, parent_values, child_values);
+          else if (dim == 2)
+            {
+              Evaluator::template apply<0,true,false>(shape, parent_values, tmp);
+              Evaluator::template apply<1,true,false>(shape, tmp, child_values);
+            }
+          else
+            {
+              Evaluator::template apply<0,true,false>(shape, parent_values, child_values);
+              Evaluator::template apply<1,true,false>(shape, child_values, tmp);
+              Evaluator::template apply<2,true,false>(shape, tmp, child_values);
+            }
+
+          // add into the fine vector, weighting dofs that are shared between
+          // several parents
+          for (unsigned int i=0; i<n_scalar_child; ++i)
+            for (unsigned int v=0; v<n_filled; ++v)
+              {
+                const unsigned int index =
+                  child_indices[(cell+v)*n_child_dofs + c*n_scalar_child + i];
+                if (element_is_continuous)
+                  dst.local_element(index) += child_values[i][v] *
+                                              weights_on_refined[to_level].local_element(index);
+                else
+                  dst.local_element(index) += child_values[i][v];
+              }
+        }
+    }
+}
+
+
+
+template <int dim, typename Number>
+template <int degree, int n_child_dofs_1d_>
+void MGTransferMatrixFree<dim,Number>
+::do_restrict_add (const unsigned int                           from_level,
+                   parallel::distributed::Vector<Number>       &dst,
+                   const parallel::distributed::Vector<Number> &src) const
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_scalar_parent = Utilities::fixed_int_power<degree+1,dim>::value;
+  const unsigned int n_scalar_child = Utilities::fixed_int_power<n_child_dofs_1d_,dim>::value;
+  const unsigned int n_parent_dofs = n_scalar_parent * n_components;
+  const unsigned int n_child_dofs = n_scalar_child * n_components;
+  const unsigned int n_parents = n_parent_cells[from_level-1];
+  const std::vector<unsigned int> &parent_indices = parent_dof_indices[from_level-1];
+  const std::vector<unsigned int> &child_indices = child_dof_indices[from_level];
+
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,
+          n_child_dofs_1d_,VectorizedArray<Number> > Evaluator;
+  const VectorizedArray<Number> *shape = prolongation_matrix_1d.begin();
+
+  AlignedVector<VectorizedArray<Number> > evaluation_data (n_scalar_parent + 2*n_scalar_child);
+  VectorizedArray<Number> *parent_values = evaluation_data.begin();
+  VectorizedArray<Number> *child_values = parent_values + n_scalar_parent;
+  VectorizedArray<Number> *tmp = child_values + n_scalar_child;
+
+  for (unsigned int cell=0; cell<n_parents; cell += n_lanes)
+    {
+      const unsigned int n_filled = std::min (n_lanes, n_parents-cell);
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          // read the values on the children, weighting dofs that are shared
+          // between several parents
+          for (unsigned int i=0; i<n_scalar_child; ++i)
+            for (unsigned int v=0; v<n_lanes; ++v)
+              if (v < n_filled)
+                {
+                  const unsigned int index =
+                    child_indices[(cell+v)*n_child_dofs + c*n_scalar_child + i];
+                  if (element_is_continuous)
+                    child_values[i][v] = src.local_element(index) *
+                                         weights_on_refined[from_level].local_element(index);
+                  else
+                    child_values[i][v] = src.local_element(index);
+                }
+              else
+                child_values[i][v] = Number();
+
+          // apply the transpose of the one-dimensional embedding in all
+          // directions
+          if (dim == 1)
+            Evaluator::template apply<0,false,false>(shape, child_values, parent_values);
+          else if (dim == 2)
+            {
+              Evaluator::template apply<0,false,false>(shape, child_values, tmp);
+              Evaluator::template apply<1,false,false>(shape, tmp, parent_values);
+            }
+          else
+            {
+              Evaluator::template apply<0,false,false>(shape, child_values, tmp);
+              Evaluator::template apply<1,false,false>(shape, tmp, child_values);
+              Evaluator::template apply<2,false,false>(shape, child_values, parent_values);
+            }
+
+          for (unsigned int i=0; i<n_scalar_parent; ++i)
+            for (unsigned int v=0; v<n_filled; ++v)
+              {
+                const unsigned int index = parent_indices[(cell+v)*n_parent_dofs +
+                                                          c*n_scalar_parent + i];
+                if (index != numbers::invalid_unsigned_int)
+                  dst.local_element(index) += parent_values[i][v];
+              }
+        }
+    }
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferMatrixFree<dim,Number>::copy_to_mg
+(const DoFHandler<dim,dim>                            &mg_dof_handler,
+ MGLevelObject<parallel::distributed::Vector<Number> > &dst,
+ const parallel::distributed::Vector<Number2>          &src) const
+{
+  const parallel::Triangulation<dim,dim> *tria =
+    dynamic_cast<const parallel::Triangulation<dim,dim>*>(&mg_dof_handler.get_tria());
+  for (unsigned int level=dst.min_level(); level<=dst.max_level(); ++level)
+    {
+      const IndexSet vector_index_set = dst[level].locally_owned_elements();
+      if (vector_index_set.size() != mg_dof_handler.locally_owned_mg_dofs(level).size() ||
+          mg_dof_handler.locally_owned_mg_dofs(level) != vector_index_set)
+        dst[level].reinit(mg_dof_handler.locally_owned_mg_dofs(level), tria != 0 ?
+                          tria->get_communicator() : MPI_COMM_SELF);
+      else
+        dst[level] = 0.;
+    }
+
+  typedef std::vector<std::pair<types::global_dof_index, types::global_dof_index> >::const_iterator dof_pair_iterator;
+  bool first = true;
+  for (unsigned int level=mg_dof_handler.get_tria().n_global_levels(); level != 0;)
+    {
+      --level;
+      parallel::distributed::Vector<Number> &dst_level = dst[level];
+
+      // first copy local unknowns
+      for (dof_pair_iterator i= copy_indices[level].begin();
+           i != copy_indices[level].end(); ++i)
+        dst_level(i->second) = src(i->first);
+
+      // Do the same for the indices where the global index is local, but the
+      // local index is not
+      for (dof_pair_iterator i= copy_indices_global_mine[level].begin();
+           i != copy_indices_global_mine[level].end(); ++i)
+        dst_level(i->second) = src(i->first);
+
+      dst_level.compress(VectorOperation::insert);
+
+      if (!first)
+        restrict_and_add (level+1, dst[level], dst[level+1]);
+
+      first = false;
+    }
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferMatrixFree<dim,Number>::copy_from_mg
+(const DoFHandler<dim,dim>                                  &mg_dof_handler,
+ parallel::distributed::Vector<Number2>                     &dst,
+ const MGLevelObject<parallel::distributed::Vector<Number> > &src) const
+{
+  typedef std::vector<std::pair<types::global_dof_index, types::global_dof_index> >::const_iterator dof_pair_iterator;
+  dst = 0;
+  for (unsigned int level=0; level<mg_dof_handler.get_tria().n_global_levels(); ++level)
+    {
+      // First copy all indices local to this process
+      for (dof_pair_iterator i= copy_indices[level].begin();
+           i != copy_indices[level].end(); ++i)
+        dst(i->first) = src[level](i->second);
+
+      // Do the same for the indices where the level index is local, but the
+      // global index is not
+      for (dof_pair_iterator i= copy_indices_level_mine[level].begin();
+           i != copy_indices_level_mine[level].end(); ++i)
+        dst(i->first) = src[level](i->second);
+    }
+  dst.compress(VectorOperation::insert);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferMatrixFree<dim,Number>::copy_from_mg_add
+(const DoFHandler<dim,dim>                                  &mg_dof_handler,
+ parallel::distributed::Vector<Number2>                     &dst,
+ const MGLevelObject<parallel::distributed::Vector<Number> > &src) const
+{
+  typedef std::vector<std::pair<types::global_dof_index, types::global_dof_index> >::const_iterator dof_pair_iterator;
+  for (unsigned int level=0; level<mg_dof_handler.get_tria().n_global_levels(); ++level)
+    {
+      // First add all indices local to this process
+      for (dof_pair_iterator i= copy_indices[level].begin();
+           i != copy_indices[level].end(); ++i)
+        dst(i->first) += src[level](i->second);
+
+      // Do the same for the indices where the level index is local, but the
+      // global index is not
+      for (dof_pair_iterator i= copy_indices_level_mine[level].begin();
+           i != copy_indices_level_mine[level].end(); ++i)
+        dst(i->first) += src[level](i->second);
+    }
+  dst.compress(VectorOperation::add);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferMatrixFree<dim,Number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  memory += MemoryConsumption::memory_consumption(prolongation_matrix_1d);
+  memory += MemoryConsumption::memory_consumption(n_parent_cells);
+  memory += MemoryConsumption::memory_consumption(parent_dof_indices);
+  memory += MemoryConsumption::memory_consumption(child_dof_indices);
+  for (unsigned int level=weights_on_refined.min_level();
+       level<=weights_on_refined.max_level(); ++level)
+    memory += weights_on_refined[level].memory_consumption();
+  for (unsigned int level=ghosted_level_vector.min_level();
+       level<=ghosted_level_vector.max_level(); ++level)
+    memory += ghosted_level_vector[level].memory_consumption();
+  memory += MemoryConsumption::memory_consumption(copy_indices);
+  memory += MemoryConsumption::memory_consumption(copy_indices_global_mine);
+  memory += MemoryConsumption::memory_consumption(copy_indices_level_mine);
+  return memory;
+}
+
+
+// explicit instantiation
+#include "mg_transfer_matrix_free.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,158 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// write records with parallel::distributed::CellDataFile on some of the
+// processors and read them back on a different number of processors with a
+// different distribution of the records. the blocks are small, so that the
+// ranges of the processors reading the file start and end in the middle of
+// blocks written by other processors
+
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/cell_data_file.h>
+
+#include <fstream>
+#include <cstring>
+
+
+const unsigned int n_records = 92;
+const unsigned int record_size = 3*sizeof(unsigned int);
+
+
+void fill_record (const unsigned int index,
+                  char              *record)
+{
+  const unsigned int values[3] = { index, index*index, 1000-index };
+  std::memcpy (record, values, record_size);
+}
+
+
+
+// write the records on the processors with color 0, each having as many
+// records as given in n_local
+void write (const std::string               &filename,
+            const std::vector<unsigned int> &n_local,
+            const bool                       compress)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  MPI_Comm comm;
+  MPI_Comm_split (MPI_COMM_WORLD, myid < n_local.size() ? 0 : MPI_UNDEFINED,
+                  myid, &comm);
+  if (myid < n_local.size())
+    {
+      unsigned int first = 0;
+      for (unsigned int p=0; p<myid; ++p)
+        first += n_local[p];
+      std::vector<char> data (n_local[myid]*record_size);
+      for (unsigned int i=0; i<n_local[myid]; ++i)
+        fill_record (first+i, &data[i*record_size]);
+
+      parallel::distributed::CellDataFile::write (filename, data, record_size,
+                                                  compress, comm, 5*record_size);
+      MPI_Comm_free (&comm);
+    }
+  MPI_Barrier (MPI_COMM_WORLD);
+
+  // the number of blocks is the fourth entry of the header
+  unsigned long long int header[5];
+  std::ifstream in (filename.c_str(), std::ios::binary);
+  in.read (reinterpret_cast<char *>(header), sizeof(header));
+  deallog << "written on " << n_local.size() << " processors"
+          << (compress ? ", compressed" : "")
+          << ", blocks: " << header[3] << std::endl;
+}
+
+
+
+// read the records on the processors with color 0 and check them
+void read (const std::string               &filename,
+           const std::vector<unsigned int> &n_local)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  MPI_Comm comm;
+  MPI_Comm_split (MPI_COMM_WORLD, myid < n_local.size() ? 0 : MPI_UNDEFINED,
+                  myid, &comm);
+  if (myid < n_local.size())
+    {
+      unsigned int first = 0;
+      for (unsigned int p=0; p<myid; ++p)
+        first += n_local[p];
+      std::vector<char> data;
+      parallel::distributed::CellDataFile::read (filename, first, n_local[myid],
+                                                 n_records, record_size, data,
+                                                 comm);
+      AssertDimension (data.size(), n_local[myid]*record_size);
+
+      unsigned int n_errors = 0;
+      std::vector<char> expected (record_size);
+      for (unsigned int i=0; i<n_local[myid]; ++i)
+        {
+          fill_record (first+i, &expected[0]);
+          if (std::memcmp (&expected[0], &data[i*record_size], record_size) != 0)
+            ++n_errors;
+        }
+      deallog << "read records " << first << " to " << first+n_local[myid]
+              << " on " << n_local.size() << " processors, errors: "
+              << n_errors << std::endl;
+      MPI_Comm_free (&comm);
+    }
+  MPI_Barrier (MPI_COMM_WORLD);
+}
+
+
+
+int main (int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  const std::string filename = "cell_data";
+  for (unsigned int compress=0; compress<2; ++compress)
+    {
+      // write on two processors, read on three and on one
+      {
+        std::vector<unsigned int> n_write (2);
+        n_write[0] = 37;
+        n_write[1] = 55;
+        write (filename, n_write, compress);
+
+        std::vector<unsigned int> n_read (3);
+        n_read[0] = 10;
+        n_read[1] = 50;
+        n_read[2] = 32;
+        read (filename, n_read);
+        read (filename, std::vector<unsigned int>(1, n_records));
+      }
+
+      // write on three processors, one of which has no records, and read on
+      // two, one of which reads nothing
+      {
+        std::vector<unsigned int> n_write (3);
+        n_write[0] = 20;
+        n_write[1] = 0;
+        n_write[2] = 72;
+        write (filename, n_write, compress);
+
+        std::vector<unsigned int> n_read (2);
+        n_read[0] = 0;
+        n_read[1] = 92;
+        read (filename, n_read);
+      }
+    }
+}
@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// test IndexSet::is_element, IndexSet::index_within_set and the set
+// operations on heavily fragmented sets that are partly stored as bitmaps,
+// by comparing with a simple array of flags
+
+#include "../tests.h"
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <deal.II/base/index_set.h>
+
+
+// create a set that consists of one large range and many isolated indices
+// and short ranges around it, like the set of locally relevant indices
+IndexSet create_set (const unsigned int size,
+                     std::vector<bool> &flags)
+{
+  IndexSet is (size);
+  flags.assign (size, false);
+
+  is.add_range (size/2, size/2+size/10);
+  for (unsigned int i=size/2; i<size/2+size/10; ++i)
+    flags[i] = true;
+
+  for (unsigned int i=0; i<size/4; ++i)
+    {
+      const unsigned int index = Testing::rand() % size;
+      const unsigned int length = 1 + Testing::rand() % 3;
+      for (unsigned int j=index; j<std::min(index+length, size); ++j)
+        {
+          is.add_index (j);
+          flags[j] = true;
+        }
+    }
+  is.compress ();
+  return is;
+}
+
+
+
+void check (const IndexSet          &is,
+            const std::vector<bool> &flags)
+{
+  unsigned int n_elements = 0;
+  for (unsigned int i=0; i<flags.size(); ++i)
+    {
+      AssertThrow (is.is_element(i) == flags[i], ExcInternalError());
+      if (flags[i])
+        {
+          AssertThrow (is.index_within_set(i) == n_elements,
+                       ExcInternalError());
+          AssertThrow (is.nth_index_in_set(n_elements) == i,
+                       ExcInternalError());
+          ++n_elements;
+        }
+    }
+  AssertThrow (is.n_elements() == n_elements, ExcInternalError());
+}
+
+
+
+void test (const unsigned int size)
+{
+  std::vector<bool> flags1, flags2, flags;
+  const IndexSet is1 = create_set (size, flags1);
+  const IndexSet is2 = create_set (size, flags2);
+  check (is1, flags1);
+  check (is2, flags2);
+  deallog << "size " << size << ": lookup OK" << std::endl;
+
+  flags.resize (size);
+  for (unsigned int i=0; i<size; ++i)
+    flags[i] = flags1[i] && flags2[i];
+  check (is1 & is2, flags);
+  deallog << "size " << size << ": intersection OK" << std::endl;
+
+  IndexSet is3 = is1;
+  is3.subtract_set (is2);
+  for (unsigned int i=0; i<size; ++i)
+    flags[i] = flags1[i] && !flags2[i];
+  check (is3, flags);
+  deallog << "size " << size << ": difference OK" << std::endl;
+
+  is3 = is1;
+  is3.add_indices (is2);
+  for (unsigned int i=0; i<size; ++i)
+    flags[i] = flags1[i] || flags2[i];
+  check (is3, flags);
+  deallog << "size " << size << ": union OK" << std::endl;
+}
+
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test (1000);
+  test (100000);
+}
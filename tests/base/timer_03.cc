@@ -0,0 +1,103 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check nested sections of TimerOutput, sections entered concurrently from
+// several tasks, and the statistics over all threads
+
+#include "../tests.h"
+#include <deal.II/base/timer.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/thread_management.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+
+void work (TimerOutput &timer)
+{
+  TimerOutput::Scope scope (timer, "worker");
+  double sum = 0;
+  for (unsigned int i=0; i<100000; ++i)
+    sum += 1./(i+1.);
+  (void)sum;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  // use std::cout for the summary, which contains timing information that
+  // cannot be compared
+  TimerOutput timer (std::cout, TimerOutput::never, TimerOutput::wall_times);
+
+  {
+    TimerOutput::Scope outer (timer, "Assemble");
+    {
+      TimerOutput::Scope inner (timer, "Local");
+    }
+    {
+      TimerOutput::Scope inner (timer, "Local");
+    }
+  }
+  timer.enter_subsection ("Solve");
+  timer.enter_subsection ("Setup");
+  timer.leave_subsection ();
+  timer.enter_subsection ("Local");
+  timer.leave_subsection ("Local");
+  timer.leave_subsection ();
+
+  Threads::TaskGroup<> tasks;
+  for (unsigned int i=0; i<8; ++i)
+    tasks += Threads::new_task (&work, timer);
+  tasks.join_all ();
+
+  const std::vector<TimerOutput::SectionStatistics> statistics
+    = timer.get_statistics();
+  for (unsigned int i=0; i<statistics.size(); ++i)
+    deallog << statistics[i].name
+            << ", depth " << statistics[i].depth
+            << ", calls " << statistics[i].n_calls
+            << ", threads ok: "
+            << (statistics[i].n_threads >= 1 &&
+                statistics[i].n_threads <= statistics[i].n_calls)
+            << ", times ok: "
+            << (statistics[i].max_thread_wall_time <= statistics[i].wall_time &&
+                statistics[i].wall_time_over_processes.max == statistics[i].wall_time)
+            << std::endl;
+
+  // check the number of lines of the machine-readable output
+  for (unsigned int format=0; format<2; ++format)
+    {
+      std::ostringstream out;
+      timer.write_statistics (out, format == 0 ? TimerOutput::json :
+                              TimerOutput::csv);
+      std::istringstream in (out.str());
+      std::string line;
+      std::getline (in, line);
+      deallog << "First line: " << line;
+      unsigned int n_lines = 1;
+      while (std::getline (in, line))
+        ++n_lines;
+      deallog << ", number of lines: " << n_lines << std::endl;
+    }
+
+  timer.reset ();
+  deallog << "Sections after reset: " << timer.get_statistics().size()
+          << std::endl;
+}
@@ -0,0 +1,91 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check TimerOutput::add_work and the hardware counters: the work must be
+// attributed to the innermost section and all sections it is nested in, and
+// the counters must give nonzero values if they are available
+
+#include "../tests.h"
+#include <deal.II/base/timer.h>
+#include <deal.II/base/logstream.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+
+double daxpy (const double a,
+              const std::vector<double> &x,
+              std::vector<double> &y)
+{
+  for (unsigned int i=0; i<x.size(); ++i)
+    y[i] += a * x[i];
+  return y[0];
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  TimerOutput timer (std::cout, TimerOutput::never, TimerOutput::wall_times);
+  timer.enable_hardware_counters ();
+
+  const unsigned int n = 100000;
+  std::vector<double> x (n, 1.), y (n, 2.);
+  {
+    TimerOutput::Scope outer (timer, "Solve");
+    for (unsigned int i=0; i<3; ++i)
+      {
+        TimerOutput::Scope inner (timer, "daxpy");
+        daxpy (0.5, x, y);
+        timer.add_work (2. * n, 3. * n * sizeof(double));
+      }
+    timer.add_work (1., 0.);
+  }
+  {
+    TimerOutput::Scope section (timer, "Setup");
+  }
+
+  const bool counters = timer.hardware_counters_available();
+  const std::vector<TimerOutput::SectionStatistics> statistics
+    = timer.get_statistics();
+  for (unsigned int i=0; i<statistics.size(); ++i)
+    deallog << statistics[i].name
+            << ", flops " << statistics[i].expected_flops
+            << ", bytes " << statistics[i].expected_bytes
+            << ", counters ok: "
+            << (counters ?
+                (statistics[i].name == "Setup" ||
+                 (statistics[i].cycles > 0 && statistics[i].instructions > 0))
+                :
+                (statistics[i].cycles == 0 && statistics[i].instructions == 0 &&
+                 statistics[i].measured_bytes == 0))
+            << std::endl;
+
+  std::ostringstream out;
+  timer.write_statistics (out, TimerOutput::csv);
+  std::istringstream in (out.str());
+  std::string line;
+  std::getline (in, line);
+  deallog << line << std::endl;
+
+  // the counters stay active after reset
+  timer.reset ();
+  deallog << "Counters after reset ok: "
+          << (timer.hardware_counters_available() == counters) << std::endl;
+}
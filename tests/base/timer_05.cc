@@ -0,0 +1,74 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check TimerOutput::get_statistics over several processes: the statistics
+// are computed if all processes entered the same sections, and an exception
+// is thrown on all processes if one of them entered a section with a
+// different name, even though the number of sections is the same
+
+#include "../tests.h"
+#include <deal.II/base/timer.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <fstream>
+#include <sstream>
+
+
+void check (const bool different_name)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+  // use a stream for the summary, which contains timing information that
+  // cannot be compared
+  std::ostringstream summary;
+  TimerOutput timer (MPI_COMM_WORLD, summary, TimerOutput::never,
+                     TimerOutput::wall_times);
+  {
+    TimerOutput::Scope scope (timer, "Assemble");
+  }
+  {
+    TimerOutput::Scope scope (timer, (different_name && myid == 1) ?
+                              "Setup" : "Solve");
+  }
+
+  try
+    {
+      const std::vector<TimerOutput::SectionStatistics> statistics
+        = timer.get_statistics();
+      for (unsigned int i=0; i<statistics.size(); ++i)
+        deallog << statistics[i].name << ", calls " << statistics[i].n_calls
+                << ", times ok: "
+                << (statistics[i].wall_time_over_processes.min <=
+                    statistics[i].wall_time_over_processes.max)
+                << std::endl;
+    }
+  catch (ExceptionBase &e)
+    {
+      deallog << "Exception: " << e.get_exc_name() << std::endl;
+    }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  check (false);
+  check (true);
+}
@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// test WorkStream::run with a WorkStream::ThreadPartitioning: every element
+// of the range must be worked on exactly once, also when running several
+// times with the same partitioning and when the partitions are given
+// explicitly
+
+#include "../tests.h"
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+
+#include <deal.II/base/work_stream.h>
+
+
+struct ScratchData
+{};
+
+
+struct CopyData
+{
+  unsigned int index;
+  unsigned int computed;
+};
+
+
+struct X
+{
+  X (const unsigned int n)
+    :
+    count (n, 0),
+    result (n, 0)
+  {}
+
+  void worker (const std::vector<unsigned int>::iterator &i,
+               ScratchData &,
+               CopyData &ad)
+  {
+    ad.index = *i;
+    ad.computed = *i * 2;
+  }
+
+  void copier (const CopyData &ad)
+  {
+    ++count[ad.index];
+    result[ad.index] = ad.computed;
+  }
+
+  std::vector<unsigned int> count;
+  std::vector<unsigned int> result;
+};
+
+
+void check (WorkStream::ThreadPartitioning<std::vector<unsigned int>::iterator> &partitioning,
+            const unsigned int n)
+{
+  X x (n);
+  for (unsigned int run=0; run<3; ++run)
+    WorkStream::run (partitioning,
+                     std_cxx11::bind (&X::worker, std_cxx11::ref(x),
+                                      std_cxx11::_1, std_cxx11::_2,
+                                      std_cxx11::_3),
+                     std_cxx11::bind (&X::copier, std_cxx11::ref(x),
+                                      std_cxx11::_1),
+                     ScratchData(), CopyData(), 3);
+
+  bool ok = true;
+  for (unsigned int i=0; i<n; ++i)
+    if (x.count[i] != 3 || x.result[i] != 2*i)
+      ok = false;
+
+  deallog << "Partitions:";
+  for (unsigned int p=0; p<partitioning.n_partitions(); ++p)
+    deallog << " " << partitioning.get_partition(p).size();
+  deallog << std::endl;
+  deallog << "Result: " << (ok ? "ok" : "wrong") << std::endl;
+}
+
+
+
+void test ()
+{
+  const unsigned int n = 100;
+  std::vector<unsigned int> v;
+  for (unsigned int i=0; i<n; ++i)
+    v.push_back (i);
+
+  for (unsigned int n_partitions=1; n_partitions<8; n_partitions+=3)
+    {
+      WorkStream::ThreadPartitioning<std::vector<unsigned int>::iterator>
+      partitioning (v.begin(), v.end(), n_partitions);
+      check (partitioning, n);
+    }
+
+  // partitions given explicitly: even and odd numbers
+  std::vector<std::vector<std::vector<unsigned int>::iterator> > partitions (2);
+  for (std::vector<unsigned int>::iterator p=v.begin(); p!=v.end(); ++p)
+    partitions[*p % 2].push_back (p);
+  WorkStream::ThreadPartitioning<std::vector<unsigned int>::iterator>
+  partitioning (partitions);
+  check (partitioning, n);
+}
+
+
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  test ();
+}
@@ -0,0 +1,158 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DoFRenumbering::compute_space_filling_curve_cell_order and
+// DoFRenumbering::space_filling_curve: print the cell order of both curves
+// on a small mesh, check that consecutive cells along the Hilbert curve are
+// neighbors on a uniformly refined mesh, and check that the new numbering of
+// the degrees of freedom follows the cell order on an adaptively refined
+// mesh
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+
+void print_cell_order ()
+{
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+
+  FE_Q<2> fe (1);
+  DoFHandler<2> dof (tria);
+  dof.distribute_dofs (fe);
+
+  const char *names[] = { "Hilbert", "Morton" };
+  for (unsigned int c=0; c<2; ++c)
+    {
+      const std::vector<DoFHandler<2>::active_cell_iterator> cells
+        = DoFRenumbering::compute_space_filling_curve_cell_order
+          (dof, c == 0 ? DoFRenumbering::hilbert_curve : DoFRenumbering::morton_curve);
+      deallog << names[c] << " curve:" << std::endl;
+      for (unsigned int i=0; i<cells.size(); ++i)
+        deallog << cells[i]->center() << std::endl;
+    }
+}
+
+
+
+template <int dim>
+void check_neighbors (const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+
+  const std::vector<typename DoFHandler<dim>::active_cell_iterator> cells
+    = DoFRenumbering::compute_space_filling_curve_cell_order (dof);
+  const double h = 1./(1<<n_refinements);
+
+  bool neighbors = (cells.size() == tria.n_active_cells());
+  for (unsigned int i=1; i<cells.size(); ++i)
+    if (std::abs(cells[i]->center().distance(cells[i-1]->center()) - h) > 1e-12)
+      neighbors = false;
+
+  deallog << "dim=" << dim << ", cells=" << cells.size()
+          << ", consecutive cells are neighbors: "
+          << (neighbors ? "yes" : "no") << std::endl;
+}
+
+
+
+template <int dim>
+void check_numbering (const DoFRenumbering::SpaceFillingCurve curve)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, -1, 1);
+  tria.refine_global (2);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell)
+        if (cell->center().norm() < 0.5)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+  DoFRenumbering::space_filling_curve (dof, curve);
+
+  // when going through the cells in the order of the curve, the degrees of
+  // freedom that have not been seen on an earlier cell must get the next
+  // free numbers
+  const std::vector<typename DoFHandler<dim>::active_cell_iterator> cells
+    = DoFRenumbering::compute_space_filling_curve_cell_order (dof, curve);
+  std::vector<bool> seen (dof.n_dofs(), false);
+  std::vector<types::global_dof_index> dof_indices (fe.dofs_per_cell);
+  types::global_dof_index next_free = 0;
+  bool ok = true;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      cells[c]->get_dof_indices (dof_indices);
+      std::sort (dof_indices.begin(), dof_indices.end());
+      for (unsigned int i=0; i<dof_indices.size(); ++i)
+        if (seen[dof_indices[i]] == false)
+          {
+            if (dof_indices[i] != next_free)
+              ok = false;
+            seen[dof_indices[i]] = true;
+            ++next_free;
+          }
+    }
+  if (next_free != dof.n_dofs())
+    ok = false;
+
+  deallog << "dim=" << dim << ", curve=" << curve
+          << ", numbering follows cell order: " << (ok ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog << std::fixed << std::setprecision(3);
+
+  print_cell_order ();
+
+  check_neighbors<2> (4);
+  check_neighbors<3> (3);
+
+  check_numbering<2> (DoFRenumbering::hilbert_curve);
+  check_numbering<2> (DoFRenumbering::morton_curve);
+  check_numbering<3> (DoFRenumbering::hilbert_curve);
+  check_numbering<3> (DoFRenumbering::morton_curve);
+}
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that DoFTools::make_sparsity_pattern with a SparsityPatternBuilder
+// followed by SparsityPattern::copy_from gives the same sparsity pattern as
+// going through a DynamicSparsityPattern, with hanging node constraints and
+// with and without keeping the constrained entries. the larger meshes have
+// enough rows to split the entries into several buckets, which are filled
+// and merged by several threads
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern_builder.h>
+
+#include <fstream>
+
+
+template <int dim>
+void test (const unsigned int degree,
+           const bool keep_constrained_dofs,
+           const unsigned int n_refinements = 2)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.last_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof, constraints);
+  constraints.close ();
+
+  SparsityPattern reference;
+  {
+    DynamicSparsityPattern dsp (dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern (dof, dsp, constraints,
+                                     keep_constrained_dofs);
+    reference.copy_from (dsp);
+  }
+
+  SparsityPattern sparsity;
+  {
+    SparsityPatternBuilder builder (dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern (dof, builder, constraints,
+                                     keep_constrained_dofs);
+    sparsity.copy_from (builder);
+  }
+
+  bool identical = (sparsity.n_nonzero_elements() ==
+                    reference.n_nonzero_elements());
+  for (unsigned int row=0; row<dof.n_dofs() && identical; ++row)
+    {
+      if (sparsity.row_length(row) != reference.row_length(row))
+        identical = false;
+      else
+        for (unsigned int i=0; i<sparsity.row_length(row); ++i)
+          if (sparsity.column_number(row, i) != reference.column_number(row, i))
+            identical = false;
+    }
+
+  deallog << "dim=" << dim << ", degree=" << degree
+          << ", n_dofs=" << dof.n_dofs()
+          << ", keep constrained: " << keep_constrained_dofs
+          << ", identical: " << (identical ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  MultithreadInfo::set_thread_limit (4);
+
+  test<2> (1, true);
+  test<2> (3, false);
+  test<3> (1, false);
+  test<3> (2, true);
+  test<2> (2, false, 6);
+  test<3> (2, true, 3);
+}
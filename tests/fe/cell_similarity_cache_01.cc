@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check FEValues::enable_cell_similarity_cache on a mesh with a few
+// different cell shapes arranged such that no cell is a translation of the
+// previous one: the data must be the same as without the cache, and cells
+// with a geometry seen before must be taken from the cache unless the
+// element is not primitive
+
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_raviart_thomas.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <fstream>
+
+
+template <int dim>
+void test (const Triangulation<dim>    &tria,
+           const FiniteElement<dim>    &fe,
+           const UpdateFlags            flags)
+{
+  const MappingQGeneric<dim> mapping (1);
+  const QGauss<dim> quadrature (fe.degree+1);
+  FEValues<dim> reference (mapping, fe, quadrature, flags);
+  FEValues<dim> cached (mapping, fe, quadrature, flags);
+  cached.enable_cell_similarity_cache (4);
+
+  double difference = 0, norm = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      reference.reinit (cell);
+      cached.reinit (cell);
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        {
+          norm += reference.JxW(q) * reference.JxW(q);
+          difference += (reference.JxW(q) - cached.JxW(q)) *
+                        (reference.JxW(q) - cached.JxW(q));
+          for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+            for (unsigned int c=0; c<fe.n_components(); ++c)
+              {
+                norm += reference.shape_grad_component(i,q,c).norm_square();
+                difference += (reference.shape_grad_component(i,q,c) -
+                               cached.shape_grad_component(i,q,c)).norm_square();
+                norm += reference.shape_value_component(i,q,c) *
+                        reference.shape_value_component(i,q,c);
+                difference += (reference.shape_value_component(i,q,c) -
+                               cached.shape_value_component(i,q,c)) *
+                              (reference.shape_value_component(i,q,c) -
+                               cached.shape_value_component(i,q,c));
+                if (flags & update_hessians)
+                  {
+                    norm += reference.shape_hessian_component(i,q,c).norm_square();
+                    difference += (reference.shape_hessian_component(i,q,c) -
+                                   cached.shape_hessian_component(i,q,c)).norm_square();
+                  }
+              }
+        }
+    }
+
+  deallog << fe.get_name() << ": cells " << tria.n_active_cells()
+          << ", cache hits " << cached.n_cell_similarity_cache_hits()
+          << ", data equal: " << (difference < 1e-24 * norm ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  // cells of two different sizes in each direction
+  std::vector<std::vector<double> > step_sizes (dim);
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      step_sizes[d].push_back (1.);
+      step_sizes[d].push_back (2.+d);
+      step_sizes[d].push_back (1.);
+    }
+  Point<dim> p2;
+  for (unsigned int d=0; d<dim; ++d)
+    p2[d] = 4.+d;
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_rectangle (tria, step_sizes, Point<dim>(), p2,
+                                             false);
+
+  test (tria, FE_Q<dim>(2),
+        update_values | update_gradients | update_hessians | update_JxW_values);
+  test (tria, FESystem<dim>(FE_Q<dim>(1), dim),
+        update_values | update_gradients | update_JxW_values);
+  test (tria, FE_RaviartThomas<dim>(1),
+        update_values | update_gradients | update_JxW_values);
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision (4);
+
+  // make sure the comparison with the previous cell is done, which is
+  // disabled with more than one thread
+  MultithreadInfo::set_thread_limit (1);
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,162 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that FEValuesBatch produces the same shape values, gradients, JxW
+// values and quadrature points as FEValues on each lane, also through the
+// extractor interface, for a partially filled last batch and for a
+// non-primitive element
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_raviart_thomas.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_batch.h>
+
+#include <fstream>
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.refine_global (1);
+
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  const QGauss<dim> quadrature (fe.degree+1);
+  const UpdateFlags flags = update_values | update_gradients |
+                            update_JxW_values | update_quadrature_points;
+  FEValues<dim> fe_values (fe, quadrature, flags);
+  FEValuesBatch<dim> fe_values_batch (fe, quadrature, flags);
+
+  const unsigned int n_lanes = FEValuesBatch<dim>::n_lanes;
+  const FEValuesExtractors::Scalar scalar (0);
+  const FEValuesExtractors::Vector vector (0);
+  const bool has_vector = (fe.n_components() >= dim);
+
+  double error = 0;
+  unsigned int n_cells = 0, n_checked_lanes = 0;
+  bool unused_lanes_ok = true;
+
+  typename DoFHandler<dim>::active_cell_iterator
+  cell = dof_handler.begin_active(), endc = dof_handler.end();
+  std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+  while (cell != endc)
+    {
+      // use batches with one cell less than the maximum to also exercise
+      // the filling of unused lanes when there is more than one lane
+      cells.clear ();
+      const unsigned int batch_size = (n_lanes > 1 ? n_lanes-1 : 1);
+      for (; cell != endc && cells.size() < batch_size; ++cell)
+        cells.push_back (cell);
+      fe_values_batch.reinit (cells);
+      n_cells += cells.size();
+
+      for (unsigned int lane=0; lane<n_lanes; ++lane)
+        {
+          // unused lanes must contain the data of the first cell
+          fe_values.reinit (cells[lane < cells.size() ? lane : 0]);
+          if (lane >= fe_values_batch.n_active_lanes())
+            {
+              if (fe_values_batch.JxW(0)[lane] != fe_values_batch.JxW(0)[0])
+                unused_lanes_ok = false;
+              continue;
+            }
+          ++n_checked_lanes;
+
+          for (unsigned int q=0; q<quadrature.size(); ++q)
+            {
+              error = std::max (error, std::abs (fe_values.JxW(q) -
+                                                 fe_values_batch.JxW(q)[lane]));
+              for (unsigned int d=0; d<dim; ++d)
+                error = std::max (error,
+                                  std::abs (fe_values.quadrature_point(q)[d] -
+                                            fe_values_batch.quadrature_point(q)[d][lane]));
+
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                {
+                  for (unsigned int c=0; c<fe.n_components(); ++c)
+                    {
+                      error = std::max (error,
+                                        std::abs (fe_values.shape_value_component(i,q,c) -
+                                                  fe_values_batch.shape_value_component(i,q,c)[lane]));
+                      for (unsigned int d=0; d<dim; ++d)
+                        error = std::max (error,
+                                          std::abs (fe_values.shape_grad_component(i,q,c)[d] -
+                                                    fe_values_batch.shape_grad_component(i,q,c)[d][lane]));
+                    }
+
+                  error = std::max (error,
+                                    std::abs (fe_values[scalar].value(i,q) -
+                                              fe_values_batch[scalar].value(i,q)[lane]));
+                  for (unsigned int d=0; d<dim; ++d)
+                    error = std::max (error,
+                                      std::abs (fe_values[scalar].gradient(i,q)[d] -
+                                                fe_values_batch[scalar].gradient(i,q)[d][lane]));
+
+                  if (has_vector)
+                    {
+                      error = std::max (error,
+                                        std::abs (fe_values[vector].divergence(i,q) -
+                                                  fe_values_batch[vector].divergence(i,q)[lane]));
+                      for (unsigned int d=0; d<dim; ++d)
+                        {
+                          error = std::max (error,
+                                            std::abs (fe_values[vector].value(i,q)[d] -
+                                                      fe_values_batch[vector].value(i,q)[d][lane]));
+                          for (unsigned int e=0; e<dim; ++e)
+                            {
+                              error = std::max (error,
+                                                std::abs (fe_values[vector].gradient(i,q)[d][e] -
+                                                          fe_values_batch[vector].gradient(i,q)[d][e][lane]));
+                              error = std::max (error,
+                                                std::abs (fe_values[vector].symmetric_gradient(i,q)[d][e] -
+                                                          fe_values_batch[vector].symmetric_gradient(i,q)[d][e][lane]));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+  deallog << fe.get_name() << ": cells " << n_cells
+          << ", checked " << (n_checked_lanes == n_cells ? "all" : "not all")
+          << ", unused lanes " << (unused_lanes_ok ? "ok" : "wrong")
+          << ", max error " << (error < 1e-12 ? 0. : error) << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test (FE_Q<2>(2));
+  test (FESystem<2>(FE_Q<2>(2), 2, FE_Q<2>(1), 1));
+  test (FE_RaviartThomas<2>(1));
+  test (FE_Q<3>(1));
+  test (FESystem<3>(FE_Q<3>(2), 3));
+}
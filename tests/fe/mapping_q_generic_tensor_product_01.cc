@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that MappingQGeneric computes the same quadrature points, Jacobians
+// and JxW values with the sum factorization path taken for tensor product
+// quadrature formulas as with the general path. the latter is triggered by
+// a quadrature formula with the points of the tensor product formula in a
+// random order, which is not a tensor product any more
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <fstream>
+
+
+template <int dim>
+void test (const unsigned int degree)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.refine_global (1);
+
+  MappingQGeneric<dim> mapping (degree);
+  FE_Q<dim> fe (1);
+
+  const QGauss<dim> quadrature (degree+2);
+  const unsigned int n_q_points = quadrature.size();
+  std::vector<unsigned int> permutation (n_q_points);
+  for (unsigned int q=0; q<n_q_points; ++q)
+    permutation[q] = q;
+  for (unsigned int q=n_q_points-1; q>0; --q)
+    std::swap (permutation[q], permutation[Testing::rand() % (q+1)]);
+  std::vector<Point<dim> > points (n_q_points);
+  std::vector<double> weights (n_q_points);
+  for (unsigned int q=0; q<n_q_points; ++q)
+    {
+      points[q] = quadrature.point(permutation[q]);
+      weights[q] = quadrature.weight(permutation[q]);
+    }
+  const Quadrature<dim> permuted (points, weights);
+
+  const UpdateFlags flags = update_quadrature_points | update_jacobians |
+                            update_inverse_jacobians | update_JxW_values;
+  FEValues<dim> fe_values (mapping, fe, quadrature, flags);
+  FEValues<dim> fe_values_permuted (mapping, fe, permuted, flags);
+
+  deallog << "dim=" << dim << ", mapping degree " << degree << std::endl;
+
+  // check which of the two paths the mapping takes for the two formulas
+  for (unsigned int i=0; i<2; ++i)
+    {
+      typename MappingQGeneric<dim>::InternalData *data =
+        mapping.get_data (flags, i == 0 ? quadrature : permuted);
+      deallog << (i == 0 ? "QGauss: " : "Permuted QGauss: ")
+              << (data->tensor_product_quadrature ? "sum factorization" :
+                  "general")
+              << std::endl;
+      delete data;
+    }
+
+  double error_points = 0, error_jacobians = 0, error_inverse = 0,
+         error_jxw = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      fe_values.reinit (cell);
+      fe_values_permuted.reinit (cell);
+      for (unsigned int r=0; r<n_q_points; ++r)
+        {
+          const unsigned int q = permutation[r];
+          error_points = std::max (error_points,
+                                   fe_values.quadrature_point(q).distance
+                                   (fe_values_permuted.quadrature_point(r)));
+          error_jacobians = std::max (error_jacobians,
+                                      (Tensor<2,dim>(fe_values.jacobian(q)) -
+                                       Tensor<2,dim>(fe_values_permuted.jacobian(r))).norm());
+          error_inverse = std::max (error_inverse,
+                                    (Tensor<2,dim>(fe_values.inverse_jacobian(q)) -
+                                     Tensor<2,dim>(fe_values_permuted.inverse_jacobian(r))).norm());
+          error_jxw = std::max (error_jxw,
+                                std::abs(fe_values.JxW(q) - fe_values_permuted.JxW(r)));
+        }
+    }
+
+  deallog << "Error quadrature points:   " << error_points << std::endl;
+  deallog << "Error Jacobians:           " << error_jacobians << std::endl;
+  deallog << "Error inverse Jacobians:   " << error_inverse << std::endl;
+  deallog << "Error JxW values:          " << error_jxw << std::endl;
+}
+
+
+int main()
+{
+  initlog();
+  deallog.threshold_double(1.e-12);
+
+  for (unsigned int degree=1; degree<5; ++degree)
+    test<2> (degree);
+  for (unsigned int degree=1; degree<4; ++degree)
+    test<3> (degree);
+}
@@ -0,0 +1,140 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check hp::FEValues::precompute_fe_values() and
+// hp::sort_cells_by_active_fe_index(): after precomputation, reinit() must
+// only switch between the objects created up front, and assembling the cells
+// in sorted order must give the same result as in the original order
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/hp/dof_handler.h>
+#include <deal.II/hp/fe_collection.h>
+#include <deal.II/hp/q_collection.h>
+#include <deal.II/hp/fe_values.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <fstream>
+
+
+template <int dim, typename CellIterator>
+double
+integrate (hp::FEValues<dim>               &hp_fe_values,
+           const std::vector<CellIterator> &cells)
+{
+  // integrate the sum of the gradients of all shape functions squared, which
+  // depends on the element on each cell
+  double result = 0;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      hp_fe_values.reinit (cells[c]);
+      const FEValues<dim> &fe_values = hp_fe_values.get_present_fe_values();
+      for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+        for (unsigned int i=0; i<fe_values.dofs_per_cell; ++i)
+          result += (fe_values.shape_grad(i,q) * fe_values.shape_grad(i,q) *
+                     fe_values.JxW(q));
+    }
+  return result;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  const unsigned int n_elements = (dim == 2 ? 8 : 4);
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (3);
+
+  hp::FECollection<dim> fe_collection;
+  hp::QCollection<dim> q_collection;
+  for (unsigned int degree=1; degree<=n_elements; ++degree)
+    {
+      fe_collection.push_back (FE_Q<dim>(degree));
+      q_collection.push_back (QGauss<dim>(degree+1));
+    }
+
+  hp::DoFHandler<dim> dof_handler (tria);
+  typedef typename hp::DoFHandler<dim>::active_cell_iterator cell_iterator;
+  unsigned int index = 0;
+  for (cell_iterator cell=dof_handler.begin_active(); cell!=dof_handler.end();
+       ++cell, ++index)
+    cell->set_active_fe_index ((index * 5) % n_elements);
+  dof_handler.distribute_dofs (fe_collection);
+
+  hp::FEValues<dim> hp_fe_values (fe_collection, q_collection,
+                                  update_gradients | update_JxW_values);
+  hp_fe_values.precompute_fe_values ();
+
+  // record the object that belongs to each element
+  std::vector<const FEValues<dim> *> objects (n_elements);
+  for (cell_iterator cell=dof_handler.begin_active(); cell!=dof_handler.end();
+       ++cell)
+    {
+      hp_fe_values.reinit (cell);
+      objects[cell->active_fe_index()] = &hp_fe_values.get_present_fe_values();
+    }
+  for (unsigned int i=0; i<n_elements; ++i)
+    deallog << "Element " << i << ": " << fe_collection[i].get_name()
+            << (objects[i] != 0 &&
+                objects[i]->get_fe().get_name() == fe_collection[i].get_name() ?
+                " ok" : " wrong")
+            << std::endl;
+
+  std::vector<cell_iterator> cells;
+  for (cell_iterator cell=dof_handler.begin_active(); cell!=dof_handler.end();
+       ++cell)
+    cells.push_back (cell);
+  const double unsorted = integrate (hp_fe_values, cells);
+
+  hp::sort_cells_by_active_fe_index (cells);
+  unsigned int n_switches = 0;
+  bool objects_reused = true;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      if (c > 0 && cells[c]->active_fe_index() != cells[c-1]->active_fe_index())
+        ++n_switches;
+      hp_fe_values.reinit (cells[c]);
+      if (&hp_fe_values.get_present_fe_values() != objects[cells[c]->active_fe_index()])
+        objects_reused = false;
+    }
+  const double sorted = integrate (hp_fe_values, cells);
+
+  deallog << "Number of switches between elements after sorting: "
+          << n_switches << std::endl;
+  deallog << "Precomputed objects reused: "
+          << (objects_reused ? "yes" : "no") << std::endl;
+  deallog << "Relative difference sorted/unsorted: "
+          << (std::abs (sorted - unsorted) < 1e-12 * std::abs (unsorted) ?
+              0. : (sorted-unsorted)/unsorted)
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
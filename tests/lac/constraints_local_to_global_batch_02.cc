@@ -0,0 +1,171 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// like constraints_local_to_global_batch, but set up the coloring and the
+// positions of the constraints once with
+// ConstraintMatrix::setup_local_to_global_batch and reuse them for two
+// assembly passes, both with one and with several threads
+
+#include "../tests.h"
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/lac/compressed_simple_sparsity_pattern.h>
+
+#include <fstream>
+#include <iostream>
+
+
+template <int dim>
+void test (const unsigned int degree)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.begin()->face(0)->set_boundary_id(1);
+  tria.refine_global(2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.last_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof, constraints);
+  VectorTools::interpolate_boundary_values (dof, 1, ConstantFunction<dim>(1.),
+                                            constraints);
+  constraints.close();
+
+  SparsityPattern sparsity;
+  {
+    CompressedSimpleSparsityPattern csp (dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern (dof, csp, constraints, false);
+    sparsity.copy_from (csp);
+  }
+  SparseMatrix<double> matrix (sparsity), matrix_batch (sparsity);
+  Vector<double> rhs (dof.n_dofs()), rhs_batch (dof.n_dofs());
+
+  // fill local matrices and vectors with random values, make the local
+  // matrices diagonally dominant to get a nonzero contribution from the
+  // inhomogeneities
+  std::vector<FullMatrix<double> > local_matrices;
+  std::vector<Vector<double> > local_vectors;
+  std::vector<std::vector<types::global_dof_index> > local_dof_indices;
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof.begin_active(); cell != dof.end(); ++cell)
+    {
+      FullMatrix<double> local_mat (fe.dofs_per_cell, fe.dofs_per_cell);
+      Vector<double> local_vec (fe.dofs_per_cell);
+      for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+        {
+          for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+            local_mat(i,j) = (double)Testing::rand() / RAND_MAX;
+          local_mat(i,i) += fe.dofs_per_cell;
+          local_vec(i) = (double)Testing::rand() / RAND_MAX;
+        }
+      std::vector<types::global_dof_index> indices (fe.dofs_per_cell);
+      cell->get_dof_indices (indices);
+
+      constraints.distribute_local_to_global (local_mat, local_vec, indices,
+                                              matrix, rhs, true);
+
+      local_matrices.push_back (local_mat);
+      local_vectors.push_back (local_vec);
+      local_dof_indices.push_back (indices);
+    }
+
+  ConstraintMatrix::LocalToGlobalBatch batch;
+  constraints.setup_local_to_global_batch (local_dof_indices, batch);
+
+  // each cell must be in exactly one color, and no two cells of one color
+  // may write into the same row, including the rows the constraints resolve
+  // to
+  unsigned int n_cells_colored = 0, n_conflicts = 0;
+  for (unsigned int c=0; c<batch.colors.size(); ++c)
+    {
+      std::vector<unsigned int> owner (dof.n_dofs(), numbers::invalid_unsigned_int);
+      for (unsigned int i=0; i<batch.colors[c].size(); ++i)
+        {
+          const unsigned int cell = batch.colors[c][i];
+          ++n_cells_colored;
+          std::vector<types::global_dof_index> rows = local_dof_indices[cell];
+          for (unsigned int j=0; j<local_dof_indices[cell].size(); ++j)
+            if (constraints.is_constrained (local_dof_indices[cell][j]))
+              {
+                const std::vector<std::pair<types::global_dof_index,double> > *entries
+                  = constraints.get_constraint_entries (local_dof_indices[cell][j]);
+                for (unsigned int k=0; k<entries->size(); ++k)
+                  rows.push_back ((*entries)[k].first);
+              }
+          for (unsigned int j=0; j<rows.size(); ++j)
+            {
+              if (owner[rows[j]] != numbers::invalid_unsigned_int &&
+                  owner[rows[j]] != cell)
+                ++n_conflicts;
+              owner[rows[j]] = cell;
+            }
+        }
+    }
+  deallog << "Cells in colors: " << n_cells_colored << " of "
+          << local_dof_indices.size() << ", conflicts: " << n_conflicts
+          << std::endl;
+
+  for (unsigned int n_threads=1; n_threads<=4; n_threads+=3)
+    {
+      MultithreadInfo::set_thread_limit (n_threads);
+      matrix_batch = 0;
+      rhs_batch = 0;
+      for (unsigned int pass=0; pass<2; ++pass)
+        constraints.distribute_local_to_global (local_matrices, local_vectors,
+                                                local_dof_indices, batch,
+                                                matrix_batch, rhs_batch, true);
+
+      matrix_batch.add (-2., matrix);
+      rhs_batch.add (-2., rhs);
+      deallog << "dim=" << dim << ", degree=" << degree
+              << ", threads=" << n_threads << std::endl;
+      deallog << "Difference in matrix: " << matrix_batch.frobenius_norm() << std::endl;
+      deallog << "Difference in rhs:    " << rhs_batch.linfty_norm() << std::endl;
+    }
+}
+
+
+int main ()
+{
+  initlog();
+  deallog.threshold_double(1.e-10);
+
+  test<2>(1);
+  test<2>(3);
+  test<3>(1);
+  test<3>(2);
+}
@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the multicolor and the block Jacobi variants of PreconditionSSOR:
+// the preconditioner must be symmetric, a block Jacobi method with a single
+// block must be identical to the standard SSOR method, and all variants must
+// work as preconditioner in CG and as smoother through step()
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/precondition.h>
+
+
+typedef PreconditionSSOR<SparseMatrix<double> > SSOR;
+
+
+void
+check (const SparseMatrix<double>   &A,
+       const SSOR::AdditionalData   &data,
+       const std::string            &name)
+{
+  SSOR precondition;
+  precondition.initialize (A, data);
+
+  const unsigned int n = A.m();
+  Vector<double> v (n), w (n), pv (n), pw (n);
+  for (unsigned int i=0; i<n; ++i)
+    {
+      v(i) = std::sin (0.1 * i);
+      w(i) = std::cos (0.3 * i);
+    }
+  precondition.vmult (pv, v);
+  precondition.vmult (pw, w);
+  const double difference = std::abs ((w*pv) - (v*pw));
+  deallog << name << " symmetric: "
+          << (difference < 1e-12 * std::abs(w*pv) ? "yes" : "no") << std::endl;
+
+  // solve with CG
+  Vector<double> x (n), b (n);
+  b = 1.;
+  SolverControl control (200, 1e-10 * b.l2_norm());
+  SolverCG<> solver (control);
+  solver.solve (A, x, b, precondition);
+  deallog << name << " cg iterations: " << control.last_step() << std::endl;
+
+  // a few steps of the SSOR iteration
+  x = 0.;
+  for (unsigned int step=0; step<10; ++step)
+    precondition.step (x, b);
+  Vector<double> r (n);
+  A.residual (r, x, b);
+  deallog << name << " residual reduction after 10 steps: "
+          << r.l2_norm() / b.l2_norm() << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+  deallog.threshold_double (1e-10);
+
+  const unsigned int size = 40;
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 9);
+  testproblem.nine_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.nine_point (A);
+
+  deallog.push ("SSOR");
+  check (A, SSOR::AdditionalData (1.2), "lexicographic");
+  check (A, SSOR::AdditionalData (1.2, SSOR::AdditionalData::multicolor),
+         "multicolor");
+  check (A, SSOR::AdditionalData (1.2, SSOR::AdditionalData::block_jacobi, 1),
+         "block Jacobi 1");
+  check (A, SSOR::AdditionalData (1.2, SSOR::AdditionalData::block_jacobi, 8),
+         "block Jacobi 8");
+  deallog.pop ();
+
+  // one block must give the same as the standard method
+  SSOR standard, one_block;
+  standard.initialize (A, SSOR::AdditionalData (1.2));
+  one_block.initialize (A, SSOR::AdditionalData (1.2, SSOR::AdditionalData::block_jacobi, 1));
+  Vector<double> src (dim), dst1 (dim), dst2 (dim);
+  for (unsigned int i=0; i<dim; ++i)
+    src(i) = 1. + std::sin (0.1 * i);
+  standard.vmult (dst1, src);
+  one_block.vmult (dst2, src);
+  dst1 -= dst2;
+  deallog << "Difference between standard and one block: "
+          << dst1.linfty_norm() << std::endl;
+}
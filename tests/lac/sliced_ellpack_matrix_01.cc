@@ -0,0 +1,163 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SlicedEllpackMatrix::vmult, Tvmult, vmult_add, Tvmult_add and
+// matrix_norm_square against SparseMatrix for a nonsymmetric matrix with
+// rows of different length, and use it as the matrix in SolverCG
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/precondition.h>
+
+#include <fstream>
+#include <limits>
+#include <iomanip>
+
+
+// relative error of a matrix-vector product, with differences on the level
+// of round-off in the given number type filtered out
+template <typename number>
+double relative_error (const Vector<number> &difference,
+                       const Vector<number> &reference)
+{
+  const double error = difference.l2_norm() / reference.l2_norm();
+  return (error < 100. * std::numeric_limits<number>::epsilon() ? 0. : error);
+}
+
+
+
+template <typename number>
+void check_products (const unsigned int size,
+                     const unsigned int sorting_window)
+{
+  const unsigned int dim = (size-1)*(size-1);
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 9);
+  testproblem.nine_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<number> A (structure);
+  testproblem.nine_point (A, true);
+
+  SlicedEllpackMatrix<number> B;
+  B.reinit (A, typename SlicedEllpackMatrix<number>::AdditionalData(sorting_window));
+  deallog << "Size " << size << " window " << sorting_window
+          << " nonzeros: " << B.n_nonzero_elements()
+          << " padding ok: " << (B.n_stored_elements() >= B.n_nonzero_elements())
+          << std::endl;
+
+  for (unsigned int i=0; i<dim; ++i)
+    for (unsigned int j=0; j<dim; ++j)
+      Assert (B.el(i,j) == A.el(i,j), ExcInternalError());
+
+  Vector<number> src (dim), dst1 (dim), dst2 (dim);
+  for (unsigned int i=0; i<dim; ++i)
+    src(i) = (i%7) + 0.5*(i%3);
+
+  A.vmult (dst1, src);
+  B.vmult (dst2, src);
+  dst2 -= dst1;
+  deallog << "vmult error: " << relative_error(dst2, dst1) << std::endl;
+
+  A.vmult_add (dst1, src);
+  B.vmult (dst2, src);
+  B.vmult_add (dst2, src);
+  dst2 -= dst1;
+  deallog << "vmult_add error: " << relative_error(dst2, dst1) << std::endl;
+
+  A.Tvmult (dst1, src);
+  B.Tvmult (dst2, src);
+  dst2 -= dst1;
+  deallog << "Tvmult error: " << relative_error(dst2, dst1) << std::endl;
+
+  A.Tvmult_add (dst1, src);
+  B.Tvmult (dst2, src);
+  B.Tvmult_add (dst2, src);
+  dst2 -= dst1;
+  deallog << "Tvmult_add error: " << relative_error(dst2, dst1) << std::endl;
+
+  const double norm_error
+    = std::abs(A.matrix_norm_square(src) - B.matrix_norm_square(src)) /
+      std::abs(A.matrix_norm_square(src));
+  deallog << "matrix_norm_square error: "
+          << (norm_error < 100. * std::numeric_limits<number>::epsilon() ?
+              0. : norm_error)
+          << std::endl;
+}
+
+
+
+void check_solve (const unsigned int size)
+{
+  const unsigned int dim = (size-1)*(size-1);
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A);
+
+  SlicedEllpackMatrix<double> B;
+  B.reinit (structure);
+  B.copy_from (A);
+
+  Vector<double> f (dim), u1 (dim), u2 (dim);
+  f = 1.;
+
+  SolverControl control1 (1000, 1e-10);
+  SolverCG<> solver1 (control1);
+  solver1.solve (A, u1, f, PreconditionIdentity());
+
+  SolverControl control2 (1000, 1e-10);
+  SolverCG<> solver2 (control2);
+  solver2.solve (B, u2, f, PreconditionIdentity());
+
+  deallog << "CG iterations equal: "
+          << (control1.last_step() == control2.last_step()) << std::endl;
+  u2 -= u1;
+  deallog << "Solution difference: " << u2.l2_norm() << std::endl;
+}
+
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog << std::setprecision(4);
+  deallog.attach(logfile);
+  deallog.depth_console(0);
+  deallog.threshold_double(1.e-10);
+
+  deallog.push("double");
+  for (unsigned int size=4; size <= 16; size *= 2)
+    {
+      check_products<double> (size, 1);
+      check_products<double> (size, 256);
+    }
+  deallog.pop();
+
+  deallog.push("float");
+  check_products<float> (16, 32);
+  deallog.pop();
+
+  check_solve (32);
+}
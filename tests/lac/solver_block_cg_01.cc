@@ -0,0 +1,136 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SparseMatrix::vmult with a MultiVector against the product with each
+// column, and compare the solutions of SolverBlockCG with those of SolverCG
+// for each column on the five-point stencil. The last right hand side is a
+// multiple of the first one, which makes the block of search directions rank
+// deficient
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_block_cg.h>
+#include <deal.II/lac/precondition.h>
+
+
+template <class PRECONDITION, class BLOCK_PRECONDITION, class OPERATOR>
+void
+check_solve (const SparseMatrix<double> &A,
+             const OPERATOR             &op,
+             const MultiVector<double>  &f,
+             const PRECONDITION         &P,
+             const BLOCK_PRECONDITION   &block_P)
+{
+  SolverControl control (500, 1.e-10, false, false);
+  SolverControl block_control (500, 1.e-10, false, false);
+  SolverCG<> cg (control);
+  SolverBlockCG<> block_cg (block_control);
+
+  MultiVector<double> u (A.m(), f.n_columns());
+  block_cg.solve (op, u, f, block_P);
+
+  unsigned int max_cg_steps = 0;
+  double max_difference = 0, max_solution = 0;
+  Vector<double> f_column (A.m()), u_column (A.m()), u_block (A.m());
+  for (unsigned int k=0; k<f.n_columns(); ++k)
+    {
+      f.extract_column (k, f_column);
+      u_column = 0;
+      cg.solve (A, u_column, f_column, P);
+      max_cg_steps = std::max (max_cg_steps, control.last_step());
+
+      u.extract_column (k, u_block);
+      u_block -= u_column;
+      max_difference = std::max (max_difference, u_block.linfty_norm());
+      max_solution = std::max (max_solution, u_column.linfty_norm());
+    }
+
+  deallog << "Block cg needs fewer iterations than cg: "
+          << (block_control.last_step() < max_cg_steps ? "yes" : "no")
+          << ", difference in solution: "
+          << (max_difference < 1e-6 * max_solution ? "small" : "large")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+
+  const unsigned int size = 32;
+  const unsigned int dim = (size-1)*(size-1);
+  const unsigned int n_columns = 6;
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A);
+
+  MultiVector<double> f (dim, n_columns);
+  for (unsigned int i=0; i<dim; ++i)
+    {
+      for (unsigned int k=0; k<n_columns-1; ++k)
+        f(i,k) = 1. + std::sin (0.1 * (k+1) * i);
+      f(i,n_columns-1) = 2. * f(i,0);
+    }
+
+  // compare the product with all columns to the product with each column
+  {
+    MultiVector<double> Af (dim, n_columns);
+    A.vmult (Af, f);
+    Vector<double> src (dim), dst (dim), result (dim);
+    double difference = 0;
+    for (unsigned int k=0; k<n_columns; ++k)
+      {
+        f.extract_column (k, src);
+        A.vmult (dst, src);
+        Af.extract_column (k, result);
+        result -= dst;
+        difference = std::max (difference, result.linfty_norm());
+      }
+    deallog << "Difference in vmult: " << difference << std::endl;
+  }
+
+  deallog.push ("no");
+  check_solve (A, A, f, PreconditionIdentity(), PreconditionIdentity());
+  deallog.pop ();
+
+  deallog.push ("jacobi");
+  PreconditionJacobi<> prec_jacobi;
+  prec_jacobi.initialize (A, 0.8);
+  check_solve (A, A, f, prec_jacobi, prec_jacobi);
+  deallog.pop ();
+
+  deallog.push ("columnwise");
+  MultiVectorColumnwiseOperator<SparseMatrix<double>,Vector<double> >
+  columnwise_A (A, Vector<double>(dim));
+  check_solve (A, columnwise_A, f, PreconditionIdentity(), PreconditionIdentity());
+  deallog.pop ();
+}
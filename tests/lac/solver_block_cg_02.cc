@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SolverBlockCG with a ReductionControl and right hand sides of very
+// different magnitude: the columns are considered converged once their
+// residual has been reduced relative to the largest initial residual, which
+// the absolute tolerance of the control object alone would never detect.
+// also check that MultiVector::inner_products on a tall multi-vector agrees
+// with the inner products of the single columns. the control object must
+// only see the largest residual of each iteration
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/multi_vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_block_cg.h>
+#include <deal.II/lac/precondition.h>
+
+
+void check_inner_products ()
+{
+  const unsigned int n_rows = 70001, n_v = 3, n_w = 4;
+  MultiVector<double> v (n_rows, n_v), w (n_rows, n_w);
+  for (unsigned int i=0; i<n_rows; ++i)
+    {
+      for (unsigned int k=0; k<n_v; ++k)
+        v(i,k) = std::sin (0.01 * (k+1) * i);
+      for (unsigned int k=0; k<n_w; ++k)
+        w(i,k) = std::cos (0.03 * (k+2) * i);
+    }
+
+  FullMatrix<double> result;
+  v.inner_products (w, result);
+
+  Vector<double> v_column (n_rows), w_column (n_rows);
+  double max_error = 0;
+  for (unsigned int j=0; j<n_v; ++j)
+    for (unsigned int k=0; k<n_w; ++k)
+      {
+        v.extract_column (j, v_column);
+        w.extract_column (k, w_column);
+        max_error = std::max (max_error,
+                              std::abs (result(j,k) - v_column * w_column));
+      }
+  deallog << "Size of inner products: " << result.m() << "x" << result.n()
+          << ", difference to columnwise products: " << max_error << std::endl;
+}
+
+
+
+// a ReductionControl that counts the calls to check()
+class CountingReductionControl : public ReductionControl
+{
+public:
+  CountingReductionControl (const unsigned int n,
+                            const double       tol,
+                            const double       red)
+    :
+    ReductionControl (n, tol, red),
+    n_checks (0)
+  {}
+
+  virtual State check (const unsigned int step,
+                       const double       check_value)
+  {
+    ++n_checks;
+    return ReductionControl::check (step, check_value);
+  }
+
+  unsigned int n_checks;
+};
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+  deallog.threshold_double(1.e-10);
+
+  check_inner_products ();
+
+  const unsigned int size = 32;
+  const unsigned int dim = (size-1)*(size-1);
+  const unsigned int n_columns = 4;
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A);
+
+  MultiVector<double> f (dim, n_columns);
+  for (unsigned int i=0; i<dim; ++i)
+    for (unsigned int k=0; k<n_columns; ++k)
+      f(i,k) = std::pow (1e-2, double(k)) * (1. + std::sin (0.1 * (k+1) * i));
+
+  std::vector<double> initial_norms;
+  f.column_norms (initial_norms);
+  const double reduction = 1e-8;
+
+  // the control object should only log the start and the convergence of
+  // the largest residual, not the checks of the single columns
+  CountingReductionControl control (500, 1e-30, reduction);
+  SolverBlockCG<> block_cg (control);
+  MultiVector<double> u (dim, n_columns);
+  block_cg.solve (A, u, f, PreconditionIdentity());
+
+  // compute the residuals of the single columns
+  MultiVector<double> r (dim, n_columns);
+  A.vmult (r, u);
+  r.sadd (-1., 1., f);
+  std::vector<double> norms;
+  r.column_norms (norms);
+
+  const double max_initial = *std::max_element (initial_norms.begin(),
+                                                 initial_norms.end());
+  for (unsigned int k=0; k<n_columns; ++k)
+    deallog << "Column " << k << " reduced relative to largest initial residual: "
+            << (norms[k] <= 1.01 * reduction * max_initial ? "yes" : "no")
+            << std::endl;
+  deallog << "Checks of the control object per iteration: "
+          << double(control.n_checks) / (control.last_step() + 1) << std::endl;
+  deallog << "Block cg stopped before maximal number of steps: "
+          << (control.last_step() < 500 ? "yes" : "no") << std::endl;
+}
@@ -0,0 +1,100 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SolverIterativeRefinement with inner solvers in single precision on
+// the five-point stencil: the solution must reach the tolerance of double
+// precision and agree with the solution of SolverCG in double precision
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_iterative_refinement.h>
+#include <deal.II/lac/precondition.h>
+
+
+template <class PRECONDITION>
+void
+check (const SparseMatrix<double> &A,
+       const SparseMatrix<float>  &A_float,
+       const PRECONDITION         &P_float,
+       const SolverIterativeRefinement<>::AdditionalData &data)
+{
+  Vector<double> f (A.m()), u (A.m()), reference (A.m());
+  for (unsigned int i=0; i<f.size(); ++i)
+    f(i) = 1. + std::sin (0.1 * i);
+
+  SolverControl control (100, 1.e-12 * f.l2_norm(), false, false);
+  SolverIterativeRefinement<> solver (control, data);
+  solver.solve (A, u, f, A_float, P_float);
+
+  SolverControl reference_control (1000, 1.e-12 * f.l2_norm(), false, false);
+  SolverCG<> cg (reference_control);
+  cg.solve (A, reference, f, PreconditionIdentity());
+
+  Vector<double> residual (A.m());
+  A.vmult (residual, u);
+  residual -= f;
+
+  reference -= u;
+  deallog << "Outer iterations: "
+          << (control.last_step() < 10 ? "less than 10" : "10 or more")
+          << ", residual below tolerance: "
+          << (residual.l2_norm() <= 1e-12 * f.l2_norm() ? "yes" : "no")
+          << ", difference to double cg: "
+          << (reference.linfty_norm() < 1e-8 * u.linfty_norm() ? "small" : "large")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+
+  const unsigned int size = 32;
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A);
+  SparseMatrix<float> A_float (structure);
+  A_float.copy_from (A);
+
+  typedef SolverIterativeRefinement<>::AdditionalData AdditionalData;
+
+  deallog.push ("cg");
+  check (A, A_float, PreconditionIdentity(), AdditionalData());
+  PreconditionSSOR<SparseMatrix<float> > ssor;
+  ssor.initialize (A_float, 1.2);
+  check (A, A_float, ssor, AdditionalData());
+  deallog.pop ();
+
+  deallog.push ("gmres");
+  check (A, A_float, ssor, AdditionalData (AdditionalData::gmres, 1e-2));
+  deallog.pop ();
+}
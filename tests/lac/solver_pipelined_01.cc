@@ -0,0 +1,101 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compare SolverPipelinedCG with SolverCG and SolverGMRES with classical
+// Gram-Schmidt orthogonalization with the default modified Gram-Schmidt
+// variant on the five-point stencil
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/precondition.h>
+
+
+template<class SOLVER1, class SOLVER2, class PRECONDITION>
+void
+compare (SOLVER1 &solver1, SolverControl &control1,
+         SOLVER2 &solver2, SolverControl &control2,
+         const SparseMatrix<double> &A,
+         const PRECONDITION &P)
+{
+  Vector<double> f (A.m()), u1 (A.m()), u2 (A.m());
+  f = 1.;
+  solver1.solve (A, u1, f, P);
+  solver2.solve (A, u2, f, P);
+  u2 -= u1;
+  // the iteration counts may differ slightly due to roundoff
+  deallog << "Difference in iterations: "
+          << (std::abs((int)control1.last_step() - (int)control2.last_step()) <= 1 ?
+              "at most one" : "more than one")
+          << ", difference in solution: "
+          << (u2.linfty_norm() < 1e-6 * u1.linfty_norm() ? "small" : "large")
+          << std::endl;
+}
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+
+  SolverControl control1 (500, 1.e-10, false, false);
+  SolverControl control2 (500, 1.e-10, false, false);
+  SolverCG<> cg (control1);
+  SolverPipelinedCG<> pipelined_cg (control2);
+  SolverGMRES<>::AdditionalData data (20);
+  SolverGMRES<> gmres (control1, data);
+  data.use_classical_gram_schmidt = true;
+  SolverGMRES<> gmres_classical (control2, data);
+
+  for (unsigned int size=4; size <= 40; size *= 3)
+    {
+      const unsigned int dim = (size-1)*(size-1);
+
+      deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+      FDMatrix testproblem (size, size);
+      SparsityPattern structure (dim, dim, 5);
+      testproblem.five_point_structure (structure);
+      structure.compress ();
+      SparseMatrix<double> A (structure);
+      testproblem.five_point (A);
+
+      PreconditionIdentity prec_no;
+      PreconditionSSOR<> prec_ssor;
+      prec_ssor.initialize (A, 1.2);
+
+      deallog.push ("no");
+      compare (cg, control1, pipelined_cg, control2, A, prec_no);
+      compare (gmres, control1, gmres_classical, control2, A, prec_no);
+      deallog.pop ();
+
+      deallog.push ("ssor");
+      compare (cg, control1, pipelined_cg, control2, A, prec_ssor);
+      compare (gmres, control1, gmres_classical, control2, A, prec_ssor);
+      deallog.pop ();
+    }
+}
@@ -0,0 +1,134 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SparseILU and SparseMIC give exactly the same results with and
+// without level scheduling, for the decomposition with the sparsity pattern
+// of the matrix and with additional off-diagonals. the second matrix is large
+// enough for levels with more rows than the grain size of the parallel loop
+// over the rows of a level, such that the rows are split among threads
+
+#include "../tests.h"
+#include "testmatrix.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_ilu.h>
+#include <deal.II/lac/sparse_mic.h>
+#include <deal.II/lac/vector.h>
+
+
+template <class DECOMPOSITION>
+void
+check (const SparseMatrix<double> &A,
+       const unsigned int          extra_off_diagonals)
+{
+  typename DECOMPOSITION::AdditionalData data (0., extra_off_diagonals);
+  DECOMPOSITION sequential;
+  sequential.initialize (A, data);
+
+  data.use_level_scheduling = true;
+  DECOMPOSITION level_scheduled;
+  level_scheduled.initialize (A, data);
+
+  Vector<double> src (A.m()), dst1 (A.m()), dst2 (A.m());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = 1. + std::sin (0.1 * i);
+
+  sequential.vmult (dst1, src);
+  level_scheduled.vmult (dst2, src);
+
+  bool identical = true;
+  for (unsigned int i=0; i<src.size(); ++i)
+    if (dst1(i) != dst2(i))
+      identical = false;
+
+  deallog << "extra off-diagonals " << extra_off_diagonals
+          << ": vmult " << (identical ? "identical" : "different")
+          << std::endl;
+}
+
+
+
+// return the largest number of rows in one level of the forward
+// substitution with the lower triangle of the given sparsity pattern
+unsigned int
+max_level_size (const SparsityPattern &sparsity)
+{
+  std::vector<unsigned int> row_level (sparsity.n_rows(), 0);
+  std::vector<unsigned int> level_size;
+  for (unsigned int row=0; row<sparsity.n_rows(); ++row)
+    {
+      for (SparsityPattern::iterator it = sparsity.begin(row);
+           it != sparsity.end(row); ++it)
+        if (it->column() < row)
+          row_level[row] = std::max (row_level[row], row_level[it->column()]+1);
+      if (row_level[row] >= level_size.size())
+        level_size.resize (row_level[row]+1, 0);
+      ++level_size[row_level[row]];
+    }
+  return *std::max_element (level_size.begin(), level_size.end());
+}
+
+
+
+void test (const unsigned int size,
+           const bool         nine_point)
+{
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 9);
+  if (nine_point)
+    testproblem.nine_point_structure (structure);
+  else
+    testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  if (nine_point)
+    testproblem.nine_point (A);
+  else
+    testproblem.five_point (A);
+
+  deallog << "Size " << dim << ", largest level of the matrix: "
+          << max_level_size (structure) << " rows" << std::endl;
+
+  deallog.push ("ilu");
+  check<SparseILU<double> > (A, 0);
+  check<SparseILU<double> > (A, 3);
+  deallog.pop ();
+
+  deallog.push ("mic");
+  check<SparseMIC<double> > (A, 0);
+  check<SparseMIC<double> > (A, 3);
+  deallog.pop ();
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+  MultithreadInfo::set_thread_limit (4);
+
+  test (40, true);
+  test (200, false);
+}
@@ -0,0 +1,92 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check Vector::add_linear_combination and Vector::inner_products against
+// calling Vector::add and the inner product for each vector separately. The
+// large size makes sure that the multithreaded code path is taken
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/vector.h>
+
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+
+
+template <typename number>
+void check (const unsigned int size,
+            const double       tolerance)
+{
+  const unsigned int n_vectors = 5;
+  Vector<number> v (size), reference;
+  std::vector<Vector<number> > w (n_vectors, Vector<number>(size));
+  std::vector<const Vector<number> *> w_ptr (n_vectors);
+  std::vector<number> a (n_vectors);
+  for (unsigned int i=0; i<size; ++i)
+    {
+      v(i) = (number)Testing::rand()/RAND_MAX;
+      for (unsigned int k=0; k<n_vectors; ++k)
+        w[k](i) = (number)Testing::rand()/RAND_MAX;
+    }
+  for (unsigned int k=0; k<n_vectors; ++k)
+    {
+      a[k] = (number)Testing::rand()/RAND_MAX - 0.5;
+      w_ptr[k] = &w[k];
+    }
+
+  std::vector<number> products;
+  v.inner_products (w_ptr, products);
+  AssertDimension (products.size(), n_vectors);
+  bool products_ok = true;
+  for (unsigned int k=0; k<n_vectors; ++k)
+    {
+      const number reference_product = v * w[k];
+      if (std::abs(products[k] - reference_product) >
+          tolerance * std::abs(reference_product))
+        products_ok = false;
+    }
+
+  reference = v;
+  for (unsigned int k=0; k<n_vectors; ++k)
+    reference.add (a[k], w[k]);
+  v.add_linear_combination (a, w_ptr);
+  reference -= v;
+
+  deallog << "size " << size << ": inner products "
+          << (products_ok ? "ok" : "wrong")
+          << ", linear combination "
+          << (reference.linfty_norm() < tolerance ? "ok" : "wrong")
+          << std::endl;
+}
+
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog << std::fixed;
+  deallog << std::setprecision(2);
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  check<double> (17, 1e-12);
+  check<double> (100000, 1e-12);
+  check<float> (17, 1e-5);
+  check<float> (100000, 1e-5);
+}
@@ -0,0 +1,443 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// same as face_loop_01, but in parallel with faces towards ghost cells. The
+// cells of a serial triangulation are distributed among the processors in a
+// checkerboard pattern, such that almost all faces, including faces with
+// hanging nodes, are between cells owned by different processors. Checks
+// that every face is worked on exactly once and compares the result of
+// MatrixFree::loop against a sparse matrix assembled on the whole mesh
+
+#include "../tests.h"
+
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/compressed_simple_sparsity_pattern.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/fe_face_evaluation.h>
+
+#include <fstream>
+#include <iostream>
+
+
+const double penalty = 10.;
+
+
+template <int dim, int fe_degree>
+class LaplaceOperator
+{
+public:
+  typedef parallel::distributed::Vector<double> VectorType;
+
+  LaplaceOperator (const MatrixFree<dim,double> &data)
+    :
+    data (data)
+  {}
+
+  void vmult (VectorType &dst, const VectorType &src) const
+  {
+    dst = 0;
+    data.loop (&LaplaceOperator::local_cell,
+               &LaplaceOperator::local_face,
+               &LaplaceOperator::local_boundary,
+               this, dst, src);
+  }
+
+private:
+  void local_cell (const MatrixFree<dim,double>              &data,
+                   VectorType                                &dst,
+                   const VectorType                          &src,
+                   const std::pair<unsigned int,unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim,fe_degree> phi (data);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        phi.evaluate (false, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          phi.submit_gradient (phi.get_gradient(q), q);
+        phi.integrate (false, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  void local_face (const MatrixFree<dim,double>              &data,
+                   VectorType                                &dst,
+                   const VectorType                          &src,
+                   const std::pair<unsigned int,unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim,fe_degree> phi_m (data, true);
+    FEFaceEvaluation<dim,fe_degree> phi_p (data, false);
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        phi_m.reinit (face);
+        phi_p.reinit (face);
+        phi_m.read_dof_values (src);
+        phi_p.read_dof_values (src);
+        phi_m.evaluate (true, true);
+        phi_p.evaluate (true, true);
+        for (unsigned int q=0; q<phi_m.n_q_points; ++q)
+          {
+            const VectorizedArray<double> jump =
+              phi_m.get_value(q) - phi_p.get_value(q);
+            const VectorizedArray<double> average_normal_gradient =
+              make_vectorized_array(0.5) * (phi_m.get_normal_gradient(q) +
+                                            phi_p.get_normal_gradient(q));
+            const VectorizedArray<double> flux =
+              make_vectorized_array(penalty) * jump - average_normal_gradient;
+            phi_m.submit_value (flux, q);
+            phi_p.submit_value (-flux, q);
+            phi_m.submit_normal_gradient (make_vectorized_array(-0.5) * jump, q);
+            phi_p.submit_normal_gradient (make_vectorized_array(-0.5) * jump, q);
+          }
+        phi_m.integrate (true, true);
+        phi_p.integrate (true, true);
+        phi_m.distribute_local_to_global (dst);
+        phi_p.distribute_local_to_global (dst);
+      }
+  }
+
+  void local_boundary (const MatrixFree<dim,double>              &data,
+                       VectorType                                &dst,
+                       const VectorType                          &src,
+                       const std::pair<unsigned int,unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim,fe_degree> phi (data, true);
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        phi.reinit (face);
+        phi.read_dof_values (src);
+        phi.evaluate (true, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          {
+            const VectorizedArray<double> value = phi.get_value(q);
+            phi.submit_value (make_vectorized_array(penalty) * value -
+                              phi.get_normal_gradient(q), q);
+            phi.submit_normal_gradient (-value, q);
+          }
+        phi.integrate (true, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  const MatrixFree<dim,double> &data;
+};
+
+
+
+// assembles the face matrix between the two sides given by the FEValues
+// objects, where the normal vector is taken from the interior side
+template <int dim>
+void assemble_face (const FEFaceValuesBase<dim> &fe_m,
+                    const FEFaceValuesBase<dim> &fe_p,
+                    FullMatrix<double>          &matrix)
+{
+  const unsigned int dofs_per_cell = fe_m.dofs_per_cell;
+  matrix = 0;
+  for (unsigned int q=0; q<fe_m.n_quadrature_points; ++q)
+    {
+      Assert (fe_m.quadrature_point(q).distance(fe_p.quadrature_point(q)) < 1e-12,
+              ExcInternalError());
+      const Tensor<1,dim> normal = fe_m.normal_vector(q);
+      for (unsigned int i=0; i<2*dofs_per_cell; ++i)
+        {
+          const FEFaceValuesBase<dim> &fe_i = i < dofs_per_cell ? fe_m : fe_p;
+          const double sign_i = i < dofs_per_cell ? 1. : -1.;
+          const unsigned int ii = i % dofs_per_cell;
+          for (unsigned int j=0; j<2*dofs_per_cell; ++j)
+            {
+              const FEFaceValuesBase<dim> &fe_j = j < dofs_per_cell ? fe_m : fe_p;
+              const double sign_j = j < dofs_per_cell ? 1. : -1.;
+              const unsigned int jj = j % dofs_per_cell;
+              matrix(i,j) += (penalty * sign_i * fe_i.shape_value(ii,q) *
+                              sign_j * fe_j.shape_value(jj,q)
+                              - 0.5 * (fe_j.shape_grad(jj,q) * normal) *
+                              sign_i * fe_i.shape_value(ii,q)
+                              - 0.5 * (fe_i.shape_grad(ii,q) * normal) *
+                              sign_j * fe_j.shape_value(jj,q)) * fe_m.JxW(q);
+            }
+        }
+    }
+}
+
+
+
+template <int dim>
+void assemble_matrix (const DoFHandler<dim> &dof,
+                      SparseMatrix<double>  &matrix)
+{
+  const FiniteElement<dim> &fe = dof.get_fe();
+  const unsigned int dofs_per_cell = fe.dofs_per_cell;
+  const QGauss<dim>   quadrature (fe.degree+1);
+  const QGauss<dim-1> face_quadrature (fe.degree+1);
+  FEValues<dim> fe_values (fe, quadrature,
+                           update_gradients | update_JxW_values);
+  const UpdateFlags face_flags = update_values | update_gradients |
+                                 update_JxW_values | update_normal_vectors |
+                                 update_quadrature_points;
+  FEFaceValues<dim> fe_face_m (fe, face_quadrature, face_flags);
+  FEFaceValues<dim> fe_face_p (fe, face_quadrature, face_flags);
+  FESubfaceValues<dim> fe_subface_p (fe, face_quadrature, face_flags);
+
+  FullMatrix<double> cell_matrix (dofs_per_cell, dofs_per_cell);
+  FullMatrix<double> face_matrix (2*dofs_per_cell, 2*dofs_per_cell);
+  std::vector<types::global_dof_index> dof_indices (dofs_per_cell);
+  std::vector<types::global_dof_index> face_dof_indices (2*dofs_per_cell);
+
+  for (typename DoFHandler<dim>::active_cell_iterator cell=dof.begin_active();
+       cell != dof.end(); ++cell)
+    {
+      fe_values.reinit (cell);
+      cell_matrix = 0;
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          for (unsigned int j=0; j<dofs_per_cell; ++j)
+            cell_matrix(i,j) += (fe_values.shape_grad(i,q) *
+                                 fe_values.shape_grad(j,q) *
+                                 fe_values.JxW(q));
+      cell->get_dof_indices (dof_indices);
+      matrix.add (dof_indices, cell_matrix);
+
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          if (cell->at_boundary(f))
+            {
+              fe_face_m.reinit (cell, f);
+              cell_matrix = 0;
+              for (unsigned int q=0; q<face_quadrature.size(); ++q)
+                for (unsigned int i=0; i<dofs_per_cell; ++i)
+                  for (unsigned int j=0; j<dofs_per_cell; ++j)
+                    cell_matrix(i,j) += (penalty * fe_face_m.shape_value(i,q) *
+                                         fe_face_m.shape_value(j,q)
+                                         - (fe_face_m.shape_grad(j,q) *
+                                            fe_face_m.normal_vector(q)) *
+                                         fe_face_m.shape_value(i,q)
+                                         - (fe_face_m.shape_grad(i,q) *
+                                            fe_face_m.normal_vector(q)) *
+                                         fe_face_m.shape_value(j,q)) *
+                                        fe_face_m.JxW(q);
+              matrix.add (dof_indices, cell_matrix);
+              continue;
+            }
+
+          const typename DoFHandler<dim>::cell_iterator neighbor =
+            cell->neighbor(f);
+          // faces with hanging nodes are visited from the finer side
+          if (neighbor->has_children())
+            continue;
+
+          fe_face_m.reinit (cell, f);
+          if (cell->neighbor_is_coarser(f))
+            {
+              const std::pair<unsigned int,unsigned int> face_subface =
+                cell->neighbor_of_coarser_neighbor(f);
+              fe_subface_p.reinit (neighbor, face_subface.first,
+                                   face_subface.second);
+              assemble_face (fe_face_m, fe_subface_p, face_matrix);
+            }
+          else if (neighbor->index() > cell->index())
+            {
+              fe_face_p.reinit (neighbor, cell->neighbor_of_neighbor(f));
+              assemble_face (fe_face_m, fe_face_p, face_matrix);
+            }
+          else
+            continue;
+
+          neighbor->get_dof_indices (dof_indices);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            face_dof_indices[dofs_per_cell+i] = dof_indices[i];
+          cell->get_dof_indices (dof_indices);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            face_dof_indices[i] = dof_indices[i];
+          matrix.add (face_dof_indices, face_matrix);
+        }
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+  const unsigned int my_id = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (1);
+  // deform the mesh by moving the center vertex
+  for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+       cell != tria.end(); ++cell)
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      if (std::abs(cell->vertex(v).norm() - std::sqrt(0.25*dim)) < 1e-10)
+        {
+          cell->vertex(v)[0] = 0.58;
+          cell->vertex(v)[1] = 0.45;
+        }
+  tria.refine_global (dim == 2 ? 2 : 1);
+  tria.begin_active()->set_refine_flag();
+  tria.last()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  // distribute the cells in a checkerboard pattern on the cells before the
+  // last refinement, such that the refined cells have the same owner and
+  // the faces with hanging nodes are between different processors
+  const unsigned int n_blocks = dim == 2 ? 8 : 4;
+  for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+       cell != tria.end(); ++cell)
+    {
+      unsigned int block = 0;
+      for (unsigned int d=0; d<dim; ++d)
+        block += static_cast<unsigned int>(cell->center()[d] * n_blocks);
+      cell->set_subdomain_id (block % n_procs);
+    }
+
+  FE_DGQ<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+  DoFRenumbering::subdomain_wise (dof);
+  const IndexSet locally_owned_dofs =
+    DoFTools::locally_owned_dofs_per_subdomain (dof)[my_id];
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  deallog << "Testing " << fe.get_name() << " on "
+          << tria.n_active_cells() << " cells" << std::endl;
+
+  CompressedSimpleSparsityPattern csp (dof.n_dofs(), dof.n_dofs());
+  DoFTools::make_flux_sparsity_pattern (dof, csp);
+  SparsityPattern sparsity;
+  sparsity.copy_from (csp);
+  SparseMatrix<double> matrix (sparsity);
+  assemble_matrix (dof, matrix);
+
+  MatrixFree<dim,double> mf_data;
+  {
+    typename MatrixFree<dim,double>::AdditionalData data;
+    data.mpi_communicator = MPI_COMM_WORLD;
+    data.mapping_update_flags_inner_faces = update_values | update_gradients |
+                                            update_JxW_values;
+    data.mapping_update_flags_boundary_faces = update_values | update_gradients |
+                                               update_JxW_values;
+    data.tasks_block_size = 3;
+    mf_data.reinit (MappingQ1<dim>(),
+                    std::vector<const DoFHandler<dim> *>(1, &dof),
+                    std::vector<const ConstraintMatrix *>(1, &constraints),
+                    std::vector<IndexSet>(1, locally_owned_dofs),
+                    std::vector<QGauss<1> >(1, QGauss<1>(fe_degree+1)), data);
+  }
+
+  // count the faces of all processors, which must be the same as in the
+  // serial case, and the faces towards ghost cells
+  const internal::MatrixFreeFunctions::FaceInfo<dim,double> &face_info =
+    mf_data.get_face_info();
+  const unsigned int n_cells = mf_data.n_macro_cells() *
+                               VectorizedArray<double>::n_array_elements;
+  unsigned int n_inner_faces = 0, n_boundary_faces = 0, n_ghost_faces = 0;
+  for (unsigned int f=0; f<face_info.faces.size(); ++f)
+    if (f < mf_data.n_inner_face_batches())
+      {
+        n_inner_faces += face_info.faces[f].n_filled_lanes;
+        for (unsigned int v=0; v<face_info.faces[f].n_filled_lanes; ++v)
+          if (face_info.faces[f].cells_exterior[v] >= n_cells)
+            ++n_ghost_faces;
+      }
+    else
+      n_boundary_faces += face_info.faces[f].n_filled_lanes;
+  deallog << "Number of faces: "
+          << Utilities::MPI::sum (n_inner_faces, MPI_COMM_WORLD) << " inner, "
+          << Utilities::MPI::sum (n_boundary_faces, MPI_COMM_WORLD) << " boundary, "
+          << Utilities::MPI::sum (n_ghost_faces, MPI_COMM_WORLD)
+          << " towards ghost cells" << std::endl;
+
+  LaplaceOperator<dim,fe_degree> mf (mf_data);
+  parallel::distributed::Vector<double> in, out;
+  mf_data.initialize_dof_vector (in);
+  mf_data.initialize_dof_vector (out);
+  Vector<double> in_serial (dof.n_dofs()), ref (dof.n_dofs());
+  for (unsigned int i=0; i<dof.n_dofs(); ++i)
+    in_serial(i) = (double)Testing::rand()/RAND_MAX;
+
+  for (unsigned int i=0; i<2; ++i)
+    {
+      for (IndexSet::ElementIterator it=locally_owned_dofs.begin();
+           it != locally_owned_dofs.end(); ++it)
+        in(*it) = in_serial(*it);
+      mf.vmult (out, in);
+      matrix.vmult (ref, in_serial);
+      deallog << "Norm of matrix-free result: " << out.l2_norm() << std::endl;
+      double error = 0;
+      for (IndexSet::ElementIterator it=locally_owned_dofs.begin();
+           it != locally_owned_dofs.end(); ++it)
+        error = std::max (error, std::abs(out(*it) - ref(*it)));
+      deallog << "Error matrix-free vs. matrix: "
+              << Utilities::MPI::max (error, MPI_COMM_WORLD) / ref.linfty_norm()
+              << std::endl;
+      in_serial = ref;
+      in_serial /= ref.linfty_norm();
+    }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog << std::setprecision(3);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-12);
+
+      deallog.push("2d");
+      test<2,1>();
+      test<2,3>();
+      deallog.pop();
+      deallog.push("3d");
+      test<3,2>();
+      deallog.pop();
+    }
+  else
+    {
+      deallog.depth_console(0);
+      test<2,1>();
+      test<2,3>();
+      test<3,2>();
+    }
+}
@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// save and load a triangulation with data attached through
+// register_data_attach(), both with and without compression of the data
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <fstream>
+#include <cstring>
+
+
+template <int dim>
+void pack_function (const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+                    const typename parallel::distributed::Triangulation<dim>::CellStatus,
+                    void *data)
+{
+  const Point<dim> center = cell->center();
+  std::memcpy (data, &center, sizeof(Point<dim>));
+}
+
+
+template <int dim>
+void unpack_function (const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+                      const typename parallel::distributed::Triangulation<dim>::CellStatus status,
+                      const void *data,
+                      unsigned int &n_errors)
+{
+  Point<dim> center;
+  std::memcpy (&center, data, sizeof(Point<dim>));
+  if (status != parallel::distributed::Triangulation<dim>::CELL_PERSIST ||
+      center.distance(cell->center()) > 1e-12)
+    ++n_errors;
+}
+
+
+template<int dim>
+void test(const bool compress_data)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const std::string filename = "dat";
+  {
+    parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+    GridGenerator::hyper_cube(tr);
+    tr.refine_global(3);
+    for (typename Triangulation<dim>::active_cell_iterator
+         cell = tr.begin_active(); cell != tr.end(); ++cell)
+      if (cell->is_locally_owned() && cell->center().norm() < 0.3)
+        cell->set_refine_flag();
+    tr.execute_coarsening_and_refinement ();
+
+    tr.register_data_attach (sizeof(Point<dim>),
+                             std_cxx11::bind(&pack_function<dim>,
+                                             std_cxx11::_1,
+                                             std_cxx11::_2,
+                                             std_cxx11::_3));
+    tr.save (filename.c_str(), compress_data);
+
+    if (myid == 0)
+      deallog << "compress=" << compress_data
+              << ", #cells = " << tr.n_global_active_cells() << std::endl;
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  {
+    parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+    GridGenerator::hyper_cube(tr);
+    tr.load (filename.c_str());
+
+    unsigned int n_errors = 0;
+    const unsigned int offset
+      = tr.register_data_attach (sizeof(Point<dim>),
+                                 std_cxx11::bind(&pack_function<dim>,
+                                                 std_cxx11::_1,
+                                                 std_cxx11::_2,
+                                                 std_cxx11::_3));
+    tr.notify_ready_to_unpack (offset,
+                               std_cxx11::bind(&unpack_function<dim>,
+                                               std_cxx11::_1,
+                                               std_cxx11::_2,
+                                               std_cxx11::_3,
+                                               std_cxx11::ref(n_errors)));
+
+    n_errors = Utilities::MPI::sum (n_errors, MPI_COMM_WORLD);
+    if (myid == 0)
+      deallog << "#cells = " << tr.n_global_active_cells()
+              << ", errors: " << n_errors << std::endl;
+  }
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+
+      deallog.push("2d");
+      test<2>(false);
+      test<2>(true);
+      deallog.pop();
+
+      deallog.push("3d");
+      test<3>(false);
+      test<3>(true);
+      deallog.pop();
+    }
+  else
+    {
+      test<2>(false);
+      test<2>(true);
+      test<3>(false);
+      test<3>(true);
+    }
+}
@@ -0,0 +1,159 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// save a triangulation with data attached through register_data_attach() on
+// some of the processors and load it on a different number of processors.
+// the attached data is read from the blocks written by other processors
+
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <fstream>
+#include <cstring>
+
+
+template <int dim>
+void pack_function (const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+                    const typename parallel::distributed::Triangulation<dim>::CellStatus,
+                    void *data)
+{
+  const Point<dim> center = cell->center();
+  std::memcpy (data, &center, sizeof(Point<dim>));
+}
+
+
+template <int dim>
+void unpack_function (const typename parallel::distributed::Triangulation<dim>::cell_iterator &cell,
+                      const typename parallel::distributed::Triangulation<dim>::CellStatus status,
+                      const void *data,
+                      unsigned int &n_errors)
+{
+  Point<dim> center;
+  std::memcpy (&center, data, sizeof(Point<dim>));
+  if (status != parallel::distributed::Triangulation<dim>::CELL_PERSIST ||
+      center.distance(cell->center()) > 1e-12)
+    ++n_errors;
+}
+
+
+template<int dim>
+void test (const unsigned int n_save,
+           const unsigned int n_load)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const std::string filename = "dat";
+
+  MPI_Comm com_save, com_load;
+  MPI_Comm_split (MPI_COMM_WORLD, myid < n_save ? 0 : MPI_UNDEFINED, myid,
+                  &com_save);
+  MPI_Comm_split (MPI_COMM_WORLD, myid < n_load ? 0 : MPI_UNDEFINED, myid,
+                  &com_load);
+
+  if (myid < n_save)
+    {
+      parallel::distributed::Triangulation<dim> tr(com_save);
+      GridGenerator::hyper_cube(tr);
+      tr.refine_global(3);
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tr.begin_active(); cell != tr.end(); ++cell)
+        if (cell->is_locally_owned() && cell->center().norm() < 0.3)
+          cell->set_refine_flag();
+      tr.execute_coarsening_and_refinement ();
+
+      tr.register_data_attach (sizeof(Point<dim>),
+                               std_cxx11::bind(&pack_function<dim>,
+                                               std_cxx11::_1,
+                                               std_cxx11::_2,
+                                               std_cxx11::_3));
+      tr.save (filename.c_str());
+
+      if (myid == 0)
+        deallog << "saved on " << n_save << " processors, #cells = "
+                << tr.n_global_active_cells() << std::endl;
+    }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  if (myid < n_load)
+    {
+      parallel::distributed::Triangulation<dim> tr(com_load);
+      GridGenerator::hyper_cube(tr);
+      tr.load (filename.c_str());
+
+      unsigned int n_errors = 0;
+      const unsigned int offset
+        = tr.register_data_attach (sizeof(Point<dim>),
+                                   std_cxx11::bind(&pack_function<dim>,
+                                                   std_cxx11::_1,
+                                                   std_cxx11::_2,
+                                                   std_cxx11::_3));
+      tr.notify_ready_to_unpack (offset,
+                                 std_cxx11::bind(&unpack_function<dim>,
+                                                 std_cxx11::_1,
+                                                 std_cxx11::_2,
+                                                 std_cxx11::_3,
+                                                 std_cxx11::ref(n_errors)));
+
+      n_errors = Utilities::MPI::sum (n_errors, com_load);
+      if (myid == 0)
+        deallog << "loaded on " << n_load << " processors, #cells = "
+                << tr.n_global_active_cells()
+                << ", errors: " << n_errors << std::endl;
+    }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  if (myid < n_save)
+    MPI_Comm_free (&com_save);
+  if (myid < n_load)
+    MPI_Comm_free (&com_load);
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  std::ofstream logfile;
+  if (myid == 0)
+    {
+      logfile.open("output");
+      deallog.attach(logfile);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+    }
+
+  deallog.push("2d");
+  test<2>(n_procs-1, n_procs);
+  test<2>(n_procs, 1);
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>(n_procs-1, n_procs);
+  test<3>(n_procs, 1);
+  deallog.pop();
+}
@@ -0,0 +1,209 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check the combined ghost exchange of parallel block vectors whose blocks
+// have different sizes and ghost entries, also with the split-phase
+// functions on two vectors at the same time and with a partitioner that
+// falls back to the block-wise exchange. in the second run, the first vector
+// switches to another communication channel while the second one is set up
+// anew on the channel the first one used before. without a neighborhood
+// communicator, the two exchanges are started in a different order on even
+// and odd processors, so messages with stale tags would be received by the
+// wrong vector
+
+#include "../tests.h"
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/lac/parallel_block_vector.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+std_cxx11::shared_ptr<const Utilities::MPI::Partitioner>
+create_partitioner (const unsigned int block,
+                    const bool         use_neighborhood)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  // block b owns 10*(b+1) entries on each processor and ghosts b+1 entries
+  // at the end of the range of each of the two following processors and
+  // entry 0 (in the last block only)
+  const unsigned int local_size = 10 * (block+1);
+  IndexSet owned (local_size * numproc);
+  owned.add_range (myid*local_size, (myid+1)*local_size);
+  IndexSet ghosts (local_size * numproc);
+  for (unsigned int p=myid+1; p<std::min(numproc, myid+3); ++p)
+    ghosts.add_range ((p+1)*local_size - block - 1, (p+1)*local_size);
+  if (block == 2)
+    ghosts.add_index (0);
+
+  std_cxx11::shared_ptr<Utilities::MPI::Partitioner> partitioner
+  (new Utilities::MPI::Partitioner (owned, ghosts, MPI_COMM_WORLD));
+  if (use_neighborhood)
+    partitioner->initialize_neighborhood_communicator ();
+  return partitioner;
+}
+
+
+
+void test (const bool use_neighborhood)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+  const unsigned int n_blocks = 3;
+  parallel::distributed::BlockVector<double> v (n_blocks), w (n_blocks);
+  std::vector<std_cxx11::shared_ptr<const Utilities::MPI::Partitioner> >
+  partitioners (n_blocks);
+  for (unsigned int b=0; b<n_blocks; ++b)
+    {
+      partitioners[b] = create_partitioner (b, use_neighborhood && b==1);
+      v.block(b).reinit (partitioners[b]);
+      w.block(b).reinit (partitioners[b]);
+    }
+  v.collect_sizes ();
+  w.collect_sizes ();
+
+  bool ghosts_ok = true, insert_ok = true, add_ok = true;
+  for (unsigned int run=0; run<2; ++run)
+    {
+      if (run == 1)
+        {
+          for (unsigned int b=0; b<n_blocks; ++b)
+            w.block(b).reinit (create_partitioner (b, use_neighborhood && b==1));
+          w.collect_sizes ();
+        }
+
+      // set the global index plus the block number times 1000 plus the run
+      for (unsigned int b=0; b<n_blocks; ++b)
+        {
+          const std::pair<types::global_dof_index,types::global_dof_index>
+          range = v.block(b).local_range();
+          for (types::global_dof_index i=range.first; i<range.second; ++i)
+            {
+              v.block(b)(i) = i + 1000.*b + run;
+              w.block(b)(i) = 2.*(i + 1000.*b + run);
+            }
+        }
+
+      // the order of the exchanges can only differ between processors for
+      // point-to-point messages, collectives must be started in the same
+      // order everywhere
+      if (myid % 2 == 0 || use_neighborhood)
+        {
+          v.update_ghost_values_start (run);
+          w.update_ghost_values_start (1-run);
+        }
+      else
+        {
+          w.update_ghost_values_start (1-run);
+          v.update_ghost_values_start (run);
+        }
+      v.update_ghost_values_finish ();
+      w.update_ghost_values_finish ();
+      for (unsigned int b=0; b<n_blocks; ++b)
+        {
+          const IndexSet &ghosts = partitioners[b]->ghost_indices();
+          for (IndexSet::ElementIterator i=ghosts.begin(); i!=ghosts.end(); ++i)
+            if (v.block(b)(*i) != *i + 1000.*b + run ||
+                w.block(b)(*i) != 2.*(*i + 1000.*b + run))
+              ghosts_ok = false;
+        }
+
+      // check that compress(insert) accepts the ghost values imported
+      // above, which are consistent with the owned values (in debug mode,
+      // the owner compares them), leaves the owned values alone and clears
+      // the ghosts, and that compress(add) adds the ghost contributions
+      v.compress (VectorOperation::insert);
+      for (unsigned int b=0; b<n_blocks; ++b)
+        {
+          const std::pair<types::global_dof_index,types::global_dof_index>
+          range = v.block(b).local_range();
+          for (types::global_dof_index i=range.first; i<range.second; ++i)
+            if (v.block(b)(i) != i + 1000.*b + run)
+              insert_ok = false;
+          for (unsigned int i=0; i<v.block(b).n_ghost_entries(); ++i)
+            if (v.block(b).local_element(v.block(b).local_size()+i) != 0.)
+              insert_ok = false;
+        }
+      v = 0;
+      for (unsigned int b=0; b<n_blocks; ++b)
+        {
+          const IndexSet &ghosts = partitioners[b]->ghost_indices();
+          for (IndexSet::ElementIterator i=ghosts.begin(); i!=ghosts.end(); ++i)
+            v.block(b)(*i) = b + 1.;
+        }
+      v.compress (VectorOperation::add);
+      for (unsigned int b=0; b<n_blocks; ++b)
+        {
+          const std::pair<types::global_dof_index,types::global_dof_index>
+          range = v.block(b).local_range();
+          for (types::global_dof_index i=range.first; i<range.second; ++i)
+            {
+              // number of processors ghosting this entry
+              unsigned int n_ghosting = 0;
+              if (i >= range.second - b - 1)
+                n_ghosting = std::min(myid, 2U);
+              if (b == 2 && i == 0)
+                n_ghosting = numproc - 1;
+              if (v.block(b)(i) != n_ghosting * (b + 1.))
+                add_ok = false;
+            }
+        }
+      v.zero_out_ghosts ();
+      w.zero_out_ghosts ();
+    }
+
+  ghosts_ok = Utilities::MPI::min (static_cast<int>(ghosts_ok), MPI_COMM_WORLD);
+  insert_ok = Utilities::MPI::min (static_cast<int>(insert_ok), MPI_COMM_WORLD);
+  add_ok = Utilities::MPI::min (static_cast<int>(add_ok), MPI_COMM_WORLD);
+  if (myid == 0)
+    deallog << "neighborhood communicator in block 1: " << use_neighborhood
+            << ", update_ghost_values " << (ghosts_ok ? "OK" : "wrong")
+            << ", compress insert " << (insert_ok ? "OK" : "wrong")
+            << ", compress add " << (add_ok ? "OK" : "wrong")
+            << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile);
+      deallog << std::setprecision(4);
+      deallog.depth_console(0);
+      deallog.threshold_double(1.e-10);
+
+      test(false);
+      test(true);
+    }
+  else
+    {
+      test(false);
+      test(true);
+    }
+}
@@ -0,0 +1,186 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that update_ghost_values() and compress() give the same results
+// with point-to-point messages, a neighborhood communicator, shared memory,
+// and both of the latter, also when repeating the exchange several times and
+// after copying and swapping vectors, also with vectors based on another
+// partitioner. optionally, the last processor neither ghosts any entries nor
+// owns entries ghosted by others, such that it has no neighbors but must
+// still take part in the collective operations
+
+#include "../tests.h"
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+void test (const bool use_neighborhood,
+           const bool use_shared_memory,
+           const bool isolate_last)
+{
+  unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  unsigned int numproc = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  const unsigned int set = 200;
+  AssertIndexRange (numproc, set-2);
+  const unsigned int local_size = set - myid;
+  unsigned int global_size = 0;
+  unsigned int my_start = 0;
+  for (unsigned int i=0; i<numproc; ++i)
+    {
+      global_size += set - i;
+      if (i<myid)
+        my_start += set - i;
+    }
+
+  // each processor owns some indices and ghosts entries from the first
+  // three processors and from both of its neighbors
+  IndexSet local_owned(global_size);
+  local_owned.add_range(my_start, my_start + local_size);
+  IndexSet local_relevant(global_size);
+  local_relevant = local_owned;
+  if (isolate_last == false || myid+1 < numproc)
+    {
+      unsigned int ghost_indices [10] = {1, 2, 13, set-2, set-1, set, set+1, 2*set,
+                                         2*set+1, 2*set+3
+                                        };
+      local_relevant.add_indices (&ghost_indices[0], &ghost_indices[0]+10);
+      if (my_start > 0)
+        local_relevant.add_range (my_start-3, my_start);
+      if (my_start + local_size < global_size &&
+          (isolate_last == false || myid+2 < numproc))
+        local_relevant.add_range (my_start + local_size, my_start + local_size + 5);
+    }
+
+  std_cxx11::shared_ptr<Utilities::MPI::Partitioner> partitioner
+  (new Utilities::MPI::Partitioner (local_owned, local_relevant,
+                                    MPI_COMM_WORLD));
+  if (use_neighborhood)
+    partitioner->initialize_neighborhood_communicator ();
+  if (use_shared_memory)
+    partitioner->initialize_shared_memory_communicator ();
+
+  parallel::distributed::Vector<double> v (partitioner);
+
+  bool ghosts_ok = true, compress_ok = true;
+  for (unsigned int run=0; run<3; ++run)
+    {
+      for (unsigned i=0; i<local_size; ++i)
+        v.local_element(i) = (run + 2.0) * (i + my_start);
+      v.update_ghost_values();
+      for (IndexSet::ElementIterator index = local_relevant.begin();
+           index != local_relevant.end(); ++index)
+        if (v(*index) != (run + 2.0) * *index)
+          ghosts_ok = false;
+
+      // add the number of the run to all ghost entries and check that the
+      // owner receives it from every process that ghosts the entry
+      v.zero_out_ghosts ();
+      v = 0;
+      for (unsigned int i=local_size; i<local_size+v.n_ghost_entries(); ++i)
+        v.local_element(i) = run + 1.;
+      v.compress (VectorOperation::add);
+
+      IndexSet ghosts = local_relevant;
+      ghosts.subtract_set (local_owned);
+      std::vector<double> n_ghosting (global_size, 0.);
+      for (IndexSet::ElementIterator index = ghosts.begin();
+           index != ghosts.end(); ++index)
+        n_ghosting[*index] = 1.;
+      Utilities::MPI::sum (n_ghosting, MPI_COMM_WORLD, n_ghosting);
+      for (unsigned i=0; i<local_size; ++i)
+        if (v.local_element(i) != (run + 1.) * n_ghosting[my_start+i])
+          compress_ok = false;
+    }
+
+  // exchange the ghosts of a copy after swapping it with the original
+  for (unsigned i=0; i<local_size; ++i)
+    v.local_element(i) = 3.0 * (i + my_start);
+  parallel::distributed::Vector<double> w (v), u;
+  u.reinit (v);
+  u.swap (w);
+  u.update_ghost_values ();
+  for (IndexSet::ElementIterator index = local_relevant.begin();
+       index != local_relevant.end(); ++index)
+    if (u(*index) != 3.0 * *index)
+      ghosts_ok = false;
+
+  // swap with a vector based on a partitioner without neighborhood and
+  // shared memory communicators, exchange the ghosts of both vectors, and
+  // reinitialize them, which frees the shared memory in the vector that now
+  // holds it
+  bool swap_ok = true;
+  std_cxx11::shared_ptr<Utilities::MPI::Partitioner> plain_partitioner
+  (new Utilities::MPI::Partitioner (local_owned, local_relevant,
+                                    MPI_COMM_WORLD));
+  parallel::distributed::Vector<double> x (plain_partitioner);
+  for (unsigned i=0; i<local_size; ++i)
+    x.local_element(i) = 5.0 * (i + my_start);
+  x.swap (u);
+  x.update_ghost_values ();
+  u.update_ghost_values ();
+  for (IndexSet::ElementIterator index = local_relevant.begin();
+       index != local_relevant.end(); ++index)
+    if (x(*index) != 3.0 * *index || u(*index) != 5.0 * *index)
+      swap_ok = false;
+  x.reinit (plain_partitioner);
+  u.reinit (partitioner);
+  u.swap (x);
+  for (unsigned i=0; i<local_size; ++i)
+    {
+      x.local_element(i) = 7.0 * (i + my_start);
+      u.local_element(i) = 9.0 * (i + my_start);
+    }
+  x.update_ghost_values ();
+  u.update_ghost_values ();
+  for (IndexSet::ElementIterator index = local_relevant.begin();
+       index != local_relevant.end(); ++index)
+    if (x(*index) != 7.0 * *index || u(*index) != 9.0 * *index)
+      swap_ok = false;
+
+  ghosts_ok = Utilities::MPI::min (static_cast<int>(ghosts_ok), MPI_COMM_WORLD);
+  swap_ok = Utilities::MPI::min (static_cast<int>(swap_ok), MPI_COMM_WORLD);
+  compress_ok = Utilities::MPI::min (static_cast<int>(compress_ok), MPI_COMM_WORLD);
+  if (myid == 0)
+    deallog << "neighborhood: " << use_neighborhood
+            << ", shared memory: " << use_shared_memory
+            << ", isolated last: " << isolate_last
+            << ", update_ghost_values " << (ghosts_ok ? "OK" : "wrong")
+            << ", compress " << (compress_ok ? "OK" : "wrong")
+            << ", swap " << (swap_ok ? "OK" : "wrong")
+            << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, testing_max_num_threads());
+  MPILogInitAll log;
+
+  for (unsigned int isolate_last=0; isolate_last<2; ++isolate_last)
+    {
+      test (false, false, isolate_last);
+      test (true, false, isolate_last);
+      test (false, true, isolate_last);
+      test (true, true, isolate_last);
+    }
+}
@@ -0,0 +1,114 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check MGTransferMatrixFree against MGTransferPrebuilt for prolongation
+// and restriction on an adaptively refined mesh
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/multigrid/mg_transfer.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
+#include <fstream>
+
+
+template <int dim>
+void check (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria(Triangulation<dim>::limit_level_difference_at_vertices);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.last_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  deallog << "Testing " << fe.get_name() << " on " << tria.n_levels()
+          << " levels" << std::endl;
+
+  DoFHandler<dim> mgdof(tria);
+  mgdof.distribute_dofs(fe);
+  mgdof.distribute_mg_dofs(fe);
+
+  MGTransferPrebuilt<Vector<double> > transfer_ref;
+  transfer_ref.build_matrices(mgdof);
+  MGTransferMatrixFree<dim,double> transfer;
+  transfer.build(mgdof);
+
+  for (unsigned int level=1; level<tria.n_levels(); ++level)
+    {
+      // prolongation
+      {
+        parallel::distributed::Vector<double> src(mgdof.n_dofs(level-1)),
+                 dst(mgdof.n_dofs(level));
+        Vector<double> src_ref(mgdof.n_dofs(level-1)), dst_ref(mgdof.n_dofs(level));
+        for (unsigned int i=0; i<src.size(); ++i)
+          src(i) = src_ref(i) = (double)Testing::rand()/RAND_MAX;
+
+        transfer.prolongate(level, dst, src);
+        transfer_ref.prolongate(level, dst_ref, src_ref);
+        for (unsigned int i=0; i<dst.size(); ++i)
+          dst_ref(i) -= dst(i);
+        deallog << "Diff prolongate   l" << level << ": "
+                << dst_ref.linfty_norm() << std::endl;
+      }
+
+      // restriction
+      {
+        parallel::distributed::Vector<double> src(mgdof.n_dofs(level)),
+                 dst(mgdof.n_dofs(level-1));
+        Vector<double> src_ref(mgdof.n_dofs(level)), dst_ref(mgdof.n_dofs(level-1));
+        for (unsigned int i=0; i<src.size(); ++i)
+          src(i) = src_ref(i) = (double)Testing::rand()/RAND_MAX;
+
+        transfer.restrict_and_add(level, dst, src);
+        transfer_ref.restrict_and_add(level, dst_ref, src_ref);
+        for (unsigned int i=0; i<dst.size(); ++i)
+          dst_ref(i) -= dst(i);
+        deallog << "Diff restrict     l" << level << ": "
+                << dst_ref.linfty_norm() << std::endl;
+      }
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+
+  initlog();
+  deallog.threshold_double(1.e-12);
+
+  check<2>(FE_Q<2>(1));
+  check<2>(FE_Q<2>(3));
+  check<2>(FE_DGQ<2>(0));
+  check<2>(FE_DGQ<2>(2));
+  check<2>(FESystem<2>(FE_Q<2>(2), 2));
+  check<3>(FE_Q<3>(1));
+  check<3>(FE_Q<3>(2));
+  check<3>(FE_DGQ<3>(1));
+}
@@ -0,0 +1,133 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check MGTransferMatrixFree against MGTransferPrebuilt for prolongation
+// and restriction on an adaptively refined parallel::distributed mesh, where
+// the children of some parent cells are owned by different processors
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/multigrid/mg_transfer.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
+#include <fstream>
+#include <cmath>
+
+
+// set the entries of a level vector to values that only depend on the
+// global index, such that they do not depend on the partitioning
+void fill (parallel::distributed::Vector<double> &vec)
+{
+  const std::pair<types::global_dof_index,types::global_dof_index>
+  range = vec.local_range();
+  for (types::global_dof_index i=range.first; i<range.second; ++i)
+    vec(i) = std::sin (1. + i);
+}
+
+
+
+template <int dim>
+void check (const FiniteElement<dim> &fe)
+{
+  parallel::distributed::Triangulation<dim>
+  tria(MPI_COMM_WORLD,
+       Triangulation<dim>::limit_level_difference_at_vertices,
+       parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell)
+        if (cell->is_locally_owned() && cell->center().norm() < 0.55)
+          cell->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+    }
+
+  deallog << "Testing " << fe.get_name() << " on " << tria.n_global_levels()
+          << " levels" << std::endl;
+
+  DoFHandler<dim> mgdof(tria);
+  mgdof.distribute_dofs(fe);
+  mgdof.distribute_mg_dofs(fe);
+
+  MGTransferPrebuilt<parallel::distributed::Vector<double> > transfer_ref;
+  transfer_ref.build_matrices(mgdof);
+  MGTransferMatrixFree<dim,double> transfer;
+  transfer.build(mgdof);
+
+  for (unsigned int level=1; level<tria.n_global_levels(); ++level)
+    {
+      // prolongation
+      {
+        parallel::distributed::Vector<double> src, dst, dst_ref;
+        src.reinit (mgdof.locally_owned_mg_dofs(level-1), MPI_COMM_WORLD);
+        dst.reinit (mgdof.locally_owned_mg_dofs(level), MPI_COMM_WORLD);
+        dst_ref.reinit (dst);
+        fill (src);
+
+        transfer.prolongate(level, dst, src);
+        transfer_ref.prolongate(level, dst_ref, src);
+        dst_ref -= dst;
+        deallog << "Diff prolongate   l" << level << ": "
+                << dst_ref.linfty_norm() << std::endl;
+      }
+
+      // restriction
+      {
+        parallel::distributed::Vector<double> src, dst, dst_ref;
+        src.reinit (mgdof.locally_owned_mg_dofs(level), MPI_COMM_WORLD);
+        dst.reinit (mgdof.locally_owned_mg_dofs(level-1), MPI_COMM_WORLD);
+        dst_ref.reinit (dst);
+        fill (src);
+
+        transfer.restrict_and_add(level, dst, src);
+        transfer_ref.restrict_and_add(level, dst_ref, src);
+        dst_ref -= dst;
+        deallog << "Diff restrict     l" << level << ": "
+                << dst_ref.linfty_norm() << std::endl;
+      }
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+
+  mpi_initlog();
+  deallog.threshold_double(1.e-12);
+
+  check<2>(FE_Q<2>(1));
+  check<2>(FE_Q<2>(3));
+  check<2>(FE_DGQ<2>(0));
+  check<2>(FE_DGQ<2>(2));
+  check<2>(FESystem<2>(FE_Q<2>(2), 2));
+  check<3>(FE_Q<3>(1));
+  check<3>(FE_Q<3>(2));
+  check<3>(FE_DGQ<3>(1));
+}
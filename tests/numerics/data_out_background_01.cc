@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that DataOutInterface::write_vtu_in_background produces the same
+// files as DataOutInterface::write_vtu, also when the DataOut object is
+// reused for the next time step while the previous file is still being
+// written. The mesh is large enough for the vertex array to be compressed
+// in several blocks. Also check that an error on a task is reported to the
+// caller of wait()
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+
+
+void write_nothing (std::ostream &)
+{}
+
+
+void test (const std::size_t memory_budget)
+{
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (8);
+
+  FE_Q<2> fe (1);
+  DoFHandler<2> dof (tria);
+  dof.distribute_dofs (fe);
+
+  Vector<double> solution (dof.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = i;
+
+  DataOutBase::BackgroundWriter writer (memory_budget);
+  DataOut<2> data_out;
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+  data_out.set_flags (flags);
+
+  const unsigned int n_steps = 4;
+  std::vector<std::string> reference (n_steps);
+  for (unsigned int step=0; step<n_steps; ++step)
+    {
+      solution *= 0.5;
+      data_out.clear ();
+      data_out.attach_dof_handler (dof);
+      data_out.add_data_vector (solution, "solution");
+      data_out.build_patches ();
+
+      std::ostringstream filename;
+      filename << "solution-" << step << ".vtu";
+      data_out.write_vtu_in_background (filename.str(), writer);
+
+      std::ostringstream out;
+      data_out.write_vtu (out);
+      reference[step] = out.str();
+    }
+  deallog << "Pending jobs before wait: " << writer.n_pending_jobs()
+          << std::endl;
+
+  writer.wait ();
+  deallog << "Pending jobs after wait: " << writer.n_pending_jobs()
+          << ", memory: " << writer.memory_in_flight() << std::endl;
+
+  for (unsigned int step=0; step<n_steps; ++step)
+    {
+      std::ostringstream filename;
+      filename << "solution-" << step << ".vtu";
+      std::ifstream in (filename.str().c_str());
+      std::ostringstream content;
+      content << in.rdbuf();
+      deallog << "Step " << step << ": "
+              << (content.str() == reference[step] ? "OK" : "different")
+              << std::endl;
+    }
+}
+
+
+void test_error ()
+{
+  DataOutBase::BackgroundWriter writer;
+  writer.submit (&write_nothing, "no_such_directory/solution.vtu", 1);
+  try
+    {
+      writer.wait ();
+      deallog << "No exception" << std::endl;
+    }
+  catch (const std::exception &)
+    {
+      deallog << "Exception caught, pending jobs: " << writer.n_pending_jobs()
+              << ", memory: " << writer.memory_in_flight() << std::endl;
+    }
+}
+
+
+int main ()
+{
+  initlog();
+
+  // with a small budget, only one job is in flight at a time
+  test (1);
+  // with a large budget, all jobs are in flight
+  test (static_cast<std::size_t>(1) << 32);
+
+  test_error ();
+}
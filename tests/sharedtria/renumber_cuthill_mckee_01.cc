@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2015 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test DoFRenumbering::distributed_Cuthill_McKee: on every processor, the
+// locally owned degrees of freedom whose rows of the global matrix couple to
+// processors with lower numbers must get the first indices of the locally
+// owned range, the ones coupling to processors with higher numbers the last
+// ones. The mesh is split into slabs that are assigned to the processors in
+// the order 0,1,0,2,1,2, so that the subdomains are not connected and
+// processor 1 has one part touching only processor 0 and one part touching
+// only processor 2.
+//
+// The slabs are assigned by hand in a parallel::shared::Triangulation, which
+// otherwise would need METIS for partitioning.
+
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/shared_tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <fstream>
+#include <algorithm>
+
+
+template <int dim>
+class SlabTriangulation : public parallel::shared::Triangulation<dim>
+{
+public:
+  SlabTriangulation ()
+    :
+    parallel::shared::Triangulation<dim> (MPI_COMM_WORLD)
+  {}
+
+  virtual void create_triangulation (const std::vector<Point<dim> > &vertices,
+                                     const std::vector<CellData<dim> > &cells,
+                                     const SubCellData &subcelldata)
+  {
+    Triangulation<dim>::create_triangulation (vertices, cells, subcelldata);
+    assign_slabs ();
+  }
+
+  virtual void execute_coarsening_and_refinement ()
+  {
+    Triangulation<dim>::execute_coarsening_and_refinement ();
+    assign_slabs ();
+  }
+
+private:
+  void assign_slabs ()
+  {
+    const unsigned int owner[] = { 0, 1, 0, 2, 1, 2 };
+    for (typename Triangulation<dim>::active_cell_iterator
+         cell = this->begin_active(); cell != this->end(); ++cell)
+      cell->set_subdomain_id (owner[std::min (static_cast<unsigned int>(cell->center()[0]), 5U)]);
+    this->update_number_cache ();
+  }
+};
+
+
+
+template <int dim>
+void check (const DoFHandler<dim> &dof_handler,
+            const bool             reversed)
+{
+  const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
+  const std::vector<IndexSet> &owned_per_processor
+    = dof_handler.locally_owned_dofs_per_processor();
+  const unsigned int my_id = dof_handler.get_tria().locally_owned_subdomain();
+  const types::global_dof_index n_owned = locally_owned.n_elements();
+
+  // find the locally owned dofs whose rows couple to dofs owned by other
+  // processors, by looking at all cells they are located on
+  std::vector<bool> lower (n_owned, false), higher (n_owned, false);
+  std::vector<types::global_dof_index> dof_indices (dof_handler.get_fe().dofs_per_cell);
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      cell->get_dof_indices (dof_indices);
+      bool couples_to_lower = false, couples_to_higher = false;
+      for (unsigned int i=0; i<dof_indices.size(); ++i)
+        for (unsigned int p=0; p<owned_per_processor.size(); ++p)
+          if (owned_per_processor[p].is_element (dof_indices[i]))
+            {
+              if (p < my_id)
+                couples_to_lower = true;
+              else if (p > my_id)
+                couples_to_higher = true;
+            }
+      for (unsigned int i=0; i<dof_indices.size(); ++i)
+        if (locally_owned.is_element (dof_indices[i]))
+          {
+            const types::global_dof_index index
+              = locally_owned.index_within_set (dof_indices[i]);
+            lower[index] = lower[index] || couples_to_lower;
+            higher[index] = higher[index] || couples_to_higher;
+          }
+    }
+
+  const types::global_dof_index n_lower = std::count (lower.begin(), lower.end(), true);
+  const types::global_dof_index n_higher = std::count (higher.begin(), higher.end(), true);
+
+  // the interface the numbering was started from must form a contiguous
+  // block at its end of the range, i.e., the dofs coupling to lower
+  // processors the first n_lower indices and the dofs coupling to higher
+  // processors the last n_higher indices. processor 1 has no component with
+  // both interfaces, so both blocks must be exact there
+  bool lower_first = true, higher_last = true;
+  for (types::global_dof_index i=0; i<n_owned; ++i)
+    {
+      if (lower[i] != (i < n_lower))
+        lower_first = false;
+      if (higher[i] != (i >= n_owned-n_higher))
+        higher_last = false;
+    }
+
+  // in any case, all dofs coupling only to lower processors must come
+  // before those coupling only to higher processors
+  types::global_dof_index last_lower = 0, first_higher = n_owned;
+  for (types::global_dof_index i=0; i<n_owned; ++i)
+    {
+      if (lower[i] && !higher[i])
+        last_lower = i;
+      if (higher[i] && !lower[i])
+        first_higher = std::min (first_higher, i);
+    }
+
+  deallog << "reversed=" << reversed
+          << ", coupling to lower: " << (n_lower > 0 ? "yes" : "no")
+          << ", coupling to higher: " << (n_higher > 0 ? "yes" : "no")
+          << std::endl;
+  deallog << "  lower interface first: " << (lower_first ? "yes" : "no")
+          << ", higher interface last: " << (higher_last ? "yes" : "no")
+          << ", separated: "
+          << (n_lower == 0 || n_higher == 0 || last_lower < first_higher ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  SlabTriangulation<dim> tria;
+  std::vector<unsigned int> repetitions (dim, 3);
+  repetitions[0] = 36;
+  Point<dim> p2;
+  for (unsigned int d=0; d<dim; ++d)
+    p2[d] = 1.;
+  p2[0] = 6.;
+  GridGenerator::subdivided_hyper_rectangle (tria, repetitions, Point<dim>(), p2);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+
+  for (unsigned int reversed=0; reversed<2; ++reversed)
+    {
+      dof_handler.distribute_dofs (fe);
+      DoFRenumbering::distributed_Cuthill_McKee (dof_handler, reversed);
+      check (dof_handler, reversed);
+    }
+}
+
+
+
+int main (int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  deallog.push ("2d");
+  test<2>();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3>();
+  deallog.pop ();
+}